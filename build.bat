@@ -504,8 +504,8 @@ if !BUILD_CPP! == 1 (
 	)
 
 	set "ADDITIONAL_DEFINES=/0x !ADDITIONAL_DEFINES!"
-	set "additional_header_files=!additional_header_files_custom_type!!additional_header_files!RTIRawTransportImpl.h Parameter.h ParameterManager.h ThreadPriorities.h ThreadCPUAffinity.h RTIDDSLoggerDevice.h MessagingIF.h RTIDDSImpl.h perftest_cpp.h qos_string.h CpuMonitor.h PerftestTransport.h Infrastructure_common.h Infrastructure_pro.h PerftestPrinter.h FileDataLoader.h"
-	set "additional_source_files=!additional_source_files_custom_type!!additional_source_files!RTIRawTransportImpl.cxx Parameter.cxx ParameterManager.cxx ThreadPriorities.cxx RTIDDSLoggerDevice.cxx RTIDDSImpl.cxx CpuMonitor.cxx PerftestTransport.cxx Infrastructure_common.cxx Infrastructure_pro.cxx PerftestPrinter.cxx FileDataLoader.cxx"
+	set "additional_header_files=!additional_header_files_custom_type!!additional_header_files!RTIRawTransportImpl.h RTIShmRingImpl.h RTILoopbackImpl.h RTIIoUringEngine.h Parameter.h ParameterManager.h ThreadPriorities.h ThreadCPUAffinity.h RTIDDSLoggerDevice.h RTIKeyFilter.h MessagingIF.h RTIDDSImpl.h perftest_cpp.h qos_string.h CpuMonitor.h PerftestTransport.h Infrastructure_common.h Infrastructure_pro.h PerftestPrinter.h FileDataLoader.h KeyDistribution.h DataLenDistribution.h TscClock.h MemoryArena.h NumaTopology.h PerftestAsyncPrinter.h PerftestColumnarStore.h PerftestColumnarPrinter.h PerftestStatsSegment.h PerftestMetricsServer.h PerftestLatencyTrace.h PerftestHostNoise.h PerftestTimerWheel.h PerftestJsonReader.h PerftestController.h PerftestScenario.h"
+	set "additional_source_files=!additional_source_files_custom_type!!additional_source_files!RTIRawTransportImpl.cxx RTIShmRingImpl.cxx RTILoopbackImpl.cxx RTIIoUringEngine.cxx Parameter.cxx ParameterManager.cxx ThreadPriorities.cxx RTIDDSLoggerDevice.cxx RTIKeyFilter.cxx RTIDDSImpl.cxx CpuMonitor.cxx PerftestTransport.cxx Infrastructure_common.cxx Infrastructure_pro.cxx PerftestPrinter.cxx FileDataLoader.cxx KeyDistribution.cxx DataLenDistribution.cxx TscClock.cxx MemoryArena.cxx NumaTopology.cxx PerftestAsyncPrinter.cxx PerftestColumnarStore.cxx PerftestColumnarPrinter.cxx PerftestStatsSegment.cxx PerftestMetricsServer.cxx PerftestHostNoise.cxx PerftestTimerWheel.cxx PerftestController.cxx PerftestScenario.cxx"
 
 	if !FLATDATA_AVAILABLE! == 1 (
 		set "additional_header_files=!additional_header_files! perftest_ZeroCopy.h perftest_ZeroCopyPlugin.h perftest_ZeroCopySupport.h"
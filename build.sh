@@ -1002,11 +1002,15 @@ function build_cpp()
 
     additional_header_files="${additional_header_files_custom_type} \
         RTIRawTransportImpl.h \
+        RTIShmRingImpl.h \
+        RTILoopbackImpl.h \
+        RTIIoUringEngine.h \
         ThreadPriorities.h \
         ThreadCPUAffinity.h \
         Parameter.h \
         ParameterManager.h \
         RTIDDSLoggerDevice.h \
+        RTIKeyFilter.h \
         MessagingIF.h \
         RTIDDSImpl.h \
         perftest_cpp.h \
@@ -1017,14 +1021,34 @@ function build_cpp()
         Infrastructure_common.h \
         Infrastructure_pro.h \
         PerftestPrinter.h \
-        FileDataLoader.h"
+        FileDataLoader.h \
+        KeyDistribution.h \
+        DataLenDistribution.h \
+        TscClock.h \
+        MemoryArena.h \
+        NumaTopology.h \
+        PerftestAsyncPrinter.h \
+        PerftestColumnarStore.h \
+        PerftestColumnarPrinter.h \
+        PerftestStatsSegment.h \
+        PerftestMetricsServer.h \
+        PerftestLatencyTrace.h \
+        PerftestHostNoise.h \
+        PerftestTimerWheel.h \
+        PerftestJsonReader.h \
+        PerftestController.h \
+        PerftestScenario.h"
 
     additional_source_files="${additional_source_files_custom_type} \
         RTIRawTransportImpl.cxx \
+        RTIShmRingImpl.cxx \
+        RTILoopbackImpl.cxx \
+        RTIIoUringEngine.cxx \
         ThreadPriorities.cxx \
         Parameter.cxx \
         ParameterManager.cxx \
         RTIDDSLoggerDevice.cxx \
+        RTIKeyFilter.cxx \
         RTIDDSImpl.cxx \
         CpuMonitor.cxx \
         PerftestTransport.cxx \
@@ -1032,7 +1056,21 @@ function build_cpp()
         Infrastructure_common.cxx \
         Infrastructure_pro.cxx \
         PerftestPrinter.cxx \
-        FileDataLoader.cxx"
+        FileDataLoader.cxx \
+        KeyDistribution.cxx \
+        DataLenDistribution.cxx \
+        TscClock.cxx \
+        MemoryArena.cxx \
+        NumaTopology.cxx \
+        PerftestAsyncPrinter.cxx \
+        PerftestColumnarStore.cxx \
+        PerftestColumnarPrinter.cxx \
+        PerftestStatsSegment.cxx \
+        PerftestMetricsServer.cxx \
+        PerftestHostNoise.cxx \
+        PerftestTimerWheel.cxx \
+        PerftestController.cxx \
+        PerftestScenario.cxx"
 
     if [ "${FAST_QUEUE}" == "1" ]; then
         additional_header_files="${additional_header_files} \
@@ -1208,6 +1246,49 @@ function build_cpp()
     # Removing README files if those are created by rtiddsgen
     rm -f "${classic_cpp_folder}/README_${platform}.txt"
 
+    build_standalone_tools
+}
+
+# Build one of the tools in resource/<name>/<name>.cxx, which only need the
+# C++ standard library and the files given of srcCppCommon:
+#   build_standalone_tool <name> [srcCppCommon sources] [libs] [defines]
+function build_standalone_tool()
+{
+    local tool_name="$1"
+    local tool_sources=("${resource_folder}/${tool_name}/${tool_name}.cxx")
+    local source
+    for source in $2; do
+        tool_sources+=("${common_cpp_folder}/${source}")
+    done
+
+    local tool_compiler="${COMPILER_EXE}"
+    if [ -z "${tool_compiler}" ]; then
+        tool_compiler="c++"
+    fi
+
+    echo ""
+    echo -e "${INFO_TAG} Compiling ${tool_name}"
+    "${tool_compiler}" -std=c++11 -O2 $4 \
+        -I"${common_cpp_folder}" \
+        "${tool_sources[@]}" \
+        -o "${bin_folder}/${platform}/${RELEASE_DEBUG}/${tool_name}" $3
+    if [ "$?" != 0 ]; then
+        echo -e "${WARNING_TAG} Failure compiling ${tool_name}."
+    else
+        echo -e "${INFO_TAG} ${tool_name} copied into: \"bin/${platform}/${RELEASE_DEBUG}\" folder"
+    fi
+}
+
+# perftest_top displays the counters published with -statsSegment (Linux
+# only), perftest_compare compares the results of a candidate against a
+# baseline and perftest_columnar reads the files of -outputFormat columnar.
+function build_standalone_tools()
+{
+    if [[ $platform == *"Linux"* ]]; then
+        build_standalone_tool perftest_top "" "-lrt" "-DRTI_LINUX -DRTI_UNIX"
+    fi
+    build_standalone_tool perftest_compare
+    build_standalone_tool perftest_columnar "PerftestColumnarStore.cxx"
 }
 
 function build_micro_cpp()
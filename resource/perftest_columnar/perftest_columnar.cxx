@@ -0,0 +1,417 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+/*
+ * perftest_columnar: Reader of the files written with
+ * "-outputFormat columnar -outputFile <file>".
+ *
+ * Without -table it lists the runs of the files and their tables. With
+ * -table it exports the rows of that table of all the runs to CSV, with the
+ * run id as the first column. -config adds the value of some parameters of
+ * every run to its rows (for example the parameter that a sweep changes), and
+ * -where keeps only the rows that match, on any exported column.
+ *
+ * It does not depend on Connext, build.sh compiles it with:
+ *
+ *   c++ -std=c++11 -O2 -I srcCppCommon \
+ *       resource/perftest_columnar/perftest_columnar.cxx \
+ *       srcCppCommon/PerftestColumnarStore.cxx -o perftest_columnar
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "PerftestColumnarStore.h"
+
+/* A condition of -where: <column><operator><value> */
+struct Condition {
+    std::string column;
+    std::string op;
+    std::string value;
+    int index;
+};
+
+static std::vector<std::string> split(const std::string &text)
+{
+    std::vector<std::string> result;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        if (end > start) {
+            result.push_back(text.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return result;
+}
+
+static bool parse_condition(const std::string &text, Condition &condition)
+{
+    static const char *OPERATORS[] = {"!=", "<=", ">=", "=", "<", ">"};
+    for (unsigned int i = 0; i < sizeof(OPERATORS) / sizeof(OPERATORS[0]);
+            i++) {
+        size_t position = text.find(OPERATORS[i]);
+        if (position != std::string::npos && position > 0) {
+            condition.column = text.substr(0, position);
+            condition.op = OPERATORS[i];
+            condition.value = text.substr(position + strlen(OPERATORS[i]));
+            condition.index = -1;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_number(const std::string &text, double &value)
+{
+    char *end = NULL;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && end != NULL && *end == '\0';
+}
+
+/* Numeric comparison if both sides are numbers, text comparison otherwise */
+static bool matches(const Condition &condition, const std::string &value)
+{
+    double left, right;
+    int comparison;
+    if (is_number(value, left) && is_number(condition.value, right)) {
+        comparison = left < right ? -1 : (left > right ? 1 : 0);
+    } else {
+        comparison = value.compare(condition.value);
+    }
+
+    if (condition.op == "=") {
+        return comparison == 0;
+    } else if (condition.op == "!=") {
+        return comparison != 0;
+    } else if (condition.op == "<") {
+        return comparison < 0;
+    } else if (condition.op == "<=") {
+        return comparison <= 0;
+    } else if (condition.op == ">") {
+        return comparison > 0;
+    }
+    return comparison >= 0;
+}
+
+static std::string format_run_id(unsigned long long runId)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%016llx", runId);
+    return buffer;
+}
+
+static void print_csv_field(FILE *output, const std::string &value)
+{
+    if (value.find_first_of(",\"\n\r") == std::string::npos) {
+        fputs(value.c_str(), output);
+        return;
+    }
+    fputc('"', output);
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '"') {
+            fputc('"', output);
+        }
+        fputc(value[i], output);
+    }
+    fputc('"', output);
+}
+
+static void list(
+        const std::vector<PerftestColumnarTable> &blocks,
+        const std::map<unsigned long long, const PerftestColumnarTable *>
+                &configs)
+{
+    // Rows and columns of every table of every run, in the order of the file
+    std::vector<unsigned long long> runs;
+    std::map<unsigned long long, std::map<std::string, unsigned long long> >
+            rows;
+    std::map<std::string, std::vector<std::string> > columns;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        const PerftestColumnarTable &block = blocks[i];
+        if (rows.find(block.get_run_id()) == rows.end()) {
+            runs.push_back(block.get_run_id());
+        }
+        rows[block.get_run_id()][block.get_name()] += block.get_rows();
+        std::vector<std::string> &names = columns[block.get_name()];
+        for (size_t j = 0; j < block.get_columns().size(); j++) {
+            const PerftestColumn &column = block.get_columns()[j];
+            std::string name = column.name
+                    + (column.type == PERFTEST_COLUMN_INT64
+                               ? " (int)"
+                               : column.type == PERFTEST_COLUMN_DOUBLE
+                                       ? " (double)"
+                                       : " (string)");
+            bool found = false;
+            for (size_t k = 0; k < names.size() && !found; k++) {
+                found = names[k] == name;
+            }
+            if (!found) {
+                names.push_back(name);
+            }
+        }
+    }
+
+    printf("%u runs, %u blocks\n",
+            (unsigned int) runs.size(),
+            (unsigned int) blocks.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        printf("\nRun %s", format_run_id(runs[i]).c_str());
+        std::map<unsigned long long, const PerftestColumnarTable *>::
+                const_iterator config = configs.find(runs[i]);
+        if (config != configs.end()) {
+            int column = config->second->find_column("start_time_s");
+            if (column >= 0) {
+                time_t start = (time_t) config->second->get_columns()[column]
+                                       .ints[0];
+                char buffer[64];
+                strftime(buffer,
+                        sizeof(buffer),
+                        "%Y-%m-%d %H:%M:%S",
+                        localtime(&start));
+                printf(", started %s", buffer);
+            }
+        }
+        printf("\n");
+        std::map<std::string, unsigned long long> &tables = rows[runs[i]];
+        std::map<std::string, unsigned long long>::iterator it;
+        for (it = tables.begin(); it != tables.end(); it++) {
+            printf("\t%-22s %llu rows\n", it->first.c_str(), it->second);
+        }
+    }
+
+    printf("\nColumns:\n");
+    std::map<std::string, std::vector<std::string> >::iterator it;
+    for (it = columns.begin(); it != columns.end(); it++) {
+        if (it->first == "config") {
+            printf("\tconfig: %u parameters (see -config)\n",
+                    (unsigned int) it->second.size());
+            continue;
+        }
+        printf("\t%s:", it->first.c_str());
+        for (size_t j = 0; j < it->second.size(); j++) {
+            printf("%s %s", j == 0 ? "" : ",", it->second[j].c_str());
+        }
+        printf("\n");
+    }
+}
+
+static bool export_csv(
+        const std::vector<PerftestColumnarTable> &blocks,
+        const std::map<unsigned long long, const PerftestColumnarTable *>
+                &configs,
+        const std::string &table,
+        std::vector<std::string> selected,
+        const std::vector<std::string> &configColumns,
+        std::vector<Condition> &conditions,
+        FILE *output)
+{
+    // All the columns of the table, in the order they appear
+    if (selected.empty()) {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            if (blocks[i].get_name() != table) {
+                continue;
+            }
+            for (size_t j = 0; j < blocks[i].get_columns().size(); j++) {
+                const std::string &name = blocks[i].get_columns()[j].name;
+                bool found = false;
+                for (size_t k = 0; k < selected.size() && !found; k++) {
+                    found = selected[k] == name;
+                }
+                if (!found) {
+                    selected.push_back(name);
+                }
+            }
+        }
+    }
+
+    std::vector<std::string> header;
+    header.push_back("run");
+    header.insert(header.end(), configColumns.begin(), configColumns.end());
+    header.insert(header.end(), selected.begin(), selected.end());
+    for (size_t i = 0; i < conditions.size(); i++) {
+        for (size_t j = 0; j < header.size(); j++) {
+            if (header[j] == conditions[i].column) {
+                conditions[i].index = (int) j;
+            }
+        }
+        if (conditions[i].index < 0) {
+            fprintf(stderr,
+                    "[Error] -where: %s is not an exported column.\n",
+                    conditions[i].column.c_str());
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < header.size(); i++) {
+        if (i > 0) {
+            fputc(',', output);
+        }
+        print_csv_field(output, header[i]);
+    }
+    fputc('\n', output);
+
+    std::vector<std::string> values(header.size());
+    for (size_t i = 0; i < blocks.size(); i++) {
+        const PerftestColumnarTable &block = blocks[i];
+        if (block.get_name() != table) {
+            continue;
+        }
+
+        // The values of the run and the index of the columns in this block
+        values[0] = format_run_id(block.get_run_id());
+        std::map<unsigned long long, const PerftestColumnarTable *>::
+                const_iterator config = configs.find(block.get_run_id());
+        for (size_t j = 0; j < configColumns.size(); j++) {
+            int column = config == configs.end()
+                    ? -1
+                    : config->second->find_column(configColumns[j]);
+            values[1 + j] = column < 0
+                    ? ""
+                    : config->second->get_columns()[column].to_string(0);
+        }
+        std::vector<int> indexes(selected.size());
+        for (size_t j = 0; j < selected.size(); j++) {
+            indexes[j] = block.find_column(selected[j]);
+        }
+
+        const size_t first = 1 + configColumns.size();
+        for (unsigned int row = 0; row < block.get_rows(); row++) {
+            for (size_t j = 0; j < selected.size(); j++) {
+                values[first + j] = indexes[j] < 0
+                        ? ""
+                        : block.get_columns()[indexes[j]].to_string(row);
+            }
+            bool keep = true;
+            for (size_t j = 0; j < conditions.size() && keep; j++) {
+                keep = matches(conditions[j], values[conditions[j].index]);
+            }
+            if (!keep) {
+                continue;
+            }
+            for (size_t j = 0; j < values.size(); j++) {
+                if (j > 0) {
+                    fputc(',', output);
+                }
+                print_csv_field(output, values[j]);
+            }
+            fputc('\n', output);
+        }
+    }
+    return true;
+}
+
+static void print_usage()
+{
+    printf("Usage: perftest_columnar <file> [<file> ...] [options]\n"
+           "Lists the runs of files written with '-outputFormat columnar',\n"
+           "or exports one of their tables to CSV.\n\n"
+           "\t-table <name>        - Export the rows of the table (for\n"
+           "\t                       example latency_summary) to CSV\n"
+           "\t-columns <c1,c2,...> - Columns of the table to export,\n"
+           "\t                       default all\n"
+           "\t-config <p1,p2,...>  - Parameters of the run to add to every\n"
+           "\t                       row, for example dataLen,batchSize\n"
+           "\t-where <condition>   - Keep the rows where <column><op><value>\n"
+           "\t                       is true, with op =, !=, <, <=, > or >=.\n"
+           "\t                       Can be repeated\n"
+           "\t-run <id>            - Only the rows of this run\n"
+           "\t-output <file>       - Write the CSV to the file, default\n"
+           "\t                       the standard output\n");
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> files;
+    std::string table;
+    std::vector<std::string> columns;
+    std::vector<std::string> configColumns;
+    std::vector<Condition> conditions;
+    std::string outputFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "-help" || option == "-h") {
+            print_usage();
+            return 0;
+        } else if (option == "-table" && hasValue) {
+            table = argv[++i];
+        } else if (option == "-columns" && hasValue) {
+            columns = split(argv[++i]);
+        } else if (option == "-config" && hasValue) {
+            configColumns = split(argv[++i]);
+        } else if (option == "-where" && hasValue) {
+            Condition condition;
+            if (!parse_condition(argv[++i], condition)) {
+                fprintf(stderr, "[Error] Wrong condition: %s\n", argv[i]);
+                return 1;
+            }
+            conditions.push_back(condition);
+        } else if (option == "-run" && hasValue) {
+            Condition condition;
+            parse_condition(std::string("run=") + argv[++i], condition);
+            conditions.push_back(condition);
+        } else if (option == "-output" && hasValue) {
+            outputFile = argv[++i];
+        } else if (!option.empty() && option[0] != '-') {
+            files.push_back(option);
+        } else {
+            fprintf(stderr, "[Error] Wrong option: %s\n", option.c_str());
+            print_usage();
+            return 1;
+        }
+    }
+    if (files.empty()) {
+        print_usage();
+        return 1;
+    }
+
+    std::vector<PerftestColumnarTable> blocks;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!PerftestColumnarStore_read_file(files[i], blocks)) {
+            return 1;
+        }
+    }
+    std::map<unsigned long long, const PerftestColumnarTable *> configs;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (blocks[i].get_name() == "config" && blocks[i].get_rows() > 0) {
+            configs[blocks[i].get_run_id()] = &blocks[i];
+        }
+    }
+
+    if (table.empty()) {
+        list(blocks, configs);
+        return 0;
+    }
+
+    FILE *output = stdout;
+    if (!outputFile.empty()) {
+        output = fopen(outputFile.c_str(), "w");
+        if (output == NULL) {
+            fprintf(stderr, "[Error] Cannot open %s.\n", outputFile.c_str());
+            return 1;
+        }
+    }
+    bool success = export_csv(
+            blocks,
+            configs,
+            table,
+            columns,
+            configColumns,
+            conditions,
+            output);
+    if (output != stdout) {
+        fclose(output);
+    }
+    return success ? 0 : 1;
+}
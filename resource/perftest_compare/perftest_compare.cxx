@@ -0,0 +1,772 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+/*
+ * perftest_compare: Performance regression gate. Compares the results of one
+ * or more candidate runs against one or more baseline runs and exits with 1
+ * if the throughput or the selected latency percentiles got worse than the
+ * thresholds.
+ *
+ * The inputs are the files written with "-outputFormat json -outputFile"
+ * (a file can contain several runs, as the output file is appended) and the
+ * latency samples written with "-latencyFile <file> -latencyFileBinary".
+ * The results are aligned by mode (latency or throughput) and data length.
+ *
+ * With several runs per side, the per-run values are compared: the delta of
+ * the medians, its bootstrap confidence interval and the Mann-Whitney U test.
+ * With latency samples on both sides, the latency percentiles are compared
+ * on the samples themselves, and the p-value of every percentile comes from
+ * its own bootstrap. A metric regresses if its delta is worse than the
+ * threshold and, when there are enough values to compute it, the confidence
+ * interval does not include 0.
+ *
+ * It does not depend on Connext, build.sh compiles it with:
+ *
+ *   c++ -std=c++11 -O2 -I srcCppCommon \
+ *       resource/perftest_compare/perftest_compare.cxx -o perftest_compare
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "PerftestJsonReader.h"
+#include "PerftestLatencyTrace.h"
+
+/* Samples of every side used for the sample-level statistics */
+#define PERFTEST_COMPARE_MAX_SAMPLES 20000
+
+enum CompareExitCode {
+    COMPARE_PASSED = 0,
+    COMPARE_REGRESSION = 1,
+    COMPARE_ERROR = 2
+};
+
+/******************************************************************************/
+/* Results                                                                    */
+/******************************************************************************/
+
+/* Results of one side (baseline or candidate) for a mode and data length */
+struct ResultSet {
+    // Value of every metric in every run
+    std::map<std::string, std::vector<double> > runs;
+    // Latency samples (us) of the binary latency files
+    std::vector<double> samples;
+};
+
+typedef std::pair<std::string, unsigned int> ResultKey;
+typedef std::map<ResultKey, ResultSet> Results;
+
+static const char *LATENCY_METRICS[] = {
+    "latency_ave", "latency_50", "latency_90", "latency_99",
+    "latency_99.99", "latency_99.9999"
+};
+static const char *THROUGHPUT_METRICS[] = {
+    "packets/sAve", "mbpsAve", "lostPercent"
+};
+
+static double get_percentile(const std::vector<double> &sorted, double percent)
+{
+    size_t index = (size_t) (sorted.size() * percent / 100.0);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static bool read_file(const std::string &fileName, std::string &content)
+{
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    if (!file.is_open()) {
+        fprintf(stderr,
+                "[Error] perftest_compare: Cannot open \"%s\".\n",
+                fileName.c_str());
+        return false;
+    }
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    content = stream.str();
+    return true;
+}
+
+/* Every {"perftest": ...} document of the file is a run */
+static bool load_json(const std::string &fileName, Results &results)
+{
+    std::string content;
+    if (!read_file(fileName, content)) {
+        return false;
+    }
+
+    unsigned int documents = 0;
+    size_t position = content.find("{\"perftest\"");
+    while (position != std::string::npos) {
+        JsonParser parser(content, position);
+        JsonValue document;
+        const JsonValue *tests = NULL;
+        if (!parser.parse(document)
+                || (tests = document.get("perftest")) == NULL
+                || tests->type != JsonValue::JSON_ARRAY) {
+            fprintf(stderr,
+                    "[Error] perftest_compare: Wrong JSON in \"%s\" at "
+                    "offset %lu.\n",
+                    fileName.c_str(),
+                    (unsigned long) position);
+            return false;
+        }
+        documents++;
+
+        for (size_t i = 0; i < tests->items.size(); i++) {
+            const JsonValue *length = tests->items[i].get("length");
+            const JsonValue *summary = tests->items[i].get("summary");
+            if (length == NULL || summary == NULL) {
+                continue;
+            }
+            bool isLatency = summary->get("latency_ave") != NULL;
+            ResultSet &set = results[ResultKey(
+                    isLatency ? "latency" : "throughput",
+                    (unsigned int) length->number)];
+            const char **metrics =
+                    isLatency ? LATENCY_METRICS : THROUGHPUT_METRICS;
+            size_t metricCount = isLatency
+                    ? sizeof(LATENCY_METRICS) / sizeof(LATENCY_METRICS[0])
+                    : sizeof(THROUGHPUT_METRICS) / sizeof(THROUGHPUT_METRICS[0]);
+            for (size_t j = 0; j < metricCount; j++) {
+                const JsonValue *value = summary->get(metrics[j]);
+                if (value != NULL && value->type == JsonValue::JSON_NUMBER) {
+                    set.runs[metrics[j]].push_back(value->number);
+                }
+            }
+        }
+        position = content.find("{\"perftest\"", parser.get_position());
+    }
+
+    if (documents == 0) {
+        fprintf(stderr,
+                "[Error] perftest_compare: No Perftest JSON output in "
+                "\"%s\".\n",
+                fileName.c_str());
+        return false;
+    }
+    return true;
+}
+
+/* Every block of the file is a run */
+static bool load_latency_trace(const std::string &fileName, Results &results)
+{
+    std::string content;
+    if (!read_file(fileName, content)) {
+        return false;
+    }
+
+    size_t position = 0;
+    while (position < content.size()) {
+        PerftestLatencyTraceHeader header;
+        if (content.size() - position < sizeof(header)) {
+            fprintf(stderr,
+                    "[Error] perftest_compare: Truncated latency file "
+                    "\"%s\".\n",
+                    fileName.c_str());
+            return false;
+        }
+        memcpy(&header, content.data() + position, sizeof(header));
+        position += sizeof(header);
+        if (header.magic != PERFTEST_LATENCY_TRACE_MAGIC
+                || header.version != PERFTEST_LATENCY_TRACE_VERSION
+                || (content.size() - position) / sizeof(unsigned long long)
+                        < header.count) {
+            fprintf(stderr,
+                    "[Error] perftest_compare: Wrong latency file \"%s\".\n",
+                    fileName.c_str());
+            return false;
+        }
+
+        std::vector<double> latencies((size_t) header.count);
+        for (size_t i = 0; i < latencies.size(); i++) {
+            unsigned long long latency = 0;
+            memcpy(&latency, content.data() + position, sizeof(latency));
+            position += sizeof(latency);
+            latencies[i] = header.nanoseconds ? latency / 1000.0
+                                              : (double) latency;
+        }
+        if (latencies.empty()) {
+            continue;
+        }
+
+        ResultSet &set = results[ResultKey("latency", header.dataLength)];
+        set.samples.insert(set.samples.end(), latencies.begin(), latencies.end());
+
+        // Also a run, like the summary printed for the same samples
+        std::sort(latencies.begin(), latencies.end());
+        double sum = 0;
+        for (size_t i = 0; i < latencies.size(); i++) {
+            sum += latencies[i];
+        }
+        set.runs["latency_ave"].push_back(sum / latencies.size());
+        set.runs["latency_50"].push_back(get_percentile(latencies, 50));
+        set.runs["latency_90"].push_back(get_percentile(latencies, 90));
+        set.runs["latency_99"].push_back(get_percentile(latencies, 99));
+        set.runs["latency_99.99"].push_back(get_percentile(latencies, 99.99));
+        set.runs["latency_99.9999"].push_back(
+                get_percentile(latencies, 99.9999));
+    }
+    return true;
+}
+
+static bool load(const std::string &fileName, Results &results)
+{
+    FILE *file = fopen(fileName.c_str(), "rb");
+    unsigned int magic = 0;
+    bool isTrace = file != NULL
+            && fread(&magic, sizeof(magic), 1, file) == 1
+            && magic == PERFTEST_LATENCY_TRACE_MAGIC;
+    if (file != NULL) {
+        fclose(file);
+    }
+    return isTrace ? load_latency_trace(fileName, results)
+                   : load_json(fileName, results);
+}
+
+/******************************************************************************/
+/* Statistics                                                                 */
+/******************************************************************************/
+
+struct Comparison {
+    double baseline;
+    double candidate;
+    double delta;          // Percentage, positive if the candidate is bigger
+    bool hasStatistics;
+    double deltaLow;       // Confidence interval of the delta
+    double deltaHigh;
+    double pValue;         // Two-sided: Mann-Whitney U or bootstrap
+    const char *basis;     // "runs" or "samples"
+};
+
+struct Options {
+    double throughputThreshold;
+    double latencyThreshold;
+    std::vector<std::string> percentiles;
+    double confidence;
+    unsigned int bootstrap;
+    unsigned long long seed;
+};
+
+static double get_median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 == 1
+            ? values[middle]
+            : (values[middle - 1] + values[middle]) / 2;
+}
+
+static double get_delta(double baseline, double candidate)
+{
+    return baseline != 0 ? (candidate - baseline) * 100.0 / baseline : 0.0;
+}
+
+/* Two-sided p-value, normal approximation with correction for ties */
+static double mann_whitney_u(
+        const std::vector<double> &first,
+        const std::vector<double> &second)
+{
+    std::vector<std::pair<double, int> > all;
+    for (size_t i = 0; i < first.size(); i++) {
+        all.push_back(std::make_pair(first[i], 0));
+    }
+    for (size_t i = 0; i < second.size(); i++) {
+        all.push_back(std::make_pair(second[i], 1));
+    }
+    std::sort(all.begin(), all.end());
+
+    double n1 = (double) first.size();
+    double n2 = (double) second.size();
+    double n = n1 + n2;
+    double rankSum = 0;
+    double ties = 0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) {
+            j++;
+        }
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++) {
+            if (all[k].second == 0) {
+                rankSum += rank;
+            }
+        }
+        double t = (double) (j - i);
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    double u = rankSum - n1 * (n1 + 1) / 2;
+    double mean = n1 * n2 / 2;
+    double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+    if (variance <= 0) {
+        return 1.0;
+    }
+    double z = (fabs(u - mean) - 0.5) / sqrt(variance);
+    return std::min(1.0, erfc(std::max(z, 0.0) / sqrt(2.0)));
+}
+
+/*
+ * Two-sided p-value of a sorted bootstrap distribution of deltas: twice the
+ * fraction of the resamples on the less likely side of 0.
+ */
+static double get_bootstrap_p_value(const std::vector<double> &sortedDeltas)
+{
+    size_t below = std::lower_bound(
+            sortedDeltas.begin(), sortedDeltas.end(), 0.0)
+            - sortedDeltas.begin();
+    size_t above = sortedDeltas.end() - std::upper_bound(
+            sortedDeltas.begin(), sortedDeltas.end(), 0.0);
+    size_t zeros = sortedDeltas.size() - below - above;
+    // Resamples with no change count for both sides
+    double tail = (double) (std::min(below, above) + zeros)
+            / (double) sortedDeltas.size();
+    return std::min(1.0, 2 * tail);
+}
+
+/* At most PERFTEST_COMPARE_MAX_SAMPLES samples, keeping the distribution */
+static std::vector<double> reduce_samples(std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    if (samples.size() <= PERFTEST_COMPARE_MAX_SAMPLES) {
+        return samples;
+    }
+    std::vector<double> reduced(PERFTEST_COMPARE_MAX_SAMPLES);
+    for (size_t i = 0; i < reduced.size(); i++) {
+        reduced[i] = samples[i * samples.size() / reduced.size()];
+    }
+    return reduced;
+}
+
+/*
+ * Compare the per-run values of a metric. With at least 2 runs per side the
+ * bootstrap resamples the runs and compares their medians.
+ */
+static Comparison compare_runs(
+        const std::vector<double> &baseline,
+        const std::vector<double> &candidate,
+        const Options &options,
+        std::mt19937_64 &random)
+{
+    Comparison result;
+    result.baseline = get_median(baseline);
+    result.candidate = get_median(candidate);
+    result.delta = get_delta(result.baseline, result.candidate);
+    result.hasStatistics = baseline.size() >= 2 && candidate.size() >= 2;
+    result.deltaLow = result.deltaHigh = result.delta;
+    result.pValue = 1.0;
+    result.basis = "runs";
+    if (!result.hasStatistics) {
+        return result;
+    }
+
+    std::vector<double> deltas(options.bootstrap);
+    std::vector<double> first(baseline.size());
+    std::vector<double> second(candidate.size());
+    std::uniform_int_distribution<size_t> pickFirst(0, baseline.size() - 1);
+    std::uniform_int_distribution<size_t> pickSecond(0, candidate.size() - 1);
+    for (unsigned int i = 0; i < options.bootstrap; i++) {
+        for (size_t j = 0; j < first.size(); j++) {
+            first[j] = baseline[pickFirst(random)];
+        }
+        for (size_t j = 0; j < second.size(); j++) {
+            second[j] = candidate[pickSecond(random)];
+        }
+        deltas[i] = get_delta(get_median(first), get_median(second));
+    }
+    std::sort(deltas.begin(), deltas.end());
+    double tail = (100.0 - options.confidence) / 2;
+    result.deltaLow = get_percentile(deltas, tail);
+    result.deltaHigh = get_percentile(deltas, 100.0 - tail);
+    result.pValue = mann_whitney_u(baseline, candidate);
+    return result;
+}
+
+/*
+ * Percentiles of a resample of the sorted samples. The resample is kept as
+ * the number of times every sample was picked, so it is already sorted.
+ */
+static void resample_percentiles(
+        const std::vector<double> &sorted,
+        const std::vector<double> &percents,
+        std::vector<unsigned int> &counts,
+        std::mt19937_64 &random,
+        std::vector<double> &result)
+{
+    std::uniform_int_distribution<size_t> pick(0, sorted.size() - 1);
+    std::fill(counts.begin(), counts.end(), 0);
+    for (size_t i = 0; i < sorted.size(); i++) {
+        counts[pick(random)]++;
+    }
+
+    // percents is sorted, so a single pass finds all of them
+    size_t seen = 0;
+    size_t sample = 0;
+    for (size_t i = 0; i < percents.size(); i++) {
+        size_t index = std::min(
+                (size_t) (sorted.size() * percents[i] / 100.0),
+                sorted.size() - 1);
+        while (seen + counts[sample] <= index) {
+            seen += counts[sample++];
+        }
+        result[i] = sorted[sample];
+    }
+}
+
+/*
+ * Compare the latency percentiles on the samples of both sides, bootstrapping
+ * the samples. The Mann-Whitney U test would only tell if the whole
+ * distributions moved (e.g. the median), not if a given percentile did, so
+ * every percentile gets the p-value of its own bootstrap.
+ */
+static std::vector<Comparison> compare_samples(
+        const std::vector<double> &baseline,
+        const std::vector<double> &candidate,
+        const std::vector<double> &percents,
+        const Options &options,
+        std::mt19937_64 &random)
+{
+    std::vector<double> first = reduce_samples(baseline);
+    std::vector<double> second = reduce_samples(candidate);
+
+    std::vector<std::vector<double> > deltas(
+            percents.size(),
+            std::vector<double>(options.bootstrap));
+    std::vector<unsigned int> countsFirst(first.size());
+    std::vector<unsigned int> countsSecond(second.size());
+    std::vector<double> resampledFirst(percents.size());
+    std::vector<double> resampledSecond(percents.size());
+    for (unsigned int i = 0; i < options.bootstrap; i++) {
+        resample_percentiles(
+                first, percents, countsFirst, random, resampledFirst);
+        resample_percentiles(
+                second, percents, countsSecond, random, resampledSecond);
+        for (size_t j = 0; j < percents.size(); j++) {
+            deltas[j][i] = get_delta(resampledFirst[j], resampledSecond[j]);
+        }
+    }
+
+    std::vector<Comparison> results(percents.size());
+    double tail = (100.0 - options.confidence) / 2;
+    for (size_t j = 0; j < percents.size(); j++) {
+        Comparison &result = results[j];
+        result.baseline = get_percentile(first, percents[j]);
+        result.candidate = get_percentile(second, percents[j]);
+        result.delta = get_delta(result.baseline, result.candidate);
+        result.hasStatistics = true;
+        std::sort(deltas[j].begin(), deltas[j].end());
+        result.deltaLow = get_percentile(deltas[j], tail);
+        result.deltaHigh = get_percentile(deltas[j], 100.0 - tail);
+        result.pValue = get_bootstrap_p_value(deltas[j]);
+        result.basis = "samples";
+    }
+    return results;
+}
+
+/******************************************************************************/
+/* Report                                                                     */
+/******************************************************************************/
+
+static void print_usage()
+{
+    printf("Usage: perftest_compare -baseline <file>... -candidate <file>... "
+           "[options]\n"
+           "  Files: JSON output (-outputFormat json -outputFile) or binary\n"
+           "  latency samples (-latencyFile -latencyFileBinary).\n"
+           "  -throughputThreshold <%%>  Maximum throughput decrease. "
+           "Default: 5\n"
+           "  -latencyThreshold <%%>     Maximum latency increase. "
+           "Default: 10\n"
+           "  -percentiles <list>       Latency values checked, from ave,50,"
+           "90,99,99.99,99.9999.\n"
+           "                            Default: 50,90,99\n"
+           "  -confidence <%%>           Confidence interval. Default: 95\n"
+           "  -bootstrap <n>            Bootstrap resamples. Default: 1000\n"
+           "  -seed <n>                 Seed of the bootstrap. Default: 1\n"
+           "Exit code: 0 if no regression, 1 if any, 2 on errors.\n");
+}
+
+static std::string format_value(double value)
+{
+    char text[32];
+    snprintf(text, sizeof(text), value >= 1000 ? "%.0f" : "%.2f", value);
+    return text;
+}
+
+/*
+ * Print the comparison of a metric, true if it regressed. biggerIsWorse is
+ * true for the latencies and false for the throughput.
+ */
+static bool report(
+        const ResultKey &key,
+        const std::string &metric,
+        const Comparison &result,
+        double threshold,
+        bool biggerIsWorse,
+        bool checked)
+{
+    double worse = biggerIsWorse ? result.delta : -result.delta;
+    bool significant = !result.hasStatistics
+            || (biggerIsWorse ? result.deltaLow > 0 : result.deltaHigh < 0);
+    bool regressed = checked && worse > threshold && significant;
+
+    const char *verdict = "ok";
+    if (regressed) {
+        verdict = "REGRESSION";
+    } else if (!checked) {
+        verdict = "-";
+    } else if (worse > threshold) {
+        verdict = "not significant";
+    } else if (worse < -threshold && result.hasStatistics
+            && (biggerIsWorse ? result.deltaHigh < 0 : result.deltaLow > 0)) {
+        verdict = "improved";
+    }
+
+    char interval[48] = "-";
+    char pValue[16] = "-";
+    if (result.hasStatistics) {
+        snprintf(interval, sizeof(interval), "[%+.1f%%, %+.1f%%]",
+                result.deltaLow, result.deltaHigh);
+        snprintf(pValue, sizeof(pValue), "%.4f", result.pValue);
+    }
+    printf("%-11s%8u  %-16s%12s%12s%+9.1f%%  %-20s%8s  %-8s%s\n",
+            key.first.c_str(),
+            key.second,
+            metric.c_str(),
+            format_value(result.baseline).c_str(),
+            format_value(result.candidate).c_str(),
+            result.delta,
+            interval,
+            pValue,
+            result.basis,
+            verdict);
+    return regressed;
+}
+
+static bool parse_number(const char *text, double &value)
+{
+    char *end = NULL;
+    value = strtod(text, &end);
+    return end != text && *end == '\0' && value >= 0;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> files[2];
+    Options options;
+    options.throughputThreshold = 5;
+    options.latencyThreshold = 10;
+    options.percentiles.push_back("50");
+    options.percentiles.push_back("90");
+    options.percentiles.push_back("99");
+    options.confidence = 95;
+    options.bootstrap = 1000;
+    options.seed = 1;
+
+    int side = -1;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        double value = 0;
+        bool hasValue = i + 1 < argc;
+        if (argument == "-baseline") {
+            side = 0;
+        } else if (argument == "-candidate") {
+            side = 1;
+        } else if (argument == "-throughputThreshold" && hasValue
+                && parse_number(argv[i + 1], value)) {
+            options.throughputThreshold = value;
+            side = -1;
+            i++;
+        } else if (argument == "-latencyThreshold" && hasValue
+                && parse_number(argv[i + 1], value)) {
+            options.latencyThreshold = value;
+            side = -1;
+            i++;
+        } else if (argument == "-confidence" && hasValue
+                && parse_number(argv[i + 1], value)
+                && value > 0 && value < 100) {
+            options.confidence = value;
+            side = -1;
+            i++;
+        } else if (argument == "-bootstrap" && hasValue
+                && parse_number(argv[i + 1], value) && value >= 10) {
+            options.bootstrap = (unsigned int) value;
+            side = -1;
+            i++;
+        } else if (argument == "-seed" && hasValue
+                && parse_number(argv[i + 1], value)) {
+            options.seed = (unsigned long long) value;
+            side = -1;
+            i++;
+        } else if (argument == "-percentiles" && hasValue) {
+            options.percentiles.clear();
+            std::stringstream list(argv[++i]);
+            std::string percentile;
+            while (std::getline(list, percentile, ',')) {
+                bool known = false;
+                for (size_t j = 0; j < sizeof(LATENCY_METRICS)
+                            / sizeof(LATENCY_METRICS[0]); j++) {
+                    known = known
+                            || "latency_" + percentile == LATENCY_METRICS[j];
+                }
+                if (!known) {
+                    fprintf(stderr,
+                            "[Error] perftest_compare: Unknown percentile "
+                            "'%s'.\n",
+                            percentile.c_str());
+                    return COMPARE_ERROR;
+                }
+                options.percentiles.push_back(percentile);
+            }
+            side = -1;
+        } else if (argument == "-help") {
+            print_usage();
+            return COMPARE_PASSED;
+        } else if (side >= 0 && argument[0] != '-') {
+            files[side].push_back(argument);
+        } else {
+            print_usage();
+            return COMPARE_ERROR;
+        }
+    }
+    if (files[0].empty() || files[1].empty()) {
+        print_usage();
+        return COMPARE_ERROR;
+    }
+
+    Results results[2];
+    for (int i = 0; i < 2; i++) {
+        for (size_t j = 0; j < files[i].size(); j++) {
+            if (!load(files[i][j], results[i])) {
+                return COMPARE_ERROR;
+            }
+        }
+    }
+
+    printf("Baseline: %lu file(s), candidate: %lu file(s). Thresholds: "
+           "throughput -%.1f%%, latency +%.1f%%. %.0f%% confidence "
+           "intervals.\n\n",
+           (unsigned long) files[0].size(),
+           (unsigned long) files[1].size(),
+           options.throughputThreshold,
+           options.latencyThreshold,
+           options.confidence);
+    printf("%-11s%8s  %-16s%12s%12s%10s  %-20s%8s  %-8s%s\n",
+            "Mode", "Length", "Metric", "Baseline", "Candidate", "Delta",
+            "Delta CI", "p-value", "Basis", "Result");
+
+    std::mt19937_64 random(options.seed);
+    unsigned int regressions = 0;
+    unsigned int compared = 0;
+    for (Results::const_iterator baseline = results[0].begin();
+            baseline != results[0].end();
+            ++baseline) {
+        Results::const_iterator candidate = results[1].find(baseline->first);
+        if (candidate == results[1].end()) {
+            printf("%-11s%8u  missing in the candidate\n",
+                    baseline->first.first.c_str(),
+                    baseline->first.second);
+            continue;
+        }
+        compared++;
+        bool isLatency = baseline->first.first == "latency";
+        bool useSamples = isLatency
+                && !baseline->second.samples.empty()
+                && !candidate->second.samples.empty();
+
+        // The percentiles of the samples, compared all at once
+        std::map<std::string, Comparison> sampleResults;
+        if (useSamples) {
+            std::vector<double> percents;
+            for (size_t i = 1; i < sizeof(LATENCY_METRICS)
+                        / sizeof(LATENCY_METRICS[0]); i++) {
+                percents.push_back(
+                        atof(LATENCY_METRICS[i] + strlen("latency_")));
+            }
+            std::vector<Comparison> comparisons = compare_samples(
+                    baseline->second.samples,
+                    candidate->second.samples,
+                    percents,
+                    options,
+                    random);
+            for (size_t i = 0; i < comparisons.size(); i++) {
+                sampleResults[LATENCY_METRICS[i + 1]] = comparisons[i];
+            }
+        }
+
+        for (std::map<std::string, std::vector<double> >::const_iterator
+                    metric = baseline->second.runs.begin();
+                metric != baseline->second.runs.end();
+                ++metric) {
+            std::map<std::string, std::vector<double> >::const_iterator
+                    other = candidate->second.runs.find(metric->first);
+            if (other == candidate->second.runs.end()
+                    || metric->second.empty()
+                    || other->second.empty()) {
+                continue;
+            }
+
+            bool checked = false;
+            if (isLatency) {
+                for (size_t i = 0; i < options.percentiles.size(); i++) {
+                    checked = checked || metric->first
+                            == "latency_" + options.percentiles[i];
+                }
+            } else {
+                checked = metric->first != "lostPercent";
+            }
+
+            std::map<std::string, Comparison>::const_iterator sampleResult =
+                    sampleResults.find(metric->first);
+            Comparison result = sampleResult != sampleResults.end()
+                    ? sampleResult->second
+                    : compare_runs(
+                            metric->second,
+                            other->second,
+                            options,
+                            random);
+            if (report(
+                        baseline->first,
+                        metric->first,
+                        result,
+                        isLatency ? options.latencyThreshold
+                                  : options.throughputThreshold,
+                        isLatency || metric->first == "lostPercent",
+                        checked)) {
+                regressions++;
+            }
+        }
+    }
+    for (Results::const_iterator candidate = results[1].begin();
+            candidate != results[1].end();
+            ++candidate) {
+        if (results[0].find(candidate->first) == results[0].end()) {
+            printf("%-11s%8u  missing in the baseline\n",
+                    candidate->first.first.c_str(),
+                    candidate->first.second);
+        }
+    }
+
+    if (compared == 0) {
+        fprintf(stderr,
+                "\n[Error] perftest_compare: No mode and data length in "
+                "both the baseline and the candidate.\n");
+        return COMPARE_ERROR;
+    }
+    if (regressions > 0) {
+        printf("\nFAILED: %u regression(s).\n", regressions);
+        return COMPARE_REGRESSION;
+    }
+    printf("\nPASSED: no regression.\n");
+    return COMPARE_PASSED;
+}
@@ -0,0 +1,334 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+/*
+ * perftest_top: Displays side by side the live counters of the Perftest
+ * processes of this host started with -statsSegment.
+ *
+ * It only maps the segments for reading and never blocks the writers. It does
+ * not depend on Connext, build.sh compiles it on Linux with:
+ *
+ *   c++ -std=c++11 -O2 -DRTI_LINUX -DRTI_UNIX -I srcCppCommon \
+ *       resource/perftest_top/perftest_top.cxx -o perftest_top -lrt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PerftestStatsSegment.h"
+
+/* Width of the first column and of the column of every process */
+#define PERFTEST_TOP_LABEL_WIDTH 20
+#define PERFTEST_TOP_COLUMN_WIDTH 22
+
+/* A segment not updated in this time is shown as stale */
+#define PERFTEST_TOP_STALE_MSEC 3000
+
+struct Segment {
+    std::string name;
+    const PerftestStatsSegmentLayout *layout;
+    PerftestStatsSnapshot snapshot;
+    bool valid;
+};
+
+static void print_usage()
+{
+    printf("Usage: perftest_top [-interval <seconds>] [-once] [-histogram]\n"
+           "  -interval <seconds>  Refresh period. Default: 1\n"
+           "  -once                Print the counters once and exit\n"
+           "  -histogram           Also print the latency histograms\n");
+}
+
+/* The segment belongs to a process that is still running */
+static bool is_alive(int pid)
+{
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+/* Map the segments of the running processes, sorted by name */
+static std::vector<Segment> attach_segments()
+{
+    std::vector<Segment> segments;
+    DIR *directory = opendir(PERFTEST_STATS_SEGMENT_DIRECTORY);
+    if (directory == NULL) {
+        fprintf(stderr,
+                "[Error] perftest_top: Cannot open %s: %s.\n",
+                PERFTEST_STATS_SEGMENT_DIRECTORY,
+                strerror(errno));
+        return segments;
+    }
+
+    struct dirent *entry = NULL;
+    while ((entry = readdir(directory)) != NULL) {
+        if (strncmp(entry->d_name,
+                    PERFTEST_STATS_SEGMENT_PREFIX,
+                    strlen(PERFTEST_STATS_SEGMENT_PREFIX)) != 0) {
+            continue;
+        }
+        std::string name = std::string("/") + entry->d_name;
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            continue;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0
+                || (size_t) status.st_size
+                        < sizeof(PerftestStatsSegmentLayout)) {
+            close(fd);
+            continue;
+        }
+        void *address = mmap(
+                NULL,
+                sizeof(PerftestStatsSegmentLayout),
+                PROT_READ,
+                MAP_SHARED,
+                fd,
+                0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            continue;
+        }
+
+        const PerftestStatsSegmentLayout *layout =
+                static_cast<const PerftestStatsSegmentLayout *>(address);
+        if (layout->magic != PERFTEST_STATS_SEGMENT_MAGIC
+                || layout->version != PERFTEST_STATS_SEGMENT_VERSION
+                || layout->size != sizeof(PerftestStatsSegmentLayout)
+                || !is_alive(layout->pid)) {
+            munmap(address, sizeof(PerftestStatsSegmentLayout));
+            continue;
+        }
+
+        Segment segment;
+        segment.name = entry->d_name;
+        segment.layout = layout;
+        segment.valid = false;
+        segments.push_back(segment);
+    }
+    closedir(directory);
+
+    std::sort(
+            segments.begin(),
+            segments.end(),
+            [](const Segment &a, const Segment &b) {
+                return a.name < b.name;
+            });
+    return segments;
+}
+
+static void detach_segments(std::vector<Segment> &segments)
+{
+    for (size_t i = 0; i < segments.size(); i++) {
+        munmap((void *) segments[i].layout, sizeof(PerftestStatsSegmentLayout));
+    }
+    segments.clear();
+}
+
+/* Upper bound (us) of the bucket where the percentile falls, 0 if empty */
+static unsigned long long get_percentile(
+        const PerftestStatsSnapshot &snapshot,
+        double percentile)
+{
+    unsigned long long total = 0;
+    for (unsigned int i = 0; i < PERFTEST_STATS_HISTOGRAM_BUCKETS; i++) {
+        total += snapshot.latencyHistogram[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    unsigned long long accumulated = 0;
+    for (unsigned int i = 0; i < PERFTEST_STATS_HISTOGRAM_BUCKETS; i++) {
+        accumulated += snapshot.latencyHistogram[i];
+        if ((double) accumulated >= total * percentile / 100.0) {
+            return 1ULL << (i + 1);
+        }
+    }
+    return 1ULL << PERFTEST_STATS_HISTOGRAM_BUCKETS;
+}
+
+/* One row of the table, value() returns the text of every process */
+template <typename ValueFunction>
+static void print_row(
+        const char *label,
+        const std::vector<Segment> &segments,
+        ValueFunction value)
+{
+    printf("%-*s", PERFTEST_TOP_LABEL_WIDTH, label);
+    for (size_t i = 0; i < segments.size(); i++) {
+        std::string text = segments[i].valid ? value(segments[i]) : "-";
+        if (text.size() > PERFTEST_TOP_COLUMN_WIDTH - 1) {
+            text = text.substr(0, PERFTEST_TOP_COLUMN_WIDTH - 1);
+        }
+        printf("%-*s", PERFTEST_TOP_COLUMN_WIDTH, text.c_str());
+    }
+    printf("\n");
+}
+
+static std::string format(const char *format, double value)
+{
+    char text[64];
+    snprintf(text, sizeof(text), format, value);
+    return text;
+}
+
+static std::string format(unsigned long long value)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "%llu", value);
+    return text;
+}
+
+static void print_table(std::vector<Segment> &segments, bool printHistogram)
+{
+    unsigned long long now = (unsigned long long)
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+
+    for (size_t i = 0; i < segments.size(); i++) {
+        segments[i].valid = PerftestStatsSegment::read(
+                segments[i].layout,
+                segments[i].snapshot);
+    }
+
+    print_row("Process", segments, [](const Segment &s) {
+        return std::string(s.layout->role) + " "
+                + format((unsigned long long) s.layout->pid);
+    });
+    print_row("Updated (s ago)", segments, [now](const Segment &s) {
+        if (s.snapshot.updates == 0) {
+            return std::string("waiting");
+        }
+        double age = now > s.snapshot.updateTime
+                ? (now - s.snapshot.updateTime) / 1000.0
+                : 0.0;
+        return format("%.1f", age)
+                + (age * 1000 > PERFTEST_TOP_STALE_MSEC ? " (stale)" : "");
+    });
+    print_row("Data length (B)", segments, [](const Segment &s) {
+        return format(s.snapshot.dataLength);
+    });
+    print_row("Samples", segments, [](const Segment &s) {
+        return format(s.snapshot.samples);
+    });
+    print_row("Samples/s", segments, [](const Segment &s) {
+        return format(s.snapshot.samplesPerSecond);
+    });
+    print_row("Mbps", segments, [](const Segment &s) {
+        return format("%.1f", s.snapshot.bytesPerSecond * 8 / 1000000.0);
+    });
+    print_row("Lost samples", segments, [](const Segment &s) {
+        return format(s.snapshot.lostSamples)
+                + format(" (%.2f%%)", s.snapshot.lostPercent);
+    });
+    print_row("Latency count", segments, [](const Segment &s) {
+        return format(s.snapshot.latencyCount);
+    });
+    print_row("Latency ave (us)", segments, [](const Segment &s) {
+        return format("%.1f", s.snapshot.latencyAve);
+    });
+    print_row("Latency min/max", segments, [](const Segment &s) {
+        return format(s.snapshot.latencyMin) + "/"
+                + format(s.snapshot.latencyMax);
+    });
+    print_row("Latency 50% (<us)", segments, [](const Segment &s) {
+        return format(get_percentile(s.snapshot, 50));
+    });
+    print_row("Latency 99% (<us)", segments, [](const Segment &s) {
+        return format(get_percentile(s.snapshot, 99));
+    });
+    print_row("Latency 99.99%(<us)", segments, [](const Segment &s) {
+        return format(get_percentile(s.snapshot, 99.99));
+    });
+    print_row("CPU (%)", segments, [](const Segment &s) {
+        return format("%.1f", s.snapshot.cpu);
+    });
+    print_row("Reader queue peak", segments, [](const Segment &s) {
+        return s.snapshot.readerQueuePeak < 0
+                ? std::string("-")
+                : format((unsigned long long) s.snapshot.readerQueuePeak);
+    });
+    print_row("Writer queue peak", segments, [](const Segment &s) {
+        return s.snapshot.writerQueuePeak < 0
+                ? std::string("-")
+                : format((unsigned long long) s.snapshot.writerQueuePeak);
+    });
+
+    if (printHistogram) {
+        for (unsigned int bucket = 0;
+                bucket < PERFTEST_STATS_HISTOGRAM_BUCKETS;
+                bucket++) {
+            char label[PERFTEST_TOP_LABEL_WIDTH + 1];
+            snprintf(label, sizeof(label), "  < %llu us", 1ULL << (bucket + 1));
+            print_row(label, segments, [bucket](const Segment &s) {
+                return format(s.snapshot.latencyHistogram[bucket]);
+            });
+        }
+    }
+
+    printf("\n");
+    for (size_t i = 0; i < segments.size(); i++) {
+        printf("[%s] %s\n",
+                segments[i].name.c_str(),
+                segments[i].layout->description);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    double interval = 1.0;
+    bool once = false;
+    bool printHistogram = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-interval") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+            if (interval <= 0) {
+                fprintf(stderr, "[Error] perftest_top: Wrong -interval.\n");
+                return -1;
+            }
+        } else if (strcmp(argv[i], "-once") == 0) {
+            once = true;
+        } else if (strcmp(argv[i], "-histogram") == 0) {
+            printHistogram = true;
+        } else {
+            print_usage();
+            return strcmp(argv[i], "-help") == 0 ? 0 : -1;
+        }
+    }
+
+    while (true) {
+        // Attach every time, to show the processes started meanwhile
+        std::vector<Segment> segments = attach_segments();
+        if (!once) {
+            printf("\033[H\033[2J");
+        }
+        if (segments.empty()) {
+            printf("No Perftest process started with -statsSegment.\n");
+        } else {
+            print_table(segments, printHistogram);
+        }
+        fflush(stdout);
+        detach_segments(segments);
+
+        if (once) {
+            return 0;
+        }
+        std::this_thread::sleep_for(
+                std::chrono::milliseconds((long long) (interval * 1000)));
+    }
+}
@@ -148,6 +148,15 @@ class IMessagingWriter
     };
     virtual void wait_for_ack(int /*sec*/, unsigned int /*nsec*/) {
     };
+    /*
+     * Write only count instances from first (round robin) in the next
+     * samples. Returns false if not supported.
+     */
+    virtual bool set_instance_set(
+            unsigned long /*first*/,
+            unsigned long /*count*/) {
+        return false;
+    };
 #ifdef RTI_CUSTOM_TYPE
   private:
     virtual bool is_sentinel_size(int size) {
@@ -179,12 +188,45 @@ public:
 
     virtual IMessagingWriter *create_writer(const char *topic_name) = 0;
 
+    /*
+     * Create a writer that uses the same middleware entity as writer, to
+     * write from several threads. Returns NULL if not supported.
+     */
+    virtual IMessagingWriter *create_shared_writer(
+            IMessagingWriter * /*writer*/)
+    {
+        return NULL;
+    }
+
+    /*
+     * Delete a writer created by create_writer() together with the middleware
+     * entity behind it, so it can be created again with different settings.
+     */
+    virtual void delete_writer(IMessagingWriter *writer)
+    {
+        delete writer;
+    }
+
     /*
      * Pass null for callback if using IMessagingReader.receive_message()
      * to get data
      */
     virtual IMessagingReader *create_reader(const char *topic_name, IMessagingCB *callback) = 0;
 
+    /*
+     * Create a reader that only receives one of partitionCount disjoint
+     * subsets of the instances of the topic. Used to drain the same topic
+     * from several threads. Returns NULL if not supported.
+     */
+    virtual IMessagingReader *create_partitioned_reader(
+            const char * /*topic_name*/,
+            IMessagingCB * /*callback*/,
+            unsigned int /*partition*/,
+            unsigned int /*partitionCount*/)
+    {
+        return NULL;
+    }
+
     /* Get information about witch features are supported by the medleware */
     virtual bool supports_listeners() = 0;
 
@@ -117,6 +117,12 @@ RTIDDSImpl<T>::RTIDDSImpl()
     _qoSProfileNameMap[LATENCY_TOPIC_NAME] = std::string("LatencyQos");
     _qoSProfileNameMap[ANNOUNCEMENT_TOPIC_NAME] = std::string("AnnouncementQos");
     _qoSProfileNameMap[THROUGHPUT_TOPIC_NAME] = std::string("ThroughputQos");
+  #ifdef PERFTEST_RTI_PRO
+    _qoSProfileNameMap[LATENCY_PROBE_TOPIC_NAME] = std::string("LatencyProbeQos");
+    _qoSProfileNameMap[LATENCY_PROBE_ECHO_TOPIC_NAME] =
+            std::string("LatencyProbeQos");
+    _keyFilter = NULL;
+  #endif
 
     if (!get_serialized_overhead_size(perftest_cpp::OVERHEAD_BYTES)) {
         throw std::runtime_error("Fail on obtain overhead size");
@@ -149,6 +155,13 @@ void RTIDDSImpl<T>::shutdown()
     if (_participant != NULL) {
         PerftestClock::milliSleep(2000);
 
+      #ifdef PERFTEST_RTI_PRO
+        if (_keyFilter != NULL) {
+            _keyFilter->print_stats(
+                    _PM->get<bool>("pub") ? "writer side" : "reader side");
+        }
+      #endif
+
         if (_reader != NULL) {
             DDSDataReaderListener* reader_listener = _reader->get_listener();
             if (reader_listener != NULL) {
@@ -167,6 +180,13 @@ void RTIDDSImpl<T>::shutdown()
         DDSTheParticipantFactory->delete_participant(_participant);
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    if (_keyFilter != NULL) {
+        delete _keyFilter;
+        _keyFilter = NULL;
+    }
+  #endif
+
     if(_pongSemaphore != NULL) {
         PerftestSemaphore_delete(_pongSemaphore);
         _pongSemaphore = NULL;
@@ -349,6 +369,13 @@ bool RTIDDSImpl<T>::data_size_related_calculations()
     // _maxUnfragmentedRTPSPayloadSize
     _isLargeData = (_PM->get<unsigned long long>("dataLen") > _maxUnfragmentedRTPSPayloadSize);
 
+    // Manage parameter -batchSizeSweep
+    if (_PM->is_set("batchSizeSweep") && (_isLargeData || _isFlatData)) {
+        fprintf(stderr,
+                "Batching cannot be used with Large Data or FlatData.\n");
+        return false;
+    }
+
     // Manage parameter -batchSize
     if (_PM->get<long>("batchSize") > 0) {
 
@@ -436,6 +463,28 @@ bool RTIDDSImpl<T>::validate_input()
         }
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // Manage parameter -keyDistribution
+    if (_PM->is_set("keyDistribution")) {
+        KeyDistributionKind kind;
+        double parameter = 0;
+        double hotTraffic = 0;
+        if (!KeyDistribution::parse(
+                    _PM->get<std::string>("keyDistribution"),
+                    kind,
+                    parameter,
+                    hotTraffic)) {
+            return false;
+        }
+        if (_PM->is_set("writeInstance")) {
+            fprintf(stderr,
+                    "'-keyDistribution' cannot be used with "
+                    "'-writeInstance'.\n");
+            return false;
+        }
+    }
+  #endif
+
     // Manage parameter -peer
     if (_PM->get_vector<std::string>("peer").size() >= RTIPERFTEST_MAX_PEERS) {
         fprintf(stderr,
@@ -659,6 +708,9 @@ class RTIPublisherBase : public IMessagingWriter
     typename T::DataWriter *_writer;
     unsigned long _num_instances;
     unsigned long _instance_counter;
+    // Instances written in round robin, all of them unless set_instance_set()
+    unsigned long _first_instance;
+    unsigned long _instance_set_size;
     DDS_InstanceHandle_t *_instance_handles;
     PerftestSemaphore *_pongSemaphore;
     long _instancesToBeWritten;
@@ -668,11 +720,81 @@ class RTIPublisherBase : public IMessagingWriter
   #endif
     bool _isReliable;
     ParameterManager *_PM;
+    /* Register the instances when first written instead of on creation */
+    bool _lazyRegistration;
+    unsigned long _registeredInstances;
+    /*
+     * Writes with the DataWriter of another publisher (-sendThreads): it uses
+     * the instances registered by that one, and leaves the listener and the
+     * instance statistics to it.
+     */
+    bool _shared;
+  #ifdef PERFTEST_RTI_PRO
+    KeyDistribution _keyDistribution;
+    InstanceCostStats *_instanceCost;
+  #endif
 
     DDS_InstanceHandle_t &getCftInstanceHandle() {
         return _instance_handles[_num_instances];
     }
 
+    /* Instance written by the next sample, if using more than one */
+    unsigned long next_key()
+    {
+        if (_instancesToBeWritten != -1) { // send sample to a specific subscriber
+            return _instancesToBeWritten;
+        }
+      #ifdef PERFTEST_RTI_PRO
+        if (!_keyDistribution.is_uniform()) {
+            return _keyDistribution.next_key();
+        }
+      #endif
+        return _first_instance + _instance_counter++ % _instance_set_size;
+    }
+
+    /*
+     * Write the sample in the instance of the key. With -lazyRegistration the
+     * instance is registered the first time it is written.
+     */
+    DDS_ReturnCode_t write_instance(
+            const T &sample,
+            long key,
+            bool isCftWildCardKey)
+    {
+        if (isCftWildCardKey) {
+            return _writer->write(sample, getCftInstanceHandle());
+        }
+
+      #ifdef PERFTEST_RTI_PRO
+        unsigned long long start = 0;
+        if (_lazyRegistration
+                && DDS_InstanceHandle_is_nil(&_instance_handles[key])) {
+            if (_instanceCost != NULL) {
+                start = InstanceCostStats::now_ns();
+            }
+            _instance_handles[key] = _writer->register_instance(sample);
+            _registeredInstances++;
+            if (_instanceCost != NULL) {
+                _instanceCost->add_registration(
+                        _registeredInstances,
+                        InstanceCostStats::now_ns() - start);
+            }
+        }
+
+        if (_instanceCost != NULL) {
+            start = InstanceCostStats::now_ns();
+            DDS_ReturnCode_t retcode =
+                    _writer->write(sample, _instance_handles[key]);
+            _instanceCost->add_write(
+                    _registeredInstances,
+                    InstanceCostStats::now_ns() - start);
+            return retcode;
+        }
+      #endif
+
+        return _writer->write(sample, _instance_handles[key]);
+    }
+
   #ifdef RTI_CUSTOM_TYPE
     bool is_sentinel_size(int size) {
         return size == perftest_cpp::INITIALIZE_SIZE
@@ -686,11 +808,15 @@ class RTIPublisherBase : public IMessagingWriter
             unsigned long num_instances,
             PerftestSemaphore * pongSemaphore,
             int instancesToBeWritten,
-            ParameterManager *PM)
+            ParameterManager *PM,
+            const RTIPublisherBase<T> *owner = NULL)
     {
         _PM = PM;
+        _shared = owner != NULL;
         _num_instances = num_instances;
         _instance_counter = 0;
+        _first_instance = 0;
+        _instance_set_size = num_instances;
         _instance_handles = (DDS_InstanceHandle_t *) malloc(
                 sizeof(DDS_InstanceHandle_t)*(_num_instances + 1)); // One extra for MAX_CFT_VALUE
         if (_instance_handles == NULL) {
@@ -700,6 +826,35 @@ class RTIPublisherBase : public IMessagingWriter
         }
         _pongSemaphore = pongSemaphore;
         _instancesToBeWritten = instancesToBeWritten;
+        _lazyRegistration = false;
+        _registeredInstances = _num_instances;
+
+      #ifdef PERFTEST_RTI_PRO
+        _instanceCost = NULL;
+        if (_PM->get<bool>("lazyRegistration")) {
+            _lazyRegistration = true;
+            _registeredInstances = 0;
+            for (unsigned long i = 0; i < _num_instances; i++) {
+                _instance_handles[i] = DDS_HANDLE_NIL;
+            }
+        }
+        if (!_keyDistribution.initialize(
+                    _PM->get<std::string>("keyDistribution"),
+                    _num_instances)) {
+            free(_instance_handles);
+            _instance_handles = NULL;
+            throw std::runtime_error("KeyDistribution::initialize failed");
+        }
+        if (_PM->get<bool>("instanceCost") && !_shared) {
+            _instanceCost = new InstanceCostStats();
+        }
+      #endif
+        if (_shared) {
+            // Those not registered yet with -lazyRegistration are still nil
+            memcpy(_instance_handles,
+                    owner->_instance_handles,
+                    sizeof(DDS_InstanceHandle_t) * (_num_instances + 1));
+        }
     }
 
     ~RTIPublisherBase() {
@@ -710,8 +865,13 @@ class RTIPublisherBase : public IMessagingWriter
         }
     }
 
+    DDSDataWriter *get_datawriter()
+    {
+        return _writer;
+    }
+
     void shutdown() {
-        if (_writer->get_listener() != NULL) {
+        if (!_shared && _writer->get_listener() != NULL) {
             delete(_writer->get_listener());
           #ifndef PERFTEST_RTI_MICRO
             _writer->set_listener(NULL);
@@ -723,6 +883,13 @@ class RTIPublisherBase : public IMessagingWriter
             free(_instance_handles);
             _instance_handles = NULL;
         }
+      #ifdef PERFTEST_RTI_PRO
+        if (_instanceCost != NULL) {
+            _instanceCost->print(_writer->get_topic()->get_name());
+            delete _instanceCost;
+            _instanceCost = NULL;
+        }
+      #endif
     }
 
     void flush()
@@ -832,6 +999,22 @@ class RTIPublisherBase : public IMessagingWriter
       #endif
     }
 
+    bool set_instance_set(unsigned long first, unsigned long count)
+    {
+        if (count == 0 || first + count > _num_instances) {
+            fprintf(stderr,
+                    "Cannot write instances %lu to %lu, there are %lu.\n",
+                    first,
+                    first + count - 1,
+                    _num_instances);
+            return false;
+        }
+        _first_instance = first;
+        _instance_set_size = count;
+        _instance_counter = 0;
+        return true;
+    }
+
     void wait_for_ack(int sec, unsigned int nsec) {
       #ifndef PERFTEST_RTI_MICRO
         if (_isReliable) {
@@ -870,12 +1053,14 @@ class RTIPublisher : public RTIPublisherBase<T>
             unsigned long num_instances,
             PerftestSemaphore * pongSemaphore,
             int instancesToBeWritten,
-            ParameterManager *PM)
+            ParameterManager *PM,
+            const RTIPublisherBase<T> *owner = NULL)
             : RTIPublisherBase<T>(
                     num_instances,
                     pongSemaphore,
                     instancesToBeWritten,
-                    PM)
+                    PM,
+                    owner)
     {
       #ifdef RTI_CUSTOM_TYPE
         this->_lastMessageSize = 0;
@@ -902,7 +1087,14 @@ class RTIPublisher : public RTIPublisherBase<T>
         this->_writer->get_qos(qos); // Gota fix the writer narrow to fix seg fault here
         this->_isReliable = (qos.reliability.kind == DDS_RELIABLE_RELIABILITY_QOS);
 
-        for (unsigned long i = 0; i < this->_num_instances; ++i) {
+        // The owner of a shared DataWriter already registered the instances
+        if (this->_shared) {
+            return;
+        }
+
+        for (unsigned long i = 0;
+                !this->_lazyRegistration && i < this->_num_instances;
+                ++i) {
             for (int c = 0; c < KEY_SIZE; c++) {
                 data.key[c] = (unsigned char) (i >> c * 8);
             }
@@ -948,11 +1140,7 @@ class RTIPublisher : public RTIPublisherBase<T>
         // Calculate key and add it if using more than one instance
         if (!isCftWildCardKey) {
             if (this->_num_instances > 1) {
-                if (this->_instancesToBeWritten == -1) {
-                    key = this->_instance_counter++ % this->_num_instances;
-                } else { // send sample to a specific subscriber
-                    key = this->_instancesToBeWritten;
-                }
+                key = this->next_key();
             }
         } else {
             key = MAX_CFT_VALUE;
@@ -1009,11 +1197,8 @@ class RTIPublisher : public RTIPublisherBase<T>
         }
       #endif
 
-        if (!isCftWildCardKey) {
-            retcode = this->_writer->write(data, this->_instance_handles[key]);
-        } else { // send CFT_MAX sample
-            retcode = this->_writer->write(data, this->getCftInstanceHandle());
-        }
+        // The CFT_MAX sample uses its own instance
+        retcode = this->write_instance(data, key, isCftWildCardKey);
 
       #ifndef RTI_CUSTOM_TYPE
         success = data.bin_data.unloan();
@@ -1104,7 +1289,9 @@ public:
         }
       #endif
 
-        for (unsigned long i = 0; i < this->_num_instances; ++i) {
+        for (unsigned long i = 0;
+                !this->_lazyRegistration && i < this->_num_instances;
+                ++i) {
             Builder builder = rti::flat::build_data<T>(this->_writer);
             add_key(builder, i);
           #ifdef RTI_CUSTOM_TYPE_FLATDATA
@@ -1158,9 +1345,7 @@ public:
         // Calculate key if using more than one instance
         if (!isCftWildCardKey) {
             if (this->_num_instances > 1) {
-                key = (this->_instancesToBeWritten == -1)
-                        ? this->_instance_counter++ % this->_num_instances
-                        : this->_instancesToBeWritten;
+                key = this->next_key();
             }
         } else {
             key = MAX_CFT_VALUE;
@@ -1220,11 +1405,7 @@ public:
         T *sample = builder.finish_sample();
 
         // Send data through the writer
-        if (!isCftWildCardKey) {
-            this->_writer->write(*sample, this->_instance_handles[key]);
-        } else {
-            this->_writer->write(*sample, this->getCftInstanceHandle());
-        }
+        this->write_instance(*sample, key, isCftWildCardKey);
 
         return true;
     }
@@ -1282,12 +1463,14 @@ class RTIDynamicDataPublisher: public RTIPublisherBase<DDS_DynamicData>
             PerftestSemaphore *pongSemaphore,
             DDS_TypeCode *typeCode,
             int instancesToBeWritten,
-            ParameterManager *PM)
+            ParameterManager *PM,
+            const RTIPublisherBase<DDS_DynamicData> *owner = NULL)
             : RTIPublisherBase<DDS_DynamicData>(
                     num_instances,
                     pongSemaphore,
                     instancesToBeWritten,
-                    PM),
+                    PM,
+                    owner),
             data(typeCode, DDS_DYNAMIC_DATA_PROPERTY_DEFAULT),
             _lastMessageSize(0)
     {
@@ -1313,7 +1496,12 @@ class RTIDynamicDataPublisher: public RTIPublisherBase<DDS_DynamicData>
         this->_writer->get_qos(qos); // Gota fix the writer narrow to fix seg fault here
         this->_isReliable = (qos.reliability.kind == DDS_RELIABLE_RELIABILITY_QOS);
 
-        for (unsigned long i = 0; i < _num_instances; ++i) {
+        // The owner of a shared DataWriter already registered the instances
+        if (_shared) {
+            return;
+        }
+
+        for (unsigned long i = 0; !_lazyRegistration && i < _num_instances; ++i) {
             for (int c = 0; c < KEY_SIZE; c++) {
                 key_octets[c] = (unsigned char) (i >> c * 8);
             }
@@ -1376,11 +1564,7 @@ class RTIDynamicDataPublisher: public RTIPublisherBase<DDS_DynamicData>
 
         if (!isCftWildCardKey) {
             if (this->_num_instances > 1) {
-                if (this->_instancesToBeWritten == -1) {
-                    key = this->_instance_counter++ % this->_num_instances;
-                } else { // send sample to a specific subscriber
-                    key = this->_instancesToBeWritten;
-                }
+                key = this->next_key();
             }
         } else {
             key = MAX_CFT_VALUE;
@@ -1501,11 +1685,7 @@ class RTIDynamicDataPublisher: public RTIPublisherBase<DDS_DynamicData>
       #endif
         this->_lastMessageSize = message.size;
 
-        if (!isCftWildCardKey) {
-            retcode = this->_writer->write(data, this->_instance_handles[key]);
-        } else {
-            retcode = this->_writer->write(data, this->getCftInstanceHandle());
-        }
+        retcode = this->write_instance(data, key, isCftWildCardKey);
 
         if (retcode != DDS_RETCODE_OK) {
             fprintf(stderr, "Write error %d.\n", retcode);
@@ -2852,6 +3032,26 @@ bool RTIDDSImpl<T>::initialize(ParameterManager &PM, perftest_cpp *parent)
         }
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    /*
+     * Compiled key filter used by the CFTs, registered in every participant
+     * so the writers can also evaluate it. FlatData keeps the SQL filter.
+     */
+    if (!_isFlatData && !_PM->get<bool>("cftSql")) {
+        _keyFilter = new RTIKeyFilter(
+                offsetof(T, key),
+                _PM->get<bool>("dynamicData")
+                        ? DynamicDataMembersId::GetInstance().at("key")
+                        : -1,
+                _PM->get<bool>("cftBenchmark"));
+        if (_participant->register_contentfilter(
+                    RTI_KEY_FILTER_NAME,
+                    _keyFilter) != DDS_RETCODE_OK) {
+            fprintf(stderr, "Problem registering the key content filter.\n");
+            return false;
+        }
+    }
+  #endif
 
   #ifdef PERFTEST_RTI_PRO
     _factory->get_publisher_qos_from_profile(
@@ -3485,7 +3685,11 @@ bool RTIDDSImpl<T>::configure_writer_qos(
     dw_qos.resource_limits.max_instances =
             _PM->get<long>("instances") + 1; // One extra for MAX_CFT_VALUE
   #ifdef PERFTEST_RTI_PRO
-    dw_qos.resource_limits.initial_instances = _PM->get<long>("instances") + 1;
+    // With -lazyRegistration the instances are allocated as they are written
+    if (!_PM->get<bool>("lazyRegistration")) {
+        dw_qos.resource_limits.initial_instances =
+                _PM->get<long>("instances") + 1;
+    }
 
     // If is LargeData
     if (_PM->get<int>("unbounded") != 0) {
@@ -3885,7 +4089,10 @@ bool RTIDDSImpl<T>::configure_reader_qos(
         dr_qos.resource_limits.initial_samples = _PM->get<int>("receiveQueueSize");
     }
 
-    dr_qos.resource_limits.initial_instances = _PM->get<long>("instances") + 1;
+    if (!_PM->get<bool>("lazyRegistration")) {
+        dr_qos.resource_limits.initial_instances =
+                _PM->get<long>("instances") + 1;
+    }
     if (_instanceMaxCountReader != DDS_LENGTH_UNLIMITED) {
         _instanceMaxCountReader++;
     }
@@ -3910,7 +4117,9 @@ bool RTIDDSImpl<T>::configure_reader_qos(
         }
     }
 
-    if (_PM->get<bool>("multicast") && _transport.allowsMulticast()) {
+    // The latency probes (-latencyProbeRate) are always sent using unicast
+    if (_PM->get<bool>("multicast") && _transport.allowsMulticast()
+            && qos_profile != "LatencyProbeQos") {
         dr_qos.multicast.value.ensure_length(1, 1);
         dr_qos.multicast.value[0].receive_address = DDS_String_dup(
                 _transport.getMulticastAddr(topic_name.c_str()).c_str());
@@ -4087,12 +4296,17 @@ IMessagingWriter *RTIDDSImpl<T>::create_writer(const char *topic_name)
     DDS_DataWriterQos dw_qos;
     DDSDataWriter *writer = NULL;
     std::string qos_profile = "";
+  #ifdef PERFTEST_RTI_PRO
+    // With -sendThreads several writers may be created for the same topic
+    DDSTopic *topic = find_or_create_topic(topic_name);
+  #else
     DDSTopic *topic = _participant->create_topic(
                        topic_name,
                        _typename,
                        DDS_TOPIC_QOS_DEFAULT,
                        NULL,
                        DDS_STATUS_MASK_NONE);
+  #endif
 
     if (topic == NULL) {
         fprintf(stderr,"Problem creating topic %s.\n", topic_name);
@@ -4120,6 +4334,17 @@ IMessagingWriter *RTIDDSImpl<T>::create_writer(const char *topic_name)
         return NULL;
     }
 
+    return create_publisher(writer);
+}
+
+/*********************************************************
+ * CreatePublisher
+ *
+ * Wraps a DDS DataWriter into the IMessagingWriter used by perftest_cpp.
+ */
+template <typename T>
+IMessagingWriter *RTIDDSImpl<T>::create_publisher(DDSDataWriter *writer)
+{
     if (!_PM->get<bool>("dynamicData")) {
         try {
             return new RTIPublisher<T>(
@@ -4259,12 +4484,78 @@ IMessagingWriter *RTIDDSImpl_FlatData<T>::create_writer(const char *topic_name)
  *          The main goal for comaparing a instances and a key is by analyze the elemetns by more significant to the lest significant.
  *          So, in the case that the key is between [ {0, 0, 0, 1} and { 0, 0, 1, 44} ], it will be received.
  *  Beside, there is a special case where all the subscribers will receive the samples, it is MAX_CFT_VALUE = 65535 = [255,255,0,0,]
+ *
+ *  The SQL condition is only used with -cftSql or FlatData. Otherwise the filter is
+ *  the RTIKeyFilter registered in the participant, which decodes the key once and
+ *  checks it against the range (or against a bitmap for the keys given by -cftKeys).
  */
 template <typename T>
 DDSTopicDescription *RTIDDSImpl<T>::create_cft(
         const char *topic_name,
         DDSTopic *topic)
 {
+    if (_PM->is_set("cftKeys")) {
+        return create_cft(
+                topic_name,
+                topic,
+                _PM->get_vector<unsigned long long>("cftKeys"),
+                true);
+    }
+    return create_cft(
+            topic_name,
+            topic,
+            _PM->get_vector<unsigned long long>("cft"),
+            false);
+}
+
+template <typename T>
+DDSTopicDescription *RTIDDSImpl<T>::create_cft(
+        const char *cft_name,
+        DDSTopic *topic,
+        const std::vector<unsigned long long> &cftRange,
+        bool keySet)
+{
+    if (keySet) {
+        std::ostringstream keys;
+        for (unsigned int i = 0; i < cftRange.size(); i++) {
+            keys << (i == 0 ? "" : ":") << cftRange[i];
+        }
+        printf("CFT enabled for instances: '%s' \n", keys.str().c_str());
+    }
+
+    if (_keyFilter != NULL) {
+        std::vector<std::string> keys;
+        for (unsigned int i = 0; i < cftRange.size(); i++) {
+            std::ostringstream key;
+            key << cftRange[i];
+            keys.push_back(key.str());
+        }
+        /* A single instance is a range with the same first and last key */
+        if (!keySet && keys.size() == 1) {
+            printf("CFT enabled for instance: '%llu' \n", cftRange[0]);
+            keys.push_back(keys[0]);
+        } else if (!keySet) {
+            printf("CFT enabled for instance range: [%llu,%llu] \n",
+                    cftRange[0],
+                    cftRange[1]);
+        }
+
+        std::vector<const char *> param_list;
+        for (unsigned int i = 0; i < keys.size(); i++) {
+            param_list.push_back(keys[i].c_str());
+        }
+        DDS_StringSeq parameters((DDS_Long) param_list.size());
+        parameters.from_array(&param_list[0], (DDS_Long) param_list.size());
+
+        return _participant->create_contentfilteredtopic_with_filter(
+                cft_name,
+                topic,
+                keySet ? RTI_KEY_FILTER_SET_EXPRESSION
+                       : RTI_KEY_FILTER_RANGE_EXPRESSION,
+                parameters,
+                RTI_KEY_FILTER_NAME);
+    }
+
     /*
      * The Key 255,255,0,0 match the internal messages, we do not want
      * to block those messages, so the instance key will be added to the
@@ -4272,8 +4563,6 @@ DDSTopicDescription *RTIDDSImpl<T>::create_cft(
      */
     std::string condition;
     DDS_StringSeq parameters(2 * KEY_SIZE);
-    const std::vector<unsigned long long> cftRange =
-            _PM->get_vector<unsigned long long>("cft");
 
     /* Reserve memory for the range case, the bigger one. */
     char cft_param[2 * KEY_SIZE][128];
@@ -4282,8 +4571,27 @@ DDSTopicDescription *RTIDDSImpl<T>::create_cft(
             cft_param[5], cft_param[6], cft_param[7]
     };
 
+    if (keySet) {
+        /*
+         * The keys are written in the condition, a long list may need a
+         * bigger contentfilter_property_max_length.
+         */
+        std::ostringstream keyCondition;
+        for (unsigned int i = 0; i < cftRange.size(); i++) {
+            keyCondition << "(";
+            for (int j = 0; j < KEY_SIZE; j++) {
+                keyCondition << (j == 0 ? "" : " AND ")
+                        << (int) (unsigned char) (cftRange[i] >> j * 8)
+                        << " = key[" << j << "]";
+            }
+            keyCondition << ") OR";
+        }
+        condition = keyCondition.str()
+                + "(255 = key[0] AND 255 = key[1] AND 0 = key[2] AND 0 = key[3])";
+        parameters.length(0);
+
     /* Only one element, no range */
-    if (cftRange.size() == 1) {
+    } else if (cftRange.size() == 1) {
         printf("CFT enabled for instance: '%llu' \n", cftRange[0]);
 
         for (int i = 0; i < KEY_SIZE ; i++) {
@@ -4323,11 +4631,156 @@ DDSTopicDescription *RTIDDSImpl<T>::create_cft(
                 ")";
     }
     return _participant->create_contentfilteredtopic(
-            topic_name,
+            cft_name,
             topic,
             condition.c_str(),
             parameters);
 }
+
+/*********************************************************
+ * CreatePartitionedReader
+ *
+ * Creates a reader that only receives the instances of the given partition.
+ * The instances of the topic are split in partitionCount contiguous key
+ * ranges, and each reader filters its own range with a CFT (the internal
+ * messages sent with MAX_CFT_VALUE are still received by every partition).
+ */
+template <typename T>
+IMessagingReader *RTIDDSImpl<T>::create_partitioned_reader(
+        const char *topic_name,
+        IMessagingCB *callback,
+        unsigned int partition,
+        unsigned int partitionCount)
+{
+    const unsigned long long instances = _PM->get<long>("instances");
+
+    if (partitionCount == 0 || partition >= partitionCount
+            || instances < partitionCount) {
+        fprintf(stderr,
+                "Cannot split %llu instances in %u partitions.\n",
+                instances,
+                partitionCount);
+        return NULL;
+    }
+
+    /* The topic is shared among all the partitions, create it only once */
+    DDSTopic *topic = find_or_create_topic(topic_name);
+    if (topic == NULL) {
+        fprintf(stderr,"Problem creating topic %s.\n", topic_name);
+        return NULL;
+    }
+
+    std::vector<unsigned long long> range(2);
+    range[0] = partition * instances / partitionCount;
+    range[1] = (partition + 1) * instances / partitionCount - 1;
+
+    std::ostringstream cft_name;
+    cft_name << topic_name << "_partition_" << partition;
+
+    DDSTopicDescription *topic_desc =
+            create_cft(cft_name.str().c_str(), topic, range, false);
+    if (topic_desc == NULL) {
+        fprintf(stderr, "Create_contentfilteredtopic error\n");
+        return NULL;
+    }
+
+    return create_reader_for_topic(topic_name, topic_desc, callback);
+}
+
+/*********************************************************
+ * CreateSharedWriter
+ *
+ * Creates a new IMessagingWriter on top of the DataWriter of writer, so
+ * several threads can write using the same DataWriter, each one with its own
+ * sample and instance counter. The instances registered by writer are reused.
+ */
+template <typename T>
+IMessagingWriter *RTIDDSImpl<T>::create_shared_writer(IMessagingWriter *writer)
+{
+    if (writer == NULL) {
+        fprintf(stderr, "No writer to share.\n");
+        return NULL;
+    }
+
+    try {
+        if (!_PM->get<bool>("dynamicData")) {
+            RTIPublisherBase<T> *owner =
+                    static_cast<RTIPublisherBase<T> *>(writer);
+            return new RTIPublisher<T>(
+                    owner->get_datawriter(),
+                    _PM->get<long>("instances"),
+                    _pongSemaphore,
+                    _PM->get<long>("writeInstance"),
+                    _PM,
+                    owner);
+        } else {
+            RTIPublisherBase<DDS_DynamicData> *owner =
+                    static_cast<RTIPublisherBase<DDS_DynamicData> *>(writer);
+            return new RTIDynamicDataPublisher(
+                    owner->get_datawriter(),
+                    _PM->get<long>("instances"),
+                    _pongSemaphore,
+                    T::TypeSupport::get_typecode(),
+                    _PM->get<long>("writeInstance"),
+                    _PM,
+                    owner);
+        }
+    } catch (const std::exception &ex) {
+        fprintf(stderr,
+                "Exception in RTIDDSImpl<T>::create_shared_writer(): %s.\n",
+                ex.what());
+        return NULL;
+    }
+}
+
+/*********************************************************
+ * DeleteWriter
+ *
+ * Used by -batchSizeSweep to recreate the Throughput DataWriter with a
+ * different batch size without touching the rest of the entities.
+ */
+template <typename T>
+void RTIDDSImpl<T>::delete_writer(IMessagingWriter *writer)
+{
+    DDSDataWriter *ddsWriter = NULL;
+
+    if (writer == NULL) {
+        return;
+    }
+
+    if (!_PM->get<bool>("dynamicData")) {
+        ddsWriter = static_cast<RTIPublisherBase<T> *>(writer)->get_datawriter();
+    } else {
+        ddsWriter = static_cast<RTIPublisherBase<DDS_DynamicData> *>(writer)
+                ->get_datawriter();
+    }
+    delete writer;
+
+    if (_publisher->delete_datawriter(ddsWriter) != DDS_RETCODE_OK) {
+        fprintf(stderr, "Problem deleting writer.\n");
+    }
+}
+
+/*********************************************************
+ * FindOrCreateTopic
+ */
+template <typename T>
+DDSTopic *RTIDDSImpl<T>::find_or_create_topic(const char *topic_name)
+{
+    DDSTopicDescription *topic_desc =
+            _participant->lookup_topicdescription(topic_name);
+
+    if (topic_desc != NULL) {
+        return DDSTopic::narrow(topic_desc);
+    }
+
+    return _participant->create_topic(
+            topic_name,
+            _typename,
+            DDS_TOPIC_QOS_DEFAULT,
+            NULL,
+            DDS_STATUS_MASK_NONE);
+}
 #endif //PERFTEST_RTI_MICRO
 
 /*********************************************************
@@ -4338,9 +4791,6 @@ IMessagingReader *RTIDDSImpl<T>::create_reader(
         const char *topic_name,
         IMessagingCB *callback)
 {
-    DDSDataReader *reader = NULL;
-    DDS_DataReaderQos dr_qos;
-    std::string qos_profile = "";
     DDSTopicDescription* topic_desc = NULL; // Used to create the DDS DataReader
 
     DDSTopic *topic = _participant->create_topic(
@@ -4354,6 +4804,34 @@ IMessagingReader *RTIDDSImpl<T>::create_reader(
     }
     topic_desc = topic;
 
+  #ifdef PERFTEST_RTI_PRO
+    /* Create CFT Topic */
+    if (strcmp(topic_name, THROUGHPUT_TOPIC_NAME) == 0
+            && (_PM->is_set("cft") || _PM->is_set("cftKeys"))) {
+        topic_desc = create_cft(topic_name, topic);
+        if (topic_desc == NULL) {
+            printf("Create_contentfilteredtopic error\n");
+            return NULL;
+        }
+    }
+  #endif
+
+    return create_reader_for_topic(topic_name, topic_desc, callback);
+}
+
+/*********************************************************
+ * CreateReaderForTopic
+ */
+template <typename T>
+IMessagingReader *RTIDDSImpl<T>::create_reader_for_topic(
+        const char *topic_name,
+        DDSTopicDescription *topic_desc,
+        IMessagingCB *callback)
+{
+    DDSDataReader *reader = NULL;
+    DDS_DataReaderQos dr_qos;
+    std::string qos_profile = "";
+
     qos_profile = get_qos_profile_name(topic_name);
     if (qos_profile.empty()) {
         fprintf(stderr, "Problem getting qos profile.\n");
@@ -4365,17 +4843,6 @@ IMessagingReader *RTIDDSImpl<T>::create_reader(
         return NULL;
     }
 
-  #ifdef PERFTEST_RTI_PRO
-    /* Create CFT Topic */
-    if (strcmp(topic_name, THROUGHPUT_TOPIC_NAME) == 0 && _PM->is_set("cft")) {
-        topic_desc = create_cft(topic_name, topic);
-        if (topic_desc == NULL) {
-            printf("Create_contentfilteredtopic error\n");
-            return NULL;
-        }
-    }
-  #endif
-
     if (callback != NULL) {
         if (!_PM->get<bool>("dynamicData")) {
             reader = _subscriber->create_datareader(
@@ -4482,7 +4949,8 @@ IMessagingReader *RTIDDSImpl_FlatData<T>::create_reader(
 
   #ifndef PERFTEST_RTI_MICRO
     /* Create CFT Topic */
-    if (strcmp(topic_name, THROUGHPUT_TOPIC_NAME) == 0 && _PM->is_set("cft")) {
+    if (strcmp(topic_name, THROUGHPUT_TOPIC_NAME) == 0
+            && (_PM->is_set("cft") || _PM->is_set("cftKeys"))) {
         topic_desc = create_cft(topic_name, topic);
         if (topic_desc == NULL) {
             printf("Create_contentfilteredtopic error\n");
@@ -27,6 +27,8 @@
 #include "Infrastructure_common.h"
 #ifdef PERFTEST_RTI_PRO
   #include "RTIDDSLoggerDevice.h"
+  #include "RTIKeyFilter.h"
+  #include "KeyDistribution.h"
 #endif
 #ifdef RTI_CUSTOM_TYPE
   #include "CustomType.h"
@@ -83,6 +85,13 @@ public:
     };
 
   #ifdef PERFTEST_RTI_PRO
+    IMessagingReader *create_partitioned_reader(
+            const char *topic_name,
+            IMessagingCB *callback,
+            unsigned int partition,
+            unsigned int partitionCount);
+    IMessagingWriter *create_shared_writer(IMessagingWriter *writer);
+    void delete_writer(IMessagingWriter *writer);
 
     /**
      * @brief This function calculates the overhead bytes that all the
@@ -114,6 +123,12 @@ protected:
 
   #ifdef PERFTEST_RTI_PRO
     DDSTopicDescription *create_cft(const char *topic_name, DDSTopic *topic);
+    DDSTopicDescription *create_cft(
+            const char *cft_name,
+            DDSTopic *topic,
+            const std::vector<unsigned long long> &cftRange,
+            bool keySet);
+    DDSTopic *find_or_create_topic(const char *topic_name);
     unsigned long int getShmemSHMMAX();
   #endif
 
@@ -129,6 +144,13 @@ protected:
 
     const std::string get_qos_profile_name(const char *topicName);
 
+    IMessagingWriter *create_publisher(DDSDataWriter *writer);
+
+    IMessagingReader *create_reader_for_topic(
+            const char *topic_name,
+            DDSTopicDescription *topic_desc,
+            IMessagingCB *callback);
+
 protected:
 
     // This Mutex is used in VxWorks to synchronize when finalizing the factory
@@ -153,6 +175,7 @@ protected:
     PerftestSemaphore           *_pongSemaphore;
   #ifdef PERFTEST_RTI_PRO
     RTIDDSLoggerDevice           _loggerDevice;
+    RTIKeyFilter                *_keyFilter;
     #ifdef PERFTEST_CONNEXT_PRO_610
     bool                         _isNetworkCapture;
     std::string                  _networkCaptureOutputFile;
@@ -8,6 +8,8 @@
 #include "osapi/osapi_sharedMemorySegment.h"
 
 #include <time.h>
+#include <sstream>
+#include "TscClock.h"
 using namespace std;
 
 #ifndef RTI_USE_CPP_11_INFRASTRUCTURE
@@ -24,11 +26,16 @@ PerftestClock::PerftestClock()
 
     clockSec = 0;
     clockUsec = 0;
+    tscClock = NULL;
+    tscOffsetUsec = 0;
 }
 
 PerftestClock::~PerftestClock()
 {
     RTIHighResolutionClock_delete(clock);
+    if (tscClock != NULL) {
+        delete tscClock;
+    }
 }
 
 PerftestClock &PerftestClock::getInstance()
@@ -38,6 +45,16 @@ PerftestClock &PerftestClock::getInstance()
 }
 
 unsigned long long PerftestClock::getTime()
+{
+    if (tscClock != NULL) {
+        return (unsigned long long)
+                ((long long) (tscClock->get_time_ns() / 1000)
+                        + tscOffsetUsec);
+    }
+    return getRtiTime();
+}
+
+unsigned long long PerftestClock::getRtiTime()
 {
     clock->getTime(clock, &clockTimeAux);
     RTINtpTime_unpackToMicrosec(
@@ -50,12 +67,129 @@ unsigned long long PerftestClock::getTime()
 #ifdef RTI_PERFTEST_NANO_CLOCK
 unsigned long long PerftestClock::getTimeNs()
 {
+    if (tscClock != NULL) {
+        return tscClock->get_time_ns();
+    }
     clock_gettime(CLOCK_MONOTONIC, &timeStruct);
     return (static_cast<unsigned long long>(timeStruct.tv_sec) * 1000000000ULL)
             + static_cast<unsigned long long>(timeStruct.tv_nsec);
 }
 #endif //RTI_PERFTEST_NANO_CLOCK
 
+bool PerftestClock::setClockSource(const std::string &source)
+{
+    if (source == "default") {
+        return true;
+    }
+    if (source != "tsc") {
+        fprintf(stderr,
+                "[Error] Unknown clock '%s'. Use 'default' or 'tsc'.\n",
+                source.c_str());
+        return false;
+    }
+    if (tscClock != NULL) {
+        // Already calibrated (i.e. by another thread of a -loopback test)
+        return true;
+    }
+
+    std::string reason;
+    if (!TscClock::is_available(reason)) {
+        fprintf(stderr,
+                "[Error] '-clock tsc' cannot be used: %s.\n",
+                reason.c_str());
+        return false;
+    }
+    TscClock *newClock = new TscClock();
+    if (!newClock->calibrate(PERFTEST_TSC_CALIBRATION_MSEC)) {
+        delete newClock;
+        return false;
+    }
+    /*
+     * Only the source of getTime() changes, not its time base: the times
+     * still compare with the ones of the default clock (i.e. in other
+     * processes). getTimeNs() is already in the base of the monotonic clock.
+     */
+    unsigned long long tscUsec = newClock->get_time_ns() / 1000;
+    tscOffsetUsec = (long long) getRtiTime() - (long long) tscUsec;
+    tscClock = newClock;
+    return true;
+}
+
+/*
+ * Time per read (averaged over many reads) and resolution (smallest step
+ * seen between consecutive reads) of a clock returning ns.
+ */
+template <typename ClockReader>
+static std::string measure_clock(const char *name, ClockReader read)
+{
+    const int reads = 100000;
+    unsigned long long resolution = ~0ULL;
+    unsigned long long previous = read();
+    unsigned long long start = TscClock::get_monotonic_ns();
+    for (int i = 0; i < reads; i++) {
+        unsigned long long now = read();
+        if (now > previous && now - previous < resolution) {
+            resolution = now - previous;
+        }
+        previous = now;
+    }
+    unsigned long long end = TscClock::get_monotonic_ns();
+
+    char line[128];
+    snprintf(line,
+             sizeof(line),
+             "\t\t%s: %.1f ns per read, %llu ns resolution\n",
+             name,
+             (double) (end - start) / reads,
+             resolution);
+    return line;
+}
+
+std::string PerftestClock::getClockDescription()
+{
+    std::ostringstream stringStream;
+    stringStream << "\tClock: ";
+    if (tscClock != NULL) {
+        stringStream << "tsc (" << tscClock->get_description() << ")\n";
+    } else {
+        stringStream << "default\n";
+    }
+
+    stringStream << measure_clock("RTIClock", [this]() {
+        clock->getTime(clock, &clockTimeAux);
+        RTINtpTime_unpackToMicrosec(clockSec, clockUsec, clockTimeAux);
+        return (clockUsec + 1000000 * clockSec) * 1000;
+    });
+  #ifdef RTI_PERFTEST_NANO_CLOCK
+    stringStream << measure_clock("CLOCK_MONOTONIC", [this]() {
+        clock_gettime(CLOCK_MONOTONIC, &timeStruct);
+        return (static_cast<unsigned long long>(timeStruct.tv_sec)
+                * 1000000000ULL)
+                + static_cast<unsigned long long>(timeStruct.tv_nsec);
+    });
+  #endif
+
+    // The TSC is measured even if not used, with a shorter calibration
+    std::string reason;
+    TscClock *tsc = tscClock;
+    if (tsc == NULL && TscClock::is_available(reason)) {
+        tsc = new TscClock();
+        if (!tsc->calibrate(PERFTEST_TSC_CALIBRATION_MSEC / 10)) {
+            delete tsc;
+            tsc = NULL;
+        }
+    }
+    if (tsc != NULL) {
+        stringStream << measure_clock("TSC", [tsc]() {
+            return tsc->get_time_ns();
+        });
+        if (tsc != tscClock) {
+            delete tsc;
+        }
+    }
+    return stringStream.str();
+}
+
 void PerftestClock::milliSleep(unsigned int millisec)
 {
     NDDSUtility::sleep(DDS_Duration_t::from_millis(millisec));
@@ -108,9 +108,12 @@ inline bool PerftestSemaphore_give(PerftestSemaphore *sem)
         PerftestSemaphore_take(sem, PERFTEST_SEMAPHORE_TIMEOUT_INFINITE)
 
 #define PERFTEST_DISCOVERY_TIME_MSEC 1000 // 1 second
+#define PERFTEST_TSC_CALIBRATION_MSEC 200 // Time to measure the TSC frequency
 #define ONE_BILLION  1000000000L // 1 billion (US) == 1 second in ns
 
 /* Perftest Clock Class */
+class TscClock;
+
 class PerftestClock
 {
 
@@ -122,6 +125,15 @@ class PerftestClock
   #ifdef RTI_PERFTEST_NANO_CLOCK
     struct timespec timeStruct;
   #endif // RTI_PERFTEST_NANO_CLOCK
+    // Only set with -clock tsc
+    TscClock *tscClock;
+    /*
+     * The TSC clock counts from the monotonic clock, getTime() adds this to
+     * keep the time base of the RTI clock.
+     */
+    long long tscOffsetUsec;
+
+    unsigned long long getRtiTime();
 
   public:
     PerftestClock();
@@ -132,6 +144,11 @@ class PerftestClock
   #ifdef RTI_PERFTEST_NANO_CLOCK
     unsigned long long getTimeNs();
   #endif // RTI_PERFTEST_NANO_CLOCK
+
+    // Select the source of getTime() and getTimeNs(): "default" or "tsc"
+    bool setClockSource(const std::string &source);
+    // Source in use, and the cost and resolution of every source available
+    std::string getClockDescription();
     static void milliSleep(unsigned int millisec);
     static void sleep(const struct DDS_Duration_t& sleep_period);
 
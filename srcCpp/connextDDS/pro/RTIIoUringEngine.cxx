@@ -0,0 +1,1417 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "RTIIoUringEngine.h"
+
+#ifdef RTI_PERFTEST_IO_URING
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+/* Time the kernel thread polls the submission queue before going to sleep */
+#define RTIPERFTEST_IO_URING_SQ_THREAD_IDLE_MSEC 1000
+
+/* Limits of the size of the queues accepted by the kernel */
+#define RTIPERFTEST_IO_URING_SQ_ENTRIES_MAX 4096
+#define RTIPERFTEST_IO_URING_CQ_ENTRIES_MAX 65536
+
+/* Buffer group used for the provided buffers of the receivers */
+#define RTIPERFTEST_IO_URING_BUFFER_GROUP 0
+
+/* Identifies the datagrams ending with a PacketTimestampTrailer */
+#define RTIPERFTEST_PACKET_TIMESTAMP_MAGIC 0x53545450
+#define RTIPERFTEST_PACKET_TIMESTAMP_PING 1
+#define RTIPERFTEST_PACKET_TIMESTAMP_PONG 2
+#define RTIPERFTEST_PACKET_TIMESTAMP_NO_PING 0xFFFFFFFFFFFFFFFFULL
+
+/*
+ * Pings and pongs waiting for the rest of their timestamps. Older ones are
+ * discarded, their pong or timestamp was lost.
+ */
+#define RTIPERFTEST_PACKET_TIMESTAMP_PENDING_MAX 1024
+
+/*********************************************************
+ * Helpers
+ */
+static inline size_t io_uring_round_up_to_page(size_t size)
+{
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    return (size + pageSize - 1) / pageSize * pageSize;
+}
+
+/* Anonymous memory, page aligned and already faulted in */
+static void *io_uring_allocate(size_t size)
+{
+    void *memory = mmap(
+            NULL,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+            -1,
+            0);
+    return memory == MAP_FAILED ? NULL : memory;
+}
+
+static inline int64_t timespec_to_ns(const struct timespec &time)
+{
+    return (int64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+/* Same clock used by the kernel for the software timestamps */
+static inline int64_t timestamp_now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return timespec_to_ns(now);
+}
+
+/* Copy the SCM_TIMESTAMPING control data of a message, NULL if none */
+static struct scm_timestamping *get_scm_timestamping(
+        struct msghdr *message,
+        struct scm_timestamping &timestamping)
+{
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(message); cmsg != NULL;
+            cmsg = CMSG_NXTHDR(message, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET
+                && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+            memcpy(&timestamping, CMSG_DATA(cmsg), sizeof(timestamping));
+            return &timestamping;
+        }
+    }
+    return NULL;
+}
+
+bool io_uring_get_interface_address(
+        const std::string &interfaceName,
+        struct in_addr &addr)
+{
+    if (inet_pton(AF_INET, interfaceName.c_str(), &addr) == 1) {
+        return true;
+    }
+
+    struct ifaddrs *interfaces = NULL;
+    if (getifaddrs(&interfaces) != 0) {
+        return false;
+    }
+
+    bool found = false;
+    for (struct ifaddrs *it = interfaces; it != NULL && !found;
+            it = it->ifa_next) {
+        if (it->ifa_addr != NULL
+                && it->ifa_addr->sa_family == AF_INET
+                && interfaceName == it->ifa_name) {
+            addr = ((struct sockaddr_in *) it->ifa_addr)->sin_addr;
+            found = true;
+        }
+    }
+    freeifaddrs(interfaces);
+
+    return found;
+}
+
+/*********************************************************
+ * IoUring
+ */
+IoUring::IoUring()
+        : _fd(-1),
+          _sqPoll(false),
+          _sqHead(NULL),
+          _sqTail(NULL),
+          _sqFlags(NULL),
+          _sqMask(0),
+          _sqEntries(0),
+          _sqes(NULL),
+          _sqeTail(0),
+          _sqeSubmitted(0),
+          _cqHead(NULL),
+          _cqTail(NULL),
+          _cqMask(0),
+          _cqes(NULL),
+          _sqRing(NULL),
+          _sqRingSize(0),
+          _cqRing(NULL),
+          _cqRingSize(0),
+          _sqesSize(0)
+{
+}
+
+IoUring::~IoUring()
+{
+    finalize();
+}
+
+bool IoUring::initialize(
+        unsigned int entries,
+        unsigned int cqEntries,
+        bool sqPoll)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    entries = std::min(entries, (unsigned int) RTIPERFTEST_IO_URING_SQ_ENTRIES_MAX);
+    if (cqEntries > entries) {
+        params.flags |= IORING_SETUP_CQSIZE;
+        params.cq_entries = std::min(
+                cqEntries,
+                (unsigned int) RTIPERFTEST_IO_URING_CQ_ENTRIES_MAX);
+    }
+    if (sqPoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = RTIPERFTEST_IO_URING_SQ_THREAD_IDLE_MSEC;
+    }
+
+    _fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if (_fd < 0) {
+        fprintf(stderr,
+                "[Error] IoUring: io_uring_setup failed: %s\n",
+                strerror(errno));
+        return false;
+    }
+    _sqPoll = sqPoll;
+
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    _cqRingSize = params.cq_off.cqes
+            + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+    }
+
+    _sqRing = mmap(
+            NULL,
+            _sqRingSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            _fd,
+            IORING_OFF_SQ_RING);
+    if (_sqRing == MAP_FAILED) {
+        _sqRing = NULL;
+        fprintf(stderr,
+                "[Error] IoUring: Could not map the submission queue: %s\n",
+                strerror(errno));
+        finalize();
+        return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _cqRing = _sqRing;
+    } else {
+        _cqRing = mmap(
+                NULL,
+                _cqRingSize,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE,
+                _fd,
+                IORING_OFF_CQ_RING);
+        if (_cqRing == MAP_FAILED) {
+            _cqRing = NULL;
+            fprintf(stderr,
+                    "[Error] IoUring: Could not map the completion queue: %s\n",
+                    strerror(errno));
+            finalize();
+            return false;
+        }
+    }
+
+    _sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(
+            NULL,
+            _sqesSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            _fd,
+            IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        fprintf(stderr,
+                "[Error] IoUring: Could not map the SQEs: %s\n",
+                strerror(errno));
+        finalize();
+        return false;
+    }
+    _sqes = (struct io_uring_sqe *) sqes;
+
+    char *sqRing = (char *) _sqRing;
+    _sqHead = (unsigned int *) (sqRing + params.sq_off.head);
+    _sqTail = (unsigned int *) (sqRing + params.sq_off.tail);
+    _sqFlags = (unsigned int *) (sqRing + params.sq_off.flags);
+    _sqMask = *(unsigned int *) (sqRing + params.sq_off.ring_mask);
+    _sqEntries = params.sq_entries;
+
+    /* The SQEs are always used in order, so the array is the identity */
+    unsigned int *sqArray = (unsigned int *) (sqRing + params.sq_off.array);
+    for (unsigned int i = 0; i < _sqEntries; i++) {
+        sqArray[i] = i;
+    }
+    _sqeTail = _sqeSubmitted = *_sqTail;
+
+    char *cqRing = (char *) _cqRing;
+    _cqHead = (unsigned int *) (cqRing + params.cq_off.head);
+    _cqTail = (unsigned int *) (cqRing + params.cq_off.tail);
+    _cqMask = *(unsigned int *) (cqRing + params.cq_off.ring_mask);
+    _cqes = (struct io_uring_cqe *) (cqRing + params.cq_off.cqes);
+
+    return true;
+}
+
+void IoUring::finalize()
+{
+    /*
+     * The ring is released asynchronously by the kernel, together with the
+     * files registered. Cancel the requests in flight and unregister the
+     * files first, so the sockets are closed (and the ports can be bound
+     * again) as soon as this returns. Errors are ignored: the requests or
+     * files may not exist, or the kernel may not support sync cancelation.
+     */
+    if (_fd >= 0) {
+        struct io_uring_sync_cancel_reg cancel;
+        memset(&cancel, 0, sizeof(cancel));
+        cancel.flags = IORING_ASYNC_CANCEL_ANY;
+        cancel.timeout.tv_sec = -1;
+        cancel.timeout.tv_nsec = -1;
+        syscall(__NR_io_uring_register,
+                _fd,
+                IORING_REGISTER_SYNC_CANCEL,
+                &cancel,
+                1);
+        syscall(__NR_io_uring_register, _fd, IORING_UNREGISTER_FILES, NULL, 0);
+    }
+
+    if (_sqes != NULL) {
+        munmap(_sqes, _sqesSize);
+        _sqes = NULL;
+    }
+    if (_cqRing != NULL && _cqRing != _sqRing) {
+        munmap(_cqRing, _cqRingSize);
+    }
+    _cqRing = NULL;
+    if (_sqRing != NULL) {
+        munmap(_sqRing, _sqRingSize);
+        _sqRing = NULL;
+    }
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+int IoUring::enter(
+        unsigned int toSubmit,
+        unsigned int waitNr,
+        unsigned int flags)
+{
+    int result = 0;
+    do {
+        result = (int) syscall(
+                __NR_io_uring_enter,
+                _fd,
+                toSubmit,
+                waitNr,
+                flags,
+                NULL,
+                0);
+        _stats.syscalls++;
+    } while (result < 0 && errno == EINTR);
+
+    if (result < 0) {
+        fprintf(stderr,
+                "[Error] IoUring: io_uring_enter failed: %s\n",
+                strerror(errno));
+    }
+    return result;
+}
+
+struct io_uring_sqe *IoUring::get_sqe()
+{
+    unsigned int head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+
+    while (_sqeTail - head >= _sqEntries) {
+        if (!submit()) {
+            return NULL;
+        }
+        if (_sqPoll && enter(0, 0, IORING_ENTER_SQ_WAIT) < 0) {
+            return NULL;
+        }
+        unsigned int newHead = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+        if (!_sqPoll && newHead == head) {
+            fprintf(stderr,
+                    "[Error] IoUring: The kernel did not consume any SQE\n");
+            return NULL;
+        }
+        head = newHead;
+    }
+
+    struct io_uring_sqe *sqe = &_sqes[_sqeTail & _sqMask];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    _sqeTail++;
+    return sqe;
+}
+
+bool IoUring::submit(unsigned int waitNr)
+{
+    unsigned int queued = _sqeTail - _sqeSubmitted;
+    if (queued > 0) {
+        __atomic_store_n(_sqTail, _sqeTail, __ATOMIC_RELEASE);
+        _sqeSubmitted = _sqeTail;
+        _stats.submissions += queued;
+    }
+
+    unsigned int flags = 0;
+    unsigned int toSubmit = 0;
+    if (_sqPoll) {
+        /*
+         * The kernel thread only needs to be woken up if it went to sleep.
+         * The barrier orders the store of the tail and the load of the flags.
+         */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(_sqFlags, __ATOMIC_RELAXED)
+                & IORING_SQ_NEED_WAKEUP) {
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        } else if (waitNr == 0) {
+            return true;
+        }
+    } else {
+        toSubmit = _sqeTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+        if (toSubmit == 0 && waitNr == 0) {
+            return true;
+        }
+    }
+
+    if (waitNr > 0) {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+    return enter(toSubmit, waitNr, flags) >= 0;
+}
+
+struct io_uring_cqe *IoUring::peek_cqe()
+{
+    unsigned int head = *_cqHead;
+    if (head == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    return &_cqes[head & _cqMask];
+}
+
+struct io_uring_cqe *IoUring::wait_cqe()
+{
+    struct io_uring_cqe *cqe = NULL;
+    while ((cqe = peek_cqe()) == NULL) {
+        if (!submit(1)) {
+            return NULL;
+        }
+    }
+    return cqe;
+}
+
+void IoUring::cqe_seen()
+{
+    __atomic_store_n(_cqHead, *_cqHead + 1, __ATOMIC_RELEASE);
+    _stats.completions++;
+}
+
+bool IoUring::do_register(
+        unsigned int opcode,
+        const void *arg,
+        unsigned int count)
+{
+    if (syscall(__NR_io_uring_register, _fd, opcode, arg, count) < 0) {
+        fprintf(stderr,
+                "[Error] IoUring: io_uring_register (opcode %u) failed: %s\n",
+                opcode,
+                strerror(errno));
+        if (errno == ENOMEM && opcode == IORING_REGISTER_BUFFERS) {
+            fprintf(stderr,
+                    "Registered buffers count against the locked memory "
+                    "limit, check 'ulimit -l'.\n");
+        }
+        return false;
+    }
+    return true;
+}
+
+bool IoUring::register_files(const int *fds, unsigned int count)
+{
+    return do_register(IORING_REGISTER_FILES, fds, count);
+}
+
+bool IoUring::register_buffers(const struct iovec *iovecs, unsigned int count)
+{
+    return do_register(IORING_REGISTER_BUFFERS, iovecs, count);
+}
+
+bool IoUring::register_buffer_ring(
+        struct io_uring_buf_ring *ring,
+        unsigned int entries,
+        unsigned short groupId)
+{
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (unsigned long) ring;
+    reg.ring_entries = entries;
+    reg.bgid = groupId;
+
+    return do_register(IORING_REGISTER_PBUF_RING, &reg, 1);
+}
+
+/*********************************************************
+ * IoUringSender
+ */
+IoUringSender::IoUringSender()
+        : _buffers(NULL),
+          _buffersSize(0),
+          _slotCount(0),
+          _slotSize(0),
+          _payloadSize(0),
+          _currentSlot(0),
+          _pendingSendCount(0),
+          _sqPoll(false),
+          _nonBlocking(false),
+          _timestamps(NULL)
+{
+}
+
+IoUringSender::~IoUringSender()
+{
+    finalize();
+}
+
+bool IoUringSender::initialize(
+        const std::vector<struct sockaddr_in> &peers,
+        const struct in_addr &interfaceAddr,
+        unsigned int slotCount,
+        unsigned int slotSize,
+        bool sqPoll,
+        bool nonBlocking,
+        PacketTimestamps *timestamps)
+{
+    _slotCount = slotCount;
+    _payloadSize = slotSize;
+    _sqPoll = sqPoll;
+    _nonBlocking = nonBlocking;
+    _timestamps = timestamps;
+    if (_timestamps != NULL) {
+        slotSize += sizeof(PacketTimestampTrailer);
+    }
+    _slotSize = (unsigned int) io_uring_round_up_to_page(slotSize);
+
+    if (peers.empty()) {
+        fprintf(stderr, "[Error] IoUringSender: No peers to send to\n");
+        return false;
+    }
+
+    /* One connected socket per peer, so the sends do not need an address */
+    int bufferSize = RTIPERFTEST_IO_URING_SOCKET_BUFFER_SIZE;
+    for (unsigned int i = 0; i < peers.size(); i++) {
+        int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            fprintf(stderr,
+                    "[Error] IoUringSender: Could not create socket: %s\n",
+                    strerror(errno));
+            return false;
+        }
+        _sockets.push_back(fd);
+
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+
+        if (IN_MULTICAST(ntohl(peers[i].sin_addr.s_addr))) {
+            unsigned char ttl = 1;
+            setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+            setsockopt(
+                    fd,
+                    IPPROTO_IP,
+                    IP_MULTICAST_IF,
+                    &interfaceAddr,
+                    sizeof(interfaceAddr));
+        }
+
+        if (connect(fd, (const struct sockaddr *) &peers[i], sizeof(peers[i]))
+                != 0) {
+            char address[INET_ADDRSTRLEN];
+            fprintf(stderr,
+                    "[Error] IoUringSender: Could not connect to %s:%d: %s\n",
+                    inet_ntop(AF_INET, &peers[i].sin_addr, address, sizeof(address)),
+                    ntohs(peers[i].sin_port),
+                    strerror(errno));
+            return false;
+        }
+    }
+
+    /*
+     * Only the datagrams sent with a SO_TIMESTAMPING control message generate
+     * a TX timestamp, and only those increase the key (OPT_ID) that tells
+     * which datagram the timestamp belongs to.
+     */
+    if (_timestamps != NULL) {
+        int flags = SOF_TIMESTAMPING_SOFTWARE
+                | SOF_TIMESTAMPING_RAW_HARDWARE
+                | SOF_TIMESTAMPING_OPT_ID
+                | SOF_TIMESTAMPING_OPT_TSONLY;
+        if (setsockopt(
+                    _sockets[0],
+                    SOL_SOCKET,
+                    SO_TIMESTAMPING,
+                    &flags,
+                    sizeof(flags))
+                != 0) {
+            fprintf(stderr,
+                    "[Error] IoUringSender: Could not enable SO_TIMESTAMPING: "
+                    "%s\n",
+                    strerror(errno));
+            return false;
+        }
+        _messages.resize(_slotCount);
+        _iovecs.resize(_slotCount);
+        _controls.assign(_slotCount * CMSG_SPACE(sizeof(uint32_t)), 0);
+    }
+
+    _buffersSize = (size_t) _slotCount * _slotSize;
+    _buffers = (char *) io_uring_allocate(_buffersSize);
+    if (_buffers == NULL) {
+        fprintf(stderr,
+                "[Error] IoUringSender: Could not allocate %lu bytes: %s\n",
+                (unsigned long) _buffersSize,
+                strerror(errno));
+        return false;
+    }
+
+    /* Every slot can have a send in flight per peer */
+    unsigned int entries = _slotCount * (unsigned int) _sockets.size();
+    if (!_ring.initialize(entries, entries, sqPoll)) {
+        return false;
+    }
+
+    if (!_ring.register_files(&_sockets[0], (unsigned int) _sockets.size())) {
+        return false;
+    }
+
+    std::vector<struct iovec> iovecs(_slotCount);
+    for (unsigned int i = 0; i < _slotCount; i++) {
+        iovecs[i].iov_base = _buffers + (size_t) i * _slotSize;
+        iovecs[i].iov_len = _slotSize;
+    }
+    if (!_ring.register_buffers(&iovecs[0], _slotCount)) {
+        return false;
+    }
+
+    _pendingSends.assign(_slotCount, 0);
+    _currentSlot = 0;
+
+    return true;
+}
+
+void IoUringSender::finalize()
+{
+    /* The kernel may still be reading from the buffers */
+    if (_pendingSendCount > 0 && _ring.submit()) {
+        while (_pendingSendCount > 0 && reap_completions(true)) {
+        }
+    }
+    _ring.finalize();
+
+    for (unsigned int i = 0; i < _sockets.size(); i++) {
+        close(_sockets[i]);
+    }
+    _sockets.clear();
+
+    if (_buffers != NULL) {
+        munmap(_buffers, _buffersSize);
+        _buffers = NULL;
+    }
+}
+
+bool IoUringSender::reap_completions(bool wait)
+{
+    struct io_uring_cqe *cqe = wait ? _ring.wait_cqe() : _ring.peek_cqe();
+    if (wait && cqe == NULL) {
+        return false;
+    }
+
+    while (cqe != NULL) {
+        /*
+         * Failed sends (e.g. ECONNREFUSED if the peer is not running yet) are
+         * not reported, they will be represented as lost samples.
+         */
+        unsigned int slot = (unsigned int) cqe->user_data;
+        if (slot < _slotCount && _pendingSends[slot] > 0) {
+            _pendingSends[slot]--;
+            _pendingSendCount--;
+        }
+        _ring.cqe_seen();
+        cqe = _ring.peek_cqe();
+    }
+
+    return true;
+}
+
+char *IoUringSender::get_buffer()
+{
+    while (true) {
+        if (!reap_completions(false)) {
+            return NULL;
+        }
+        if (_pendingSends[_currentSlot] == 0) {
+            return _buffers + (size_t) _currentSlot * _slotSize;
+        }
+        /* The slot is still in use, make sure its sends were submitted */
+        if (!_ring.submit() || !reap_completions(true)) {
+            return NULL;
+        }
+    }
+}
+
+void IoUringSender::read_tx_timestamps()
+{
+    char control[256];
+
+    while (true) {
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (recvmsg(_sockets[0], &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;
+        }
+
+        struct scm_timestamping timestamping;
+        struct sock_extended_err *error = NULL;
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg != NULL;
+                cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level == IPPROTO_IP
+                    && cmsg->cmsg_type == IP_RECVERR) {
+                error = (struct sock_extended_err *) CMSG_DATA(cmsg);
+            }
+        }
+        if (error != NULL
+                && error->ee_origin == SO_EE_ORIGIN_TIMESTAMPING
+                && get_scm_timestamping(&message, timestamping) != NULL) {
+            _timestamps->on_tx_timestamp(
+                    error->ee_data,
+                    timespec_to_ns(timestamping.ts[0]),
+                    timespec_to_ns(timestamping.ts[2]));
+        }
+    }
+}
+
+bool IoUringSender::send_buffer(unsigned int length, bool timestamped)
+{
+    char *buffer = _buffers + (size_t) _currentSlot * _slotSize;
+
+    timestamped = timestamped && _timestamps != NULL;
+    if (timestamped) {
+        /* The timestamps of the previous datagrams should be there by now */
+        read_tx_timestamps();
+
+        PacketTimestampTrailer trailer;
+        _timestamps->on_datagram_sent(trailer);
+        memcpy(buffer + length, &trailer, sizeof(trailer));
+        length += sizeof(trailer);
+    }
+
+    for (unsigned int i = 0; i < _sockets.size(); i++) {
+        struct io_uring_sqe *sqe = _ring.get_sqe();
+        if (sqe == NULL) {
+            return false;
+        }
+        if (timestamped && i == 0) {
+            /*
+             * The TX timestamp is requested per datagram with a control
+             * message, that needs a sendmsg instead of a fixed buffer write.
+             */
+            char *control = &_controls[_currentSlot
+                    * CMSG_SPACE(sizeof(uint32_t))];
+            struct msghdr &message = _messages[_currentSlot];
+            memset(&message, 0, sizeof(message));
+            _iovecs[_currentSlot].iov_base = buffer;
+            _iovecs[_currentSlot].iov_len = length;
+            message.msg_iov = &_iovecs[_currentSlot];
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = CMSG_SPACE(sizeof(uint32_t));
+
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SO_TIMESTAMPING;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint32_t));
+            uint32_t flags = SOF_TIMESTAMPING_TX_SOFTWARE
+                    | SOF_TIMESTAMPING_TX_HARDWARE;
+            memcpy(CMSG_DATA(cmsg), &flags, sizeof(flags));
+
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->flags = IOSQE_FIXED_FILE;
+            sqe->fd = (int) i;
+            sqe->addr = (unsigned long) &message;
+            sqe->len = 1;
+            sqe->msg_flags = _nonBlocking ? MSG_DONTWAIT : 0;
+        } else {
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->flags = IOSQE_FIXED_FILE;
+            sqe->fd = (int) i;
+            sqe->addr = (unsigned long) buffer;
+            sqe->len = length;
+            sqe->buf_index = (unsigned short) _currentSlot;
+            /*
+             * Like a non-blocking socket, fail with EAGAIN if the buffer is
+             * full
+             */
+            sqe->rw_flags = _nonBlocking ? RWF_NOWAIT : 0;
+        }
+        sqe->user_data = _currentSlot;
+
+        _pendingSends[_currentSlot]++;
+        _pendingSendCount++;
+    }
+
+    _currentSlot = (_currentSlot + 1) % _slotCount;
+
+    /*
+     * Submitting with SQPOLL does not need a system call (as long as the
+     * kernel thread is awake), otherwise wait until there are a few sends.
+     */
+    if (_sqPoll
+            || _ring.get_queued_count()
+                    >= (_slotCount / 2) * (unsigned int) _sockets.size()) {
+        return _ring.submit();
+    }
+    return true;
+}
+
+bool IoUringSender::submit()
+{
+    return _ring.submit();
+}
+
+/*********************************************************
+ * IoUringReceiver
+ */
+IoUringReceiver::IoUringReceiver()
+        : _socket(-1),
+          _bufferRing(NULL),
+          _bufferRingSize(0),
+          _buffers(NULL),
+          _buffersSize(0),
+          _bufferCount(0),
+          _bufferRingTail(0),
+          _currentBuffer(-1),
+          _armed(false),
+          _bufferSize(RTIPERFTEST_IO_URING_DATAGRAM_SIZE_MAX),
+          _timestamps(NULL)
+{
+    memset(&_unblockAddr, 0, sizeof(_unblockAddr));
+    memset(&_unblockInterface, 0, sizeof(_unblockInterface));
+    memset(&_message, 0, sizeof(_message));
+}
+
+IoUringReceiver::~IoUringReceiver()
+{
+    finalize();
+}
+
+bool IoUringReceiver::initialize(
+        unsigned short port,
+        const struct in_addr &multicastAddr,
+        const struct in_addr &interfaceAddr,
+        unsigned int bufferCount,
+        bool sqPoll,
+        PacketTimestamps *timestamps)
+{
+    bool isMulticast = multicastAddr.s_addr != htonl(INADDR_ANY);
+
+    if (bufferCount == 0 || (bufferCount & (bufferCount - 1)) != 0) {
+        fprintf(stderr,
+                "[Error] IoUringReceiver: The number of buffers (%u) must be "
+                "a power of 2\n",
+                bufferCount);
+        return false;
+    }
+    _bufferCount = bufferCount;
+
+    _socket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (_socket < 0) {
+        fprintf(stderr,
+                "[Error] IoUringReceiver: Could not create socket: %s\n",
+                strerror(errno));
+        return false;
+    }
+
+    int bufferSize = RTIPERFTEST_IO_URING_SOCKET_BUFFER_SIZE;
+    setsockopt(_socket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    /*
+     * With timestamps every provided buffer gets the output of a recvmsg:
+     * a header, the control messages and then the datagram.
+     */
+    _timestamps = timestamps;
+    if (_timestamps != NULL) {
+        int flags = SOF_TIMESTAMPING_RX_SOFTWARE
+                | SOF_TIMESTAMPING_RX_HARDWARE
+                | SOF_TIMESTAMPING_SOFTWARE
+                | SOF_TIMESTAMPING_RAW_HARDWARE;
+        if (setsockopt(
+                    _socket,
+                    SOL_SOCKET,
+                    SO_TIMESTAMPING,
+                    &flags,
+                    sizeof(flags))
+                != 0) {
+            fprintf(stderr,
+                    "[Error] IoUringReceiver: Could not enable "
+                    "SO_TIMESTAMPING: %s\n",
+                    strerror(errno));
+            return false;
+        }
+        _message.msg_namelen = 0;
+        _message.msg_controllen = CMSG_SPACE(sizeof(struct scm_timestamping));
+        _bufferSize = (unsigned int) io_uring_round_up_to_page(
+                RTIPERFTEST_IO_URING_DATAGRAM_SIZE_MAX
+                + sizeof(struct io_uring_recvmsg_out)
+                + _message.msg_controllen);
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr = multicastAddr;
+
+    if (isMulticast) {
+        int reuse = 1;
+        setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+
+    if (bind(_socket, (const struct sockaddr *) &addr, sizeof(addr)) != 0) {
+        fprintf(stderr,
+                "[Error] IoUringReceiver: Could not bind port %d: %s\n"
+                "Check if you have other pub/sub with the same id\n",
+                port,
+                strerror(errno));
+        return false;
+    }
+
+    _unblockAddr = addr;
+    if (isMulticast) {
+        struct ip_mreq membership;
+        membership.imr_multiaddr = multicastAddr;
+        membership.imr_interface = interfaceAddr;
+        if (setsockopt(
+                    _socket,
+                    IPPROTO_IP,
+                    IP_ADD_MEMBERSHIP,
+                    &membership,
+                    sizeof(membership))
+                != 0) {
+            fprintf(stderr,
+                    "[Error] IoUringReceiver: Could not join the multicast "
+                    "group: %s\n",
+                    strerror(errno));
+            return false;
+        }
+        _unblockInterface = interfaceAddr;
+    } else {
+        _unblockAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+
+    /* Every buffer given to the kernel can generate a CQE */
+    if (!_ring.initialize(4, _bufferCount * 2, sqPoll)) {
+        return false;
+    }
+
+    if (!_ring.register_files(&_socket, 1)) {
+        return false;
+    }
+
+    _buffersSize = (size_t) _bufferCount * _bufferSize;
+    _buffers = (char *) io_uring_allocate(_buffersSize);
+    _bufferRingSize = io_uring_round_up_to_page(
+            _bufferCount * sizeof(struct io_uring_buf));
+    _bufferRing = (struct io_uring_buf_ring *) io_uring_allocate(
+            _bufferRingSize);
+    if (_buffers == NULL || _bufferRing == NULL) {
+        fprintf(stderr,
+                "[Error] IoUringReceiver: Could not allocate the buffers: %s\n",
+                strerror(errno));
+        return false;
+    }
+
+    if (!_ring.register_buffer_ring(
+                _bufferRing,
+                _bufferCount,
+                RTIPERFTEST_IO_URING_BUFFER_GROUP)) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < _bufferCount; i++) {
+        return_buffer((unsigned short) i);
+    }
+
+    return true;
+}
+
+void IoUringReceiver::finalize()
+{
+    /* Closing the ring cancels the receive in flight */
+    _ring.finalize();
+
+    if (_socket >= 0) {
+        close(_socket);
+        _socket = -1;
+    }
+    if (_bufferRing != NULL) {
+        munmap(_bufferRing, _bufferRingSize);
+        _bufferRing = NULL;
+    }
+    if (_buffers != NULL) {
+        munmap(_buffers, _buffersSize);
+        _buffers = NULL;
+    }
+}
+
+void IoUringReceiver::return_buffer(unsigned short bufferId)
+{
+    /*
+     * The entries are not accessed through _bufferRing->bufs: in C++ the
+     * flexible array of the kernel header does not start at offset 0.
+     */
+    struct io_uring_buf *buffer = (struct io_uring_buf *) _bufferRing
+            + (_bufferRingTail & (_bufferCount - 1));
+    buffer->addr = (unsigned long) (_buffers + (size_t) bufferId * _bufferSize);
+    buffer->len = _bufferSize;
+    buffer->bid = bufferId;
+
+    _bufferRingTail++;
+    __atomic_store_n(&_bufferRing->tail, _bufferRingTail, __ATOMIC_RELEASE);
+}
+
+bool IoUringReceiver::arm_receive()
+{
+    struct io_uring_sqe *sqe = _ring.get_sqe();
+    if (sqe == NULL) {
+        return false;
+    }
+
+    /* Keeps generating a CQE per datagram until it runs out of buffers */
+    sqe->opcode = IORING_OP_RECV;
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->fd = 0;
+    if (_timestamps != NULL) {
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->addr = (unsigned long) &_message;
+        sqe->len = 1;
+    }
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->buf_group = RTIPERFTEST_IO_URING_BUFFER_GROUP;
+
+    _armed = true;
+    return true;
+}
+
+bool IoUringReceiver::receive(char *&data, unsigned int &length)
+{
+    /* The previous datagram has already been processed */
+    if (_currentBuffer >= 0) {
+        return_buffer((unsigned short) _currentBuffer);
+        _currentBuffer = -1;
+    }
+
+    while (true) {
+        if (!_armed && !arm_receive()) {
+            return false;
+        }
+
+        struct io_uring_cqe *cqe = _ring.wait_cqe();
+        if (cqe == NULL) {
+            return false;
+        }
+        int result = cqe->res;
+        unsigned int flags = cqe->flags;
+        _ring.cqe_seen();
+
+        if (!(flags & IORING_CQE_F_MORE)) {
+            _armed = false;
+        }
+
+        if (flags & IORING_CQE_F_BUFFER) {
+            unsigned short bufferId =
+                    (unsigned short) (flags >> IORING_CQE_BUFFER_SHIFT);
+            data = _buffers + (size_t) bufferId * _bufferSize;
+            length = result > 0 ? (unsigned int) result : 0;
+            if (_timestamps != NULL && length > 0) {
+                process_timestamps(data, length);
+                if (length == 0) {
+                    /* Empty datagram sent by unblock() */
+                    return_buffer(bufferId);
+                    data = NULL;
+                    return true;
+                }
+            }
+            if (length > 0) {
+                _currentBuffer = bufferId;
+                return true;
+            }
+            return_buffer(bufferId);
+        }
+
+        if (result == 0) {
+            /* Empty datagram sent by unblock() */
+            data = NULL;
+            length = 0;
+            return true;
+        } else if (result == -ENOBUFS) {
+            /*
+             * All the buffers were used before processing their CQEs, the
+             * receive will be armed again once they are processed.
+             */
+            continue;
+        } else if (result < 0) {
+            fprintf(stderr,
+                    "[Error] IoUringReceiver: Receive failed: %s\n",
+                    strerror(-result));
+            return false;
+        }
+    }
+}
+
+void IoUringReceiver::process_timestamps(char *&data, unsigned int &length)
+{
+    struct io_uring_recvmsg_out output;
+    if (length < sizeof(output)) {
+        length = 0;
+        return;
+    }
+    memcpy(&output, data, sizeof(output));
+
+    char *control = data + sizeof(output) + _message.msg_namelen;
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_control = control;
+    message.msg_controllen = output.controllen;
+
+    int64_t swNs = 0;
+    int64_t hwNs = 0;
+    struct scm_timestamping timestamping;
+    if (get_scm_timestamping(&message, timestamping) != NULL) {
+        swNs = timespec_to_ns(timestamping.ts[0]);
+        hwNs = timespec_to_ns(timestamping.ts[2]);
+    }
+
+    data = control + _message.msg_controllen;
+    length = output.payloadlen;
+
+    PacketTimestampTrailer trailer;
+    if (length >= sizeof(trailer)) {
+        memcpy(&trailer, data + length - sizeof(trailer), sizeof(trailer));
+        if (trailer.magic == RTIPERFTEST_PACKET_TIMESTAMP_MAGIC) {
+            length -= sizeof(trailer);
+            _timestamps->on_datagram_received(trailer, swNs, hwNs);
+        }
+    }
+}
+
+bool IoUringReceiver::unblock()
+{
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        fprintf(stderr,
+                "[Error] IoUringReceiver: Could not create socket: %s\n",
+                strerror(errno));
+        return false;
+    }
+
+    if (IN_MULTICAST(ntohl(_unblockAddr.sin_addr.s_addr))) {
+        setsockopt(
+                fd,
+                IPPROTO_IP,
+                IP_MULTICAST_IF,
+                &_unblockInterface,
+                sizeof(_unblockInterface));
+    }
+
+    ssize_t result = sendto(
+            fd,
+            "",
+            0,
+            0,
+            (const struct sockaddr *) &_unblockAddr,
+            sizeof(_unblockAddr));
+    close(fd);
+
+    if (result < 0) {
+        fprintf(stderr,
+                "[Error] IoUringReceiver: Could not unblock the receiver: %s\n",
+                strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+/*********************************************************
+ * PacketTimestamps
+ */
+PacketTimestamps::Ping::Ping()
+        : userSendNs(0),
+          txSwNs(0),
+          txHwNs(0),
+          rxSwNs(0),
+          rxHwNs(0),
+          userReceiveNs(0),
+          subKernelToUserNs(0),
+          subTurnaroundSwNs(0),
+          subTurnaroundHwNs(0),
+          pongReceived(false),
+          turnaroundReceived(false)
+{
+}
+
+PacketTimestamps::Component::Component()
+        : count(0),
+          sumNs(0),
+          minNs(0),
+          maxNs(0)
+{
+}
+
+void PacketTimestamps::Component::add(int64_t ns)
+{
+    if (count == 0 || ns < minNs) {
+        minNs = ns;
+    }
+    if (count == 0 || ns > maxNs) {
+        maxNs = ns;
+    }
+    sumNs += (double) ns;
+    count++;
+}
+
+PacketTimestamps::PacketTimestamps(bool isPublisher)
+        : _isPublisher(isPublisher),
+          _nextKey(0),
+          _hardwareWireCount(0),
+          _pingReceived(false),
+          _lastPingId(0),
+          _lastPingRxSwNs(0),
+          _lastPingRxHwNs(0),
+          _lastPingUserNs(0)
+{
+}
+
+void PacketTimestamps::on_datagram_sent(PacketTimestampTrailer &trailer)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    memset(&trailer, 0, sizeof(trailer));
+    trailer.pingId = RTIPERFTEST_PACKET_TIMESTAMP_NO_PING;
+    trailer.turnaroundPingId = RTIPERFTEST_PACKET_TIMESTAMP_NO_PING;
+    trailer.magic = RTIPERFTEST_PACKET_TIMESTAMP_MAGIC;
+
+    /* Every timestamped datagram uses a key, even if it is not tracked */
+    uint32_t key = _nextKey++;
+
+    if (_isPublisher) {
+        trailer.kind = RTIPERFTEST_PACKET_TIMESTAMP_PING;
+        trailer.pingId = key;
+        _pings[key].userSendNs = timestamp_now_ns();
+        if (_pings.size() > RTIPERFTEST_PACKET_TIMESTAMP_PENDING_MAX) {
+            _pings.erase(_pings.begin());
+        }
+        return;
+    }
+
+    trailer.kind = RTIPERFTEST_PACKET_TIMESTAMP_PONG;
+    if (_pingReceived && _lastPingRxSwNs != 0) {
+        trailer.pingId = _lastPingId;
+        trailer.kernelToUserNs = _lastPingUserNs - _lastPingRxSwNs;
+
+        Pong &pong = _pongs[key];
+        pong.pingId = _lastPingId;
+        pong.rxSwNs = _lastPingRxSwNs;
+        pong.rxHwNs = _lastPingRxHwNs;
+        pong.txHwNs = 0;
+        if (_pongs.size() > RTIPERFTEST_PACKET_TIMESTAMP_PENDING_MAX) {
+            _pongs.erase(_pongs.begin());
+        }
+    }
+    _pingReceived = false;
+
+    if (!_turnarounds.empty()) {
+        trailer.turnaroundPingId = _turnarounds.front().pingId;
+        trailer.turnaroundSwNs = _turnarounds.front().swNs;
+        trailer.turnaroundHwNs = _turnarounds.front().hwNs;
+        _turnarounds.pop_front();
+    }
+}
+
+void PacketTimestamps::on_tx_timestamp(
+        uint32_t key,
+        int64_t swNs,
+        int64_t hwNs)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_isPublisher) {
+        std::map<uint64_t, Ping>::iterator it = _pings.find(key);
+        if (it != _pings.end()) {
+            if (swNs != 0) {
+                it->second.txSwNs = swNs;
+            }
+            if (hwNs != 0) {
+                it->second.txHwNs = hwNs;
+            }
+            complete_ping(it);
+        }
+        return;
+    }
+
+    /*
+     * The software and hardware timestamps arrive separately. The turnaround
+     * is ready with the software one, the hardware one is added if it is
+     * still waiting for the next pong.
+     */
+    std::map<uint32_t, Pong>::iterator it = _pongs.find(key);
+    if (it == _pongs.end()) {
+        return;
+    }
+    Pong &pong = it->second;
+    if (hwNs != 0) {
+        pong.txHwNs = hwNs;
+        for (unsigned int i = 0; i < _turnarounds.size(); i++) {
+            if (_turnarounds[i].key == key && pong.rxHwNs != 0) {
+                _turnarounds[i].hwNs = hwNs - pong.rxHwNs;
+            }
+        }
+    }
+    if (swNs != 0) {
+        Turnaround turnaround;
+        turnaround.key = key;
+        turnaround.pingId = pong.pingId;
+        turnaround.swNs = swNs - pong.rxSwNs;
+        turnaround.hwNs = (pong.txHwNs != 0 && pong.rxHwNs != 0)
+                ? pong.txHwNs - pong.rxHwNs
+                : 0;
+        _turnarounds.push_back(turnaround);
+        if (_turnarounds.size() > RTIPERFTEST_PACKET_TIMESTAMP_PENDING_MAX) {
+            _turnarounds.pop_front();
+        }
+    }
+}
+
+void PacketTimestamps::on_datagram_received(
+        const PacketTimestampTrailer &trailer,
+        int64_t swNs,
+        int64_t hwNs)
+{
+    int64_t userNs = timestamp_now_ns();
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_isPublisher) {
+        if (trailer.kind == RTIPERFTEST_PACKET_TIMESTAMP_PING) {
+            _pingReceived = true;
+            _lastPingId = trailer.pingId;
+            _lastPingRxSwNs = swNs;
+            _lastPingRxHwNs = hwNs;
+            _lastPingUserNs = userNs;
+        }
+        return;
+    }
+
+    if (trailer.kind != RTIPERFTEST_PACKET_TIMESTAMP_PONG) {
+        return;
+    }
+
+    std::map<uint64_t, Ping>::iterator it = _pings.find(trailer.pingId);
+    if (it != _pings.end() && swNs != 0) {
+        it->second.rxSwNs = swNs;
+        it->second.rxHwNs = hwNs;
+        it->second.userReceiveNs = userNs;
+        it->second.subKernelToUserNs = trailer.kernelToUserNs;
+        it->second.pongReceived = true;
+        complete_ping(it);
+    }
+
+    it = _pings.find(trailer.turnaroundPingId);
+    if (it != _pings.end()) {
+        it->second.subTurnaroundSwNs = trailer.turnaroundSwNs;
+        it->second.subTurnaroundHwNs = trailer.turnaroundHwNs;
+        it->second.turnaroundReceived = true;
+        complete_ping(it);
+    }
+}
+
+void PacketTimestamps::complete_ping(std::map<uint64_t, Ping>::iterator it)
+{
+    const Ping &ping = it->second;
+    if (!ping.pongReceived || !ping.turnaroundReceived || ping.txSwNs == 0) {
+        return;
+    }
+
+    /*
+     * The components add up to the round trip: the subscriber times are
+     * differences of its own clock, the rest use the clock of the publisher.
+     */
+    int64_t wireNs = ping.rxSwNs - ping.txSwNs - ping.subTurnaroundSwNs;
+    if (ping.txHwNs != 0 && ping.rxHwNs != 0 && ping.subTurnaroundHwNs != 0) {
+        wireNs = ping.rxHwNs - ping.txHwNs - ping.subTurnaroundHwNs;
+        _hardwareWireCount++;
+    }
+
+    _components[PUB_SEND_PATH].add(ping.txSwNs - ping.userSendNs);
+    _components[WIRE].add(wireNs);
+    _components[SUB_KERNEL_TO_USER].add(ping.subKernelToUserNs);
+    _components[SUB_USER_TO_KERNEL].add(
+            ping.subTurnaroundSwNs - ping.subKernelToUserNs);
+    _components[PUB_KERNEL_TO_USER].add(ping.userReceiveNs - ping.rxSwNs);
+
+    _pings.erase(it);
+}
+
+void PacketTimestamps::print()
+{
+    static const char *names[COMPONENT_COUNT] = {
+        "Publisher user to kernel TX",
+        "Wire, both ways (kernel to kernel)",
+        "Subscriber kernel RX to user",
+        "Subscriber user to kernel TX",
+        "Publisher kernel RX to user"
+    };
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    unsigned long long count = _components[WIRE].count;
+    if (!_isPublisher) {
+        return;
+    } else if (count == 0) {
+        printf("Packet timestamps: No ping got all its timestamps\n");
+        return;
+    }
+
+    printf("Packet timestamps: %llu pings, wire time from %s timestamps\n",
+           count,
+           _hardwareWireCount == count
+                   ? "hardware"
+                   : (_hardwareWireCount == 0 ? "software" : "mixed"));
+    printf("%-36s %10s %10s %10s\n",
+           "Round trip component (us)",
+           "Ave",
+           "Min",
+           "Max");
+    for (unsigned int i = 0; i < COMPONENT_COUNT; i++) {
+        printf("%-36s %10.2f %10.2f %10.2f\n",
+               names[i],
+               _components[i].sumNs / _components[i].count / 1000.0,
+               _components[i].minNs / 1000.0,
+               _components[i].maxNs / 1000.0);
+    }
+}
+
+#endif // RTI_PERFTEST_IO_URING
@@ -0,0 +1,443 @@
+#ifndef __RTIIoUringEngine_H__
+#define __RTIIoUringEngine_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+/*
+ * The engine needs the io_uring headers of Linux 6.0 or newer (provided
+ * buffer rings, multishot receive and synchronous cancel). Some of them are
+ * enum values, so the macros added in the same releases are checked instead.
+ * RTI_PERFTEST_IO_URING is only defined if they are available.
+ */
+#if defined(RTI_LINUX) && defined(__has_include)
+  #if __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #if defined(IORING_ASYNC_CANCEL_ANY) && defined(IORING_RECV_MULTISHOT)
+      #define RTI_PERFTEST_IO_URING
+    #endif
+  #endif
+#endif
+
+#ifdef RTI_PERFTEST_IO_URING
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/*
+ * Same size used by default by the UDPv4 transport plugin for the send and
+ * receive socket buffers, so both engines can be compared.
+ */
+#define RTIPERFTEST_IO_URING_SOCKET_BUFFER_SIZE 131072
+
+/* Maximum size of a UDP datagram, rounded up to a page */
+#define RTIPERFTEST_IO_URING_DATAGRAM_SIZE_MAX 65536
+
+/* Counters of the work done by an io_uring instance */
+struct IoUringStats {
+    IoUringStats() : submissions(0), completions(0), syscalls(0) {}
+
+    /* Number of SQEs handed to the kernel */
+    unsigned long long submissions;
+    /* Number of CQEs consumed */
+    unsigned long long completions;
+    /* Number of io_uring_enter() calls */
+    unsigned long long syscalls;
+};
+
+/*
+ * Trailer appended to the datagrams carrying pings and pongs when packet
+ * timestamps are enabled. The times are measured with the clock of the
+ * subscriber, so the publisher can subtract them from its own without
+ * synchronizing both clocks.
+ */
+struct PacketTimestampTrailer {
+    /* Ping sent or answered */
+    uint64_t pingId;
+    /* Pongs: subscriber kernel RX to user time of the ping answered */
+    int64_t kernelToUserNs;
+    /*
+     * Pongs: subscriber kernel RX of a previous ping to kernel TX of its
+     * pong. The TX timestamp is only known once the pong is sent, so it
+     * travels with the next pong.
+     */
+    uint64_t turnaroundPingId;
+    int64_t turnaroundSwNs;
+    int64_t turnaroundHwNs;
+    uint32_t kind;
+    uint32_t magic;
+};
+
+/*
+ * Kernel (SO_TIMESTAMPING) timestamps of the pings and pongs. They split the
+ * round trip measured by the publisher in the time spent in the kernel send
+ * path, on the wire and in the kernel receive path until the application
+ * gets the datagram.
+ *
+ * Software timestamps are always used to compare with the application time.
+ * Hardware timestamps (only if the NIC has them enabled, e.g. by ptp4l) are
+ * used for the wire component when they are available for every packet.
+ *
+ * The writers and readers of a process share the same instance.
+ */
+class PacketTimestamps {
+  public:
+    explicit PacketTimestamps(bool isPublisher);
+
+    /*
+     * Fill the trailer of a datagram about to be sent: a ping in the
+     * publisher, a pong in the subscriber.
+     */
+    void on_datagram_sent(PacketTimestampTrailer &trailer);
+
+    /*
+     * TX timestamp read from the error queue of the socket. The key is the
+     * number of timestamped datagrams sent before (SOF_TIMESTAMPING_OPT_ID).
+     * A time of 0 means that it is not available.
+     */
+    void on_tx_timestamp(uint32_t key, int64_t swNs, int64_t hwNs);
+
+    /* A datagram with a trailer was received at the given kernel times */
+    void on_datagram_received(
+            const PacketTimestampTrailer &trailer,
+            int64_t swNs,
+            int64_t hwNs);
+
+    /* Publisher: print the components of the round trip */
+    void print();
+
+  private:
+    struct Ping {
+        Ping();
+
+        int64_t userSendNs;
+        int64_t txSwNs;
+        int64_t txHwNs;
+        int64_t rxSwNs;
+        int64_t rxHwNs;
+        int64_t userReceiveNs;
+        int64_t subKernelToUserNs;
+        int64_t subTurnaroundSwNs;
+        int64_t subTurnaroundHwNs;
+        bool pongReceived;
+        bool turnaroundReceived;
+    };
+
+    struct Pong {
+        uint64_t pingId;
+        int64_t rxSwNs;
+        int64_t rxHwNs;
+        int64_t txHwNs;
+    };
+
+    struct Turnaround {
+        uint32_t key;
+        uint64_t pingId;
+        int64_t swNs;
+        int64_t hwNs;
+    };
+
+    struct Component {
+        Component();
+        void add(int64_t ns);
+
+        unsigned long long count;
+        double sumNs;
+        int64_t minNs;
+        int64_t maxNs;
+    };
+
+    enum {
+        PUB_SEND_PATH,
+        WIRE,
+        SUB_KERNEL_TO_USER,
+        SUB_USER_TO_KERNEL,
+        PUB_KERNEL_TO_USER,
+        COMPONENT_COUNT
+    };
+
+    /* Account the ping if every timestamp is known */
+    void complete_ping(std::map<uint64_t, Ping>::iterator it);
+
+    std::mutex _mutex;
+    bool _isPublisher;
+    /* Key of the next timestamped datagram */
+    uint32_t _nextKey;
+
+    /* --- Publisher --- */
+    std::map<uint64_t, Ping> _pings;
+    Component _components[COMPONENT_COUNT];
+    unsigned long long _hardwareWireCount;
+
+    /* --- Subscriber --- */
+    bool _pingReceived;
+    uint64_t _lastPingId;
+    int64_t _lastPingRxSwNs;
+    int64_t _lastPingRxHwNs;
+    int64_t _lastPingUserNs;
+    /* Pongs sent waiting for their TX timestamp, by key */
+    std::map<uint32_t, Pong> _pongs;
+    /* Turnarounds waiting to be sent with the next pong */
+    std::deque<Turnaround> _turnarounds;
+};
+
+/*
+ * Minimal io_uring wrapper on top of the raw system calls (liburing is not
+ * required). It is not thread safe: every instance is used by a single
+ * writer or reader.
+ */
+class IoUring {
+  public:
+    IoUring();
+    ~IoUring();
+
+    /*
+     * Create the ring. If sqPoll is true a kernel thread polls the submission
+     * queue, so submitting does not need a system call while it is awake.
+     */
+    bool initialize(unsigned int entries, unsigned int cqEntries, bool sqPoll);
+    void finalize();
+
+    /* Get a free SQE, submitting the queued ones if the queue is full */
+    struct io_uring_sqe *get_sqe();
+
+    /*
+     * Make the queued SQEs visible to the kernel, entering it only if
+     * needed. If waitNr > 0, wait until there are that many CQEs.
+     */
+    bool submit(unsigned int waitNr = 0);
+
+    /* Get the next CQE without blocking, NULL if there is none */
+    struct io_uring_cqe *peek_cqe();
+
+    /* Get the next CQE, blocking until there is one */
+    struct io_uring_cqe *wait_cqe();
+
+    /* Mark the CQE returned by peek_cqe() or wait_cqe() as consumed */
+    void cqe_seen();
+
+    /* Number of SQEs queued and not submitted yet */
+    unsigned int get_queued_count()
+    {
+        return _sqeTail - _sqeSubmitted;
+    }
+
+    bool register_files(const int *fds, unsigned int count);
+    bool register_buffers(const struct iovec *iovecs, unsigned int count);
+    bool register_buffer_ring(
+            struct io_uring_buf_ring *ring,
+            unsigned int entries,
+            unsigned short groupId);
+
+    const IoUringStats &get_stats()
+    {
+        return _stats;
+    }
+
+  private:
+    int enter(unsigned int toSubmit, unsigned int waitNr, unsigned int flags);
+    bool do_register(unsigned int opcode, const void *arg, unsigned int count);
+
+    int _fd;
+    bool _sqPoll;
+    IoUringStats _stats;
+
+    /* Submission queue */
+    unsigned int *_sqHead;
+    unsigned int *_sqTail;
+    unsigned int *_sqFlags;
+    unsigned int _sqMask;
+    unsigned int _sqEntries;
+    struct io_uring_sqe *_sqes;
+    /* Local tail, SQEs up to _sqeSubmitted are visible to the kernel */
+    unsigned int _sqeTail;
+    unsigned int _sqeSubmitted;
+
+    /* Completion queue */
+    unsigned int *_cqHead;
+    unsigned int *_cqTail;
+    unsigned int _cqMask;
+    struct io_uring_cqe *_cqes;
+
+    void *_sqRing;
+    size_t _sqRingSize;
+    void *_cqRing;
+    size_t _cqRingSize;
+    size_t _sqesSize;
+};
+
+/*
+ * Sends datagrams to a list of peers. The datagrams are built in a set of
+ * slots registered with the kernel (fixed buffers) and sent with
+ * IORING_OP_WRITE_FIXED on one connected socket per peer (fixed files).
+ * Several datagrams can be queued before submitting them all at once.
+ */
+class IoUringSender {
+  public:
+    IoUringSender();
+    ~IoUringSender();
+
+    bool initialize(
+            const std::vector<struct sockaddr_in> &peers,
+            const struct in_addr &interfaceAddr,
+            unsigned int slotCount,
+            unsigned int slotSize,
+            bool sqPoll,
+            bool nonBlocking,
+            PacketTimestamps *timestamps = NULL);
+    void finalize();
+
+    /*
+     * Get the buffer of the next slot, waiting until the previous sends using
+     * it are completed. NULL in case of error.
+     */
+    char *get_buffer();
+
+    unsigned int get_buffer_size()
+    {
+        return _payloadSize;
+    }
+
+    /*
+     * Queue the send of the first length bytes of the buffer returned by
+     * get_buffer() to every peer. The sends are submitted when half of the
+     * slots are queued or when submit() is called.
+     *
+     * If timestamped is true and packet timestamps are enabled, a trailer is
+     * appended and the kernel is asked for the TX timestamp of the datagram
+     * sent to the first peer.
+     */
+    bool send_buffer(unsigned int length, bool timestamped = false);
+
+    bool submit();
+
+    const IoUringStats &get_stats()
+    {
+        return _ring.get_stats();
+    }
+
+  private:
+    /* Consume the available CQEs, if wait is true at least one */
+    bool reap_completions(bool wait);
+
+    /* Pass the TX timestamps in the error queue of the first socket */
+    void read_tx_timestamps();
+
+    IoUring _ring;
+    std::vector<int> _sockets;
+    char *_buffers;
+    size_t _buffersSize;
+    unsigned int _slotCount;
+    unsigned int _slotSize;
+    /* Size available for the samples, the rest is left for the trailer */
+    unsigned int _payloadSize;
+    unsigned int _currentSlot;
+    /* Number of sends not completed yet per slot */
+    std::vector<unsigned int> _pendingSends;
+    unsigned int _pendingSendCount;
+    bool _sqPoll;
+    bool _nonBlocking;
+
+    /* --- Packet timestamps --- */
+    PacketTimestamps *_timestamps;
+    /* Message and control data of the timestamped sendmsg of every slot */
+    std::vector<struct msghdr> _messages;
+    std::vector<struct iovec> _iovecs;
+    std::vector<char> _controls;
+};
+
+/*
+ * Receives datagrams from a UDP port with a multishot receive, so the socket
+ * only needs to be armed once. The kernel picks the buffer for every
+ * datagram from a ring of provided buffers (registered with the kernel) and
+ * the application gives it back once the datagram is processed.
+ */
+class IoUringReceiver {
+  public:
+    IoUringReceiver();
+    ~IoUringReceiver();
+
+    /*
+     * Bind to the port. If multicastAddr is not INADDR_ANY, join that group
+     * in the interface interfaceAddr.
+     *
+     * If timestamps is not NULL the datagrams are received with their kernel
+     * RX timestamp and the trailers are removed and passed to it.
+     */
+    bool initialize(
+            unsigned short port,
+            const struct in_addr &multicastAddr,
+            const struct in_addr &interfaceAddr,
+            unsigned int bufferCount,
+            bool sqPoll,
+            PacketTimestamps *timestamps = NULL);
+    void finalize();
+
+    /*
+     * Get the next datagram, blocking until there is one. The datagram is
+     * valid until the next call. A length of 0 means that the receiver was
+     * unblocked.
+     */
+    bool receive(char *&data, unsigned int &length);
+
+    /* Unblock the thread waiting in receive() */
+    bool unblock();
+
+    const IoUringStats &get_stats()
+    {
+        return _ring.get_stats();
+    }
+
+  private:
+    bool arm_receive();
+    void return_buffer(unsigned short bufferId);
+
+    /*
+     * Parse the output of a recvmsg into a provided buffer, leaving data and
+     * length pointing to the payload without the trailer.
+     */
+    void process_timestamps(char *&data, unsigned int &length);
+
+    IoUring _ring;
+    int _socket;
+    /* Address used to send the datagram that unblocks the receiver */
+    struct sockaddr_in _unblockAddr;
+    struct in_addr _unblockInterface;
+    struct io_uring_buf_ring *_bufferRing;
+    size_t _bufferRingSize;
+    char *_buffers;
+    size_t _buffersSize;
+    unsigned int _bufferCount;
+    unsigned short _bufferRingTail;
+    /* Buffer of the last datagram returned, -1 if none */
+    int _currentBuffer;
+    bool _armed;
+    /* Size of every provided buffer */
+    unsigned int _bufferSize;
+
+    /* --- Packet timestamps --- */
+    PacketTimestamps *_timestamps;
+    /* Layout of the recvmsg output in the provided buffers */
+    struct msghdr _message;
+};
+
+/*
+ * Get the IPv4 address of an interface given either its address or its
+ * name. Return false if no interface matches.
+ */
+bool io_uring_get_interface_address(
+        const std::string &interfaceName,
+        struct in_addr &addr);
+
+#endif // RTI_PERFTEST_IO_URING
+
+#endif // __RTIIoUringEngine_H__
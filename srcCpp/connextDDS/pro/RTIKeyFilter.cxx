@@ -0,0 +1,220 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "RTIKeyFilter.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include "perftest.h"
+
+/* Number of clock reads used to estimate the cost of timing an evaluation */
+#define RTI_KEY_FILTER_CLOCK_CALIBRATION_COUNT 1000
+
+RTIKeyFilter::RTIKeyFilter(
+        size_t keyOffset,
+        int keyMemberId,
+        bool collectStats)
+        : _keyOffset(keyOffset),
+          _keyMemberId(keyMemberId),
+          _collectStats(collectStats),
+          _evaluations(0),
+          _passed(0),
+          _evaluationNs(0),
+          _firstEvaluationNs(0),
+          _lastEvaluationNs(0),
+          _clockOverheadNs(0)
+{
+    if (_collectStats) {
+        long long overheadNs = 0;
+        for (int i = 0; i < RTI_KEY_FILTER_CLOCK_CALIBRATION_COUNT; i++) {
+            long long start = now_ns();
+            overheadNs += now_ns() - start;
+        }
+        _clockOverheadNs = overheadNs / RTI_KEY_FILTER_CLOCK_CALIBRATION_COUNT;
+    }
+}
+
+long long RTIKeyFilter::now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+DDS_ReturnCode_t RTIKeyFilter::compile(
+        void **new_compile_data,
+        const char *expression,
+        const DDS_StringSeq &parameters,
+        const DDS_TypeCode *type_code,
+        const char *type_class_name,
+        void *old_compile_data)
+{
+    bool isSet = false;
+    if (expression != NULL
+            && strcmp(expression, RTI_KEY_FILTER_SET_EXPRESSION) == 0) {
+        isSet = true;
+    } else if (expression == NULL
+            || strcmp(expression, RTI_KEY_FILTER_RANGE_EXPRESSION) != 0) {
+        fprintf(stderr,
+                "[Error] RTIKeyFilter: Unknown expression '%s'\n",
+                expression == NULL ? "" : expression);
+        return DDS_RETCODE_BAD_PARAMETER;
+    }
+
+    std::vector<unsigned long> keys;
+    for (int i = 0; i < parameters.length(); i++) {
+        const char *parameter = parameters[i];
+        char *end = NULL;
+        /*
+         * Any key of the 4 bytes of the type. MAX_CFT_VALUE may be in the
+         * filter, it passes every filter anyway.
+         */
+        errno = 0;
+        unsigned long long key = strtoull(parameter, &end, 10);
+        if (end == parameter || *end != '\0' || errno == ERANGE
+                || key > 0xFFFFFFFFULL) {
+            fprintf(stderr,
+                    "[Error] RTIKeyFilter: Wrong key '%s'\n",
+                    parameter);
+            return DDS_RETCODE_BAD_PARAMETER;
+        }
+        keys.push_back((unsigned long) key);
+    }
+
+    if (keys.empty() || (!isSet && (keys.size() != 2 || keys[0] > keys[1]))) {
+        fprintf(stderr,
+                "[Error] RTIKeyFilter: '%s' got a wrong number of keys (%lu)\n",
+                expression,
+                (unsigned long) keys.size());
+        return DDS_RETCODE_BAD_PARAMETER;
+    }
+
+    CompiledFilter *filter = new CompiledFilter();
+    filter->first = *std::min_element(keys.begin(), keys.end());
+    filter->last = *std::max_element(keys.begin(), keys.end());
+    if (isSet) {
+        filter->bitmap.assign((filter->last - filter->first) / 8 + 1, 0);
+        for (unsigned int i = 0; i < keys.size(); i++) {
+            unsigned long bit = keys[i] - filter->first;
+            filter->bitmap[bit >> 3] |= (unsigned char) (1 << (bit & 7));
+        }
+    }
+
+    /* The filter is compiled again when the parameters change */
+    if (old_compile_data != NULL) {
+        delete (CompiledFilter *) old_compile_data;
+    }
+    *new_compile_data = filter;
+
+    return DDS_RETCODE_OK;
+}
+
+bool RTIKeyFilter::get_key(const void *sample, unsigned long &key)
+{
+    const DDS_Octet *octets = (const DDS_Octet *) sample + _keyOffset;
+    DDS_Octet dynamicKey[KEY_SIZE];
+
+    if (_keyMemberId != -1) {
+        DDS_UnsignedLong length = KEY_SIZE;
+        if (((DDS_DynamicData *) sample)->get_octet_array(
+                    dynamicKey,
+                    &length,
+                    NULL,
+                    _keyMemberId)
+                != DDS_RETCODE_OK) {
+            return false;
+        }
+        octets = dynamicKey;
+    }
+
+    /* Same encoding used by the writers: least significant byte first */
+    key = (unsigned long) octets[0]
+            | (unsigned long) octets[1] << 8
+            | (unsigned long) octets[2] << 16
+            | (unsigned long) octets[3] << 24;
+    return true;
+}
+
+bool RTIKeyFilter::matches(const CompiledFilter &filter, const void *sample)
+{
+    unsigned long key = 0;
+    if (!get_key(sample, key)) {
+        return false;
+    }
+
+    if (key == MAX_CFT_VALUE) {
+        return true;
+    } else if (key < filter.first || key > filter.last) {
+        return false;
+    } else if (filter.bitmap.empty()) {
+        return true;
+    }
+
+    unsigned long bit = key - filter.first;
+    return (filter.bitmap[bit >> 3] & (1 << (bit & 7))) != 0;
+}
+
+DDS_Boolean RTIKeyFilter::evaluate(
+        void *compile_data,
+        const void *sample,
+        const struct DDS_FilterSampleInfo *meta_data)
+{
+    const CompiledFilter &filter = *(const CompiledFilter *) compile_data;
+
+    if (!_collectStats) {
+        return matches(filter, sample) ? DDS_BOOLEAN_TRUE : DDS_BOOLEAN_FALSE;
+    }
+
+    long long start = now_ns();
+    bool passed = matches(filter, sample);
+    long long end = now_ns();
+
+    _evaluations.fetch_add(1, std::memory_order_relaxed);
+    if (passed) {
+        _passed.fetch_add(1, std::memory_order_relaxed);
+    }
+    _evaluationNs.fetch_add(
+            (unsigned long long) std::max(end - start - _clockOverheadNs, 0LL),
+            std::memory_order_relaxed);
+    long long notSet = 0;
+    _firstEvaluationNs.compare_exchange_strong(notSet, start);
+    _lastEvaluationNs.store(end, std::memory_order_relaxed);
+
+    return passed ? DDS_BOOLEAN_TRUE : DDS_BOOLEAN_FALSE;
+}
+
+void RTIKeyFilter::finalize(void *compile_data)
+{
+    delete (CompiledFilter *) compile_data;
+}
+
+void RTIKeyFilter::print_stats(const char *side)
+{
+    if (!_collectStats) {
+        return;
+    }
+
+    unsigned long long evaluations = _evaluations.load();
+    if (evaluations == 0) {
+        printf("CFT key filter (%s): No evaluations\n", side);
+        return;
+    }
+
+    /* Time between the first and the last evaluation */
+    double windowNs = (double) (_lastEvaluationNs.load()
+            - _firstEvaluationNs.load());
+    double evaluationNs = (double) _evaluationNs.load();
+
+    printf("CFT key filter (%s): %llu evaluations (%.1f%% passed), "
+           "%.0f evaluations/s, %.1f ns per evaluation, %.2f%% of a core\n",
+           side,
+           evaluations,
+           100.0 * _passed.load() / evaluations,
+           windowNs > 0 ? evaluations * 1000000000.0 / windowNs : 0.0,
+           evaluationNs / evaluations,
+           windowNs > 0 ? 100.0 * evaluationNs / windowNs : 0.0);
+}
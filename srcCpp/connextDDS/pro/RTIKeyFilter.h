@@ -0,0 +1,89 @@
+#ifndef __RTIKEYFILTER_H__
+#define __RTIKEYFILTER_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+#include "ndds/ndds_cpp.h"
+
+/* Name of the filter, registered in every participant */
+#define RTI_KEY_FILTER_NAME "PerftestKeyFilter"
+
+/*
+ * Expressions understood by the filter. The parameters are the first and last
+ * keys of the range, or the keys of the set.
+ */
+#define RTI_KEY_FILTER_RANGE_EXPRESSION "key range"
+#define RTI_KEY_FILTER_SET_EXPRESSION "key set"
+
+/*
+ * Content filter for the key of the Perftest types. It replaces the SQL
+ * expression comparing the key byte by byte: the key is decoded once and
+ * checked against a range, or against a bitmap for a set of keys. The
+ * internal messages (sent with the key MAX_CFT_VALUE) pass every filter.
+ *
+ * The same instance evaluates the filters of the local readers (reader side)
+ * and, in the writers, the filters of the remote readers (writer side).
+ */
+class RTIKeyFilter : public DDSContentFilter {
+  public:
+    /*
+     * keyOffset is the offset of the key in the samples of the type. If
+     * keyMemberId is not -1 the samples are DDS_DynamicData and the key is
+     * got with that member id. If collectStats is true the evaluations are
+     * counted and timed.
+     */
+    RTIKeyFilter(size_t keyOffset, int keyMemberId, bool collectStats);
+
+    DDS_ReturnCode_t compile(
+            void **new_compile_data,
+            const char *expression,
+            const DDS_StringSeq &parameters,
+            const DDS_TypeCode *type_code,
+            const char *type_class_name,
+            void *old_compile_data);
+
+    DDS_Boolean evaluate(
+            void *compile_data,
+            const void *sample,
+            const struct DDS_FilterSampleInfo *meta_data);
+
+    void finalize(void *compile_data);
+
+    /* Print the evaluations done, side is "writer side" or "reader side" */
+    void print_stats(const char *side);
+
+  private:
+    struct CompiledFilter {
+        unsigned long first;
+        unsigned long last;
+        /* One bit per key from first to last, empty for a range */
+        std::vector<unsigned char> bitmap;
+    };
+
+    bool get_key(const void *sample, unsigned long &key);
+    bool matches(const CompiledFilter &filter, const void *sample);
+
+    /* Current time in ns, only used with collectStats */
+    static long long now_ns();
+
+    size_t _keyOffset;
+    int _keyMemberId;
+    bool _collectStats;
+
+    /* --- Statistics --- */
+    std::atomic<unsigned long long> _evaluations;
+    std::atomic<unsigned long long> _passed;
+    std::atomic<unsigned long long> _evaluationNs;
+    std::atomic<long long> _firstEvaluationNs;
+    std::atomic<long long> _lastEvaluationNs;
+    /* Time added by reading the clock twice, subtracted from every sample */
+    long long _clockOverheadNs;
+};
+
+#endif // __RTIKEYFILTER_H__
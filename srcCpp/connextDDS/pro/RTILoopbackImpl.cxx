@@ -0,0 +1,286 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "RTILoopbackImpl.h"
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <thread>
+
+/*********************************************************
+ * Constructor
+ */
+RTILoopbackImpl::RTILoopbackImpl()
+        : _pongSemaphore(NULL),
+          _PM(NULL)
+{
+}
+
+/*********************************************************
+ * shutdown
+ */
+void RTILoopbackImpl::shutdown()
+{
+    if (_pongSemaphore != NULL) {
+        PerftestSemaphore_delete(_pongSemaphore);
+        _pongSemaphore = NULL;
+    }
+}
+
+/*********************************************************
+ * validate_input
+ */
+bool RTILoopbackImpl::validate_input()
+{
+    if (_PM->get<bool>("rawTransport") || _PM->get<bool>("shmRing")) {
+        fprintf(stderr,
+                "-loopback cannot be used with -rawTransport or -shmRing.\n");
+        return false;
+    }
+
+    // Manage parameter -batchSize
+    if (_PM->is_set("batchSize") && _PM->get<long>("batchSize") > 0) {
+        fprintf(stderr, "Batching is not supported with -loopback.\n");
+        return false;
+    }
+    _PM->set<long>("batchSize", 0);
+
+    return true;
+}
+
+/*********************************************************
+ * PrintConfiguration
+ */
+std::string RTILoopbackImpl::print_configuration()
+{
+    std::ostringstream stringStream;
+
+    // Middleware
+    stringStream << "\tMiddleware: Loopback (in-process, no middleware)\n";
+
+    if (_PM->get<bool>("pub")) {
+        stringStream << "\tSubscriber threads: "
+                     << _PM->get<int>("numSubscribers") << "\n";
+    }
+
+    return stringStream.str();
+}
+
+/*********************************************************
+ * Initialize
+ */
+bool RTILoopbackImpl::initialize(ParameterManager &PM, perftest_cpp *parent)
+{
+    /* Set parameter manager */
+    _PM = &PM;
+
+    if (!validate_input()) {
+        return false;
+    }
+
+    /* Only if we run latency test we need to wait for pongs after sending pings */
+    if (_PM->get<bool>("latencyTest")) {
+        _pongSemaphore = PerftestSemaphore_new();
+        if (_pongSemaphore == NULL) {
+            fprintf(stderr, "Fail to create a Semaphore for RTILoopbackImpl\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+LoopbackTopic *RTILoopbackImpl::get_topic(const char *topicName)
+{
+    static std::mutex topicsMutex;
+    static std::map<std::string, LoopbackTopic *> topics;
+
+    std::lock_guard<std::mutex> lock(topicsMutex);
+    LoopbackTopic *&topic = topics[topicName];
+    if (topic == NULL) {
+        topic = new LoopbackTopic();
+    }
+    return topic;
+}
+
+/*********************************************************
+ * RTILoopbackPublisher
+ */
+class RTILoopbackPublisher : public IMessagingWriter {
+  private:
+    LoopbackTopic *_topic;
+    /* Copy of the readers of the topic, and its version */
+    std::vector<IMessagingCB *> _readers;
+    unsigned int _readersVersion;
+    TestMessage _message;
+    PerftestSemaphore *_pongSemaphore;
+
+  public:
+    RTILoopbackPublisher(RTILoopbackImpl *parent, const char *topicName)
+            : _topic(RTILoopbackImpl::get_topic(topicName)),
+              _readersVersion(0),
+              _pongSemaphore(parent->get_pong_semaphore())
+    {
+        _topic->writerCount.fetch_add(1);
+        update_readers();
+    }
+
+    ~RTILoopbackPublisher()
+    {
+        _topic->writerCount.fetch_sub(1);
+    }
+
+    void update_readers()
+    {
+        std::lock_guard<std::mutex> lock(_topic->mutex);
+        _readers = _topic->readers;
+        _readersVersion = _topic->version.load();
+    }
+
+    /*
+     * The sample is delivered to the listener of every reader in the context
+     * of the calling thread. Every listener gets its own copy of the message
+     * header, the data buffer is shared.
+     */
+    bool send(const TestMessage &message, bool isCftWildCardKey)
+    {
+        _topic->dispatching.fetch_add(1);
+        if (_topic->version.load() != _readersVersion) {
+            update_readers();
+        }
+        for (unsigned int i = 0; i < _readers.size(); i++) {
+            _message = message;
+            _readers[i]->process_message(_message);
+        }
+        _topic->dispatching.fetch_sub(1);
+        return true;
+    }
+
+    void flush()
+    {
+        /* Samples are delivered as soon as they are sent */
+    }
+
+    void wait_for_readers(int numSubscribers)
+    {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(_topic->mutex);
+                if ((int) _topic->readers.size() >= numSubscribers) {
+                    return;
+                }
+            }
+            PerftestClock::milliSleep(PERFTEST_DISCOVERY_TIME_MSEC);
+        }
+    }
+
+    bool wait_for_ping_response()
+    {
+        if (_pongSemaphore != NULL
+                && !PerftestSemaphore_take(
+                        _pongSemaphore,
+                        PERFTEST_SEMAPHORE_TIMEOUT_INFINITE)) {
+            fprintf(stderr, "Unexpected error taking semaphore\n");
+            return false;
+        }
+        return true;
+    }
+
+    /* time out in milliseconds */
+    bool wait_for_ping_response(int timeout)
+    {
+        if (_pongSemaphore != NULL
+                && !PerftestSemaphore_take(_pongSemaphore, timeout)) {
+            fprintf(stderr, "Unexpected error taking semaphore\n");
+            return false;
+        }
+        return true;
+    }
+
+    bool notify_ping_response()
+    {
+        if (_pongSemaphore != NULL
+                && !PerftestSemaphore_give(_pongSemaphore)) {
+            fprintf(stderr, "Unexpected error giving semaphore\n");
+            return false;
+        }
+        return true;
+    }
+};
+
+/*********************************************************
+ * RTILoopbackSubscriber
+ */
+class RTILoopbackSubscriber : public IMessagingReader {
+  private:
+    LoopbackTopic *_topic;
+    IMessagingCB *_callback;
+
+  public:
+    RTILoopbackSubscriber(const char *topicName, IMessagingCB *callback)
+            : _topic(RTILoopbackImpl::get_topic(topicName)),
+              _callback(callback)
+    {
+        std::lock_guard<std::mutex> lock(_topic->mutex);
+        _topic->readers.push_back(_callback);
+        _topic->version.fetch_add(1);
+    }
+
+    /*
+     * After removing the reader, wait until no writer is delivering a sample,
+     * since they could be using the previous list of readers.
+     */
+    ~RTILoopbackSubscriber()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_topic->mutex);
+            _topic->readers.erase(std::remove(
+                    _topic->readers.begin(),
+                    _topic->readers.end(),
+                    _callback),
+                    _topic->readers.end());
+            _topic->version.fetch_add(1);
+        }
+        while (_topic->dispatching.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    /* Samples are always delivered to the listener */
+    TestMessage *receive_message()
+    {
+        return NULL;
+    }
+
+    void wait_for_writers(int numPublishers)
+    {
+        while ((int) _topic->writerCount.load() < numPublishers) {
+            PerftestClock::milliSleep(PERFTEST_DISCOVERY_TIME_MSEC);
+        }
+    }
+};
+
+/*********************************************************
+ * CreateWriter
+ */
+IMessagingWriter *RTILoopbackImpl::create_writer(const char *topicName)
+{
+    return new RTILoopbackPublisher(this, topicName);
+}
+
+/*********************************************************
+ * CreateReader
+ */
+IMessagingReader *
+RTILoopbackImpl::create_reader(const char *topicName, IMessagingCB *callback)
+{
+    if (callback == NULL) {
+        fprintf(stderr,
+                "RTILoopbackImpl::create_reader(): -loopback only supports "
+                "listeners.\n");
+        return NULL;
+    }
+    return new RTILoopbackSubscriber(topicName, callback);
+}
@@ -0,0 +1,65 @@
+#ifndef __RTILoopbackImpl_H__
+#define __RTILoopbackImpl_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MessagingIF.h"
+#include "perftest_cpp.h"
+
+/*
+ * A topic shared by all the RTILoopbackImpl instances of the process (the
+ * publisher and the subscribers running as threads).
+ *
+ * The writers keep their own copy of the list of readers and only copy it
+ * again when the version changes, so sending a sample takes no lock.
+ */
+class LoopbackTopic {
+  public:
+    LoopbackTopic() : version(0), writerCount(0), dispatching(0) {}
+
+    /* Protects readers */
+    std::mutex mutex;
+    std::vector<IMessagingCB *> readers;
+    std::atomic<unsigned int> version;
+    std::atomic<unsigned int> writerCount;
+    /* Number of samples being delivered to the readers */
+    std::atomic<unsigned int> dispatching;
+};
+
+class RTILoopbackImpl : public IMessaging {
+  public:
+    RTILoopbackImpl();
+    ~RTILoopbackImpl() { shutdown(); }
+    bool validate_input();
+    std::string print_configuration();
+    bool initialize(ParameterManager &PM, perftest_cpp *parent);
+    void shutdown();
+
+    bool supports_listeners() {return true;}
+
+    IMessagingWriter *create_writer(const char *topic_name);
+
+    IMessagingReader *
+    create_reader(const char *topic_name, IMessagingCB *callback);
+
+    /*------------------------------- Getters --------------------------------*/
+    unsigned long get_initial_burst_size()  {return 0;}
+    PerftestSemaphore *get_pong_semaphore() {return _pongSemaphore;}
+    /*------------------------------------------------------------------------*/
+
+    /* Get the topic, creating it the first time. Topics are never deleted */
+    static LoopbackTopic *get_topic(const char *topicName);
+
+  private:
+    PerftestSemaphore *_pongSemaphore;
+    ParameterManager *_PM;
+};
+
+#endif // __RTILoopbackImpl_H__
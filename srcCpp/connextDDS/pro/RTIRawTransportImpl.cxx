@@ -6,6 +6,10 @@
 
 #include "RTIRawTransportImpl.h"
 
+#ifdef RTI_LINUX
+#include <arpa/inet.h>
+#endif
+
 #if defined(RTI_WIN32) || defined(RTI_INTIME)
 #pragma warning(push)
 #pragma warning(disable : 4996)
@@ -27,6 +31,10 @@ RTIRawTransportImpl::RTIRawTransportImpl()
 {
     PeerData::resourcesList.reserve(RTIPERFTEST_MAX_PEERS);
 
+  #ifdef RTI_PERFTEST_IO_URING
+    _packetTimestamps = NULL;
+  #endif
+
     if (!get_serialized_overhead_size(perftest_cpp::OVERHEAD_BYTES)) {
         throw std::runtime_error("[Error] RTIRawTransportImpl: "
                 "get_serialized_overhead_size returned error");
@@ -61,6 +69,15 @@ void RTIRawTransportImpl::shutdown()
         _pongSemaphore = NULL;
     }
 
+  #ifdef RTI_PERFTEST_IO_URING
+    /* The writers and readers using it have already been deleted */
+    if (_packetTimestamps != NULL) {
+        _packetTimestamps->print();
+        delete _packetTimestamps;
+        _packetTimestamps = NULL;
+    }
+  #endif
+
 }
 
 /*********************************************************
@@ -192,6 +209,33 @@ bool RTIRawTransportImpl::validate_input() {
         return false;
     }
 
+    // Manage parameter -ioUring
+    if (_PM->get<bool>("ioUring")) {
+      #ifdef RTI_PERFTEST_IO_URING
+        if (_transport.transportConfig.kind != TRANSPORT_NOT_SET
+                && _transport.transportConfig.kind != TRANSPORT_UDPv4) {
+            fprintf(stderr, "-ioUring only supports UDPv4\n");
+            return false;
+        }
+        unsigned long long depth = _PM->get<unsigned long long>("ioUringDepth");
+        if ((depth & (depth - 1)) != 0) {
+            fprintf(stderr, "-ioUringDepth must be a power of 2\n");
+            return false;
+        }
+      #else
+        fprintf(stderr,
+                "-ioUring is not available: it requires Linux and the "
+                "io_uring headers of Linux 6.0 or newer when building\n");
+        return false;
+      #endif
+    } else if (_PM->is_set("ioUringSqPoll") || _PM->is_set("ioUringDepth")
+            || _PM->get<bool>("packetTimestamps")) {
+        fprintf(stderr,
+                "-ioUringSqPoll, -ioUringDepth and -packetTimestamps require "
+                "-ioUring\n");
+        return false;
+    }
+
     return true;
 }
 
@@ -214,6 +258,17 @@ std::string RTIRawTransportImpl::print_configuration()
     stringStream << "\tBlocking Sockets: "
                  << (_PM->get<bool>("noBlockingSockets")? "Yes\n" : "No\n");
 
+    // io_uring
+    if (_PM->get<bool>("ioUring")) {
+        stringStream << "\tI/O Engine: io_uring (Depth: "
+                     << _PM->get<unsigned long long>("ioUringDepth")
+                     << ", SQPOLL: "
+                     << (_PM->get<bool>("ioUringSqPoll") ? "Yes" : "No")
+                     << ")\n";
+        stringStream << "\tPacket Timestamps: "
+                     << (_PM->get<bool>("packetTimestamps") ? "Yes\n" : "No\n");
+    }
+
     // Ports
     stringStream << "\tThe following ports will be used: ";
     if (_PM->get<bool>("pub")) {
@@ -708,6 +763,366 @@ public:
     }
 };
 
+#ifdef RTI_PERFTEST_IO_URING
+/*
+ * Print the work done by io_uring for the samples sent or received by an
+ * endpoint. The announcement channel is skipped, it only has a few samples.
+ */
+static void print_io_uring_stats(
+        const std::string &topicName,
+        const char *endpointKind,
+        const IoUringStats &stats,
+        unsigned long long sampleCount)
+{
+    if (sampleCount == 0 || topicName == ANNOUNCEMENT_TOPIC_NAME) {
+        return;
+    }
+    printf("io_uring %s %s: %llu samples, %.3f submissions, "
+           "%.3f completions, %.3f syscalls per sample\n",
+           topicName.c_str(),
+           endpointKind,
+           sampleCount,
+           (double) stats.submissions / sampleCount,
+           (double) stats.completions / sampleCount,
+           (double) stats.syscalls / sampleCount);
+}
+
+/*********************************************************
+ * RTIIoUringPublisher
+ */
+class RTIIoUringPublisher : public IMessagingWriter {
+  private:
+    /* --- Transport members --- */
+    IoUringSender _sender;
+    /* Buffer being filled, NULL if none */
+    char *_buffer;
+    unsigned int _bufferLength;
+    /* The buffer has a ping or a pong, it will be timestamped */
+    bool _bufferHasPing;
+
+    /* --- Perftest members --- */
+    std::string _topicName;
+    TestData_t _data;
+    RTIOsapiSemaphore *_pongSemaphore;
+    ParameterManager *_PM;
+    unsigned long long _sampleCount;
+
+    /* --- Buffers management --- */
+    unsigned int _batchBufferSize;
+    bool _useBatching;
+
+  public:
+    RTIIoUringPublisher(
+            RTIRawTransportImpl *parent,
+            const char *topicName,
+            const std::vector<struct sockaddr_in> &peers,
+            const struct in_addr &interfaceAddr)
+            : _buffer(NULL),
+              _bufferLength(0),
+              _bufferHasPing(false),
+              _topicName(topicName),
+              _sampleCount(0)
+    {
+        _pongSemaphore = parent->get_pong_semaphore();
+        _PM = parent->get_parameter_manager();
+
+        /* Only the pings and the pongs are timestamped */
+        PacketTimestamps *timestamps = NULL;
+        if (_PM->get<bool>("pub")
+                ? _topicName == THROUGHPUT_TOPIC_NAME
+                : _topicName == LATENCY_TOPIC_NAME) {
+            timestamps = parent->get_packet_timestamps();
+        }
+
+        /*
+         * The subscriber does not know the size of the samples it will echo,
+         * the publisher only needs room for its largest sample.
+         */
+        unsigned int slotSize = NDDS_TRANSPORT_UDPV4_PAYLOAD_SIZE_MAX;
+        if (_PM->get<bool>("pub")) {
+            slotSize = (unsigned int) std::max(
+                    _PM->get<unsigned long long>("dataLen"),
+                    (unsigned long long) perftest_cpp::FINISHED_SIZE
+                            + perftest_cpp::OVERHEAD_BYTES)
+                    + RTI_CDR_ENCAPSULATION_HEADER_SIZE;
+        }
+
+        if (_PM->get<long>("batchSize") <= 0) {
+            _batchBufferSize = slotSize;
+            _useBatching = false;
+        } else {
+            _batchBufferSize = _PM->get<long>("batchSize");
+            slotSize = std::max(slotSize, _batchBufferSize);
+            _useBatching = true;
+        }
+
+        if (!_sender.initialize(
+                    peers,
+                    interfaceAddr,
+                    (unsigned int) _PM->get<unsigned long long>("ioUringDepth"),
+                    slotSize,
+                    _PM->get<bool>("ioUringSqPoll"),
+                    _PM->get<bool>("noBlockingSockets"),
+                    timestamps)) {
+            throw std::runtime_error("Fail to initialize the io_uring sender\n");
+        }
+    }
+
+    ~RTIIoUringPublisher()
+    {
+        flush();
+        _sender.finalize();
+        print_io_uring_stats(
+                _topicName,
+                "writer",
+                _sender.get_stats(),
+                _sampleCount);
+    }
+
+    bool queue_buffer()
+    {
+        bool success = _sender.send_buffer(_bufferLength, _bufferHasPing);
+        _buffer = NULL;
+        _bufferLength = 0;
+        _bufferHasPing = false;
+        return success;
+    }
+
+    void flush()
+    {
+        if (_buffer != NULL) {
+            queue_buffer();
+        }
+        /*
+         * No need of check for errors.
+         * This will be represented as lost packets
+         */
+        _sender.submit();
+    }
+
+    bool send(const TestMessage &message, bool isCftWildCardKey)
+    {
+        RTIBool success = false;
+        unsigned int serializeSize =  message.size
+                + perftest_cpp::OVERHEAD_BYTES
+                + RTI_CDR_ENCAPSULATION_HEADER_SIZE;
+
+        /*
+         * If there is no more space on the buffer to allocate the new message
+         * queue it before add a new sample.
+         */
+        if (_buffer != NULL
+                && _bufferLength + serializeSize > _batchBufferSize) {
+            queue_buffer();
+        }
+
+        if (_buffer == NULL) {
+            _buffer = _sender.get_buffer();
+            if (_buffer == NULL) {
+                fprintf(stderr, "Fail to get an io_uring send buffer\n");
+                return false;
+            }
+        }
+
+        _data.entity_id = message.entity_id;
+        _data.seq_num = message.seq_num;
+        _data.timestamp_sec = message.timestamp_sec;
+        _data.timestamp_usec = message.timestamp_usec;
+        _data.latency_ping = message.latency_ping;
+        _data.bin_data.loan_contiguous(
+                (DDS_Octet *) message.data,
+                message.size,
+                message.size);
+
+        unsigned int actualCdrLength =
+                _sender.get_buffer_size() - _bufferLength;
+        success = TestData_tPlugin_serialize_to_cdr_buffer(
+                _buffer + _bufferLength,
+                &actualCdrLength,
+                &_data);
+
+        /* _data is been serialized (copied). Then it's right to unloan. */
+        _data.bin_data.unloan();
+
+        if (!success) {
+            fprintf(stderr, "Fail to serialize data\n");
+            return false;
+        }
+        _bufferLength += actualCdrLength;
+        ++_sampleCount;
+        if (message.latency_ping != -1) {
+            _bufferHasPing = true;
+        }
+
+        if (!_useBatching && !queue_buffer()) {
+            return false;
+        }
+
+        /*
+         * The sends are submitted in groups, but pings must not wait for the
+         * rest of the group.
+         */
+        if (message.latency_ping != -1) {
+            return _sender.submit();
+        }
+        return true;
+    }
+
+    void wait_for_readers(int numSubscribers) {
+        /* --- Dummy Function --- */
+    }
+
+    bool wait_for_ping_response() {
+        if (_pongSemaphore != NULL) {
+            if (!RTIOsapiSemaphore_take(_pongSemaphore, NULL)) {
+                fprintf(stderr, "Unexpected error taking semaphore\n");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* time out in milliseconds */
+    bool wait_for_ping_response(int timeout) {
+        struct RTINtpTime blockDurationIn;
+        RTINtpTime_packFromMillisec(blockDurationIn, 0, timeout);
+
+        if (_pongSemaphore != NULL) {
+            if (!RTIOsapiSemaphore_take(_pongSemaphore, &blockDurationIn)) {
+                fprintf(stderr, "Unexpected error taking semaphore\n");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool notify_ping_response() {
+        if (_pongSemaphore != NULL) {
+            if (!RTIOsapiSemaphore_give(_pongSemaphore)) {
+                fprintf(stderr, "Unexpected error giving semaphore\n");
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/*********************************************************
+ * RTIIoUringSubscriber
+ */
+class RTIIoUringSubscriber : public IMessagingReader
+{
+  private:
+    /* --- Transport members --- */
+    IoUringReceiver _receiver;
+    char *_datagram;
+    unsigned int _datagramLength;
+
+    /* --- Perftest members --- */
+    std::string _topicName;
+    TestMessage _message;
+    TestData_t _data;
+    unsigned long long _sampleCount;
+
+    /* --- Buffer Management --- */
+    unsigned int _currentOffset;
+
+  public:
+    RTIIoUringSubscriber(
+            RTIRawTransportImpl *parent,
+            const char *topicName,
+            unsigned short port,
+            const struct in_addr &multicastAddr,
+            const struct in_addr &interfaceAddr)
+            : _datagram(NULL),
+              _datagramLength(0),
+              _topicName(topicName),
+              _sampleCount(0),
+              _currentOffset(0)
+    {
+        ParameterManager *PM = parent->get_parameter_manager();
+
+        if (!_receiver.initialize(
+                    port,
+                    multicastAddr,
+                    interfaceAddr,
+                    (unsigned int) PM->get<unsigned long long>("ioUringDepth"),
+                    PM->get<bool>("ioUringSqPoll"),
+                    parent->get_packet_timestamps())) {
+            throw std::runtime_error(
+                    "Fail to initialize the io_uring receiver\n");
+        }
+
+        if (!_data.bin_data.maximum(NDDS_TRANSPORT_UDPV4_PAYLOAD_SIZE_MAX
+                - perftest_cpp::OVERHEAD_BYTES)) {
+            throw std::runtime_error("bin_data.maximum Error\n");
+        }
+    }
+
+    ~RTIIoUringSubscriber()
+    {
+        _receiver.finalize();
+        print_io_uring_stats(
+                _topicName,
+                "reader",
+                _receiver.get_stats(),
+                _sampleCount);
+    }
+
+    TestMessage *receive_message() {
+
+        /* All the samples of the previous datagram have been processed */
+        if (_currentOffset >= _datagramLength) {
+            if (!_receiver.receive(_datagram, _datagramLength)) {
+                fprintf(stderr, "Fail to receive data\n");
+                return NULL;
+            } else if (_datagramLength == 0) {
+                /* The receiver was unblocked */
+                return NULL;
+            }
+            _currentOffset = 0;
+        }
+
+        TestData_tPlugin_deserialize_from_cdr_buffer(
+                &_data,
+                _datagram + _currentOffset,
+                _datagramLength - _currentOffset);
+
+        _message.entity_id = _data.entity_id;
+        _message.seq_num = _data.seq_num;
+        _message.timestamp_sec = _data.timestamp_sec;
+        _message.timestamp_usec = _data.timestamp_usec;
+        _message.latency_ping = _data.latency_ping;
+        _message.size = _data.bin_data.length();
+        _message.data = (char *)_data.bin_data.get_contiguous_bufferI();
+
+        /*
+         * In case of batching we need to know the offset for each sample
+         * received to take the next one from the buffer.
+         */
+        _currentOffset += _message.size
+            + perftest_cpp::OVERHEAD_BYTES
+            + RTI_CDR_ENCAPSULATION_HEADER_SIZE;
+        ++_sampleCount;
+
+        return &_message;
+    }
+
+    void wait_for_writers(int numPublishers) {
+        /*Dummy Function*/
+    }
+
+    bool unblock() {
+        if (!_receiver.unblock()) {
+            fprintf(stderr,
+                    "Fail to unblock the receiver on RTIIoUringSubscriber\n");
+            return false;
+        }
+        return true;
+    }
+};
+#endif // RTI_PERFTEST_IO_URING
+
 /*********************************************************
  * Initialize
  */
@@ -752,6 +1167,12 @@ bool RTIRawTransportImpl::initialize(ParameterManager &PM, perftest_cpp *parent)
         return false;
     }
 
+  #ifdef RTI_PERFTEST_IO_URING
+    if (_PM->get<bool>("packetTimestamps")) {
+        _packetTimestamps = new PacketTimestamps(_PM->get<bool>("pub"));
+    }
+  #endif
+
     return true;
 }
 
@@ -857,6 +1278,11 @@ bool RTIRawTransportImpl::get_multicast_transport_addr(
  */
 IMessagingWriter *RTIRawTransportImpl::create_writer(const char *topicName)
 {
+  #ifdef RTI_PERFTEST_IO_URING
+    if (_PM->get<bool>("ioUring")) {
+        return create_io_uring_writer(topicName);
+    }
+  #endif
 
     NDDS_Transport_Address_t multicastAddr;
     bool is_multicastAddr = false;
@@ -939,6 +1365,12 @@ IMessagingWriter *RTIRawTransportImpl::create_writer(const char *topicName)
 IMessagingReader *
 RTIRawTransportImpl::create_reader(const char *topicName, IMessagingCB *callback)
 {
+  #ifdef RTI_PERFTEST_IO_URING
+    if (_PM->get<bool>("ioUring")) {
+        return create_io_uring_reader(topicName);
+    }
+  #endif
+
     NDDS_Transport_RecvResource_t recvResource = NULL;
     NDDS_Transport_Port_t recvPort = 0;
     NDDS_Transport_Address_t multicastAddr;
@@ -983,6 +1415,121 @@ RTIRawTransportImpl::create_reader(const char *topicName, IMessagingCB *callback
 
 }
 
+#ifdef RTI_PERFTEST_IO_URING
+/*********************************************************
+ * get_io_uring_interface_address
+ */
+struct in_addr RTIRawTransportImpl::get_io_uring_interface_address()
+{
+    struct in_addr interfaceAddr;
+    interfaceAddr.s_addr = htonl(INADDR_ANY);
+
+    if (!io_uring_get_interface_address(
+                _PM->get<std::string>("allowInterfaces"),
+                interfaceAddr)) {
+        fprintf(stderr,
+                "Interface '%s' not found, using the default one for "
+                "multicast\n",
+                _PM->get<std::string>("allowInterfaces").c_str());
+    }
+    return interfaceAddr;
+}
+
+/*********************************************************
+ * create_io_uring_writer
+ */
+IMessagingWriter *
+RTIRawTransportImpl::create_io_uring_writer(const char *topicName)
+{
+    std::vector<struct sockaddr_in> peers;
+    struct in_addr multicastAddr;
+    struct in_addr interfaceAddr;
+    interfaceAddr.s_addr = htonl(INADDR_ANY);
+
+    if (is_multicast()) {
+        if (inet_pton(
+                    AF_INET,
+                    _transport.getMulticastAddr(topicName).c_str(),
+                    &multicastAddr) != 1) {
+            fprintf(stderr, "Bad configuration for multicast (rawTransport)\n");
+            return NULL;
+        }
+        interfaceAddr = get_io_uring_interface_address();
+    }
+
+    for (unsigned int i = 0; i < _peersMap.size(); i++) {
+        struct sockaddr_in peer;
+        memset(&peer, 0, sizeof(peer));
+        peer.sin_family = AF_INET;
+        peer.sin_port = htons((unsigned short) get_peer_unicast_port(
+                topicName,
+                _peersMap[i].second));
+
+        /* The IPv4 address is stored in the last 4 bytes */
+        if (is_multicast()) {
+            peer.sin_addr = multicastAddr;
+        } else {
+            memcpy(&peer.sin_addr,
+                   &_peersMap[i].first.network_ordered_value[12],
+                   sizeof(peer.sin_addr));
+        }
+        peers.push_back(peer);
+    }
+
+    try {
+        return new RTIIoUringPublisher(
+                this,
+                topicName,
+                peers,
+                interfaceAddr);
+    } catch (const std::exception &ex) {
+        fprintf(stderr,
+                "Exception in RTIRawTransportImpl::create_io_uring_writer(): "
+                "%s.\n",
+                ex.what());
+        return NULL;
+    }
+}
+
+/*********************************************************
+ * create_io_uring_reader
+ */
+IMessagingReader *
+RTIRawTransportImpl::create_io_uring_reader(const char *topicName)
+{
+    struct in_addr multicastAddr;
+    struct in_addr interfaceAddr;
+    multicastAddr.s_addr = htonl(INADDR_ANY);
+    interfaceAddr.s_addr = htonl(INADDR_ANY);
+
+    if (is_multicast()) {
+        if (inet_pton(
+                    AF_INET,
+                    _transport.getMulticastAddr(topicName).c_str(),
+                    &multicastAddr) != 1) {
+            fprintf(stderr, "Bad configuration for multicast (RawTransport)\n");
+            return NULL;
+        }
+        interfaceAddr = get_io_uring_interface_address();
+    }
+
+    try {
+        return new RTIIoUringSubscriber(
+                this,
+                topicName,
+                (unsigned short) get_receive_port(topicName),
+                multicastAddr,
+                interfaceAddr);
+    } catch (const std::exception &ex) {
+        fprintf(stderr,
+                "Exception in RTIRawTransportImpl::create_io_uring_reader(): "
+                "%s.\n",
+                ex.what());
+        return NULL;
+    }
+}
+#endif // RTI_PERFTEST_IO_URING
+
 bool RTIRawTransportImpl::configure_sockets_transport()
 {
     char *interfaceAddr = NULL; /*WARNING: interface is a reserved word on VS */
@@ -15,6 +15,7 @@
 #include "perftest.h"
 #include "perftestSupport.h"
 #include "perftest_cpp.h"
+#include "RTIIoUringEngine.h"
 #include "transport/transport_socketutil.h"
 #include "transport/transport_udpv4.h"
 #include "disc/disc_rtps.h"
@@ -52,6 +53,9 @@ class RTIRawTransportImpl : public IMessaging {
     RTIOsapiSemaphore *get_pong_semaphore()         {return _pongSemaphore;}
     struct REDAWorkerFactory *get_worker_factory()  {return _workerFactory;}
     ParameterManager *get_parameter_manager()       {return _PM;}
+  #ifdef RTI_PERFTEST_IO_URING
+    PacketTimestamps *get_packet_timestamps()       {return _packetTimestamps;}
+  #endif
 
     /* Calculate the port depending of the Id of the subscriber.*/
     unsigned int
@@ -83,6 +87,18 @@ class RTIRawTransportImpl : public IMessaging {
 
   private:
 
+  #ifdef RTI_PERFTEST_IO_URING
+    /* Writers and readers using io_uring instead of the transport plugin */
+    IMessagingWriter *create_io_uring_writer(const char *topicName);
+    IMessagingReader *create_io_uring_reader(const char *topicName);
+
+    /* Address of the interface used for multicast with io_uring */
+    struct in_addr get_io_uring_interface_address();
+
+    /* Kernel timestamps of the pings and pongs, NULL if not enabled */
+    PacketTimestamps *_packetTimestamps;
+  #endif
+
     std::vector<std::pair<NDDS_Transport_Address_t, int> > _peersMap;
     std::vector<PeerData> _peersDataList;
     PerftestTransport _transport;
@@ -0,0 +1,898 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "RTIShmRingImpl.h"
+
+#ifdef RTI_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sstream>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define RTIPERFTEST_SHM_RING_MAGIC 0x52505446 /* "RPTF" */
+#define RTIPERFTEST_SHM_RING_VERSION 1
+
+/* Time a futex waits before checking again the state of the ring */
+#define RTIPERFTEST_SHM_RING_WAIT_NSEC 100000000
+
+/* Iterations of a spin loop before checking the state of the ring */
+#define RTIPERFTEST_SHM_RING_SPIN_CHECK 0xFFFFF
+
+/*********************************************************
+ * Helpers
+ */
+/*
+ * Busy wait. The CPU is yielded from time to time, so the test can progress
+ * (slowly) even if the publisher and the subscriber share the same core.
+ */
+static inline void shm_ring_spin(unsigned long iterations)
+{
+    if ((iterations & RTIPERFTEST_SHM_RING_SPIN_CHECK) == 0) {
+        sched_yield();
+    } else {
+      #if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+      #endif
+    }
+}
+
+/*
+ * The futex is shared between processes, so FUTEX_PRIVATE_FLAG is not used.
+ * Returns false if it timed out.
+ */
+static inline bool shm_ring_futex_wait(
+        std::atomic<uint32_t> *word,
+        uint32_t expected)
+{
+    struct timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = RTIPERFTEST_SHM_RING_WAIT_NSEC;
+    return syscall(SYS_futex,
+                   reinterpret_cast<uint32_t *>(word),
+                   FUTEX_WAIT,
+                   expected,
+                   &timeout,
+                   NULL,
+                   0) == 0
+            || errno != ETIMEDOUT;
+}
+
+static inline void shm_ring_futex_wake(std::atomic<uint32_t> *word)
+{
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t *>(word),
+            FUTEX_WAKE,
+            INT_MAX,
+            NULL,
+            NULL,
+            0);
+}
+
+static inline bool shm_ring_is_process_alive(int32_t pid)
+{
+    return pid != 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static inline uint64_t shm_ring_round_up(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/*********************************************************
+ * ShmRingSegment
+ */
+ShmRingSegment::ShmRingSegment()
+        : _header(NULL),
+          _mappedSize(0),
+          _slotsOffset(0),
+          _inode(0)
+{
+}
+
+ShmRingSegment::~ShmRingSegment()
+{
+    close();
+}
+
+bool ShmRingSegment::open(
+        const std::string &name,
+        uint32_t slotCount,
+        uint32_t slotPayloadSize)
+{
+    _name = name;
+    _slotsOffset = (size_t) shm_ring_round_up(
+            sizeof(ShmRingHeader),
+            RTIPERFTEST_SHM_RING_CACHE_LINE);
+
+    /* A few attempts, in case of racing with other process recreating it */
+    for (int attempt = 0; attempt < 5; attempt++) {
+        if (create(slotCount, slotPayloadSize)) {
+            return true;
+        }
+        if (errno != EEXIST) {
+            fprintf(stderr,
+                    "[Error] ShmRingSegment: Could not create '%s': %s\n",
+                    _name.c_str(),
+                    strerror(errno));
+            return false;
+        }
+        if (!attach()) {
+            return false;
+        }
+        if (_header == NULL) {
+            // The segment was stale and it has been removed, try again
+            continue;
+        }
+        if (_header->slotPayloadSize < slotPayloadSize) {
+            fprintf(stderr,
+                    "[Error] ShmRingSegment: The segment '%s' was created for "
+                    "samples of %u bytes, but %u are needed. Use the same "
+                    "-dataLen in all the applications.\n",
+                    _name.c_str(),
+                    _header->slotPayloadSize,
+                    slotPayloadSize);
+            close();
+            return false;
+        }
+        _header->attachedCount.fetch_add(1);
+        return true;
+    }
+
+    fprintf(stderr,
+            "[Error] ShmRingSegment: Could not open '%s'\n",
+            _name.c_str());
+    return false;
+}
+
+bool ShmRingSegment::create(uint32_t slotCount, uint32_t slotPayloadSize)
+{
+    int fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    uint64_t slotStride = shm_ring_round_up(
+            RTIPERFTEST_SHM_RING_CACHE_LINE + (uint64_t) slotPayloadSize,
+            RTIPERFTEST_SHM_RING_CACHE_LINE);
+    _mappedSize = (size_t) (_slotsOffset + slotStride * slotCount);
+
+    struct stat segmentStat;
+    if (ftruncate(fd, (off_t) _mappedSize) != 0
+            || fstat(fd, &segmentStat) != 0) {
+        fprintf(stderr,
+                "[Error] ShmRingSegment: Could not allocate %lu bytes for "
+                "'%s': %s\n",
+                (unsigned long) _mappedSize,
+                _name.c_str(),
+                strerror(errno));
+        ::close(fd);
+        shm_unlink(_name.c_str());
+        errno = ENOMEM;
+        return false;
+    }
+    _inode = (unsigned long) segmentStat.st_ino;
+
+    void *address = mmap(
+            NULL,
+            _mappedSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            fd,
+            0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        fprintf(stderr,
+                "[Error] ShmRingSegment: Could not map '%s': %s\n",
+                _name.c_str(),
+                strerror(errno));
+        shm_unlink(_name.c_str());
+        errno = ENOMEM;
+        return false;
+    }
+
+    /* The memory of a new segment is zeroed, so only set the geometry */
+    _header = static_cast<ShmRingHeader *>(address);
+    _header->version = RTIPERFTEST_SHM_RING_VERSION;
+    _header->slotCount = slotCount;
+    _header->slotPayloadSize = slotPayloadSize;
+    _header->slotStride = slotStride;
+    _header->attachedCount.store(1);
+    _header->magic.store(RTIPERFTEST_SHM_RING_MAGIC, std::memory_order_release);
+
+    return true;
+}
+
+/*
+ * Map an existing segment. If it is stale, it is removed and _header is left
+ * to NULL so the caller can create it again.
+ */
+bool ShmRingSegment::attach()
+{
+    int fd = shm_open(_name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        // Removed in the meantime
+        return errno == ENOENT;
+    }
+
+    /* Wait for the creator to size and initialize the segment */
+    struct stat segmentStat;
+    for (int i = 0; i < 100; i++) {
+        if (fstat(fd, &segmentStat) != 0) {
+            ::close(fd);
+            fprintf(stderr,
+                    "[Error] ShmRingSegment: fstat of '%s' failed: %s\n",
+                    _name.c_str(),
+                    strerror(errno));
+            return false;
+        }
+        if ((size_t) segmentStat.st_size >= _slotsOffset) {
+            break;
+        }
+        PerftestClock::milliSleep(10);
+    }
+    if ((size_t) segmentStat.st_size < _slotsOffset) {
+        ::close(fd);
+        fprintf(stderr,
+                "[Error] ShmRingSegment: '%s' is not a valid segment, "
+                "remove it from /dev/shm\n",
+                _name.c_str());
+        return false;
+    }
+    _mappedSize = (size_t) segmentStat.st_size;
+    _inode = (unsigned long) segmentStat.st_ino;
+
+    void *address = mmap(
+            NULL,
+            _mappedSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            fd,
+            0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        fprintf(stderr,
+                "[Error] ShmRingSegment: Could not map '%s': %s\n",
+                _name.c_str(),
+                strerror(errno));
+        return false;
+    }
+    _header = static_cast<ShmRingHeader *>(address);
+
+    for (int i = 0; i < 100
+            && _header->magic.load(std::memory_order_acquire)
+                    != RTIPERFTEST_SHM_RING_MAGIC; i++) {
+        PerftestClock::milliSleep(10);
+    }
+
+    if (_header->magic.load(std::memory_order_acquire)
+                    != RTIPERFTEST_SHM_RING_MAGIC
+            || _header->version != RTIPERFTEST_SHM_RING_VERSION
+            || _slotsOffset + _header->slotStride * _header->slotCount
+                    > _mappedSize
+            || is_stale()) {
+        /* Left by a previous execution (or by a different version) */
+        munmap(_header, _mappedSize);
+        _header = NULL;
+
+        struct stat currentStat;
+        fd = shm_open(_name.c_str(), O_RDWR, 0600);
+        if (fd >= 0) {
+            if (fstat(fd, &currentStat) == 0
+                    && (unsigned long) currentStat.st_ino == _inode) {
+                shm_unlink(_name.c_str());
+            }
+            ::close(fd);
+        }
+    }
+
+    return true;
+}
+
+/* A segment is stale if none of the processes using it is alive */
+bool ShmRingSegment::is_stale()
+{
+    for (unsigned int i = 0; i < RTIPERFTEST_SHM_RING_MAX_ENDPOINTS; i++) {
+        if (shm_ring_is_process_alive(_header->writerPids[i].load())
+                || shm_ring_is_process_alive(_header->readers[i].pid.load())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShmRingSegment::close()
+{
+    if (_header == NULL) {
+        return;
+    }
+
+    if (_header->attachedCount.fetch_sub(1) == 1) {
+        /* Last one, remove the name if it still refers to this segment */
+        struct stat currentStat;
+        int fd = shm_open(_name.c_str(), O_RDWR, 0600);
+        if (fd >= 0) {
+            if (fstat(fd, &currentStat) == 0
+                    && (unsigned long) currentStat.st_ino == _inode) {
+                shm_unlink(_name.c_str());
+            }
+            ::close(fd);
+        }
+    }
+
+    munmap(_header, _mappedSize);
+    _header = NULL;
+}
+
+/*********************************************************
+ * Constructor
+ */
+RTIShmRingImpl::RTIShmRingImpl()
+        : _pongSemaphore(NULL),
+          _useFutex(true),
+          _PM(NULL)
+{
+}
+
+/*********************************************************
+ * shutdown
+ */
+void RTIShmRingImpl::shutdown()
+{
+    if (_pongSemaphore != NULL) {
+        PerftestSemaphore_delete(_pongSemaphore);
+        _pongSemaphore = NULL;
+    }
+}
+
+/*********************************************************
+ * validate_input
+ */
+bool RTIShmRingImpl::validate_input()
+{
+    const char *socketParameters[] = {
+        "transport",
+        "nic",
+        "allowInterfaces",
+        "peer",
+        "multicast",
+        "multicastAddr",
+        "noBlockingSockets"
+    };
+
+    if (_PM->get<bool>("rawTransport")) {
+        fprintf(stderr, "-shmRing and -rawTransport cannot be used together.\n");
+        return false;
+    }
+
+    for (unsigned int i = 0;
+            i < sizeof(socketParameters) / sizeof(socketParameters[0]);
+            i++) {
+        if (_PM->is_set(socketParameters[i])) {
+            fprintf(stderr,
+                    "-%s is not supported with -shmRing.\n",
+                    socketParameters[i]);
+            return false;
+        }
+    }
+
+    // Manage parameter -batchSize
+    if (_PM->is_set("batchSize") && _PM->get<long>("batchSize") > 0) {
+        fprintf(stderr, "Batching is not supported with -shmRing.\n");
+        return false;
+    }
+    _PM->set<long>("batchSize", 0);
+
+    // Manage parameter -shmRingSlots
+    unsigned long long slots = _PM->get<unsigned long long>("shmRingSlots");
+    if ((slots & (slots - 1)) != 0) {
+        fprintf(stderr, "-shmRingSlots must be a power of 2.\n");
+        return false;
+    }
+
+    // Manage parameter -shmRingWait
+    if (_PM->get<std::string>("shmRingWait") == "futex") {
+        _useFutex = true;
+    } else if (_PM->get<std::string>("shmRingWait") == "spin") {
+        _useFutex = false;
+    } else {
+        fprintf(stderr, "-shmRingWait must be either 'futex' or 'spin'.\n");
+        return false;
+    }
+
+    if (_PM->get<int>("numSubscribers") > RTIPERFTEST_SHM_RING_MAX_ENDPOINTS
+            || _PM->get<int>("numPublishers")
+                    > RTIPERFTEST_SHM_RING_MAX_ENDPOINTS) {
+        fprintf(stderr,
+                "The maximum number of publishers or subscribers with "
+                "-shmRing is %d.\n",
+                RTIPERFTEST_SHM_RING_MAX_ENDPOINTS);
+        return false;
+    }
+
+    return true;
+}
+
+/*********************************************************
+ * PrintConfiguration
+ */
+std::string RTIShmRingImpl::print_configuration()
+{
+    std::ostringstream stringStream;
+
+    // Middleware
+    stringStream << "\tMiddleware: Shared Memory Ring\n";
+
+    // Domain ID
+    stringStream << "\tDomain: " << _PM->get<int>("domain") << "\n";
+
+    stringStream << "\tSegments: /dev/shm" << get_segment_name("*") << "\n";
+
+    stringStream << "\tSlots: " << get_slot_count(THROUGHPUT_TOPIC_NAME)
+                 << " of " << get_slot_payload_size() << " Bytes\n";
+
+    stringStream << "\tWait: "
+                 << (_useFutex ? "Futex\n" : "Spin (busy wait)\n");
+
+    return stringStream.str();
+}
+
+/*********************************************************
+ * Initialize
+ */
+bool RTIShmRingImpl::initialize(ParameterManager &PM, perftest_cpp *parent)
+{
+    /* Set parameter manager */
+    _PM = &PM;
+
+    if (!validate_input()) {
+        return false;
+    }
+
+    /* Only if we run latency test we need to wait for pongs after sending pings */
+    if (_PM->get<bool>("latencyTest")) {
+        _pongSemaphore = PerftestSemaphore_new();
+        if (_pongSemaphore == NULL) {
+            fprintf(stderr, "Fail to create a Semaphore for RTIShmRingImpl\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string RTIShmRingImpl::get_segment_name(const char *topicName)
+{
+    std::ostringstream stringStream;
+    stringStream << "/rtiperftest_" << _PM->get<int>("domain") << "_"
+                 << topicName;
+    return stringStream.str();
+}
+
+uint32_t RTIShmRingImpl::get_slot_count(const char *topicName)
+{
+    if (strcmp(topicName, THROUGHPUT_TOPIC_NAME) == 0) {
+        return (uint32_t) _PM->get<unsigned long long>("shmRingSlots");
+    }
+    return RTIPERFTEST_SHM_RING_CONTROL_SLOTS;
+}
+
+uint32_t RTIShmRingImpl::get_slot_payload_size()
+{
+    unsigned long long size = _PM->get<unsigned long long>("dataLen");
+    if (size < (unsigned long long) perftest_cpp::FINISHED_SIZE) {
+        size = perftest_cpp::FINISHED_SIZE;
+    }
+    return (uint32_t) size;
+}
+
+/*********************************************************
+ * RTIShmRingPublisher
+ */
+class RTIShmRingPublisher : public IMessagingWriter {
+  private:
+    ShmRingSegment _segment;
+    ShmRingHeader *_header;
+    unsigned int _writerIndex;
+    /* Lowest position of the readers, seen the last time it was checked */
+    uint64_t _minReaderPosition;
+    bool _useFutex;
+    PerftestSemaphore *_pongSemaphore;
+
+  public:
+    RTIShmRingPublisher(RTIShmRingImpl *parent, const char *topicName)
+            : _header(NULL),
+              _writerIndex(RTIPERFTEST_SHM_RING_MAX_ENDPOINTS),
+              _minReaderPosition(0),
+              _useFutex(parent->use_futex()),
+              _pongSemaphore(parent->get_pong_semaphore())
+    {
+        if (!_segment.open(
+                    parent->get_segment_name(topicName),
+                    parent->get_slot_count(topicName),
+                    parent->get_slot_payload_size())) {
+            throw std::runtime_error("Could not open the shared memory ring");
+        }
+        _header = _segment.header();
+
+        const int32_t pid = (int32_t) getpid();
+        for (unsigned int i = 0; i < RTIPERFTEST_SHM_RING_MAX_ENDPOINTS; i++) {
+            int32_t freeEntry = 0;
+            if (_header->writerPids[i].compare_exchange_strong(freeEntry, pid)) {
+                _writerIndex = i;
+                break;
+            }
+        }
+        if (_writerIndex == RTIPERFTEST_SHM_RING_MAX_ENDPOINTS) {
+            throw std::runtime_error(
+                    "Too many writers attached to the shared memory ring");
+        }
+    }
+
+    ~RTIShmRingPublisher()
+    {
+        if (_header != NULL
+                && _writerIndex < RTIPERFTEST_SHM_RING_MAX_ENDPOINTS) {
+            _header->writerPids[_writerIndex].store(0);
+        }
+    }
+
+    /*
+     * Lowest position of the readers attached. Readers of processes that are
+     * not alive anymore are detached, so they do not block the ring.
+     */
+    uint64_t get_min_reader_position(uint64_t ticket, bool removeDeadReaders)
+    {
+        uint64_t minPosition = ticket;
+        for (unsigned int i = 0; i < RTIPERFTEST_SHM_RING_MAX_ENDPOINTS; i++) {
+            int32_t pid = _header->readers[i].pid.load(std::memory_order_acquire);
+            if (pid == 0) {
+                continue;
+            }
+            if (removeDeadReaders && !shm_ring_is_process_alive(pid)) {
+                _header->readers[i].pid.compare_exchange_strong(pid, 0);
+                continue;
+            }
+            uint64_t position = _header->readers[i].position.load(
+                    std::memory_order_acquire);
+            if (position < minPosition) {
+                minPosition = position;
+            }
+        }
+        return minPosition;
+    }
+
+    void wait_for_free_slot(uint64_t ticket)
+    {
+        const uint64_t slotCount = _header->slotCount;
+        unsigned long iterations = 0;
+
+        while (ticket >= _minReaderPosition + slotCount) {
+            _minReaderPosition = get_min_reader_position(
+                    ticket,
+                    (iterations & RTIPERFTEST_SHM_RING_SPIN_CHECK)
+                            == RTIPERFTEST_SHM_RING_SPIN_CHECK);
+            if (ticket < _minReaderPosition + slotCount) {
+                break;
+            }
+            iterations++;
+
+            if (!_useFutex) {
+                shm_ring_spin(iterations);
+                continue;
+            }
+
+            uint32_t signal = _header->spaceSignal.load(std::memory_order_acquire);
+            _header->spaceWaiters.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            _minReaderPosition = get_min_reader_position(ticket, false);
+            if (ticket >= _minReaderPosition + slotCount
+                    && !shm_ring_futex_wait(&_header->spaceSignal, signal)) {
+                // Check the readers that could be dead after a timeout
+                iterations = RTIPERFTEST_SHM_RING_SPIN_CHECK;
+            }
+            _header->spaceWaiters.fetch_sub(1);
+        }
+    }
+
+    bool send(const TestMessage &message, bool isCftWildCardKey)
+    {
+        if (message.size < 0
+                || (uint32_t) message.size > _header->slotPayloadSize) {
+            fprintf(stderr,
+                    "Sample of %d bytes does not fit in the slots of '%s'\n",
+                    message.size,
+                    _segment.name().c_str());
+            return false;
+        }
+
+        uint64_t ticket = _header->writeTicket.fetch_add(1);
+        wait_for_free_slot(ticket);
+
+        ShmRingSlot *slot = _segment.slot(ticket);
+        slot->size = message.size;
+        slot->entity_id = message.entity_id;
+        slot->seq_num = message.seq_num;
+        slot->timestamp_sec = message.timestamp_sec;
+        slot->timestamp_usec = message.timestamp_usec;
+        slot->latency_ping = message.latency_ping;
+        memcpy(slot->key, message.key, sizeof(slot->key));
+        if (message.size > 0 && message.data != NULL) {
+            memcpy(_segment.payload(slot), message.data, message.size);
+        }
+        slot->sequence.store(ticket + 1, std::memory_order_release);
+
+        if (_useFutex) {
+            _header->dataSignal.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_header->dataWaiters.load() > 0) {
+                shm_ring_futex_wake(&_header->dataSignal);
+            }
+        }
+
+        return true;
+    }
+
+    void flush()
+    {
+        /* Samples are visible to the readers as soon as they are sent */
+    }
+
+    void wait_for_readers(int numSubscribers)
+    {
+        while (true) {
+            int readers = 0;
+            for (unsigned int i = 0; i < RTIPERFTEST_SHM_RING_MAX_ENDPOINTS; i++) {
+                if (_header->readers[i].pid.load() != 0) {
+                    readers++;
+                }
+            }
+            if (readers >= numSubscribers) {
+                return;
+            }
+            PerftestClock::milliSleep(PERFTEST_DISCOVERY_TIME_MSEC);
+        }
+    }
+
+    bool wait_for_ping_response()
+    {
+        if (_pongSemaphore != NULL
+                && !PerftestSemaphore_take(
+                        _pongSemaphore,
+                        PERFTEST_SEMAPHORE_TIMEOUT_INFINITE)) {
+            fprintf(stderr, "Unexpected error taking semaphore\n");
+            return false;
+        }
+        return true;
+    }
+
+    /* time out in milliseconds */
+    bool wait_for_ping_response(int timeout)
+    {
+        if (_pongSemaphore != NULL
+                && !PerftestSemaphore_take(_pongSemaphore, timeout)) {
+            fprintf(stderr, "Unexpected error taking semaphore\n");
+            return false;
+        }
+        return true;
+    }
+
+    bool notify_ping_response()
+    {
+        if (_pongSemaphore != NULL
+                && !PerftestSemaphore_give(_pongSemaphore)) {
+            fprintf(stderr, "Unexpected error giving semaphore\n");
+            return false;
+        }
+        return true;
+    }
+};
+
+/*********************************************************
+ * RTIShmRingSubscriber
+ */
+class RTIShmRingSubscriber : public IMessagingReader {
+  private:
+    ShmRingSegment _segment;
+    ShmRingHeader *_header;
+    ShmRingCursor *_cursor;
+    /* Position of the next sample to read */
+    uint64_t _position;
+    /* The sample returned by the last call is still being used */
+    bool _holdingSlot;
+    bool _useFutex;
+    std::atomic<bool> _unblocked;
+    TestMessage _message;
+
+  public:
+    RTIShmRingSubscriber(RTIShmRingImpl *parent, const char *topicName)
+            : _header(NULL),
+              _cursor(NULL),
+              _position(0),
+              _holdingSlot(false),
+              _useFutex(parent->use_futex()),
+              _unblocked(false)
+    {
+        if (!_segment.open(
+                    parent->get_segment_name(topicName),
+                    parent->get_slot_count(topicName),
+                    parent->get_slot_payload_size())) {
+            throw std::runtime_error("Could not open the shared memory ring");
+        }
+        _header = _segment.header();
+
+        /*
+         * The reader starts with the samples written from now on. The
+         * position is set before the pid so the writers never see a free
+         * cursor as attached with an old position.
+         */
+        const int32_t pid = (int32_t) getpid();
+        for (unsigned int i = 0; i < RTIPERFTEST_SHM_RING_MAX_ENDPOINTS; i++) {
+            int32_t freeEntry = 0;
+            if (_header->readers[i].pid.load() == 0) {
+                _position = _header->writeTicket.load();
+                _header->readers[i].position.store(_position);
+                if (_header->readers[i].pid.compare_exchange_strong(
+                            freeEntry, pid)) {
+                    _cursor = &_header->readers[i];
+                    break;
+                }
+            }
+        }
+        if (_cursor == NULL) {
+            throw std::runtime_error(
+                    "Too many readers attached to the shared memory ring");
+        }
+    }
+
+    ~RTIShmRingSubscriber()
+    {
+        if (_cursor != NULL) {
+            _cursor->pid.store(0);
+            notify_free_slot();
+        }
+    }
+
+    void notify_free_slot()
+    {
+        if (!_useFutex) {
+            return;
+        }
+        _header->spaceSignal.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_header->spaceWaiters.load() > 0) {
+            shm_ring_futex_wake(&_header->spaceSignal);
+        }
+    }
+
+    /*
+     * The message points to the slot in the shared memory (no copy), so the
+     * slot is released in the next call.
+     */
+    TestMessage *receive_message()
+    {
+        if (_holdingSlot) {
+            _position++;
+            _cursor->position.store(_position, std::memory_order_release);
+            _holdingSlot = false;
+            notify_free_slot();
+        }
+
+        ShmRingSlot *slot = _segment.slot(_position);
+        unsigned long spinIterations = 0;
+        while (true) {
+            if (_unblocked.load(std::memory_order_relaxed)) {
+                return NULL;
+            }
+
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == _position + 1) {
+                break;
+            }
+            if (sequence > _position + 1) {
+                /*
+                 * The reader was overtaken while attaching, continue from the
+                 * sample in the slot. The samples skipped are reported as lost.
+                 */
+                _position = sequence - 1;
+                _cursor->position.store(_position, std::memory_order_release);
+                continue;
+            }
+
+            if (!_useFutex) {
+                shm_ring_spin(++spinIterations);
+                continue;
+            }
+
+            uint32_t signal = _header->dataSignal.load(std::memory_order_acquire);
+            _header->dataWaiters.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (slot->sequence.load() <= _position && !_unblocked.load()) {
+                shm_ring_futex_wait(&_header->dataSignal, signal);
+            }
+            _header->dataWaiters.fetch_sub(1);
+        }
+
+        _message.size = slot->size;
+        _message.entity_id = slot->entity_id;
+        _message.seq_num = slot->seq_num;
+        _message.timestamp_sec = slot->timestamp_sec;
+        _message.timestamp_usec = slot->timestamp_usec;
+        _message.latency_ping = slot->latency_ping;
+        memcpy(_message.key, slot->key, sizeof(_message.key));
+        _message.data = _segment.payload(slot);
+        _holdingSlot = true;
+
+        return &_message;
+    }
+
+    void wait_for_writers(int numPublishers)
+    {
+        while (true) {
+            int writers = 0;
+            for (unsigned int i = 0; i < RTIPERFTEST_SHM_RING_MAX_ENDPOINTS; i++) {
+                if (_header->writerPids[i].load() != 0) {
+                    writers++;
+                }
+            }
+            if (writers >= numPublishers) {
+                return;
+            }
+            PerftestClock::milliSleep(PERFTEST_DISCOVERY_TIME_MSEC);
+        }
+    }
+
+    bool unblock()
+    {
+        _unblocked.store(true);
+        if (_useFutex) {
+            _header->dataSignal.fetch_add(1);
+            shm_ring_futex_wake(&_header->dataSignal);
+        }
+        return true;
+    }
+};
+
+/*********************************************************
+ * CreateWriter
+ */
+IMessagingWriter *RTIShmRingImpl::create_writer(const char *topicName)
+{
+    try {
+        return new RTIShmRingPublisher(this, topicName);
+    } catch (const std::exception &ex) {
+        fprintf(stderr,
+                "Exception in RTIShmRingImpl::create_writer(): %s.\n",
+                ex.what());
+        return NULL;
+    }
+}
+
+/*********************************************************
+ * CreateReader
+ */
+IMessagingReader *
+RTIShmRingImpl::create_reader(const char *topicName, IMessagingCB *callback)
+{
+    try {
+        return new RTIShmRingSubscriber(this, topicName);
+    } catch (const std::exception &ex) {
+        fprintf(stderr,
+                "Exception in RTIShmRingImpl::create_reader(): %s.\n",
+                ex.what());
+        return NULL;
+    }
+}
+
+#endif // RTI_LINUX
@@ -0,0 +1,181 @@
+#ifndef __RTIShmRingImpl_H__
+#define __RTIShmRingImpl_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#ifdef RTI_LINUX
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <stdint.h>
+#include "MessagingIF.h"
+#include "perftest_cpp.h"
+
+/*
+ * Maximum number of readers (and writers) that can be attached at the same
+ * time to one ring.
+ */
+#define RTIPERFTEST_SHM_RING_MAX_ENDPOINTS 64
+
+/* Number of slots of the rings used by the Latency and Announcement topics */
+#define RTIPERFTEST_SHM_RING_CONTROL_SLOTS 64
+
+#define RTIPERFTEST_SHM_RING_CACHE_LINE 64
+
+/*
+ * Every topic is mapped to a POSIX shared memory segment that contains a ring
+ * of fixed size slots. Writers claim a slot with an atomic ticket, copy the
+ * sample into it and publish it by writing the ticket in the slot sequence.
+ * Every reader has its own cursor, so all the readers receive all the samples
+ * (one writer to many readers for the Throughput topic, many writers to one
+ * reader for the Latency and Announcement topics). The writers never overtake
+ * the slowest reader attached.
+ *
+ * The atomics are placed in the shared memory, so they must be lock-free
+ * (which is the case for 32 and 64 bits types on Linux).
+ */
+struct ShmRingCursor {
+    std::atomic<uint64_t> position;
+    /* Process owning the cursor, 0 if the cursor is free */
+    std::atomic<int32_t> pid;
+    char padding[RTIPERFTEST_SHM_RING_CACHE_LINE
+            - sizeof(std::atomic<uint64_t>)
+            - sizeof(std::atomic<int32_t>)];
+};
+
+struct ShmRingHeader {
+    /* Set by the creator of the segment once it is initialized */
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotPayloadSize;
+    uint64_t slotStride;
+    /* Number of endpoints mapping the segment, the last one removes it */
+    std::atomic<uint32_t> attachedCount;
+    std::atomic<int32_t> writerPids[RTIPERFTEST_SHM_RING_MAX_ENDPOINTS];
+
+    alignas(RTIPERFTEST_SHM_RING_CACHE_LINE) std::atomic<uint64_t> writeTicket;
+
+    /* Futex words used to wake up readers waiting for data */
+    alignas(RTIPERFTEST_SHM_RING_CACHE_LINE) std::atomic<uint32_t> dataSignal;
+    std::atomic<uint32_t> dataWaiters;
+
+    /* Futex words used to wake up writers waiting for free slots */
+    alignas(RTIPERFTEST_SHM_RING_CACHE_LINE) std::atomic<uint32_t> spaceSignal;
+    std::atomic<uint32_t> spaceWaiters;
+
+    alignas(RTIPERFTEST_SHM_RING_CACHE_LINE)
+            ShmRingCursor readers[RTIPERFTEST_SHM_RING_MAX_ENDPOINTS];
+};
+
+/* Header of every slot, the payload follows it */
+struct ShmRingSlot {
+    /* Ticket + 1 of the sample stored in the slot, 0 if never used */
+    std::atomic<uint64_t> sequence;
+    int32_t size;
+    int32_t entity_id;
+    uint32_t seq_num;
+    int32_t timestamp_sec;
+    uint32_t timestamp_usec;
+    int32_t latency_ping;
+    unsigned char key[4];
+};
+
+/* A shared memory segment mapped by one endpoint */
+class ShmRingSegment {
+  public:
+    ShmRingSegment();
+    ~ShmRingSegment();
+
+    /*
+     * Create the segment or attach to an existing one. If the segment exists
+     * but none of the processes attached to it is alive, it is recreated.
+     */
+    bool open(
+            const std::string &name,
+            uint32_t slotCount,
+            uint32_t slotPayloadSize);
+    void close();
+
+    ShmRingHeader *header()
+    {
+        return _header;
+    }
+
+    ShmRingSlot *slot(uint64_t ticket)
+    {
+        return reinterpret_cast<ShmRingSlot *>(
+                reinterpret_cast<char *>(_header)
+                + _slotsOffset
+                + (ticket & (_header->slotCount - 1)) * _header->slotStride);
+    }
+
+    char *payload(ShmRingSlot *slot)
+    {
+        return reinterpret_cast<char *>(slot) + RTIPERFTEST_SHM_RING_CACHE_LINE;
+    }
+
+    const std::string &name()
+    {
+        return _name;
+    }
+
+  private:
+    bool create(uint32_t slotCount, uint32_t slotPayloadSize);
+    bool attach();
+    bool is_stale();
+
+    std::string _name;
+    ShmRingHeader *_header;
+    size_t _mappedSize;
+    size_t _slotsOffset;
+    /* Inode of the segment, to not remove a segment created by others */
+    unsigned long _inode;
+};
+
+class RTIShmRingImpl : public IMessaging {
+  public:
+    RTIShmRingImpl();
+    ~RTIShmRingImpl() { shutdown(); }
+    bool validate_input();
+    std::string print_configuration();
+    bool initialize(ParameterManager &PM, perftest_cpp *parent);
+    void shutdown();
+
+    bool supports_listeners() {return false;}
+
+    IMessagingWriter *create_writer(const char *topic_name);
+
+    /* This implementation does not support listener so callback is ignored. */
+    IMessagingReader *
+    create_reader(const char *topic_name, IMessagingCB *callback);
+
+    /*------------------------------- Getters --------------------------------*/
+    unsigned long get_initial_burst_size()  {return 0;}
+    PerftestSemaphore *get_pong_semaphore() {return _pongSemaphore;}
+    ParameterManager *get_parameter_manager() {return _PM;}
+    bool use_futex() {return _useFutex;}
+
+    /* Name of the shared memory segment used for a topic */
+    std::string get_segment_name(const char *topicName);
+
+    /* Number of slots of the ring used for a topic */
+    uint32_t get_slot_count(const char *topicName);
+
+    /* Size of the payload of the slots, big enough for any sample */
+    uint32_t get_slot_payload_size();
+    /*------------------------------------------------------------------------*/
+
+  private:
+    PerftestSemaphore *_pongSemaphore;
+    bool _useFutex;
+    ParameterManager *_PM;
+};
+
+#endif // RTI_LINUX
+
+#endif // __RTIShmRingImpl_H__
@@ -11,6 +11,8 @@
   #include "RTITSSImpl.h"
 #elif defined(PERFTEST_RTI_PRO)
   #include "RTIRawTransportImpl.h"
+  #include "RTIShmRingImpl.h"
+  #include "RTILoopbackImpl.h"
   #include "RTIDDSImpl.h"
 #elif defined(PERFTEST_RTI_MICRO)
   #include "RTIDDSImpl.h"
@@ -19,6 +21,10 @@
 #endif
 #include "CpuMonitor.h"
 #include "Infrastructure_common.h"
+#ifdef PERFTEST_RTI_PRO
+  #include <atomic>
+  #include <thread>
+#endif
 
 /*
  * We set 28 as the default value since this matches with the Micro use-case
@@ -139,7 +145,13 @@ int perftest_cpp_main(char *args)
 int perftest_cpp::Run(int argc, char *argv[])
 {
     unsigned short mask;
+  #ifdef PERFTEST_RTI_PRO
+    if (_loopbackSubscriberId < 0) {
+        print_version();
+    }
+  #else
     print_version();
+  #endif
 
     try {
         _PM.initialize();
@@ -150,9 +162,31 @@ int perftest_cpp::Run(int argc, char *argv[])
     if (_PM.check_help(argc, argv)) {
         return 0;
     }
+  #ifdef PERFTEST_RTI_PRO
+    /*
+     * The subscribers of a -loopback test use the command line of the
+     * publisher, so parse it without the publisher parameters.
+     */
+    std::vector<std::string> subscriberArguments;
+    std::vector<char *> subscriberArgv;
+    if (_loopbackSubscriberId >= 0) {
+        subscriberArguments = _PM.remove_group_arguments(argc, argv, PUB);
+        for (unsigned int i = 0; i < subscriberArguments.size(); i++) {
+            subscriberArgv.push_back(&subscriberArguments[i][0]);
+        }
+        argc = (int) subscriberArgv.size();
+        argv = &subscriberArgv[0];
+    }
+  #endif
     if (!_PM.parse(argc, argv)) {
         return -1;
     }
+  #ifdef PERFTEST_RTI_PRO
+    if (_loopbackSubscriberId >= 0) {
+        _PM.set("sub", true);
+        _PM.set<int>("sidMultiSubTest", _loopbackSubscriberId);
+    }
+  #endif
     if (!_PM.check_incompatible_parameters()) {
         return -1;
     }
@@ -160,6 +194,14 @@ int perftest_cpp::Run(int argc, char *argv[])
         return -1;
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // The controller only launches the processes of the test
+    if (_PM.get<bool>("controller")) {
+        PerftestController controller(_PM);
+        return controller.run(argc, argv);
+    }
+  #endif
+
     if (_threadPriorities.isSet
             && !_threadPriorities.set_main_thread_priority()) {
         return -1;
@@ -177,6 +219,17 @@ int perftest_cpp::Run(int argc, char *argv[])
       #ifdef PERFTEST_RTI_PRO
         _MessagingImpl = new RTIRawTransportImpl();
       #endif
+    } else if (_PM.get<bool>("shmRing")) {
+      #if defined(PERFTEST_RTI_PRO) && defined(RTI_LINUX)
+        _MessagingImpl = new RTIShmRingImpl();
+      #else
+        fprintf(stderr, "-shmRing is only available on Linux.\n");
+        return -1;
+      #endif
+    } else if (_PM.get<bool>("loopback")) {
+      #ifdef PERFTEST_RTI_PRO
+        _MessagingImpl = new RTILoopbackImpl();
+      #endif
     } else {
         mask = (_PM.get<int>("unbounded") != 0) << 0;
         mask += _PM.get<bool>("keyed") << 1;
@@ -335,6 +388,15 @@ int perftest_cpp::Run(int argc, char *argv[])
         _printer = new PerftestJSONPrinter();
     } else if (outputFormat == "legacy") {
         _printer = new PerftestLegacyPrinter();
+    } else if (outputFormat == "columnar") {
+      #ifdef PERFTEST_RTI_PRO
+        _printer = new PerftestColumnarPrinter();
+      #else
+        fprintf(stderr,
+                "'-outputFormat columnar' is only available with Connext "
+                "Pro.\n");
+        return -1;
+      #endif
     }
 
     if (!_printer->initialize(&_PM)) {
@@ -343,8 +405,76 @@ int perftest_cpp::Run(int argc, char *argv[])
         return -1;
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // The subscribers of a -loopback test share the cores of the publisher
+    if (_PM.is_set("hostNoiseCheck") && _loopbackSubscriberId < 0) {
+        if (!run_host_noise_check()) {
+            return -1;
+        }
+        _printer->set_host_noise_json(_hostNoise->get_json());
+    }
+
+    if (_PM.get<bool>("asyncPrinter")) {
+        // The printer thread shares the cores of the event thread
+        const std::vector<int> &cores = _threadCPUAffinity.get_cores_event();
+        PerftestAsyncPrinter *asyncPrinter = new PerftestAsyncPrinter(_printer);
+        _printer = asyncPrinter;
+        if (!asyncPrinter->start(cores.empty() ? -1 : cores[0])) {
+            return -1;
+        }
+    }
+
+    // The timer wheel also shares the cores of the event thread
+    int timerWheelPriority = Perftest_THREAD_PRIORITY_DEFAULT;
+    int timerWheelOptions = Perftest_THREAD_OPTION_DEFAULT;
+    if (_threadPriorities.isSet) {
+        timerWheelPriority = _threadPriorities.main + 10;
+        timerWheelOptions = Perftest_THREAD_SETTINGS_REALTIME_PRIORITY
+                | Perftest_THREAD_SETTINGS_PRIORITY_ENFORCE;
+    }
+    const std::vector<int> &eventCores = _threadCPUAffinity.get_cores_event();
+    if (!_timerWheel.start(
+                timerWheelPriority,
+                timerWheelOptions,
+                eventCores.empty() ? -1 : eventCores[0])) {
+        return -1;
+    }
+  #endif
+
     print_configuration();
 
+  #ifdef PERFTEST_RTI_PRO
+    if (_PM.get<bool>("statsSegment")) {
+        std::string commandLine;
+        for (int i = 1; i < argc; i++) {
+            commandLine += (i > 1 ? " " : "") + std::string(argv[i]);
+        }
+        if (!_statsSegment.initialize(
+                    _PM.get<bool>("pub") ? "pub" : "sub",
+                    _PM.get<bool>("pub") ? _PM.get<int>("pidMultiPubTest")
+                                         : _PM.get<int>("sidMultiSubTest"),
+                    commandLine)) {
+            return -1;
+        }
+    }
+
+    // The subscribers of a -loopback test would use the same port
+    if (_PM.is_set("metricsEndpoint") && _loopbackSubscriberId < 0) {
+        _metricsServer = new PerftestMetricsServer(
+                _PM.get<bool>("pub") ? "pub" : "sub",
+                _PM.get<bool>("pub") ? _PM.get<int>("pidMultiPubTest")
+                                     : _PM.get<int>("sidMultiSubTest"));
+        if (!_metricsServer->start(
+                    _PM.get<std::string>("metricsEndpoint"))) {
+            return -1;
+        }
+    }
+
+    if (_PM.get<bool>("loopback") && _PM.get<bool>("pub")) {
+        return run_loopback(argc, argv);
+    }
+  #endif
+
     if (_PM.get<bool>("pub")) {
         return Publisher();
     } else {
@@ -352,6 +482,131 @@ int perftest_cpp::Run(int argc, char *argv[])
     }
 }
 
+#ifdef PERFTEST_RTI_PRO
+/*********************************************************
+ * Measure the noise of the cores of the test before it starts
+ * (-hostNoiseCheck). The wake-up latency of every core is measured with the
+ * priority of the threads that run on it.
+ */
+bool perftest_cpp::run_host_noise_check()
+{
+    _hostNoise = new PerftestHostNoise(
+            _PM.get<unsigned long long>("hostNoiseCheck"),
+            _PM.get<unsigned long long>("hostNoiseThreshold"));
+
+    const std::vector<int> *cores[] = {
+        &_threadCPUAffinity.get_cores_main(),
+        &_threadCPUAffinity.get_cores_receive(),
+        &_threadCPUAffinity.get_cores_db(),
+        &_threadCPUAffinity.get_cores_event()
+    };
+    int priorities[] = {
+        _threadPriorities.main,
+        _threadPriorities.receive,
+        _threadPriorities.dbAndEvent,
+        _threadPriorities.dbAndEvent
+    };
+    int threadOptions = Perftest_THREAD_OPTION_DEFAULT;
+    if (_threadPriorities.isSet) {
+        threadOptions = Perftest_THREAD_SETTINGS_REALTIME_PRIORITY
+                | Perftest_THREAD_SETTINGS_PRIORITY_ENFORCE;
+    }
+
+    for (unsigned int i = 0; i < sizeof(cores) / sizeof(cores[0]); i++) {
+        for (unsigned int j = 0; j < cores[i]->size(); j++) {
+            _hostNoise->add_core(
+                    (*cores[i])[j],
+                    _threadPriorities.isSet
+                            ? priorities[i]
+                            : Perftest_THREAD_PRIORITY_DEFAULT,
+                    threadOptions);
+        }
+    }
+    // Without -threadCPUAffinity, a single check not pinned to any core
+    if (!_threadCPUAffinity.isInitialized()) {
+        _hostNoise->add_core(
+                -1,
+                _threadPriorities.isSet
+                        ? _threadPriorities.main
+                        : Perftest_THREAD_PRIORITY_DEFAULT,
+                threadOptions);
+    }
+
+    if (!_hostNoise->run()) {
+        return false;
+    }
+    if (_hostNoise->is_noisy()) {
+        fprintf(stderr,
+                "[Warning] Noisy host: gaps or wake-up latencies longer than "
+                "%llu us, see the configuration summary.\n",
+                _PM.get<unsigned long long>("hostNoiseThreshold"));
+    }
+    return true;
+}
+
+/*********************************************************
+ * Run one of the subscribers of a -loopback test, with the same command line
+ * as the publisher.
+ */
+static void loopback_subscriber_thread(
+        int argc,
+        char **argv,
+        int subscriberId,
+        int *result)
+{
+    try {
+        perftest_cpp subscriber;
+        subscriber.set_loopback_subscriber(subscriberId);
+        *result = subscriber.Run(argc, argv);
+    } catch (const std::exception &ex) {
+        fprintf(stderr,
+                "Exception in loopback subscriber %d: %s.\n",
+                subscriberId,
+                ex.what());
+        *result = -1;
+    }
+}
+
+/*********************************************************
+ * Run a -loopback test: the subscribers run as threads of this process and
+ * the publisher runs in the main thread.
+ */
+int perftest_cpp::run_loopback(int argc, char *argv[])
+{
+    const int numSubscribers = _PM.get<int>("numSubscribers");
+    std::vector<int> results(numSubscribers, 0);
+    std::vector<std::thread> subscribers;
+
+    for (int i = 0; i < numSubscribers; i++) {
+        subscribers.push_back(std::thread(
+                loopback_subscriber_thread,
+                argc,
+                argv,
+                i,
+                &results[i]));
+    }
+
+    int result = Publisher();
+
+    /* If the publisher failed, the subscribers would wait forever */
+    if (result != 0) {
+        for (unsigned int i = 0; i < subscribers.size(); i++) {
+            subscribers[i].detach();
+        }
+        return result;
+    }
+
+    for (unsigned int i = 0; i < subscribers.size(); i++) {
+        subscribers[i].join();
+        if (results[i] != 0) {
+            result = results[i];
+        }
+    }
+
+    return result;
+}
+#endif
+
 const Perftest_ProductVersion_t perftest_cpp::get_perftest_version()
 {
     return _version;
@@ -397,6 +652,10 @@ void perftest_cpp::print_version()
  */
 perftest_cpp::~perftest_cpp()
 {
+  #ifdef PERFTEST_RTI_PRO
+    _timerWheel.stop();
+  #endif
+
     if(_MessagingImpl != NULL){
         delete _MessagingImpl;
     }
@@ -405,6 +664,15 @@ perftest_cpp::~perftest_cpp()
         delete _printer;
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    if (_metricsServer != NULL) {
+        delete _metricsServer;
+    }
+    if (_hostNoise != NULL) {
+        delete _hostNoise;
+    }
+  #endif
+
     fprintf(stderr, "Test ended.\n");
     fflush(stderr);
 }
@@ -435,6 +703,12 @@ perftest_cpp::perftest_cpp()
     _SleepNanosec = 0;
     _MessagingImpl = NULL;
     _printer = NULL;
+  #ifdef PERFTEST_RTI_PRO
+    _loopbackSubscriberId = -1;
+    _numaNode = -1;
+    _metricsServer = NULL;
+    _hostNoise = NULL;
+  #endif
 
     /*
      * We use rand to generate the key of a SHMEM segment when
@@ -527,103 +801,510 @@ bool perftest_cpp::validate_input()
         }
     }
 
-    // Manage the parameter: -pubRate -sleep -spin
-    if (_PM.is_set("pubRate") || _PM.is_set("pubRatebps")) {
-        if (_SpinLoopCount > 0) {
-            fprintf(stderr, "'-spin' is not compatible with '-pubRate'. "
-                    "Spin/Sleep value will be set by -pubRate.\n");
-            _SpinLoopCount = 0;
+    // Manage the parameter: -cftKeys
+    if (_PM.is_set("cftKeys") && _PM.is_set("cft")) {
+        fprintf(stderr, "'-cftKeys' cannot be used with '-cft'.\n");
+        return false;
+    }
+
+    // Manage the parameter: -readThreads
+    if (_PM.get<int>("readThreads") > 1) {
+        if (!_PM.get<bool>("keyed")
+                || _PM.get<long>("instances") < _PM.get<int>("readThreads")) {
+            fprintf(stderr,
+                    "'-readThreads' requires '-keyed' and at least as many "
+                    "'-instances' as threads.\n");
+            return false;
         }
-        if (_SleepNanosec > 0) {
-            fprintf(stderr, "'-sleep' is not compatible with '-pubRate'. "
-                    "Spin/Sleep value will be set by -pubRate.\n");
-            _SleepNanosec = 0;
+        if (_PM.is_set("cft") || _PM.is_set("cftKeys")) {
+            fprintf(stderr,
+                    "'-readThreads' is not compatible with '-cft' and "
+                    "'-cftKeys'.\n");
+            return false;
+        }
+      #ifdef RTI_FLATDATA_AVAILABLE
+        if (_PM.get<bool>("flatdata") || _PM.get<bool>("zerocopy")) {
+            fprintf(stderr,
+                    "'-readThreads' is not compatible with '-flatData'.\n");
+            return false;
         }
+      #endif
+        _PM.set("useReadThread", true);
     }
 
-    if (_PM.is_set("loadDataFromFile")){
-        /*
-         * Load a file in memory if realPayload is set.
-         * If dataLen is not defined, we will use the size of the file.
-         * This function may take some time to load
-         */
-        if(!_fileDataLoader.initialize(
-                _PM.get<std::string>("loadDataFromFile"),
-                &_PM)) {
-            fprintf(stderr, "Could not start the fileDataLoader.\n");
+    // Manage the parameter: -sendThreads
+    if (_PM.get<int>("sendThreads") > 1) {
+        if (_PM.get<bool>("latencyTest")
+                || _PM.get<bool>("lowResolutionClock")) {
+            fprintf(stderr,
+                    "'-sendThreads' cannot be used in a Latency Test.\n");
             return false;
         }
-
+        if (_PM.is_set("loadDataFromFile")) {
+            fprintf(stderr,
+                    "'-sendThreads' is not compatible with "
+                    "'-loadDataFromFile'.\n");
+            return false;
+        }
+      #ifdef RTI_FLATDATA_AVAILABLE
+        if (_PM.get<bool>("flatdata") || _PM.get<bool>("zerocopy")) {
+            fprintf(stderr,
+                    "'-sendThreads' is not compatible with '-flatData'.\n");
+            return false;
+        }
+      #endif
     }
 
-    // Manage the parameter: -unbounded
-    if (_PM.is_set("unbounded")) {
-        if (_PM.get<int>("unbounded") == 0) { // Is the default
-            _PM.set<int>("unbounded", (int)(std::min)(
-                    2 * _PM.get<unsigned long long>("dataLen"),
-                    (unsigned long long)MAX_BOUNDED_SEQ_SIZE));
+    // Manage the parameter: -batchSizeSweep
+    if (_PM.is_set("batchSizeSweep")) {
+        if (_PM.get<bool>("latencyTest")
+                || _PM.get<bool>("lowResolutionClock")) {
+            fprintf(stderr,
+                    "'-batchSizeSweep' cannot be used in a Latency Test.\n");
+            return false;
+        }
+        if (_PM.is_set("batchSize")) {
+            fprintf(stderr,
+                    "'-batchSizeSweep' is not compatible with "
+                    "'-batchSize'.\n");
+            return false;
+        }
+        if (_PM.is_set("pubRate") || _PM.is_set("pubRatebps")) {
+            fprintf(stderr,
+                    "'-batchSizeSweep' is not compatible with '-pubRate'.\n");
+            return false;
+        }
+        if (_PM.get<unsigned long long>("executionTime") > 0) {
+            fprintf(stderr,
+                    "'-batchSizeSweep' is not compatible with "
+                    "'-executionTime', use '-numIter' instead.\n");
+            return false;
+        }
+        if (_PM.get<int>("sendThreads") > 1) {
+            fprintf(stderr,
+                    "'-batchSizeSweep' is not compatible with "
+                    "'-sendThreads'.\n");
+            return false;
+        }
+        if (_PM.get<unsigned long long>("numIter")
+                < _PM.get_vector<unsigned long long>("batchSizeSweep").size()) {
+            fprintf(stderr,
+                    "'-numIter' must be at least the number of batch sizes "
+                    "in '-batchSizeSweep'.\n");
+            return false;
         }
     }
 
-    // Manage the parameter: -threadPriorities
-    if (_PM.is_set("threadPriorities")) {
-        const std::string priorities = _PM.get<std::string>("threadPriorities");
-        if (!_threadPriorities.parse_priority(priorities)) {
-            fprintf(stderr, "Could not set -threadPriorities.\n");
+    // Manage the parameter: -latencyProbeRate
+    if (_PM.is_set("latencyProbeRate")) {
+        if (_PM.get<bool>("latencyTest")
+                || _PM.get<bool>("lowResolutionClock")) {
+            fprintf(stderr,
+                    "'-latencyProbeRate' cannot be used in a Latency Test.\n");
+            return false;
+        }
+        if (_PM.get<int>("sendThreads") > 1
+                || _PM.is_set("batchSizeSweep")) {
+            fprintf(stderr,
+                    "'-latencyProbeRate' is not compatible with "
+                    "'-sendThreads' or '-batchSizeSweep'.\n");
             return false;
         }
-        _threadPriorities.isSet = true;
     }
 
-  #ifdef PERFTEST_RTI_PRO
-    if (_PM.is_set("threadCPUAffinity")) {
-        if (!_threadCPUAffinity.parse_affinities(_PM.get<std::string>("threadCPUAffinity"))) {
-            fprintf(stderr, "Could not set -threadCPUAffinity.\n");
+    // Manage the parameter: -rampRate
+    if (_PM.is_set("rampRate")) {
+        const std::vector<unsigned long long> rampRate =
+                _PM.get_vector<unsigned long long>("rampRate");
+        if (rampRate.size() != 4 || rampRate[2] < rampRate[0]) {
+            fprintf(stderr,
+                    "'-rampRate' requires <start>:<step>:<max>:<secondsPerStep>"
+                    " with <max> bigger or equal than <start>.\n");
             return false;
         }
-        // isSet is already set to true in parse_affinities
+        if (_PM.get<bool>("latencyTest")
+                || _PM.get<bool>("lowResolutionClock")) {
+            fprintf(stderr, "'-rampRate' cannot be used in a Latency Test.\n");
+            return false;
+        }
+        if (_PM.is_set("pubRate") || _PM.is_set("pubRatebps")) {
+            fprintf(stderr,
+                    "'-rampRate' is not compatible with '-pubRate'.\n");
+            return false;
+        }
+        if (_PM.get<int>("sendThreads") > 1
+                || _PM.is_set("batchSizeSweep")) {
+            fprintf(stderr,
+                    "'-rampRate' is not compatible with "
+                    "'-sendThreads' or '-batchSizeSweep'.\n");
+            return false;
+        }
+        char *end = NULL;
+        double maxLoss = strtod(
+                _PM.get<std::string>("rampMaxLoss").c_str(),
+                &end);
+        if (end == NULL || *end != '\0' || maxLoss < 0 || maxLoss > 100) {
+            fprintf(stderr,
+                    "'-rampMaxLoss' must be a percentage between 0 and 100.\n");
+            return false;
+        }
+
+        // The ramp drives the -pubRate control loop, starting at <start>
+        _PM.set("pubRate", std::pair<unsigned long long, std::string>(
+                rampRate[0],
+                "spin"));
     }
-  #endif
 
-    // Check if we need to enable the use of unbounded sequences.
-    if (_PM.get<unsigned long long>("dataLen") > MAX_BOUNDED_SEQ_SIZE) {
-        if (_PM.get<int>("unbounded") == 0) {
-            _PM.set<int>("unbounded", MAX_BOUNDED_SEQ_SIZE);
+  #ifdef PERFTEST_RTI_PRO
+    // Manage the parameter: -latencyFileBinary
+    if (_PM.get<bool>("latencyFileBinary") && !_PM.is_set("latencyFile")) {
+        fprintf(stderr, "'-latencyFileBinary' requires '-latencyFile'.\n");
+        return false;
+    }
+
+    // Manage the parameters: -repetitions, -warmupSeconds, -steadyState
+    if (_PM.is_set("repetitions")) {
+        if (_PM.get<int>("pidMultiPubTest") != 0) {
+            fprintf(stderr,
+                    "'-repetitions' can only be used in the Publisher with "
+                    "'-pidMultiPubTest 0'.\n");
+            return false;
+        }
+        if (_PM.is_set("rampRate")
+                || _PM.get<int>("sendThreads") > 1
+                || _PM.is_set("batchSizeSweep")
+                || _PM.get<bool>("lowResolutionClock")) {
+            fprintf(stderr,
+                    "'-repetitions' is not compatible with '-rampRate', "
+                    "'-sendThreads', '-batchSizeSweep' or "
+                    "'-lowResolutionClock'.\n");
+            return false;
+        }
+        if (_PM.is_set("steadyState")) {
+            char *end = NULL;
+            double maxVariation = strtod(
+                    _PM.get<std::string>("steadyState").c_str(),
+                    &end);
+            if (end == NULL || *end != '\0' || maxVariation <= 0) {
+                fprintf(stderr,
+                        "'-steadyState' must be a percentage bigger than "
+                        "0.\n");
+                return false;
+            }
+            if (!_PM.is_set("warmupSeconds")) {
+                _PM.set<unsigned long long>("warmupSeconds", 60);
+            }
         }
+    } else if (_PM.is_set("warmupSeconds") || _PM.is_set("steadyState")
+            || _PM.is_set("repetitionSeconds")) {
+        fprintf(stderr,
+                "'-warmupSeconds', '-steadyState' and '-repetitionSeconds' "
+                "require '-repetitions'.\n");
+        return false;
     }
 
-    /* RawTransport only allow listeners by threads */
-    if (_PM.get<bool>("rawTransport")) {
-        _PM.set("useReadThread", true);
+    // Manage the parameter: -memoryMode
+    if (!MemoryArena::get_instance().initialize(
+                _PM.get<std::string>("memoryMode"))) {
+        return false;
     }
 
-    // Manage the lowResolutionClock parameter
-    if (_PM.get<bool>("lowResolutionClock")) {
-        if (_PM.get<unsigned long long>("latencyCount") != 1) {
+    // Manage the parameter: -numaPlacement
+    if (_PM.is_set("numaPlacement")) {
+        if (!_numaTopology.load()) {
+            return false;
+        }
+        const std::string placement = _PM.get<std::string>("numaPlacement");
+        if (placement == "auto") {
+            if (_PM.is_set("nic")) {
+                _numaNode = NumaTopology::get_nic_node(
+                        _PM.get<std::string>("nic"));
+                _numaNodeReason = "node of the NIC";
+            }
+            if (_numaNode < 0) {
+                _numaNode = _numaTopology.get_current_node();
+                _numaNodeReason = "node of the main thread";
+            }
+        } else {
+            char *end = NULL;
+            _numaNode = (int) strtol(placement.c_str(), &end, 10);
+            if (placement.empty() || *end != '\0') {
+                fprintf(stderr,
+                        "'-numaPlacement' must be 'auto' or the number of a "
+                        "NUMA node.\n");
+                return false;
+            }
+            _numaNodeReason = "given";
+        }
+        if (_numaTopology.get_cores(_numaNode).empty()) {
             fprintf(stderr,
-                "The -lowResolutionClock option should only be used if "
-                "latencyCount is 1.\n");
+                    "The NUMA node %d does not exist or has no cores.\n",
+                    _numaNode);
             return false;
         }
 
-        if (_PM.is_set("sleep")
-                || _PM.is_set("pubRate")
-                || _PM.is_set("spin")) {
-            fprintf(stderr,
-                "The -lowResolutionClock cannot be used with the "
-                "sleep, spin or pubRate command-line options.\n");
+        // The buffers are first touched in the node, even if not prefaulted
+        MemoryArena::get_instance().set_numa_node(_numaNode);
+
+        // An explicit -threadCPUAffinity takes precedence over the plan
+        if (!_PM.is_set("threadCPUAffinity")
+                && !_threadCPUAffinity.parse_affinities(
+                        _numaTopology.plan_affinity(_numaNode))) {
+            fprintf(stderr, "Could not plan the thread CPU affinity.\n");
             return false;
         }
     }
 
-    #ifdef RTI_FLATDATA_AVAILABLE
-      // Automatically enable FlatData when using Zero Copy
-      if (_PM.get<bool>("zerocopy") && !_PM.get<bool>("flatdata")) {
-           _PM.set<bool>("flatdata", true);
-      }
-
-      if (_PM.get<bool>("zerocopy") && 
-            !(_PM.get<std::string>("transport") == "SHMEM" 
+    // Manage the parameter: -clock
+  #ifndef RTI_USE_CPP_11_INFRASTRUCTURE
+    if (!PerftestClock::getInstance().setClockSource(
+                _PM.get<std::string>("clock"))) {
+        return false;
+    }
+  #else
+    if (_PM.get<std::string>("clock") != "default") {
+        fprintf(stderr,
+                "'-clock' is not available with the C++11 infrastructure.\n");
+        return false;
+    }
+  #endif
+
+    // Manage the parameter: -dataLenDistribution
+    if (_PM.is_set("dataLenDistribution")) {
+        if (_PM.is_set("dataLen")) {
+            fprintf(stderr,
+                    "'-dataLenDistribution' cannot be used with '-dataLen', "
+                    "the data length is the maximum of the distribution.\n");
+            return false;
+        }
+        if (_PM.get<int>("sendThreads") > 1
+                || _PM.is_set("batchSizeSweep")
+                || _PM.is_set("loadDataFromFile")) {
+            fprintf(stderr,
+                    "'-dataLenDistribution' is not compatible with "
+                    "'-sendThreads', '-batchSizeSweep' and "
+                    "'-loadDataFromFile'.\n");
+            return false;
+        }
+        if (_PM.get<std::string>("outputFormat") == "json") {
+            fprintf(stderr,
+                    "'-dataLenDistribution' is not compatible with "
+                    "'-outputFormat json'.\n");
+            return false;
+        }
+        if (!_dataLenDistribution.initialize(
+                    _PM.get<std::string>("dataLenDistribution"),
+                    OVERHEAD_BYTES,
+                    MAX_PERFTEST_SAMPLE_SIZE)) {
+            return false;
+        }
+        /*
+         * The type (bounded or unbounded) and the buffers are chosen for
+         * the biggest sample of the distribution.
+         */
+        _PM.set<unsigned long long>(
+                "dataLen",
+                _dataLenDistribution.get_max());
+    }
+
+    // Manage the parameter: -scenario
+    if (_PM.is_set("scenario")) {
+        if (_PM.is_set("rampRate") || _PM.is_set("repetitions")
+                || _PM.is_set("batchSizeSweep")
+                || _PM.is_set("dataLenDistribution")
+                || _PM.is_set("loadDataFromFile")
+                || _PM.get<int>("sendThreads") > 1
+                || _PM.get<int>("readThreads") > 1) {
+            fprintf(stderr,
+                    "'-scenario' is not compatible with '-rampRate', "
+                    "'-repetitions', '-batchSizeSweep', "
+                    "'-dataLenDistribution', '-loadDataFromFile', "
+                    "'-sendThreads' and '-readThreads'.\n");
+            return false;
+        }
+        if (_PM.is_set("pubRate") || _PM.is_set("pubRatebps")) {
+            fprintf(stderr,
+                    "'-scenario' is not compatible with '-pubRate', the rate "
+                    "is set by every phase.\n");
+            return false;
+        }
+        if (_PM.get<bool>("latencyTest")
+                || _PM.get<bool>("lowResolutionClock")) {
+            fprintf(stderr, "'-scenario' cannot be used in a Latency Test.\n");
+            return false;
+        }
+        if (_PM.get<std::string>("outputFormat") == "json") {
+            fprintf(stderr,
+                    "'-scenario' is not compatible with "
+                    "'-outputFormat json'.\n");
+            return false;
+        }
+        if (!_scenario.initialize(
+                    _PM.get<std::string>("scenario"),
+                    _PM.get<unsigned long long>("dataLen"),
+                    OVERHEAD_BYTES,
+                    MAX_PERFTEST_SAMPLE_SIZE)) {
+            return false;
+        }
+        if (_scenario.get_max_instance() >= 0
+                && (_scenario.get_max_instance() >= _PM.get<long>("instances")
+                    || _PM.is_set("writeInstance")
+                    || _PM.is_set("keyDistribution"))) {
+            fprintf(stderr,
+                    "The 'instances=' of '-scenario' must be lower than "
+                    "'-instances' and cannot be used with '-writeInstance' "
+                    "or '-keyDistribution'.\n");
+            return false;
+        }
+        // Like -dataLenDistribution, the type is chosen for the biggest size
+        _PM.set<unsigned long long>("dataLen", _scenario.get_max_data_len());
+    }
+  #endif
+
+    // Manage the parameter: -pubRate -sleep -spin
+    if (_PM.is_set("pubRate") || _PM.is_set("pubRatebps")) {
+        if (_SpinLoopCount > 0) {
+            fprintf(stderr, "'-spin' is not compatible with '-pubRate'. "
+                    "Spin/Sleep value will be set by -pubRate.\n");
+            _SpinLoopCount = 0;
+        }
+        if (_SleepNanosec > 0) {
+            fprintf(stderr, "'-sleep' is not compatible with '-pubRate'. "
+                    "Spin/Sleep value will be set by -pubRate.\n");
+            _SleepNanosec = 0;
+        }
+    }
+
+    if (_PM.is_set("loadDataFromFile")){
+        /*
+         * Load a file in memory if realPayload is set.
+         * If dataLen is not defined, we will use the size of the file.
+         * This function may take some time to load
+         */
+        if(!_fileDataLoader.initialize(
+                _PM.get<std::string>("loadDataFromFile"),
+                &_PM)) {
+            fprintf(stderr, "Could not start the fileDataLoader.\n");
+            return false;
+        }
+
+    }
+
+    // Manage the parameter: -unbounded
+    if (_PM.is_set("unbounded")) {
+        if (_PM.get<int>("unbounded") == 0) { // Is the default
+            _PM.set<int>("unbounded", (int)(std::min)(
+                    2 * _PM.get<unsigned long long>("dataLen"),
+                    (unsigned long long)MAX_BOUNDED_SEQ_SIZE));
+        }
+    }
+
+    // Manage the parameter: -threadPriorities
+    if (_PM.is_set("threadPriorities")) {
+        const std::string priorities = _PM.get<std::string>("threadPriorities");
+        if (!_threadPriorities.parse_priority(priorities)) {
+            fprintf(stderr, "Could not set -threadPriorities.\n");
+            return false;
+        }
+        _threadPriorities.isSet = true;
+    }
+
+  #ifdef PERFTEST_RTI_PRO
+    if (_PM.is_set("threadCPUAffinity")) {
+        if (!_threadCPUAffinity.parse_affinities(_PM.get<std::string>("threadCPUAffinity"))) {
+            fprintf(stderr, "Could not set -threadCPUAffinity.\n");
+            return false;
+        }
+        // isSet is already set to true in parse_affinities
+    }
+  #endif
+
+    // Check if we need to enable the use of unbounded sequences.
+    if (_PM.get<unsigned long long>("dataLen") > MAX_BOUNDED_SEQ_SIZE) {
+        if (_PM.get<int>("unbounded") == 0) {
+            _PM.set<int>("unbounded", MAX_BOUNDED_SEQ_SIZE);
+        }
+    }
+
+  #ifdef PERFTEST_RTI_PRO
+    // Manage the parameters: -controller and -controllerCores
+    if (_PM.get<bool>("controller")) {
+        // Given by the controller to every process
+        const char *controllerParameters[] = {
+            "pub", "sub", "pidMultiPubTest", "sidMultiSubTest",
+            "outputFormat", "outputFile", "metricsEndpoint", "loopback"
+        };
+        for (unsigned int i = 0;
+                i < sizeof(controllerParameters)
+                        / sizeof(controllerParameters[0]);
+                i++) {
+            if (_PM.is_set(controllerParameters[i])) {
+                fprintf(stderr,
+                        "-controller cannot be used with '-%s', it is set "
+                        "by the controller for every process.\n",
+                        controllerParameters[i]);
+                return false;
+            }
+        }
+    } else if (_PM.is_set("controllerCores")) {
+        fprintf(stderr, "-controllerCores can only be used with -controller.\n");
+        return false;
+    }
+
+    // Manage the parameter: -loopback
+    if (_PM.get<bool>("loopback")) {
+        if (_PM.get<bool>("sub") && _loopbackSubscriberId < 0) {
+            fprintf(stderr,
+                    "-loopback runs the subscribers as threads of the "
+                    "publisher, use it only with -pub.\n");
+            return false;
+        }
+        if (_PM.get<int>("numPublishers") > 1) {
+            fprintf(stderr, "-loopback only supports one publisher.\n");
+            return false;
+        }
+        if (_PM.get<std::string>("outputFormat") == "json") {
+            fprintf(stderr,
+                    "-loopback cannot be used with '-outputFormat json', "
+                    "the publisher and the subscribers print to the same "
+                    "output.\n");
+            return false;
+        }
+    }
+  #endif
+
+    /* RawTransport and shmRing only allow listeners by threads */
+    if (_PM.get<bool>("rawTransport") || _PM.get<bool>("shmRing")) {
+        _PM.set("useReadThread", true);
+    }
+
+    // Manage the lowResolutionClock parameter
+    if (_PM.get<bool>("lowResolutionClock")) {
+        if (_PM.get<unsigned long long>("latencyCount") != 1) {
+            fprintf(stderr,
+                "The -lowResolutionClock option should only be used if "
+                "latencyCount is 1.\n");
+            return false;
+        }
+
+        if (_PM.is_set("sleep")
+                || _PM.is_set("pubRate")
+                || _PM.is_set("spin")) {
+            fprintf(stderr,
+                "The -lowResolutionClock cannot be used with the "
+                "sleep, spin or pubRate command-line options.\n");
+            return false;
+        }
+    }
+
+    #ifdef RTI_FLATDATA_AVAILABLE
+      // Automatically enable FlatData when using Zero Copy
+      if (_PM.get<bool>("zerocopy") && !_PM.get<bool>("flatdata")) {
+           _PM.set<bool>("flatdata", true);
+      }
+
+      if (_PM.get<bool>("zerocopy") && 
+            !(_PM.get<std::string>("transport") == "SHMEM" 
                 || _PM.get<std::string>("transport") == "Use XML"
                 || _PM.get<std::string>("transport") == "UDPv4 & SHMEM"
                 || _PM.get<std::string>("transport") == "UDPv6 & SHMEM"
@@ -761,27 +1442,104 @@ void perftest_cpp::print_configuration()
             stringStream << "\tExecution time: "
                          << _PM.get<unsigned long long>("executionTime")
                          << " seconds\n";
-        } else {
+        } else if ((!_PM.is_set("rampRate") && !_PM.is_set("repetitions")
+                    && !_PM.is_set("scenario"))
+                || _PM.is_set("numIter")) {
             stringStream << "\tNumber of samples: "
                          << _PM.get<unsigned long long>("numIter")
                          << "\n";
         }
 
+        // Rate ramp
+        if (_PM.is_set("rampRate")) {
+            const std::vector<unsigned long long> rampRate =
+                    _PM.get_vector<unsigned long long>("rampRate");
+            stringStream << "\tRate Ramp: " << rampRate[0] << " to "
+                         << rampRate[2] << " Samples/s, +" << rampRate[1]
+                         << " every " << rampRate[3] << " seconds\n";
+        }
+
+      #ifdef PERFTEST_RTI_PRO
+        // Repetitions
+        if (_PM.is_set("repetitions")) {
+            stringStream << "\tRepetitions: "
+                         << _PM.get<unsigned long long>("repetitions")
+                         << " windows of "
+                         << _PM.get<unsigned long long>("repetitionSeconds")
+                         << " seconds, warm-up: ";
+            if (_PM.is_set("steadyState")) {
+                stringStream << "until steady state (CV < "
+                             << _PM.get<std::string>("steadyState")
+                             << " %, at most "
+                             << _PM.get<unsigned long long>("warmupSeconds")
+                             << " seconds)\n";
+            } else {
+                stringStream << _PM.get<unsigned long long>("warmupSeconds")
+                             << " seconds\n";
+            }
+        }
+
+        // Scenario
+        if (_PM.is_set("scenario")) {
+            unsigned long long durationUsec = 0;
+            for (unsigned int i = 0; i < _scenario.get_phases().size(); i++) {
+                durationUsec += _scenario.get_phases()[i].durationUsec;
+            }
+            stringStream << "\tScenario: " << _PM.get<std::string>("scenario")
+                         << " (" << _scenario.get_phases().size()
+                         << " phases, " << durationUsec / 1000000.0
+                         << " seconds)\n";
+        }
+      #endif
+
         // Manage the lowResolutionClock parameter
         if (_PM.get<bool>("lowResolutionClock")) {
             stringStream << "\tLow resolution clock latency measurements.\n";
         }
 
+        // Send threads
+        if (_PM.get<int>("sendThreads") > 1) {
+            stringStream << "\tSend threads: " << _PM.get<int>("sendThreads")
+                         << " (" << _PM.get<std::string>("sendThreadsWriter")
+                         << " DataWriter)\n";
+        }
+
+        // Latency probes
+        if (_PM.is_set("latencyProbeRate")) {
+            stringStream << "\tLatency probes: "
+                         << _PM.get<unsigned long long>("latencyProbeRate")
+                         << " samples/s\n";
+        }
+
+        // Batch size sweep
+        if (_PM.is_set("batchSizeSweep")) {
+            const std::vector<unsigned long long> batchSizes =
+                    _PM.get_vector<unsigned long long>("batchSizeSweep");
+            stringStream << "\tBatch Size Sweep:";
+            for (unsigned int i = 0; i < batchSizes.size(); i++) {
+                stringStream << " " << batchSizes[i];
+            }
+            stringStream << " Bytes ("
+                         << _PM.get<unsigned long long>("numIter")
+                                    / batchSizes.size()
+                         << " samples per step)\n";
+        }
+
     } else {
         stringStream << "\tData Size: " << _PM.get<unsigned long long>("dataLen");
         stringStream << std::endl;
     }
 
     // Listener/WaitSets
-    if (!_PM.get<bool>("rawTransport")) {
+    if (!_PM.get<bool>("rawTransport") && !_PM.get<bool>("shmRing")) {
         stringStream << "\tReceive using: ";
         if (_PM.get<bool>("useReadThread")) {
-            stringStream << "WaitSets\n";
+            stringStream << "WaitSets";
+            if (_PM.get<bool>("sub") && _PM.get<int>("readThreads") > 1) {
+                stringStream << " (" << _PM.get<int>("readThreads")
+                             << " threads, partitioned by instance)";
+            }
+            stringStream << "\n";
         } else {
             stringStream << "Listeners\n";
         }
@@ -811,6 +1569,21 @@ void perftest_cpp::print_configuration()
         stringStream << "\t\tEvent thread Core(s): "
                 << _threadCPUAffinity.get_cores_event_str() << std::endl;
     }
+
+    if (_hostNoise != NULL) {
+        stringStream << _hostNoise->get_summary();
+    }
+
+    if (_numaNode >= 0) {
+        stringStream << "\tNUMA Placement: node " << _numaNode
+                     << " of " << _numaTopology.get_node_count()
+                     << " (" << _numaNodeReason << "), threads and buffers\n";
+    }
+
+  #ifndef RTI_USE_CPP_11_INFRASTRUCTURE
+    // Clock source, and what reading every clock costs
+    stringStream << PerftestClock::getInstance().getClockDescription();
+  #endif
   #endif
 
     stringStream << _MessagingImpl->print_configuration();
@@ -855,6 +1628,72 @@ void perftest_cpp::print_configuration()
 
 }
 
+/*
+ * Counters of the ThroughputListener. With -readThreads the main thread reads
+ * them while the thread of every partition updates its own, so they are
+ * atomic. Only that thread writes them: it does not need a locked
+ * read-modify-write, a load and a store are enough.
+ */
+#ifdef PERFTEST_RTI_PRO
+typedef std::atomic<unsigned long long> ReceivedCounter;
+typedef std::atomic<unsigned long> ReceivedSeqNum;
+
+static inline void add_received(
+        ReceivedCounter &counter,
+        unsigned long long value)
+{
+    counter.store(
+            counter.load(std::memory_order_relaxed) + value,
+            std::memory_order_relaxed);
+}
+
+static inline unsigned long load_seq_num(const ReceivedSeqNum &seqNum)
+{
+    return seqNum.load(std::memory_order_acquire);
+}
+
+static inline void store_seq_num(ReceivedSeqNum &seqNum, unsigned long value)
+{
+    seqNum.store(value, std::memory_order_release);
+}
+#else
+typedef unsigned long long ReceivedCounter;
+typedef unsigned long ReceivedSeqNum;
+
+static inline void add_received(
+        ReceivedCounter &counter,
+        unsigned long long value)
+{
+    counter += value;
+}
+
+static inline unsigned long load_seq_num(const ReceivedSeqNum &seqNum)
+{
+    return seqNum;
+}
+
+static inline void store_seq_num(ReceivedSeqNum &seqNum, unsigned long value)
+{
+    seqNum = value;
+}
+#endif
+
+/*
+ * CPU time used by the calling thread, in microseconds. It is 0 if the OS
+ * does not provide it.
+ */
+static unsigned long long get_thread_cpu_time()
+{
+  #if defined(RTI_LINUX) && defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0) {
+        return (unsigned long long) now.tv_sec * 1000000
+                + now.tv_nsec / 1000;
+    }
+  #endif
+    return 0;
+}
+
 /*********************************************************
  * Listener for the Subscriber side
  *
@@ -873,9 +1712,9 @@ class ThroughputListener : public IMessagingCB
 
   public:
 
-    unsigned long long packets_received;
-    unsigned long long bytes_received;
-    unsigned long long missing_packets;
+    ReceivedCounter    packets_received;
+    ReceivedCounter    bytes_received;
+    ReceivedCounter    missing_packets;
     int                last_data_length;
 
     // store info for the last data set
@@ -890,12 +1729,72 @@ class ThroughputListener : public IMessagingCB
     IMessagingWriter *_writer;
     IMessagingReader *_reader;
     unsigned long * _last_seq_num;
+    /*
+     * Partitions only see a subset of the sequence numbers, so they keep the
+     * first one received of every publisher (plus one, 0 means none) and the
+     * highest one. The Subscriber gets the samples lost out of the ranges of
+     * all the partitions (-readThreads), while they are still receiving.
+     */
+    ReceivedSeqNum * _first_seq_num;
+    ReceivedSeqNum * _max_seq_num;
+    /*
+     * Publishers using -sendThreads announce the number of threads in the
+     * initialization messages. Thread i sends the sequence numbers i,
+     * i + threads, i + 2 * threads..., so the gaps are detected per thread.
+     */
+    std::vector<std::vector<unsigned long> > _last_thread_seq_num;
 
     int _num_publishers;
     std::vector<int> _finished_publishers;
     CpuMonitor cpu;
     bool _useCft;
 
+    /*
+     * CPU time used by the thread of a partition since its first sample,
+     * kept with the summary (microseconds, 0 if not known).
+     */
+    unsigned long long begin_thread_cpu;
+    unsigned long long interval_thread_cpu;
+
+    /*
+     * Index of the partition of instances received by this listener when
+     * using -readThreads, -1 otherwise. Partitioned listeners share the pong
+     * writer, so the access to it is serialized with _writerMutex.
+     */
+    int _partition;
+    PerftestMutex *_writerMutex;
+
+    /*
+     * The Publisher asked for the samples lost in the seq_num of the pongs.
+     * Only listeners that see every sequence number (no -cft or -readThreads)
+     * accept it, the rest echo the ping as the other implementations do.
+     */
+    bool _lostSamplesInPong;
+
+  #ifdef PERFTEST_RTI_PRO
+    /*
+     * With -dataLenDistribution the size changes in every sample, so the
+     * whole test uses the length of the biggest one (-1 otherwise), and the
+     * samples are also counted by size.
+     */
+    int _distributionLength;
+    DataLenBucketStats *_sizeBuckets;
+
+    /*
+     * With -scenario the counters are copied at every phase mark of the
+     * first Publisher, which are sent in order with the samples. A phase
+     * gets what was received between its mark and the next one.
+     */
+    struct ScenarioPhaseMark {
+        long phase;
+        unsigned long long time;
+        unsigned long long packets;
+        unsigned long long bytes;
+        unsigned long long missing;
+    };
+    std::vector<ScenarioPhaseMark> _phaseMarks;
+  #endif
+
 
     ThroughputListener(
             ParameterManager &PM,
@@ -903,7 +1802,8 @@ class ThroughputListener : public IMessagingCB
             IMessagingWriter *writer,
             IMessagingReader *reader = NULL,
             bool UseCft = false,
-            int numPublishers = 1)
+            int numPublishers = 1,
+            int partition = -1)
     {
         packets_received = 0;
         bytes_received = 0;
@@ -921,10 +1821,20 @@ class ThroughputListener : public IMessagingCB
         _writer = writer;
         _reader = reader;
         _last_seq_num = new unsigned long[numPublishers];
+        _first_seq_num = new ReceivedSeqNum[numPublishers];
+        _max_seq_num = new ReceivedSeqNum[numPublishers];
+        _last_thread_seq_num.resize(numPublishers);
         _useCft = UseCft;
+        _partition = partition;
+        _writerMutex = NULL;
+        _lostSamplesInPong = false;
+        begin_thread_cpu = 0;
+        interval_thread_cpu = 0;
 
         for (int i = 0; i < numPublishers; i++) {
             _last_seq_num[i] = 0;
+            store_seq_num(_first_seq_num[i], 0);
+            store_seq_num(_max_seq_num[i], 0);
         }
 
         _num_publishers = numPublishers;
@@ -936,12 +1846,37 @@ class ThroughputListener : public IMessagingCB
         cacheStats = _PM->get<bool>("cacheStats");
         showCpu = _PM->get<bool>("cpu");
         subID = _PM->get<int>("sidMultiSubTest");
+
+      #ifdef PERFTEST_RTI_PRO
+        _distributionLength = -1;
+        _sizeBuckets = NULL;
+        // The sizes of -scenario change, but it is still a single test
+        if (_PM->is_set("dataLenDistribution") || _PM->is_set("scenario")) {
+            _distributionLength = (int) _PM->get<unsigned long long>("dataLen")
+                    - perftest_cpp::OVERHEAD_BYTES;
+        }
+        // Partitions do not print their own summary
+        if (_PM->is_set("dataLenDistribution") && _partition < 0) {
+            _sizeBuckets = new DataLenBucketStats();
+        }
+      #endif
     }
 
     ~ThroughputListener() {
         if (_last_seq_num != NULL) {
             delete []_last_seq_num;
         }
+        if (_first_seq_num != NULL) {
+            delete []_first_seq_num;
+        }
+        if (_max_seq_num != NULL) {
+            delete []_max_seq_num;
+        }
+      #ifdef PERFTEST_RTI_PRO
+        if (_sizeBuckets != NULL) {
+            delete _sizeBuckets;
+        }
+      #endif
     }
 
     void process_message(TestMessage &message)
@@ -956,8 +1891,34 @@ class ThroughputListener : public IMessagingCB
         // Check for test initialization messages
         if (message.size == perftest_cpp::INITIALIZE_SIZE)
         {
-            _writer->send(message);
-            _writer->flush();
+          #ifdef PERFTEST_RTI_PRO
+            if (message.latency_ping == perftest_cpp::SCENARIO_PHASE_MARK) {
+                if (message.entity_id == 0 && _PM->is_set("scenario")) {
+                    mark_scenario_phase(message.timestamp_sec);
+                }
+                return;
+            }
+          #endif
+            if (message.seq_num > 1
+                    && _last_thread_seq_num[message.entity_id].size()
+                            != message.seq_num) {
+                _last_thread_seq_num[message.entity_id].assign(
+                        message.seq_num,
+                        0);
+            }
+            // Every partition gets it, but only one of them has to reply
+            if (_partition > 0) {
+                return;
+            }
+            if (message.latency_ping == perftest_cpp::LOST_SAMPLES_REQUEST
+                    && !_useCft && _partition < 0) {
+                _lostSamplesInPong = true;
+                TestMessage reply = message;
+                reply.latency_ping = perftest_cpp::LOST_SAMPLES_REPLY;
+                send_pong(reply);
+                return;
+            }
+            send_pong(message);
             return;
         }
         else if (message.size == perftest_cpp::FINISHED_SIZE)
@@ -986,8 +1947,29 @@ class ThroughputListener : public IMessagingCB
 
             _finished_publishers.push_back(message.entity_id);
 
+            /*
+             * The last samples sent may not have reached this partition,
+             * the end of test message carries the last sequence number.
+             */
+            if (_partition >= 0
+                    && load_seq_num(_first_seq_num[message.entity_id]) != 0
+                    && message.seq_num
+                            > load_seq_num(_max_seq_num[message.entity_id])) {
+                store_seq_num(_max_seq_num[message.entity_id], message.seq_num);
+            }
+
             if (_finished_publishers.size() >= (unsigned int)_num_publishers) {
-                print_summary_throughput(message, true);
+              #ifdef PERFTEST_RTI_PRO
+                // The end of the last phase, if its mark was not received
+                if (!_phaseMarks.empty()) {
+                    mark_scenario_phase(-1);
+                }
+              #endif
+                if (_partition < 0) {
+                    print_summary_throughput(message, true);
+                } else {
+                    store_summary_throughput();
+                }
                 end_test = true;
             }
             return;
@@ -999,29 +1981,90 @@ class ThroughputListener : public IMessagingCB
           #ifdef DEBUG_PING_PONG
             printf("-- Answering Ping ...\n");
           #endif
-            _writer->send(message);
-            _writer->flush();
+            /*
+             * If asked, the pong carries the number of samples lost so far in
+             * seq_num, so the Publisher can follow the loss during the test
+             * (-rampRate, -repetitions, -scenario).
+             */
+            if (_lostSamplesInPong) {
+                TestMessage pong = message;
+                pong.seq_num = (unsigned int) missing_packets;
+                send_pong(pong);
+            } else {
+                send_pong(message);
+            }
+        }
+
+        int length = message.size;
+      #ifdef PERFTEST_RTI_PRO
+        if (_distributionLength >= 0) {
+            length = _distributionLength;
         }
+      #endif
 
-        if (message.size != last_data_length) {
+        if (length != last_data_length) {
             packets_received = 0;
             bytes_received = 0;
             missing_packets = 0;
 
             for (int i=0; i<_num_publishers; i++) {
                 _last_seq_num[i] = 0;
+                store_seq_num(_first_seq_num[i], 0);
+                store_seq_num(_max_seq_num[i], 0);
+                std::fill(
+                        _last_thread_seq_num[i].begin(),
+                        _last_thread_seq_num[i].end(),
+                        0);
             }
 
             begin_time = PerftestClock::getInstance().getTime();
-            _printer->_dataLength = message.size + perftest_cpp::OVERHEAD_BYTES;
-            _printer->print_throughput_header();
+            if (_partition >= 0 && showCpu) {
+                begin_thread_cpu = get_thread_cpu_time();
+            }
+            if (_partition <= 0) {
+                _printer->_dataLength = length + perftest_cpp::OVERHEAD_BYTES;
+                _printer->print_throughput_header();
+            }
         }
 
-        last_data_length = message.size;
-        ++packets_received;
-        bytes_received += (unsigned long long) (message.size + perftest_cpp::OVERHEAD_BYTES);
+        last_data_length = length;
+        add_received(packets_received, 1);
+        add_received(
+                bytes_received,
+                (unsigned long long) (message.size
+                        + perftest_cpp::OVERHEAD_BYTES));
+      #ifdef PERFTEST_RTI_PRO
+        if (_sizeBuckets != NULL) {
+            _sizeBuckets->add_sample(message.size + perftest_cpp::OVERHEAD_BYTES);
+        }
+      #endif
 
-        if (!_useCft) {
+        if (_partition >= 0) {
+            /*
+             * Keep the range of sequence numbers received by this partition.
+             * It is stored after the counters, so whoever sees the range also
+             * sees the samples received in it.
+             */
+            ReceivedSeqNum &first = _first_seq_num[message.entity_id];
+            ReceivedSeqNum &max = _max_seq_num[message.entity_id];
+            if (load_seq_num(first) == 0) {
+                store_seq_num(first, (unsigned long) message.seq_num + 1);
+            }
+            if (message.seq_num > load_seq_num(max)) {
+                store_seq_num(max, message.seq_num);
+            }
+        } else if (!_useCft && !_last_thread_seq_num[message.entity_id].empty()) {
+            // detect missing packets of every send thread
+            std::vector<unsigned long> &lastSeqNum =
+                    _last_thread_seq_num[message.entity_id];
+            const unsigned long threads = (unsigned long) lastSeqNum.size();
+            unsigned long &last = lastSeqNum[message.seq_num % threads];
+            if (last != 0 && message.seq_num > last + threads) {
+                missing_packets +=
+                        (message.seq_num - last - threads) / threads;
+            }
+            last = message.seq_num;
+        } else if (!_useCft) {
             // detect missing packets
             if (_last_seq_num[message.entity_id] == 0) {
                 _last_seq_num[message.entity_id] = message.seq_num;
@@ -1086,6 +2129,11 @@ class ThroughputListener : public IMessagingCB
                     interval_missing_packets,
                     missing_packets_percent,
                     outputCpu);
+          #ifdef PERFTEST_RTI_PRO
+            if (_sizeBuckets != NULL) {
+                _sizeBuckets->print_throughput(interval_time);
+            }
+          #endif
             if (cacheStats) {
                 printf("Samples Ping Reader Queue Peak: %4d\n", sample_count_peak);
             }
@@ -1110,6 +2158,147 @@ class ThroughputListener : public IMessagingCB
         _last_seq_num[0] = 0;
         begin_time = now;
     }
+
+    /*
+     * Partitioned listeners do not print their own summary. They keep the
+     * results so the Subscriber can print the aggregated one.
+     */
+    void store_summary_throughput()
+    {
+        interval_time = PerftestClock::getInstance().getTime() - begin_time;
+        interval_packets_received = packets_received;
+        interval_bytes_received = bytes_received;
+        interval_missing_packets = 0;
+        if (showCpu && begin_thread_cpu != 0) {
+            interval_thread_cpu = get_thread_cpu_time() - begin_thread_cpu;
+        }
+        interval_data_length = last_data_length;
+        missing_packets_percent = 0;
+    }
+
+    /*
+     * Samples lost by a -readThreads test. A sample of every publisher is
+     * lost if its sequence number is between the first and the last ones
+     * received by any partition, but no partition got it.
+     *
+     * The main thread calls it while the partitions receive. The ranges are
+     * read before the counters, which already count every sample in them:
+     * the samples received meanwhile only make the loss smaller.
+     */
+    static unsigned long long get_partitioned_missing_packets(
+            ThroughputListener **listeners,
+            int count)
+    {
+        unsigned long long expected = 0;
+        unsigned long long received = 0;
+
+        for (int id = 0; id < listeners[0]->_num_publishers; id++) {
+            unsigned long first = 0;
+            unsigned long last = 0;
+            for (int i = 0; i < count; i++) {
+                unsigned long partitionLast =
+                        load_seq_num(listeners[i]->_max_seq_num[id]);
+                unsigned long partitionFirst =
+                        load_seq_num(listeners[i]->_first_seq_num[id]);
+                if (partitionFirst == 0) {
+                    continue;
+                }
+                if (first == 0 || partitionFirst < first) {
+                    first = partitionFirst;
+                }
+                if (partitionLast > last) {
+                    last = partitionLast;
+                }
+            }
+            if (first != 0 && last >= first - 1) {
+                expected += last - (first - 1) + 1;
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            received += listeners[i]->packets_received;
+        }
+        return expected > received ? expected - received : 0;
+    }
+
+  #ifdef PERFTEST_RTI_PRO
+    /* Throughput and loss of every phase of -scenario, once the test ends */
+    void print_scenario_report(const PerftestScenario &scenario)
+    {
+        const std::vector<PerftestScenarioPhase> &phases =
+                scenario.get_phases();
+        unsigned int phasesReceived = 0;
+
+        printf("\nScenario, Subscriber:\n");
+        printf("           Phase, Time (s), Length (B),"
+                " Received (Samples/s),      Mbps, Lost Samples, Lost (%%)\n");
+        for (unsigned int i = 0; i + 1 < _phaseMarks.size(); i++) {
+            const ScenarioPhaseMark &begin = _phaseMarks[i];
+            const ScenarioPhaseMark &end = _phaseMarks[i + 1];
+            if (begin.phase < 0 || begin.phase >= (long) phases.size()) {
+                continue;
+            }
+            const PerftestScenarioPhase &phase = phases[begin.phase];
+            unsigned long long elapsed = end.time - begin.time;
+            unsigned long long packets = end.packets - begin.packets;
+            unsigned long long missing = end.missing - begin.missing;
+            double samplesPerSec = 0;
+            double mbps = 0;
+            double lostPercent = 0;
+            if (elapsed > 0) {
+                samplesPerSec = packets * 1000000.0 / elapsed;
+                mbps = (end.bytes - begin.bytes) * 8.0 / elapsed;
+            }
+            if (packets + missing > 0) {
+                lostPercent = missing * 100.0 / (packets + missing);
+            }
+            printf("%16s,%9.1f,%11llu,%21.0f,%10.1f,%13llu,%9.3f\n",
+                    phase.name.c_str(),
+                    elapsed / 1000000.0,
+                    phase.dataLen,
+                    samplesPerSec,
+                    mbps,
+                    missing,
+                    lostPercent);
+            phasesReceived++;
+        }
+        if (phasesReceived < phases.size()) {
+            printf("Only %u of %u phases received. The test ended before the "
+                    "rest, or their marks were lost and they count in the "
+                    "previous phase\n",
+                    phasesReceived,
+                    (unsigned int) phases.size());
+        }
+        fflush(stdout);
+    }
+  #endif
+
+  private:
+
+  #ifdef PERFTEST_RTI_PRO
+    void mark_scenario_phase(long phase)
+    {
+        ScenarioPhaseMark mark;
+        mark.phase = phase;
+        mark.time = PerftestClock::getInstance().getTime();
+        mark.packets = packets_received;
+        mark.bytes = bytes_received;
+        mark.missing = missing_packets;
+        _phaseMarks.push_back(mark);
+    }
+  #endif
+
+    void send_pong(TestMessage &message)
+    {
+        if (_writerMutex != NULL && !PerftestMutex_take(_writerMutex)) {
+            fprintf(stderr, "Unexpected error taking semaphore\n");
+            return;
+        }
+        _writer->send(message);
+        _writer->flush();
+        if (_writerMutex != NULL && !PerftestMutex_give(_writerMutex)) {
+            fprintf(stderr, "Unexpected error giving semaphore\n");
+        }
+    }
 };
 
 /*********************************************************
@@ -1149,6 +2338,354 @@ static void *ReadThread(void *arg)
     return NULL;
 }
 
+/*********************************************************
+ * Used for receiving one partition of the instances with -readThreads.
+ * The thread is pinned to its core (if any) before start reading.
+ */
+struct PartitionedReadThreadArgs
+{
+    ThroughputListener *listener;
+    int core;
+};
+
+static void *PartitionedReadThread(void *arg)
+{
+    PartitionedReadThreadArgs *args =
+            static_cast<PartitionedReadThreadArgs *>(arg);
+
+  #ifdef PERFTEST_RTI_PRO
+    if (args->core >= 0) {
+        ThreadCPUAffinity::set_current_thread_affinity(args->core);
+    }
+  #endif
+
+    return ReadThread<ThroughputListener>(args->listener);
+}
+
+/*
+ * Print the summary of a -readThreads test: the aggregated throughput of all
+ * the partitions through the printer, and the throughput of every thread.
+ * With -cpu, the CPU of the summary is the one of the whole process, which
+ * includes every partition, and every thread also shows its own.
+ */
+static void print_partitioned_summary_throughput(
+        PerftestPrinter *printer,
+        PartitionedReadThreadArgs *partitions,
+        int count,
+        bool showCpu)
+{
+    unsigned long long packets = 0;
+    unsigned long long bytes = 0;
+    unsigned long long time = 0;
+    int length = -1;
+    std::vector<ThroughputListener *> listeners(count);
+
+    for (int i = 0; i < count; i++) {
+        ThroughputListener *listener = partitions[i].listener;
+        listeners[i] = listener;
+        packets += listener->interval_packets_received;
+        bytes += listener->interval_bytes_received;
+        // The test lasts as long as the slowest partition
+        time = (std::max)(time, listener->interval_time);
+        if (listener->interval_data_length > length) {
+            length = listener->interval_data_length;
+        }
+    }
+
+    if (packets == 0 || time == 0) {
+        printer->print_throughput_summary(0, 0, 0, 0, 0, 0, 0);
+        fprintf(stderr, "\nNo samples have been received by the Subscriber side.\n");
+        return;
+    }
+
+    unsigned long long missing =
+            ThroughputListener::get_partitioned_missing_packets(
+                    &listeners[0],
+                    count);
+    float missingPercent = (float) ((missing * 100.0)
+            / (float) (packets + missing));
+
+    /*
+     * CpuMonitor measures the process, not the thread that samples it, so
+     * the monitor of the first partition (sampled by the main loop) has the
+     * CPU of all of them.
+     */
+    double outputCpu = 0.0;
+    if (showCpu) {
+        outputCpu = partitions[0].listener->cpu.get_cpu_average();
+    }
+    printer->print_throughput_summary(
+            length + perftest_cpp::OVERHEAD_BYTES,
+            packets,
+            time,
+            bytes,
+            missing,
+            missingPercent,
+            outputCpu);
+
+    double threadsCpu = 0.0;
+    bool threadsCpuKnown = showCpu;
+    fprintf(stderr, "\nThroughput per read thread:\n");
+    for (int i = 0; i < count; i++) {
+        ThroughputListener *listener = partitions[i].listener;
+        double seconds = listener->interval_time / 1000000.0;
+        if (seconds <= 0) {
+            seconds = 1;
+        }
+        fprintf(stderr,
+                "\tThread %d (core %d): %llu samples, %.0f samples/s, "
+                "%.1f Mbps",
+                i,
+                partitions[i].core,
+                listener->interval_packets_received,
+                listener->interval_packets_received / seconds,
+                listener->interval_bytes_received * 8.0 / seconds / 1000000.0);
+        if (showCpu && listener->interval_thread_cpu != 0) {
+            // Percentage of one core, the summary uses all of them
+            double threadCpu = listener->interval_thread_cpu / 10000.0
+                    / seconds;
+            threadsCpu += threadCpu;
+            fprintf(stderr, ", CPU %.1f%% of a core", threadCpu);
+        } else {
+            threadsCpuKnown = false;
+        }
+        fprintf(stderr, "\n");
+    }
+    if (threadsCpuKnown) {
+        fprintf(stderr,
+                "\tAll read threads: CPU %.1f%% of a core\n",
+                threadsCpu);
+    }
+    fflush(stderr);
+    fflush(stdout);
+}
+
+#ifdef PERFTEST_RTI_PRO
+/*********************************************************
+ * Latency probes (-latencyProbeRate)
+ *
+ * The Publisher sends timestamped probes on their own topic at a fixed rate
+ * from a dedicated thread while the main loop sends the throughput data. The
+ * first Subscriber echoes them back on a second topic, so the probes do not
+ * queue behind the data in the history of the Throughput DataWriter.
+ */
+class LatencyProbeEchoListener : public IMessagingCB
+{
+  private:
+    IMessagingWriter *_writer;
+
+  public:
+    LatencyProbeEchoListener(IMessagingWriter *writer) : _writer(writer)
+    {
+    }
+
+    void process_message(TestMessage &message)
+    {
+        if (message.size == perftest_cpp::INITIALIZE_SIZE
+                || message.size == perftest_cpp::FINISHED_SIZE) {
+            return;
+        }
+        _writer->send(message);
+        _writer->flush();
+    }
+};
+
+class LatencyProbeListener : public IMessagingCB
+{
+  private:
+    std::vector<unsigned long> _latencies;
+    unsigned long _clockSkewCount;
+    PerftestMutex *_mutex;
+
+  public:
+    LatencyProbeListener(unsigned long expectedProbes)
+            : _clockSkewCount(0), _mutex(PerftestMutex_new())
+    {
+        _latencies.reserve(expectedProbes);
+    }
+
+    ~LatencyProbeListener()
+    {
+        if (_mutex != NULL) {
+            PerftestMutex_delete(_mutex);
+        }
+    }
+
+    void process_message(TestMessage &message)
+    {
+      #ifndef RTI_PERFTEST_NANO_CLOCK
+        unsigned long long now = PerftestClock::getInstance().getTime();
+      #else
+        unsigned long long now = PerftestClock::getInstance().getTimeNs();
+      #endif
+        unsigned long long sentTime =
+                ((unsigned long long) message.timestamp_sec << 32)
+                | (unsigned long long) message.timestamp_usec;
+
+        PerftestMutex_take(_mutex);
+        if (now >= sentTime) {
+            // keep track of one-way latency
+            _latencies.push_back((unsigned long) ((now - sentTime) / 2));
+        } else {
+            ++_clockSkewCount;
+        }
+        PerftestMutex_give(_mutex);
+    }
+
+    /*
+     * Print the percentiles of the probes received, together with the load
+     * offered by the main loop while they were sent.
+     */
+    void print_summary(
+            unsigned long long probesSent,
+            unsigned long long probeRate,
+            double offeredSamplesPerSec,
+            double offeredMbps)
+    {
+        PerftestMutex_take(_mutex);
+        std::vector<unsigned long> latencies(_latencies);
+        unsigned long clockSkewCount = _clockSkewCount;
+        PerftestMutex_give(_mutex);
+
+        printf("\nLatency Probes (%llu probes/s, offered load %.0f samples/s, "
+                "%.1f Mbps):\n",
+                probeRate,
+                offeredSamplesPerSec,
+                offeredMbps);
+        printf("Probes Sent, Probes Received,  Ave (μs),  Min (μs),  Max (μs),"
+                "  50%% (μs),  90%% (μs),  99%% (μs), 99.99%% (μs)\n");
+
+        double latencyAve = 0;
+        double scale = 1.0;
+        size_t count = latencies.size();
+      #ifdef RTI_PERFTEST_NANO_CLOCK
+        scale = 1000.0;
+      #endif
+        if (count == 0) {
+            printf("%11llu,%16u\n", probesSent, 0);
+        } else {
+            std::sort(latencies.begin(), latencies.end());
+            for (size_t i = 0; i < count; i++) {
+                latencyAve += latencies[i];
+            }
+            latencyAve /= count;
+            printf("%11llu,%16lu,%10.1f,%10.1f,%10.1f,%10.1f,%10.1f,%10.1f,%13.1f\n",
+                    probesSent,
+                    (unsigned long) count,
+                    latencyAve / scale,
+                    latencies[0] / scale,
+                    latencies[count - 1] / scale,
+                    latencies[count * 50 / 100] / scale,
+                    latencies[count * 90 / 100] / scale,
+                    latencies[count * 99 / 100] / scale,
+                    latencies[(size_t) (count * (9999.0 / 10000))] / scale);
+        }
+        if (clockSkewCount != 0) {
+            fprintf(stderr,
+                    "The latency probe results may not be accurate because"
+                    " clock skew happens %lu times\n",
+                    clockSkewCount);
+        }
+        fflush(stdout);
+    }
+};
+
+struct LatencyProbeThreadInfo
+{
+    IMessagingWriter *writer;
+    TestMessage message;
+    unsigned long long periodUsec;
+    unsigned long long probesSent;
+    std::atomic<bool> stop;
+    std::atomic<bool> finished;
+};
+
+/*
+ * Sends one probe every periodUsec. The send times are scheduled in advance,
+ * so a probe that is sent late does not delay the following ones.
+ */
+static void *LatencyProbeThread(void *arg)
+{
+    LatencyProbeThreadInfo *info = static_cast<LatencyProbeThreadInfo *>(arg);
+    TestMessage &message = info->message;
+    DDS_Duration_t sleep_period = {0, 0};
+    unsigned long long nextSendTime = PerftestClock::getInstance().getTime();
+
+    while (!info->stop.load() && !perftest_cpp::_testCompleted) {
+        nextSendTime += info->periodUsec;
+        unsigned long long now = PerftestClock::getInstance().getTime();
+        if (nextSendTime > now) {
+            sleep_period.sec = (long) ((nextSendTime - now) / 1000000);
+            sleep_period.nanosec = (unsigned long)
+                    ((nextSendTime - now) % 1000000) * 1000;
+            PerftestClock::sleep(sleep_period);
+        } else if (now - nextSendTime > info->periodUsec) {
+            // Too late, do not send a burst of probes to catch up
+            nextSendTime = now;
+        }
+
+      #ifndef RTI_PERFTEST_NANO_CLOCK
+        now = PerftestClock::getInstance().getTime();
+      #else
+        now = PerftestClock::getInstance().getTimeNs();
+      #endif
+        message.timestamp_sec = (int)((now >> 32) & 0xFFFFFFFF);
+        message.timestamp_usec = (unsigned int)(now & 0xFFFFFFFF);
+        message.seq_num = (unsigned long) info->probesSent;
+        info->writer->send(message);
+        info->writer->flush();
+        ++info->probesSent;
+    }
+
+    info->finished.store(true);
+    return NULL;
+}
+
+/*
+ * Print the page faults taken since the given ones (-memoryMode), to check
+ * that the test did not touch any page for the first time.
+ */
+static void print_page_faults(
+        unsigned long long minorFaults,
+        unsigned long long majorFaults)
+{
+    unsigned long long minorFaultsNow = 0;
+    unsigned long long majorFaultsNow = 0;
+    if (MemoryArena::get_page_faults(minorFaultsNow, majorFaultsNow)) {
+        fprintf(stderr,
+                "Page faults during the test: %llu minor, %llu major\n",
+                minorFaultsNow - minorFaults,
+                majorFaultsNow - majorFaults);
+    }
+}
+
+/*
+ * Print the pages allocated by the system in the NUMA node since the given
+ * counters (-numaPlacement). Pages of the node allocated for other nodes,
+ * or meant for it but allocated elsewhere, are remote accesses.
+ */
+static void print_numa_stats(int node, const NumaTopology::NodeStats &before)
+{
+    NumaTopology::NodeStats now;
+    if (NumaTopology::get_node_stats(node, now)) {
+        fprintf(stderr,
+                "NUMA node %d during the test (whole system): %llu local "
+                "pages, %llu pages for other nodes, %llu pages placed in "
+                "other nodes\n",
+                node,
+                now.local - before.local,
+                now.other - before.other,
+                now.foreign - before.foreign);
+    }
+}
+
+/* Timer wheel callback waking up the thread waiting on the semaphore */
+static void GiveSemaphoreTimer(void *arg)
+{
+    PerftestSemaphore_give(static_cast<PerftestSemaphore *>(arg));
+}
+#endif // PERFTEST_RTI_PRO
+
 /*********************************************************
  * Subscriber
  */
@@ -1160,6 +2697,17 @@ int perftest_cpp::Subscriber()
     IMessagingWriter *announcement_writer;
     struct PerftestThread *throughputThread = NULL;
 
+    /*
+     * With -readThreads every thread has its own reader and listener. In any
+     * other case these vectors contain only one element.
+     */
+    std::vector<ThroughputListener *> reader_listeners;
+    std::vector<IMessagingReader *> readers;
+    std::vector<PerftestThread *> throughputThreads;
+    PartitionedReadThreadArgs *partitionArgs = NULL;
+    PerftestMutex *pongWriterMutex = NULL;
+    const int readThreads = _PM.get<int>("readThreads");
+
     // create latency pong writer
     writer = _MessagingImpl->create_writer(LATENCY_TOPIC_NAME);
     if (writer == NULL) {
@@ -1175,7 +2723,7 @@ int perftest_cpp::Subscriber()
                 _printer,
                 writer,
                 NULL,
-                _PM.is_set("cft"),
+                _PM.is_set("cft") || _PM.is_set("cftKeys"),
                 _PM.get<int>("numPublishers"));
         reader = _MessagingImpl->create_reader(
                 THROUGHPUT_TOPIC_NAME,
@@ -1185,6 +2733,77 @@ int perftest_cpp::Subscriber()
             fprintf(stderr, "Problem creating throughput reader.\n");
             return -1;
         }
+        reader_listeners.push_back(reader_listener);
+        readers.push_back(reader);
+    } else if (readThreads > 1) {
+        int threadPriority = Perftest_THREAD_PRIORITY_DEFAULT;
+        int threadOptions = Perftest_THREAD_OPTION_DEFAULT;
+
+        if (_threadPriorities.isSet) {
+            threadOptions = Perftest_THREAD_SETTINGS_REALTIME_PRIORITY
+                    | Perftest_THREAD_SETTINGS_PRIORITY_ENFORCE;
+            threadPriority = _threadPriorities.receive;
+        }
+
+        pongWriterMutex = PerftestMutex_new();
+        if (pongWriterMutex == NULL) {
+            fprintf(stderr, "Problem creating the pong writer mutex.\n");
+            return -1;
+        }
+        partitionArgs = new PartitionedReadThreadArgs[readThreads];
+
+        for (int i = 0; i < readThreads; i++) {
+            reader = _MessagingImpl->create_partitioned_reader(
+                    THROUGHPUT_TOPIC_NAME,
+                    NULL,
+                    i,
+                    readThreads);
+            if (reader == NULL) {
+                fprintf(stderr,
+                        "Problem creating throughput reader for partition %d.\n",
+                        i);
+                return -1;
+            }
+            reader_listener = new ThroughputListener(
+                    _PM,
+                    _printer,
+                    writer,
+                    reader,
+                    false,
+                    _PM.get<int>("numPublishers"),
+                    i);
+            reader_listener->_writerMutex = pongWriterMutex;
+            reader_listeners.push_back(reader_listener);
+            readers.push_back(reader);
+
+            partitionArgs[i].listener = reader_listener;
+            partitionArgs[i].core = -1;
+          #ifdef PERFTEST_RTI_PRO
+            const std::vector<int> &cores =
+                    _threadCPUAffinity.get_cores_receive();
+            if (!cores.empty()) {
+                partitionArgs[i].core = cores[i % cores.size()];
+            }
+          #endif
+
+            throughputThread = PerftestThread_new(
+                    "ReceiverThread",
+                    threadPriority,
+                    threadOptions,
+                    PartitionedReadThread,
+                    &partitionArgs[i]);
+            if (throughputThread == NULL) {
+                fprintf(stderr,
+                        "Problem creating ReceiverThread %d for ThroughputReadThread.\n",
+                        i);
+                return -1;
+            }
+            throughputThreads.push_back(throughputThread);
+        }
+
+        // The first partition is used for the synchronization with the publisher
+        reader_listener = reader_listeners[0];
+        reader = readers[0];
     } else {
         reader = _MessagingImpl->create_reader(
                 THROUGHPUT_TOPIC_NAME,
@@ -1199,7 +2818,7 @@ int perftest_cpp::Subscriber()
                 _printer,
                 writer,
                 reader,
-                _PM.is_set("cft"),
+                _PM.is_set("cft") || _PM.is_set("cftKeys"),
                 _PM.get<int>("numPublishers"));
 
         int threadPriority = Perftest_THREAD_PRIORITY_DEFAULT;
@@ -1221,6 +2840,9 @@ int perftest_cpp::Subscriber()
             fprintf(stderr, "Problem creating ReceiverThread for ThroughputReadThread.\n");
             return -1;
         }
+        reader_listeners.push_back(reader_listener);
+        readers.push_back(reader);
+        throughputThreads.push_back(throughputThread);
     }
 
     // Create announcement writer
@@ -1232,15 +2854,49 @@ int perftest_cpp::Subscriber()
         return -1;
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // Only the first subscriber echoes the latency probes
+    IMessagingWriter *probe_writer = NULL;
+    IMessagingReader *probe_reader = NULL;
+    LatencyProbeEchoListener *probe_listener = NULL;
+    if (_PM.is_set("latencyProbeRate") && subID == 0) {
+        if (!_MessagingImpl->supports_listeners()) {
+            fprintf(stderr, "'-latencyProbeRate' requires listeners.\n");
+            return -1;
+        }
+        probe_writer = _MessagingImpl->create_writer(
+                LATENCY_PROBE_ECHO_TOPIC_NAME);
+        if (probe_writer == NULL) {
+            fprintf(stderr, "Problem creating latency probe echo writer.\n");
+            return -1;
+        }
+        probe_listener = new LatencyProbeEchoListener(probe_writer);
+        probe_reader = _MessagingImpl->create_reader(
+                LATENCY_PROBE_TOPIC_NAME,
+                probe_listener);
+        if (probe_reader == NULL) {
+            fprintf(stderr, "Problem creating latency probe reader.\n");
+            return -1;
+        }
+    }
+  #endif
+
     // Synchronize with publishers
     fprintf(stderr,
             "Waiting to discover %d publishers ...\n",
             _PM.get<int>("numPublishers"));
     fflush(stderr);
-    reader->wait_for_writers(_PM.get<int>("numPublishers"));
+    for (unsigned int i = 0; i < readers.size(); i++) {
+        readers[i]->wait_for_writers(_PM.get<int>("numPublishers"));
+    }
     // In a multi publisher test, only the first publisher will have a reader.
     writer->wait_for_readers(1);
     announcement_writer->wait_for_readers(_PM.get<int>("numPublishers"));
+  #ifdef PERFTEST_RTI_PRO
+    if (probe_writer != NULL) {
+        probe_writer->wait_for_readers(1);
+    }
+  #endif
 
     /*
      * Announcement message that will be used by the announcement_writer
@@ -1282,7 +2938,9 @@ int perftest_cpp::Subscriber()
     unsigned long long mps = 0, bps = 0;
     double mps_ave = 0.0, bps_ave = 0.0;
     unsigned long long msgsent, bytes, last_msgs, last_bytes;
+    unsigned long long missing_packets;
     float missing_packets_percent = 0;
+    bool end_test;
 
     const bool cacheStats = _PM.get<bool>("cacheStats");
 
@@ -1290,14 +2948,89 @@ int perftest_cpp::Subscriber()
         reader_listener->cpu.initialize();
     }
 
-    now = PerftestClock::getInstance().getTime();
-
+  #ifdef PERFTEST_RTI_PRO
+    unsigned long long minorFaults = 0;
+    unsigned long long majorFaults = 0;
+    const bool reportPageFaults = _PM.is_set("memoryMode")
+            && MemoryArena::get_page_faults(minorFaults, majorFaults);
+    NumaTopology::NodeStats numaStats;
+    const bool reportNumaStats = _numaNode >= 0
+            && NumaTopology::get_node_stats(_numaNode, numaStats);
+
+    // -statsSegment and -metricsEndpoint: rates since the previous update
+    const bool reportStats =
+            _statsSegment.is_initialized() || _metricsServer != NULL;
+    unsigned long long statsPrevMsgs = 0;
+    unsigned long long statsPrevBytes = 0;
+    CpuMonitor statsCpu;
+    if (reportStats) {
+        statsCpu.initialize();
+    }
+
+    // The intervals are taken by the timer wheel, so they do not drift
+    PerftestSemaphore *intervalSemaphore = PerftestSemaphore_new();
+    if (intervalSemaphore == NULL) {
+        fprintf(stderr, "Problem creating the interval semaphore.\n");
+        return -1;
+    }
+    long intervalTimer = _timerWheel.schedule(
+            PERFTEST_DISCOVERY_TIME_MSEC * 1000000ULL,
+            PERFTEST_DISCOVERY_TIME_MSEC * 1000000ULL,
+            GiveSemaphoreTimer,
+            intervalSemaphore);
+  #endif
+
+    now = PerftestClock::getInstance().getTime();
+
     while (true) {
         prev_time = now;
+      #ifdef PERFTEST_RTI_PRO
+        PerftestSemaphore_take(
+                intervalSemaphore,
+                PERFTEST_SEMAPHORE_TIMEOUT_INFINITE);
+      #else
         PerftestClock::milliSleep(PERFTEST_DISCOVERY_TIME_MSEC);
+      #endif
         now = PerftestClock::getInstance().getTime();
 
-        if (reader_listener->end_test) { // ACK end_test
+        end_test = true;
+        last_msgs = 0;
+        last_bytes = 0;
+        missing_packets = 0;
+        for (unsigned int i = 0; i < reader_listeners.size(); i++) {
+            end_test = end_test && reader_listeners[i]->end_test;
+            last_msgs += reader_listeners[i]->packets_received;
+            last_bytes += reader_listeners[i]->bytes_received;
+            missing_packets += reader_listeners[i]->missing_packets;
+        }
+        if (partitionArgs != NULL) {
+            missing_packets =
+                    ThroughputListener::get_partitioned_missing_packets(
+                            &reader_listeners[0],
+                            (int) reader_listeners.size());
+        }
+
+        if (end_test) { // ACK end_test
+          #ifdef PERFTEST_RTI_PRO
+            if (reportPageFaults) {
+                print_page_faults(minorFaults, majorFaults);
+            }
+            if (reportNumaStats) {
+                print_numa_stats(_numaNode, numaStats);
+            }
+          #endif
+            if (readThreads > 1) {
+                print_partitioned_summary_throughput(
+                        _printer,
+                        partitionArgs,
+                        readThreads,
+                        showCpu);
+            }
+          #ifdef PERFTEST_RTI_PRO
+            if (_PM.is_set("scenario")) {
+                reader_listener->print_scenario_report(_scenario);
+            }
+          #endif
             announcement_msg.entity_id = subID;
             announcement_msg.size = FINISHED_SIZE;
             announcement_writer->send(announcement_msg);
@@ -1305,20 +3038,52 @@ int perftest_cpp::Subscriber()
             break;
         }
 
+      #ifdef PERFTEST_RTI_PRO
+        if (reportStats) {
+            PerftestStatsSnapshot stats;
+            memset(&stats, 0, sizeof(stats));
+            stats.dataLength =
+                    reader_listener->last_data_length + OVERHEAD_BYTES;
+            stats.samples = last_msgs;
+            stats.bytes = last_bytes;
+            // The counters are reset when the data length changes
+            if (now > prev_time && last_msgs >= statsPrevMsgs) {
+                stats.samplesPerSecond =
+                        (last_msgs - statsPrevMsgs) * 1000000
+                        / (now - prev_time);
+                stats.bytesPerSecond =
+                        (last_bytes - statsPrevBytes) * 1000000
+                        / (now - prev_time);
+            }
+            statsPrevMsgs = last_msgs;
+            statsPrevBytes = last_bytes;
+            stats.lostSamples = missing_packets;
+            if (last_msgs + missing_packets != 0) {
+                stats.lostPercent = (missing_packets * 100.0)
+                        / (double) (last_msgs + missing_packets);
+            }
+            stats.cpu = statsCpu.get_cpu_instant();
+            stats.readerQueuePeak = reader->get_sample_count_peak();
+            stats.writerQueuePeak = writer->get_sample_count_peak();
+            _statsSegment.update(stats);
+            if (_metricsServer != NULL) {
+                _metricsServer->update(stats);
+            }
+        }
+      #endif
+
         if (printIntervals) {
             if (last_data_length != reader_listener->last_data_length)
             {
                 last_data_length = reader_listener->last_data_length;
-                prev_count = reader_listener->packets_received;
-                prev_bytes = reader_listener->bytes_received;
+                prev_count = last_msgs;
+                prev_bytes = last_bytes;
                 bps_ave = 0;
                 mps_ave = 0;
                 ave_count = 0;
                 continue;
             }
 
-            last_msgs = reader_listener->packets_received;
-            last_bytes = reader_listener->bytes_received;
             msgsent = last_msgs - prev_count;
             bytes = last_bytes - prev_bytes;
             prev_count = last_msgs;
@@ -1333,12 +3098,12 @@ int perftest_cpp::Subscriber()
             mps_ave = mps_ave + (double)(mps - mps_ave) / (double)ave_count;
 
             // Calculations of missing package percent
-            if (last_msgs + reader_listener->missing_packets == 0) {
+            if (last_msgs + missing_packets == 0) {
                 missing_packets_percent = 0.0;
             } else {
                 missing_packets_percent = (float)
-                        ((reader_listener->missing_packets * 100.0)
-                        / (float) (last_msgs + reader_listener->missing_packets));
+                        ((missing_packets * 100.0)
+                        / (float) (last_msgs + missing_packets));
             }
 
             if (last_msgs > 0) {
@@ -1352,7 +3117,7 @@ int perftest_cpp::Subscriber()
                         mps_ave,
                         bps,
                         bps_ave,
-                        reader_listener->missing_packets,
+                        missing_packets,
                         missing_packets_percent,
                         outputCpu);
                 fflush(stdout);
@@ -1370,20 +3135,36 @@ int perftest_cpp::Subscriber()
         }
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    _timerWheel.cancel(intervalTimer);
+    PerftestSemaphore_delete(intervalSemaphore);
+  #endif
+
     PerftestClock::milliSleep(2000);
     _printer->print_final_output();
-    if (!finalize_read_thread(throughputThread, reader_listener)) {
-        fprintf(stderr, "Error deleting throughputThread\n");
-        return -1;
+    for (unsigned int i = 0; i < reader_listeners.size(); i++) {
+        if (!finalize_read_thread(
+                i < throughputThreads.size() ? throughputThreads[i] : NULL,
+                reader_listeners[i])) {
+            fprintf(stderr, "Error deleting throughputThread\n");
+            return -1;
+        }
     }
 
-    if (reader != NULL)
-    {
-        delete(reader);
+    for (unsigned int i = 0; i < readers.size(); i++) {
+        delete(readers[i]);
     }
 
-    if (reader_listener != NULL) {
-        delete(reader_listener);
+    for (unsigned int i = 0; i < reader_listeners.size(); i++) {
+        delete(reader_listeners[i]);
+    }
+
+    if (partitionArgs != NULL) {
+        delete[] partitionArgs;
+    }
+
+    if (pongWriterMutex != NULL) {
+        PerftestMutex_delete(pongWriterMutex);
     }
 
     if (writer != NULL) {
@@ -1394,6 +3175,18 @@ int perftest_cpp::Subscriber()
         delete(announcement_writer);
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    if (probe_reader != NULL) {
+        delete(probe_reader);
+    }
+    if (probe_listener != NULL) {
+        delete(probe_listener);
+    }
+    if (probe_writer != NULL) {
+        delete(probe_writer);
+    }
+  #endif
+
     delete[] announcement_msg.data;
 
     fprintf(stderr,"Finishing test...\n");
@@ -1479,6 +3272,44 @@ class LatencyListener : public IMessagingCB
     bool printIntervals;
     bool showCpu;
 
+    // Samples lost by every subscriber, as reported in its last pong
+    std::vector<unsigned long long> _lostSamples;
+
+  #ifdef PERFTEST_RTI_PRO
+    // Same as in ThroughputListener, for -dataLenDistribution
+    int _distributionLength;
+    DataLenBucketStats *_sizeBuckets;
+
+    // Latencies of the history already added to the -statsSegment histogram
+    int _statsDataLength;
+    unsigned long long _statsCount;
+    unsigned long long _statsHistogram[PERFTEST_STATS_HISTOGRAM_BUCKETS];
+
+    // Last CPU sample taken by the timer wheel (see sample_cpu())
+    std::mutex _cpuMutex;
+    std::atomic<bool> _cpuSampled;
+    std::atomic<double> _cpuInstant;
+
+    /*
+     * take_step_latency() is called by another thread while the pongs are
+     * being received. It swaps _latency_history with _stepHistory and resets
+     * the counters under _historyMutex, then sorts the step outside the lock,
+     * so the listener never writes the array being sorted. Only the tests
+     * made of steps (-batchSizeSweep, -rampRate, -repetitions, -scenario)
+     * call it, the rest do not take the mutex on every pong.
+     */
+    std::mutex _historyMutex;
+    bool _lockHistory;
+    unsigned long *_stepHistory;
+
+    /*
+     * Some Subscriber echoed the LOST_SAMPLES_REQUEST of the initialization
+     * messages, so the seq_num of its pongs is not the samples it lost.
+     */
+    std::atomic<bool> _lostSamplesUnknown;
+    bool _lostSamplesUnknownWarned;
+  #endif
+
     void resetLatencyCounters() {
         latency_sum = 0;
         latency_sum_square = 0;
@@ -1519,7 +3350,17 @@ public:
              * log this specific problem and then rethrow it.
              */
             try {
+              #ifdef PERFTEST_RTI_PRO
+                // Prefaulted with -memoryMode, so storing it costs no faults
+                _latency_history = static_cast<unsigned long *>(
+                        MemoryArena::get_instance().allocate(
+                                _num_latency * sizeof(unsigned long)));
+                if (_latency_history == NULL) {
+                    throw std::bad_alloc();
+                }
+              #else
                 _latency_history = new unsigned long[_num_latency];
+              #endif
             } catch(const std::bad_alloc&) {
                 fprintf(
                         stderr,
@@ -1543,7 +3384,156 @@ public:
         subID = _PM->get<int>("sidMultiSubTest");
         printIntervals = !_PM->get<bool>("noPrintIntervals");
         showCpu = _PM->get<bool>("cpu");
+        _lostSamples.resize(_PM->get<int>("numSubscribers"), 0);
+
+      #ifdef PERFTEST_RTI_PRO
+        _distributionLength = -1;
+        _sizeBuckets = NULL;
+        if (_PM->is_set("dataLenDistribution") || _PM->is_set("scenario")) {
+            _distributionLength = (int) _PM->get<unsigned long long>("dataLen")
+                    - perftest_cpp::OVERHEAD_BYTES;
+        }
+        if (_PM->is_set("dataLenDistribution")) {
+            _sizeBuckets = new DataLenBucketStats();
+        }
+        _statsDataLength = -1;
+        _statsCount = 0;
+        memset(_statsHistogram, 0, sizeof(_statsHistogram));
+        _cpuSampled.store(false);
+        _cpuInstant.store(0.0);
+        _lockHistory = _PM->is_set("batchSizeSweep")
+                || _PM->is_set("rampRate") || _PM->is_set("repetitions")
+                || _PM->is_set("scenario");
+        _stepHistory = NULL;
+        _lostSamplesUnknown.store(false);
+        _lostSamplesUnknownWarned = false;
+      #endif
+    }
+
+  #ifdef PERFTEST_RTI_PRO
+    /*
+     * Called periodically by the timer wheel once the Publisher schedules it,
+     * so the latency intervals print the last sample instead of measuring the
+     * CPU on every pong (where times() has not moved in most of them).
+     */
+    void sample_cpu()
+    {
+        std::lock_guard<std::mutex> lock(_cpuMutex);
+        _cpuInstant.store(cpu.get_cpu_instant());
+    }
+
+    void set_cpu_sampled()
+    {
+        _cpuSampled.store(true);
+    }
+  #endif
+
+  #ifdef PERFTEST_RTI_PRO
+    /*
+     * Append the latencies of the current data length to a binary
+     * -latencyFile (-latencyFileBinary), in the order they were received.
+     */
+    void write_latency_trace(const std::string &fileName)
+    {
+        FILE *outputFile = fopen(fileName.c_str(), "ab");
+        if (outputFile == NULL) {
+            fprintf(stderr,
+                    "[Error]: print_summary_latency error opening "
+                    "file to save latency samples\n");
+            return;
+        }
+        fprintf(stderr,
+                "Saving latency information in \"%s\".\n",
+                fileName.c_str());
+
+        PerftestLatencyTraceHeader header;
+        header.magic = PERFTEST_LATENCY_TRACE_MAGIC;
+        header.version = PERFTEST_LATENCY_TRACE_VERSION;
+        header.dataLength = last_data_length + perftest_cpp::OVERHEAD_BYTES;
+      #ifdef RTI_PERFTEST_NANO_CLOCK
+        header.nanoseconds = 1;
+      #else
+        header.nanoseconds = 0;
+      #endif
+        header.count = count;
+        bool written = fwrite(&header, sizeof(header), 1, outputFile) == 1;
+
+        // Written in blocks, as unsigned long may be 32 bits
+        unsigned long long block[1024];
+        for (unsigned long long i = 0; written && i < count;) {
+            size_t length = 0;
+            while (length < 1024 && i < count) {
+                block[length++] = _latency_history[i++];
+            }
+            written = fwrite(block, sizeof(block[0]), length, outputFile)
+                    == length;
+        }
+        if (!written) {
+            fprintf(stderr,
+                    "[Error]: Could not write the latency samples in "
+                    "\"%s\".\n",
+                    fileName.c_str());
+        }
+        fclose(outputFile);
+    }
+
+    /*
+     * Copy the counters of the current data length into a -statsSegment
+     * snapshot. It is called once per interval by another thread and reads
+     * the counters without synchronization, so the values may be one sample
+     * behind each other. Only the new latencies of the history are added to
+     * the histogram.
+     */
+    void fill_stats(PerftestStatsSnapshot &stats)
+    {
+        const unsigned long long currentCount = count;
+        if (currentCount < _statsCount
+                || last_data_length != _statsDataLength) {
+            // The counters were reset for a new data length
+            _statsDataLength = last_data_length;
+            _statsCount = 0;
+            memset(_statsHistogram, 0, sizeof(_statsHistogram));
+        }
+        for (; _latency_history != NULL
+                    && _statsCount < currentCount
+                    && _statsCount < _num_latency;
+                _statsCount++) {
+          #ifndef RTI_PERFTEST_NANO_CLOCK
+            unsigned long long latency = _latency_history[_statsCount];
+          #else
+            unsigned long long latency = _latency_history[_statsCount] / 1000;
+          #endif
+            _statsHistogram[
+                    PerftestStatsSegment::get_histogram_bucket(latency)]++;
+        }
+        memcpy(stats.latencyHistogram,
+                _statsHistogram,
+                sizeof(_statsHistogram));
+
+        stats.dataLength = last_data_length + perftest_cpp::OVERHEAD_BYTES;
+        stats.latencyCount = currentCount;
+        if (currentCount > 0) {
+            stats.latencyAve = (double) latency_sum / (double) currentCount;
+            stats.latencyStd = sqrt(
+                    (double) latency_sum_square / (double) currentCount
+                    - stats.latencyAve * stats.latencyAve);
+            stats.latencyMin = latency_min;
+            stats.latencyMax = latency_max;
+          #ifdef RTI_PERFTEST_NANO_CLOCK
+            stats.latencyAve /= 1000.0;
+            stats.latencyStd /= 1000.0;
+            stats.latencyMin /= 1000;
+            stats.latencyMax /= 1000;
+          #endif
+        }
+        stats.lostSamples = 0;
+        for (size_t i = 0;
+                !_lostSamplesUnknown.load() && i < _lostSamples.size();
+                i++) {
+            stats.lostSamples += _lostSamples[i];
+        }
     }
+  #endif
 
     void print_summary_latency(bool endTest = false){
         unsigned short mask;
@@ -1588,6 +3578,14 @@ public:
 
         // Before Sorting the array, it is the right time to print into a file
         // if we have to.
+      #ifdef PERFTEST_RTI_PRO
+        if (_PM->is_set("latencyFile")
+                && _PM->get<bool>("latencyFileBinary")) {
+            std::string file_name = _PM->get<std::string>("latencyFile");
+            write_latency_trace(
+                    file_name.empty() ? "LatencySamples.bin" : file_name);
+        } else
+      #endif
         if (_PM->is_set("latencyFile")) {
             std::string file_name = _PM->get<std::string>("latencyFile");
             if (file_name.empty()) {
@@ -1618,6 +3616,9 @@ public:
         latency_std = sqrt((double)latency_sum_square / (double)count - (latency_ave * latency_ave));
 
         if (showCpu) {
+          #ifdef PERFTEST_RTI_PRO
+            std::lock_guard<std::mutex> lock(_cpuMutex);
+          #endif
             outputCpu = cpu.get_cpu_average();
             cpu = CpuMonitor();
             cpu.initialize();
@@ -1747,6 +3748,14 @@ public:
                 serializeTime,
                 deserializeTime,
                 outputCpu);
+
+        if (_sizeBuckets != NULL) {
+          #ifndef RTI_PERFTEST_NANO_CLOCK
+            _sizeBuckets->print_latency("us");
+          #else
+            _sizeBuckets->print_latency("ns");
+          #endif
+        }
       #endif
 
         latency_sum = 0;
@@ -1759,11 +3768,123 @@ public:
         return;
     }
 
+    /*
+     * Used by -batchSizeSweep: get the statistics (in microseconds) of the
+     * pongs received since the last call and reset the counters for the
+     * next step. Returns the number of pongs.
+     */
+    unsigned long long take_step_latency(
+            double &latencyAve,
+            double &latencyP50,
+            double &latencyP90,
+            double &latencyP99)
+    {
+        unsigned long long stepCount = 0;
+        unsigned long long stepSum = 0;
+        unsigned long *history = NULL;
+        latencyAve = latencyP50 = latencyP90 = latencyP99 = 0;
+
+      #ifdef PERFTEST_RTI_PRO
+        if (_latency_history != NULL && _stepHistory == NULL) {
+            _stepHistory = static_cast<unsigned long *>(
+                    MemoryArena::get_instance().allocate(
+                            _num_latency * sizeof(unsigned long)));
+            if (_stepHistory == NULL) {
+                fprintf(stderr,
+                        "LatencyListener: Not able to allocate %u elements "
+                        "for the latency percentiles of the steps\n",
+                        _num_latency);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(_historyMutex);
+            stepCount = count;
+            stepSum = latency_sum;
+            if (_stepHistory != NULL) {
+                std::swap(_latency_history, _stepHistory);
+                history = _stepHistory;
+            }
+            resetLatencyCounters();
+        }
+      #else
+        stepCount = count;
+        stepSum = latency_sum;
+        history = _latency_history;
+      #endif
+
+        if (stepCount > 0) {
+            latencyAve = (double) stepSum / stepCount;
+            if (history != NULL) {
+                std::sort(history, history + stepCount);
+                latencyP50 = history[stepCount * 50 / 100];
+                latencyP90 = history[stepCount * 90 / 100];
+                latencyP99 = history[stepCount * 99 / 100];
+            }
+          #ifdef RTI_PERFTEST_NANO_CLOCK
+            latencyAve /= 1000.0;
+            latencyP50 /= 1000.0;
+            latencyP90 /= 1000.0;
+            latencyP99 /= 1000.0;
+          #endif
+        }
+
+      #ifndef PERFTEST_RTI_PRO
+        resetLatencyCounters();
+      #endif
+        return stepCount;
+    }
+
+    /*
+     * Every Subscriber reports the samples it loses in the pongs, see
+     * LOST_SAMPLES_REQUEST
+     */
+    bool is_lost_samples_known()
+    {
+      #ifdef PERFTEST_RTI_PRO
+        if (_lostSamplesUnknown.load()) {
+            if (!_lostSamplesUnknownWarned) {
+                fprintf(stderr,
+                        "[Warning] Some Subscribers do not report the samples "
+                        "they lose (other language, -cft or -readThreads), "
+                        "the lost samples are reported as N/A.\n");
+                _lostSamplesUnknownWarned = true;
+            }
+            return false;
+        }
+      #endif
+        return true;
+    }
+
+    // Total number of samples lost by the subscribers, see ThroughputListener
+    unsigned long long get_lost_samples()
+    {
+        unsigned long long lostSamples = 0;
+      #ifdef PERFTEST_RTI_PRO
+        std::lock_guard<std::mutex> lock(_historyMutex);
+      #endif
+        for (unsigned int i = 0; i < _lostSamples.size(); i++) {
+            lostSamples += _lostSamples[i];
+        }
+        return lostSamples;
+    }
+
     ~LatencyListener()
     {
         if (_latency_history != NULL) {
+          #ifdef PERFTEST_RTI_PRO
+            MemoryArena::get_instance().release(_latency_history);
+          #else
             delete []_latency_history;
+          #endif
+        }
+      #ifdef PERFTEST_RTI_PRO
+        if (_stepHistory != NULL) {
+            MemoryArena::get_instance().release(_stepHistory);
+        }
+        if (_sizeBuckets != NULL) {
+            delete _sizeBuckets;
         }
+      #endif
     }
 
     void process_message(TestMessage &message)
@@ -1785,6 +3906,12 @@ public:
         switch (message.size) {
             // Initializing message, don't process
             case perftest_cpp::INITIALIZE_SIZE:
+              #ifdef PERFTEST_RTI_PRO
+                if (message.latency_ping
+                        == perftest_cpp::LOST_SAMPLES_REQUEST) {
+                    _lostSamplesUnknown.store(true);
+                }
+              #endif
                 return;
             // Test finished message
             case perftest_cpp::FINISHED_SIZE:
@@ -1793,10 +3920,32 @@ public:
                 break;
         }
 
-        if (last_data_length != message.size) {
+      #ifdef PERFTEST_RTI_PRO
+        // Released at the end of the function, see take_step_latency()
+        std::unique_lock<std::mutex> historyLock(
+                _historyMutex,
+                std::defer_lock);
+        if (_lockHistory) {
+            historyLock.lock();
+        }
+      #endif
+
+        int length = message.size;
+      #ifdef PERFTEST_RTI_PRO
+        if (_distributionLength >= 0) {
+            length = _distributionLength;
+        }
+      #endif
+
+        if (last_data_length != length) {
             resetLatencyCounters();
         }
 
+        if (message.latency_ping >= 0
+                && message.latency_ping < (int) _lostSamples.size()) {
+            _lostSamples[message.latency_ping] = message.seq_num;
+        }
+
         sec = message.timestamp_sec;
         usec = message.timestamp_usec;
         sentTime = ((unsigned long long) sec << 32) | (unsigned long long) usec;
@@ -1838,62 +3987,1445 @@ public:
                      * (unsigned long long) latency);
 
             // if data sized changed, print out stats and zero counters
-            if (last_data_length != message.size) {
-                last_data_length = message.size;
+            if (last_data_length != length) {
+                last_data_length = length;
                 _printer->_dataLength =
                         last_data_length + perftest_cpp::OVERHEAD_BYTES;
                 _printer->print_latency_header();
                 resetLatencyCounters();
             } else {
+              #ifdef PERFTEST_RTI_PRO
+                if (_sizeBuckets != NULL) {
+                    _sizeBuckets->add_latency(
+                            message.size + perftest_cpp::OVERHEAD_BYTES,
+                            latency);
+                }
+              #endif
                 if (printIntervals) {
                     latency_ave = (double) latency_sum / (double) count;
                     latency_std =
                             sqrt((double) latency_sum_square / (double) count
                                  - (latency_ave * latency_ave));
 
-                    if (showCpu) {
-                        outputCpu = cpu.get_cpu_instant();
-                    }
-                    _printer->print_latency_interval(
-                            latency,
-                            latency_ave,
-                            latency_std,
-                            latency_min,
-                            latency_max,
-                            outputCpu);
+                    if (showCpu) {
+                      #ifdef PERFTEST_RTI_PRO
+                        outputCpu = _cpuSampled.load()
+                                ? _cpuInstant.load()
+                                : cpu.get_cpu_instant();
+                      #else
+                        outputCpu = cpu.get_cpu_instant();
+                      #endif
+                    }
+                    _printer->print_latency_interval(
+                            latency,
+                            latency_ave,
+                            latency_std,
+                            latency_min,
+                            latency_max,
+                            outputCpu);
+                }
+            }
+        } else {
+            fprintf(stderr,
+                    "Clock skew suspected: received time %llu usec,"
+                    " sent time %llu usec\n",
+                    now,
+                    sentTime);
+            ++clock_skew_count;
+        }
+
+        if (_writer != NULL) {
+            _writer->notify_ping_response();
+        }
+    }
+};
+
+#ifdef PERFTEST_RTI_PRO
+struct StatsTimerInfo
+{
+    PerftestStatsSegment *segment;
+    PerftestMetricsServer *metricsServer;
+    LatencyListener *listener;
+    IMessagingReader *reader;
+    IMessagingWriter *writer;
+    CpuMonitor cpu;
+};
+
+/*
+ * Updates the -statsSegment and -metricsEndpoint counters of the Publisher
+ * once per interval from the timer wheel, so neither the sending loop nor
+ * the thread receiving the pongs do it.
+ */
+static void StatsTimer(void *arg)
+{
+    StatsTimerInfo *info = static_cast<StatsTimerInfo *>(arg);
+
+    PerftestStatsSnapshot stats;
+    memset(&stats, 0, sizeof(stats));
+    if (info->listener != NULL) {
+        info->listener->fill_stats(stats);
+    }
+    stats.cpu = info->cpu.get_cpu_instant();
+    stats.readerQueuePeak = info->reader != NULL
+            ? (long long) info->reader->get_sample_count_peak()
+            : -1;
+    stats.writerQueuePeak = info->writer->get_sample_count_peak();
+    info->segment->update(stats);
+    if (info->metricsServer != NULL) {
+        info->metricsServer->update(stats);
+    }
+}
+
+/* Timer wheel callback of the CPU samples of the latency intervals */
+static void CpuSampleTimer(void *arg)
+{
+    static_cast<LatencyListener *>(arg)->sample_cpu();
+}
+
+/* Timer wheel callback of -executionTime */
+static void ExecutionTimeoutTimer(void *)
+{
+    perftest_cpp::_testCompleted = true;
+}
+
+/* Timer wheel callback of the steps of -rampRate, seen by the control loop */
+static void RampStepTimer(void *arg)
+{
+    static_cast<std::atomic<bool> *>(arg)->store(true);
+}
+
+/* Timer wheel callback of the end of every phase of -scenario */
+static void ScenarioPhaseTimer(void *arg)
+{
+    static_cast<std::atomic<unsigned int> *>(arg)->fetch_add(1);
+}
+#endif
+
+void perftest_cpp::calculate_publication_rate()
+{
+    unsigned long long pubRate =
+            (_PM.get_pair<unsigned long long, std::string>("pubRatebps").first
+                / (8 * _PM.get<unsigned long long>("dataLen")));
+    if (pubRate < 1) {
+        pubRate = 1;
+    }
+    fprintf(stderr, "Calculated Publication Rate is: %lld samples/s\n", pubRate);
+
+    _PM.set("pubRate", std::pair<unsigned long long, std::string>(
+        pubRate,
+        _PM.get_pair<unsigned long long, std::string>("pubRatebps").second
+    ));
+
+}
+
+#ifdef PERFTEST_RTI_PRO
+/*********************************************************
+ * Send threads (-sendThreads)
+ *
+ * Every thread sends its own sequence numbers through its own
+ * IMessagingWriter (which may share the DataWriter with the other threads):
+ * thread i sends i, i + threads, i + 2 * threads... The number of threads
+ * goes in the initialization messages, so the Subscriber detects the samples
+ * lost per thread.
+ * The threads wait in a lock-free barrier so all of them start sending at the
+ * same time. Only the first thread sends latency pings, with the latency
+ * count divided by the number of threads.
+ */
+struct PerftestSendThreadInfo
+{
+    int index;
+    int core;
+    IMessagingWriter *writer;
+    TestMessage message;
+    unsigned long long firstSeqNum;
+    unsigned long long seqNumStride;
+    unsigned long long numSamples;
+
+    // Configuration common to all the threads
+    bool sendPings;
+    unsigned int samplesPerBatch;
+    unsigned long long latencyCount;
+    int numSubscribers;
+    unsigned long pubRate;
+    bool pubRateMethodSpin;
+    unsigned long long spinPerUsec;
+    unsigned long long spinLoopCount;
+    unsigned long sleepNanosec;
+    std::atomic<int> *readyThreads;
+    std::atomic<int> *finishedThreads;
+    std::atomic<bool> *startSending;
+
+    // Results
+    unsigned long long samplesSent;
+    unsigned long long elapsedUsec;
+};
+
+static void *SendThread(void *arg)
+{
+    PerftestSendThreadInfo *info = static_cast<PerftestSendThreadInfo *>(arg);
+    TestMessage &message = info->message;
+    unsigned long long spinLoopCount = info->spinLoopCount;
+    unsigned long sleepNanosec = info->sleepNanosec;
+    const unsigned long sleepUsec = 1000;
+    DDS_Duration_t sleep_period = {0,0};
+    unsigned long pubRate_sample_period = 1;
+    unsigned long long time_now = 0, time_last_check = 0, time_delta = 0;
+    unsigned long rate = 0;
+    int num_pings = 0;
+    unsigned int current_index_in_batch = 0;
+    unsigned int ping_index_in_batch = 0;
+    bool sentPing = false;
+
+    if (info->core >= 0) {
+        ThreadCPUAffinity::set_current_thread_affinity(info->core);
+    }
+
+    if (info->pubRate > 100) {
+        pubRate_sample_period = info->pubRate / 100;
+    }
+
+    // Start barrier: wait until every thread is ready
+    info->readyThreads->fetch_add(1);
+    while (!info->startSending->load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    const unsigned long long startTime = PerftestClock::getInstance().getTime();
+    time_last_check = startTime;
+
+    unsigned long long loop = 0;
+    for (loop = 0;
+            (loop < info->numSamples) && (!perftest_cpp::_testCompleted);
+            ++loop) {
+
+        // Same control loop used by the main thread, with this thread's rate
+        if (info->pubRate > 0 && (loop > 0)
+                && (loop % pubRate_sample_period == 0)) {
+            time_now = PerftestClock::getInstance().getTime();
+            time_delta = time_now - time_last_check;
+            time_last_check = time_now;
+            if (time_delta > 0) {
+                rate = (pubRate_sample_period * 1000000) / (unsigned long) time_delta;
+            } else {
+                rate = pubRate_sample_period * 1000000;
+            }
+            if (info->pubRateMethodSpin) {
+                if (rate > info->pubRate) {
+                    spinLoopCount += info->spinPerUsec;
+                } else if (rate < info->pubRate && spinLoopCount > info->spinPerUsec) {
+                    spinLoopCount -= info->spinPerUsec;
+                } else if (rate < info->pubRate && spinLoopCount <= info->spinPerUsec) {
+                    spinLoopCount = 0;
+                }
+            } else { // sleep
+                if (rate > info->pubRate) {
+                    sleepNanosec += sleepUsec;
+                } else if (rate < info->pubRate && sleepNanosec > sleepUsec) {
+                    sleepNanosec -= sleepUsec;
+                } else if (rate < info->pubRate && sleepNanosec <= sleepUsec) {
+                    sleepNanosec = 0;
+                }
+            }
+        }
+
+        if (spinLoopCount > 0) {
+            NDDSUtility::spin(spinLoopCount);
+        }
+
+        if (sleepNanosec > 0) {
+            sleep_period.sec = (long) (sleepNanosec / 1000000000u);
+            sleep_period.nanosec = (unsigned long) sleepNanosec
+                                    - (unsigned long) (sleep_period.sec * 1000000000);
+            PerftestClock::sleep(sleep_period);
+        }
+
+        message.latency_ping = -1;
+
+        // Same ping logic used by the main thread, see Publisher()
+        if (info->sendPings && (((loop / info->samplesPerBatch)
+                % info->latencyCount) == 0)) {
+            if (current_index_in_batch == ping_index_in_batch && !sentPing) {
+                message.latency_ping = num_pings % info->numSubscribers;
+
+              #ifndef RTI_PERFTEST_NANO_CLOCK
+                unsigned long long now = PerftestClock::getInstance().getTime();
+              #else
+                unsigned long long now = PerftestClock::getInstance().getTimeNs();
+              #endif
+                message.timestamp_sec = (int)((now >> 32) & 0xFFFFFFFF);
+                message.timestamp_usec = (unsigned int)(now & 0xFFFFFFFF);
+                ++num_pings;
+                ping_index_in_batch =
+                        (ping_index_in_batch + 1) % info->samplesPerBatch;
+                sentPing = true;
+            }
+        }
+        current_index_in_batch =
+                (current_index_in_batch + 1) % info->samplesPerBatch;
+
+        message.seq_num = (unsigned long)
+                (info->firstSeqNum + loop * info->seqNumStride);
+        info->writer->send(message);
+
+        if (current_index_in_batch == 0) {
+            sentPing = false;
+        }
+    }
+
+    info->writer->flush();
+    info->elapsedUsec = PerftestClock::getInstance().getTime() - startTime;
+    info->samplesSent = loop;
+    info->finishedThreads->fetch_add(1);
+
+    return NULL;
+}
+
+/*
+ * Run the main sending loop in _PM["sendThreads"] threads, one per writer in
+ * writers, and report the send rate of every thread and the aggregated one.
+ */
+bool perftest_cpp::run_send_threads(
+        const std::vector<IMessagingWriter *> &writers,
+        const TestMessage &message,
+        unsigned int samplesPerBatch,
+        unsigned long long spinPerUsec)
+{
+    const int sendThreads = (int) writers.size();
+    const unsigned long long numIter = _PM.get<unsigned long long>("numIter");
+    std::atomic<int> readyThreads(0);
+    std::atomic<int> finishedThreads(0);
+    std::atomic<bool> startSending(false);
+    std::vector<PerftestSendThreadInfo> infos(sendThreads);
+    std::vector<PerftestThread *> threads;
+    bool success = true;
+
+    int threadPriority = Perftest_THREAD_PRIORITY_DEFAULT;
+    int threadOptions = Perftest_THREAD_OPTION_DEFAULT;
+    if (_threadPriorities.isSet) {
+        threadPriority = _threadPriorities.main;
+        threadOptions = Perftest_THREAD_SETTINGS_REALTIME_PRIORITY
+                | Perftest_THREAD_SETTINGS_PRIORITY_ENFORCE;
+    }
+    const std::vector<int> &cores = _threadCPUAffinity.get_cores_main();
+
+    for (int i = 0; i < sendThreads; i++) {
+        PerftestSendThreadInfo &info = infos[i];
+        info.index = i;
+        info.core = cores.empty() ? -1 : cores[i % cores.size()];
+        info.writer = writers[i];
+        info.message = message;
+        info.firstSeqNum = i;
+        info.seqNumStride = sendThreads;
+        info.numSamples = numIter > (unsigned long long) i
+                ? (numIter - i + sendThreads - 1) / sendThreads
+                : 0;
+        info.sendPings = (i == 0) && (_PM.get<int>("pidMultiPubTest") == 0);
+        info.samplesPerBatch = samplesPerBatch;
+        /*
+         * The first thread sends 1 of every sendThreads samples, so it pings
+         * sendThreads times as often to keep the pings of a single thread.
+         */
+        info.latencyCount = (std::max)(
+                _PM.get<unsigned long long>("latencyCount")
+                        / (unsigned long long) sendThreads,
+                1ULL);
+        info.numSubscribers = _PM.get<int>("numSubscribers");
+        info.pubRate = (unsigned long) (_PM.get_pair<unsigned long long,
+                std::string>("pubRate").first / sendThreads);
+        if (_PM.is_set("pubRate") && info.pubRate == 0) {
+            info.pubRate = 1;
+        }
+        info.pubRateMethodSpin = _PM.get_pair<unsigned long long,
+                std::string>("pubRate").second == "spin";
+        info.spinPerUsec = spinPerUsec;
+        info.spinLoopCount = _SpinLoopCount * sendThreads;
+        info.sleepNanosec = _SleepNanosec * sendThreads;
+        info.readyThreads = &readyThreads;
+        info.finishedThreads = &finishedThreads;
+        info.startSending = &startSending;
+        info.samplesSent = 0;
+        info.elapsedUsec = 0;
+    }
+
+    for (int i = 0; i < sendThreads; i++) {
+        PerftestThread *thread = PerftestThread_new(
+                "SendThread",
+                threadPriority,
+                threadOptions,
+                SendThread,
+                &infos[i]);
+        if (thread == NULL) {
+            fprintf(stderr, "Problem creating SendThread %d.\n", i);
+            success = false;
+            break;
+        }
+        threads.push_back(thread);
+    }
+
+    // Release the threads once all of them are ready
+    while (success && readyThreads.load() < sendThreads) {
+        std::this_thread::yield();
+    }
+    if (!success) {
+        _testCompleted = true;
+    }
+    startSending.store(true, std::memory_order_release);
+
+    while (finishedThreads.load() < (int) threads.size()) {
+        PerftestClock::milliSleep(10);
+    }
+
+    for (unsigned int i = 0; i < threads.size(); i++) {
+        PerftestThread_delete(threads[i]);
+    }
+
+    // Make sure the samples of every writer are delivered before finishing
+    for (int i = 1; i < sendThreads; i++) {
+        writers[i]->wait_for_ack(
+                timeout_wait_for_ack_sec,
+                timeout_wait_for_ack_nsec);
+    }
+
+    if (!success) {
+        return false;
+    }
+
+    unsigned long long totalSamples = 0;
+    unsigned long long maxElapsedUsec = 0;
+    fprintf(stderr, "\nSend rate per thread:\n");
+    for (int i = 0; i < sendThreads; i++) {
+        totalSamples += infos[i].samplesSent;
+        maxElapsedUsec = (std::max)(maxElapsedUsec, infos[i].elapsedUsec);
+        fprintf(stderr,
+                "\tThread %d (core %d): %llu samples, %.0f samples/s\n",
+                i,
+                infos[i].core,
+                infos[i].samplesSent,
+                infos[i].elapsedUsec > 0
+                    ? infos[i].samplesSent * 1000000.0 / infos[i].elapsedUsec
+                    : 0.0);
+    }
+    fprintf(stderr,
+            "\tAggregated: %llu samples, %.0f samples/s, %.1f Mbps\n",
+            totalSamples,
+            maxElapsedUsec > 0
+                ? totalSamples * 1000000.0 / maxElapsedUsec
+                : 0.0,
+            maxElapsedUsec > 0
+                ? totalSamples * 8.0 * (message.size + OVERHEAD_BYTES)
+                        / maxElapsedUsec
+                : 0.0);
+    fflush(stderr);
+
+    return true;
+}
+
+/*********************************************************
+ * Batch size sweep (-batchSizeSweep)
+ *
+ * The main sending loop is run once per batch size. Only the Throughput
+ * DataWriter is recreated between steps; the sequence numbers keep growing
+ * so the Subscriber sees a single test.
+ */
+struct BatchSizeSweepStep
+{
+    long batchSize;
+    unsigned long long samples;
+    double samplesPerSec;
+    double mbps;
+    unsigned long long pongs;
+    double latencyAve;
+    double latencyP50;
+    double latencyP90;
+    double latencyP99;
+    double cpu;
+};
+
+/*
+ * A step is in the Pareto frontier if no other step has both more (or equal)
+ * throughput and less (or equal) 99% latency, being better in one of them.
+ */
+static bool is_pareto_optimal(
+        const std::vector<BatchSizeSweepStep> &steps,
+        unsigned int index)
+{
+    const BatchSizeSweepStep &step = steps[index];
+    for (unsigned int i = 0; i < steps.size(); i++) {
+        if (i == index) {
+            continue;
+        }
+        if (steps[i].samplesPerSec >= step.samplesPerSec
+                && steps[i].latencyP99 <= step.latencyP99
+                && (steps[i].samplesPerSec > step.samplesPerSec
+                    || steps[i].latencyP99 < step.latencyP99)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool perftest_cpp::run_batch_size_sweep(
+        IMessagingWriter *&writer,
+        LatencyListener *latencyListener,
+        TestMessage &message)
+{
+    const std::vector<unsigned long long> batchSizes =
+            _PM.get_vector<unsigned long long>("batchSizeSweep");
+    const unsigned long long dataLen = _PM.get<unsigned long long>("dataLen");
+    const unsigned long long samplesPerStep =
+            _PM.get<unsigned long long>("numIter") / batchSizes.size();
+    const unsigned long long latencyCount =
+            _PM.get<unsigned long long>("latencyCount");
+    const int numSubscribers = _PM.get<int>("numSubscribers");
+    const bool useDatafromFile = _PM.is_set("loadDataFromFile");
+    std::vector<BatchSizeSweepStep> steps;
+    unsigned long long seqNum = 0;
+    int num_pings = 0;
+
+    for (unsigned int s = 0; s < batchSizes.size() && !_testCompleted; s++) {
+        BatchSizeSweepStep step;
+
+        /*
+         * Same rule used by the middleware when validating -batchSize: the
+         * batch must be able to contain at least two samples.
+         */
+        step.batchSize = (long) batchSizes[s];
+        if ((unsigned long long) step.batchSize < dataLen * 2) {
+            step.batchSize = 0;
+        }
+        _PM.set<long>("batchSize", step.batchSize);
+
+        // Make sure everything sent so far is delivered before the writer goes
+        writer->flush();
+        writer->wait_for_ack(timeout_wait_for_ack_sec, timeout_wait_for_ack_nsec);
+        _MessagingImpl->delete_writer(writer);
+        writer = _MessagingImpl->create_writer(THROUGHPUT_TOPIC_NAME);
+        if (writer == NULL) {
+            fprintf(stderr,
+                    "Problem creating throughput writer for batch size %ld.\n",
+                    step.batchSize);
+            return false;
+        }
+        writer->wait_for_readers(numSubscribers);
+
+        const unsigned int samplesPerBatch = get_samples_per_batch();
+        int current_index_in_batch = 0;
+        int ping_index_in_batch = 0;
+        bool sentPing = false;
+        double latencyIgnored;
+        CpuMonitor cpu;
+
+        fprintf(stderr,
+                "Sending data with batch size %ld (step %u of %u) ...\n",
+                step.batchSize,
+                s + 1,
+                (unsigned int) batchSizes.size());
+        fflush(stderr);
+
+        // Discard the pongs of the previous step that arrived late
+        if (latencyListener != NULL) {
+            latencyListener->take_step_latency(
+                    latencyIgnored,
+                    latencyIgnored,
+                    latencyIgnored,
+                    latencyIgnored);
+        }
+        if (showCpu) {
+            cpu.initialize();
+        }
+
+        unsigned long long startTime = PerftestClock::getInstance().getTime();
+        unsigned long long loop = 0;
+        for (loop = 0; (loop < samplesPerStep) && (!_testCompleted); ++loop) {
+            message.latency_ping = -1;
+
+            // Same ping logic used by the main thread, see Publisher()
+            if (latencyListener != NULL
+                    && (((loop / samplesPerBatch) % latencyCount) == 0)
+                    && current_index_in_batch == ping_index_in_batch
+                    && !sentPing) {
+                message.latency_ping = num_pings % numSubscribers;
+
+              #ifndef RTI_PERFTEST_NANO_CLOCK
+                unsigned long long now = PerftestClock::getInstance().getTime();
+              #else
+                unsigned long long now = PerftestClock::getInstance().getTimeNs();
+              #endif
+                message.timestamp_sec = (int)((now >> 32) & 0xFFFFFFFF);
+                message.timestamp_usec = (unsigned int)(now & 0xFFFFFFFF);
+                ++num_pings;
+                ping_index_in_batch = (ping_index_in_batch + 1) % samplesPerBatch;
+                sentPing = true;
+            }
+            current_index_in_batch = (current_index_in_batch + 1) % samplesPerBatch;
+
+            message.seq_num = (unsigned long) seqNum++;
+            if (useDatafromFile) {
+                message.data = _fileDataLoader.get_next_buffer();
+            }
+            writer->send(message);
+
+            if (current_index_in_batch == 0) {
+                sentPing = false;
+            }
+        }
+        writer->flush();
+        writer->wait_for_ack(timeout_wait_for_ack_sec, timeout_wait_for_ack_nsec);
+        unsigned long long elapsedUsec =
+                PerftestClock::getInstance().getTime() - startTime;
+
+        // Give the last pongs of the step some time to arrive
+        PerftestClock::milliSleep(100);
+
+        step.samples = loop;
+        step.samplesPerSec = elapsedUsec > 0
+                ? loop * 1000000.0 / elapsedUsec
+                : 0.0;
+        step.mbps = elapsedUsec > 0
+                ? loop * 8.0 * (message.size + OVERHEAD_BYTES) / elapsedUsec
+                : 0.0;
+        step.pongs = 0;
+        step.latencyAve = step.latencyP50 = 0;
+        step.latencyP90 = step.latencyP99 = 0;
+        if (latencyListener != NULL) {
+            step.pongs = latencyListener->take_step_latency(
+                    step.latencyAve,
+                    step.latencyP50,
+                    step.latencyP90,
+                    step.latencyP99);
+        }
+        step.cpu = showCpu ? cpu.get_cpu_average() : 0.0;
+        steps.push_back(step);
+    }
+
+    printf("\nBatch Size Sweep (%llu samples per step, latency in μs):\n",
+            samplesPerStep);
+    printf("Batch Size (Bytes), Samples/s,      Mbps,   Pongs,"
+            "       Ave,       50%%,       90%%,       99%%");
+    if (showCpu) {
+        printf(",  CPU (%%)");
+    }
+    printf(", Pareto\n");
+    for (unsigned int i = 0; i < steps.size(); i++) {
+        printf("%18ld,%10.0f,%10.1f,%8llu,%10.1f,%10.1f,%10.1f,%10.1f",
+                steps[i].batchSize,
+                steps[i].samplesPerSec,
+                steps[i].mbps,
+                steps[i].pongs,
+                steps[i].latencyAve,
+                steps[i].latencyP50,
+                steps[i].latencyP90,
+                steps[i].latencyP99);
+        if (showCpu) {
+            printf(",%9.2f", steps[i].cpu);
+        }
+        printf(", %s\n", is_pareto_optimal(steps, i) ? "yes" : "no");
+    }
+
+    printf("\nPareto frontier (throughput vs 99%% latency):\n");
+    for (unsigned int i = 0; i < steps.size(); i++) {
+        if (is_pareto_optimal(steps, i)) {
+            printf("\tBatch Size %ld Bytes: %.0f samples/s, %.1f μs\n",
+                    steps[i].batchSize,
+                    steps[i].samplesPerSec,
+                    steps[i].latencyP99);
+        }
+    }
+    fflush(stdout);
+
+    return true;
+}
+
+/*********************************************************
+ * Rate ramp (-rampRate)
+ *
+ * The -pubRate control loop of the main thread increases the rate every
+ * secondsPerStep. The Subscribers report the samples they lost so far in
+ * every pong, and the latency of every step is taken from the pongs received
+ * during it.
+ */
+struct RampRateStep
+{
+    unsigned long long rate;
+    double samplesPerSec;
+    // False if some Subscriber does not report its loss, see LOST_SAMPLES_*
+    bool lostKnown;
+    unsigned long long lostSamples;
+    double lostPercent;
+    unsigned long long pongs;
+    double latencyAve;
+    double latencyP50;
+    double latencyP90;
+    double latencyP99;
+};
+
+// Send about this number of pings per second in every step
+static const unsigned long long RAMP_RATE_PINGS_PER_SEC = 100;
+
+static unsigned long long ramp_rate_latency_count(unsigned long long rate)
+{
+    return rate > RAMP_RATE_PINGS_PER_SEC
+            ? rate / RAMP_RATE_PINGS_PER_SEC
+            : 1;
+}
+
+/*
+ * Get the results of the step that has just finished. lostSamplesBase is the
+ * number of samples lost before the step, it is updated for the next one.
+ */
+static RampRateStep finish_ramp_rate_step(
+        LatencyListener *latencyListener,
+        unsigned long long rate,
+        unsigned long long samples,
+        unsigned long long elapsedUsec,
+        int numSubscribers,
+        unsigned long long &lostSamplesBase)
+{
+    RampRateStep step;
+    step.rate = rate;
+    step.samplesPerSec = elapsedUsec > 0
+            ? samples * 1000000.0 / elapsedUsec
+            : 0.0;
+    step.lostKnown = false;
+    step.lostSamples = 0;
+    step.lostPercent = 0;
+    step.pongs = 0;
+    step.latencyAve = step.latencyP50 = 0;
+    step.latencyP90 = step.latencyP99 = 0;
+
+    if (latencyListener != NULL) {
+        step.lostKnown = latencyListener->is_lost_samples_known();
+        unsigned long long lostSamples = latencyListener->get_lost_samples();
+        if (lostSamples > lostSamplesBase) {
+            step.lostSamples = lostSamples - lostSamplesBase;
+        }
+        lostSamplesBase = lostSamples;
+        if (samples > 0) {
+            step.lostPercent = step.lostSamples * 100.0
+                    / (samples * (double) numSubscribers);
+        }
+        step.pongs = latencyListener->take_step_latency(
+                step.latencyAve,
+                step.latencyP50,
+                step.latencyP90,
+                step.latencyP99);
+    }
+
+    return step;
+}
+
+/* Columns "Lost Samples, Lost (%)," of the reports of the steps */
+static void print_step_loss(const RampRateStep &step)
+{
+    if (step.lostKnown) {
+        printf("%13llu,%9.3f,", step.lostSamples, step.lostPercent);
+    } else {
+        printf("%13s,%9s,", "N/A", "N/A");
+    }
+}
+
+/*
+ * Print the results of every step and the knee: the highest rate before the
+ * first step that exceeds the loss or latency thresholds. The steps whose
+ * loss is not known are only checked against the latency threshold.
+ */
+static void print_ramp_rate_report(
+        const std::vector<RampRateStep> &steps,
+        unsigned long long secondsPerStep,
+        double maxLostPercent,
+        unsigned long long maxLatency)
+{
+    const RampRateStep *knee = NULL;
+    bool exceeded = false;
+    bool lostUnknown = false;
+
+    printf("\nRate Ramp (%llu s per step, latency in μs):\n", secondsPerStep);
+    printf("Rate (Samples/s), Sent (Samples/s), Lost Samples, Lost (%%),"
+            "   Pongs,       Ave,       50%%,       90%%,       99%%,"
+            " Sustainable\n");
+    for (unsigned int i = 0; i < steps.size(); i++) {
+        bool sustainable =
+                (!steps[i].lostKnown || steps[i].lostPercent <= maxLostPercent)
+                && (maxLatency == 0 || steps[i].latencyP99 <= maxLatency);
+        if (!sustainable) {
+            exceeded = true;
+        } else if (!exceeded) {
+            knee = &steps[i];
+        }
+        lostUnknown = lostUnknown || !steps[i].lostKnown;
+        printf("%16llu,%17.0f,", steps[i].rate, steps[i].samplesPerSec);
+        print_step_loss(steps[i]);
+        printf("%8llu,%10.1f,%10.1f,%10.1f,%10.1f, %s\n",
+                steps[i].pongs,
+                steps[i].latencyAve,
+                steps[i].latencyP50,
+                steps[i].latencyP90,
+                steps[i].latencyP99,
+                sustainable ? "yes" : "no");
+    }
+
+    if (lostUnknown) {
+        printf("\nThe loss of some steps is not known, only their latency "
+                "is checked.");
+    }
+    printf("\nKnee (lost <= %.3f %%", maxLostPercent);
+    if (maxLatency > 0) {
+        printf(", 99%% latency <= %llu μs", maxLatency);
+    }
+    printf("): ");
+    if (knee != NULL) {
+        printf("%llu samples/s%s\n",
+                knee->rate,
+                exceeded ? "" : " (thresholds not exceeded, increase <max>)");
+    } else {
+        printf("Not found, the first step exceeds the thresholds\n");
+    }
+    fflush(stdout);
+}
+
+/*********************************************************
+ * Repetitions (-repetitions, -warmupSeconds, -steadyState)
+ *
+ * The main thread of the Publisher checks the clock every few samples. The
+ * samples sent during the warm-up are discarded, and then the test is split
+ * in windows of the same duration, measured like the steps of -rampRate:
+ * the throughput sent, the loss reported in the pongs and the latency of the
+ * pongs received in the window.
+ */
+struct RepetitionWindow
+{
+    double samplesPerSec;
+    double mbps;
+    // False if some Subscriber does not report its loss, see LOST_SAMPLES_*
+    bool lostKnown;
+    double lostPercent;
+    unsigned long long pongs;
+    double latencyAve;
+    double latencyP50;
+    double latencyP90;
+    double latencyP99;
+};
+
+// Seconds measured to decide if the warm-up reached the steady state
+static const unsigned int STEADY_STATE_SECONDS = 5;
+
+class RepetitionRunner
+{
+  public:
+    RepetitionRunner(
+            ParameterManager &PM,
+            LatencyListener *latencyListener,
+            unsigned long long sampleSize)
+            : _latencyListener(latencyListener),
+              _sampleSize(sampleSize),
+              _numSubscribers(PM.get<int>("numSubscribers")),
+              _repetitions(PM.get<unsigned long long>("repetitions")),
+              _windowUsec(PM.get<unsigned long long>("repetitionSeconds")
+                      * 1000000),
+              _warmupUsec(PM.get<unsigned long long>("warmupSeconds")
+                      * 1000000),
+              _maxVariation(-1),
+              _warmingUp(true),
+              _steady(false),
+              _startTime(0),
+              _periodStartTime(0),
+              _periodFirstLoop(0),
+              _lostSamplesBase(0),
+              _warmupElapsedUsec(0)
+    {
+        if (PM.is_set("steadyState")) {
+            _maxVariation = strtod(
+                    PM.get<std::string>("steadyState").c_str(),
+                    NULL);
+        }
+    }
+
+    void start(unsigned long long now)
+    {
+        _startTime = now;
+        _periodStartTime = now;
+        _periodFirstLoop = 0;
+        fprintf(stderr, "Warming up ...\n");
+        fflush(stderr);
+    }
+
+    /*
+     * Called by the main loop with the samples sent so far. False when the
+     * last window has finished.
+     */
+    bool check(unsigned long long now, unsigned long long loop)
+    {
+        if (_warmingUp) {
+            check_warmup(now, loop);
+            return true;
+        }
+        if (now - _periodStartTime < _windowUsec) {
+            return true;
+        }
+
+        _windows.push_back(finish_window(now, loop));
+        _periodStartTime = now;
+        _periodFirstLoop = loop;
+        if (_windows.size() >= _repetitions) {
+            return false;
+        }
+        fprintf(stderr,
+                "Measuring window %u of %llu ...\n",
+                (unsigned int) _windows.size() + 1,
+                _repetitions);
+        fflush(stderr);
+        return true;
+    }
+
+    void print_report()
+    {
+        printf("\nRepetitions (%llu s per window, latency in μs):\n",
+                _windowUsec / 1000000);
+        if (_warmingUp) {
+            printf("The test finished during the warm-up, increase "
+                    "-numIter or -executionTime\n");
+            fflush(stdout);
+            return;
+        }
+        printf("Warm-up: %.1f s%s\n",
+                _warmupElapsedUsec / 1000000.0,
+                _maxVariation < 0
+                        ? ""
+                        : _steady ? " (steady state reached)"
+                                  : " (steady state not reached)");
+        if (_windows.size() < _repetitions) {
+            printf("Only %u of %llu windows completed, increase -numIter "
+                    "or -executionTime\n",
+                    (unsigned int) _windows.size(),
+                    _repetitions);
+        }
+
+        printf("    Window, Samples/s,      Mbps, Lost (%%),   Pongs,"
+                "       Ave,       50%%,       90%%,       99%%\n");
+        bool lostKnown = true;
+        for (unsigned int i = 0; i < _windows.size(); i++) {
+            printf("%10u,%10.0f,%10.1f,",
+                    i + 1,
+                    _windows[i].samplesPerSec,
+                    _windows[i].mbps);
+            if (_windows[i].lostKnown) {
+                printf("%9.3f,", _windows[i].lostPercent);
+            } else {
+                printf("%9s,", "N/A");
+                lostKnown = false;
+            }
+            printf("%8llu,%10.1f,%10.1f,%10.1f,%10.1f\n",
+                    _windows[i].pongs,
+                    _windows[i].latencyAve,
+                    _windows[i].latencyP50,
+                    _windows[i].latencyP90,
+                    _windows[i].latencyP99);
+        }
+        if (_windows.empty()) {
+            fflush(stdout);
+            return;
+        }
+
+        printf("\n    Metric,      Mean,    StdDev,  95%% CI (+/-),"
+                "  CV (%%)\n");
+        print_statistic("Samples/s", &RepetitionWindow::samplesPerSec);
+        print_statistic("Mbps", &RepetitionWindow::mbps);
+        if (lostKnown) {
+            print_statistic("Lost (%)", &RepetitionWindow::lostPercent);
+        } else {
+            printf("%10s,%10s,%10s,%14s,%9s\n",
+                    "Lost (%)", "N/A", "N/A", "N/A", "N/A");
+        }
+        if (_latencyListener != NULL) {
+            print_statistic("Ave", &RepetitionWindow::latencyAve);
+            print_statistic("50%", &RepetitionWindow::latencyP50);
+            print_statistic("90%", &RepetitionWindow::latencyP90);
+            print_statistic("99%", &RepetitionWindow::latencyP99);
+        }
+        fflush(stdout);
+    }
+
+  private:
+    void check_warmup(unsigned long long now, unsigned long long loop)
+    {
+        bool finished = now - _startTime >= _warmupUsec;
+
+        // Every second, look for the steady state in the last seconds
+        if (_maxVariation >= 0 && !finished
+                && now - _periodStartTime >= 1000000) {
+            RepetitionWindow second = finish_window(now, loop);
+            _periodStartTime = now;
+            _periodFirstLoop = loop;
+            _throughputHistory.push_back(second.samplesPerSec);
+            if (second.pongs > 0) {
+                _latencyHistory.push_back(second.latencyAve);
+            }
+            _steady = is_steady(_throughputHistory)
+                    && (_latencyListener == NULL
+                        || is_steady(_latencyHistory));
+            finished = _steady;
+        }
+        if (!finished) {
+            return;
+        }
+
+        // Discard what was measured during the warm-up
+        _warmingUp = false;
+        _warmupElapsedUsec = now - _startTime;
+        finish_window(now, loop);
+        _periodStartTime = now;
+        _periodFirstLoop = loop;
+        fprintf(stderr,
+                "Warm-up finished after %.1f s. Measuring window 1 of "
+                "%llu ...\n",
+                _warmupElapsedUsec / 1000000.0,
+                _repetitions);
+        fflush(stderr);
+    }
+
+    // Coefficient of variation of the last seconds below the threshold
+    bool is_steady(const std::vector<double> &history)
+    {
+        if (history.size() < STEADY_STATE_SECONDS) {
+            return false;
+        }
+        double mean = 0;
+        double deviation = 0;
+        get_statistics(
+                history.end() - STEADY_STATE_SECONDS,
+                history.end(),
+                mean,
+                deviation);
+        return mean > 0 && deviation * 100.0 / mean <= _maxVariation;
+    }
+
+    RepetitionWindow finish_window(
+            unsigned long long now,
+            unsigned long long loop)
+    {
+        RepetitionWindow window;
+        unsigned long long samples = loop - _periodFirstLoop;
+        unsigned long long elapsedUsec = now - _periodStartTime;
+        window.samplesPerSec = elapsedUsec > 0
+                ? samples * 1000000.0 / elapsedUsec
+                : 0.0;
+        window.mbps = elapsedUsec > 0
+                ? samples * 8.0 * _sampleSize / elapsedUsec
+                : 0.0;
+        window.lostKnown = false;
+        window.lostPercent = 0;
+        window.pongs = 0;
+        window.latencyAve = window.latencyP50 = 0;
+        window.latencyP90 = window.latencyP99 = 0;
+
+        if (_latencyListener != NULL) {
+            window.lostKnown = _latencyListener->is_lost_samples_known();
+            unsigned long long lostSamples =
+                    _latencyListener->get_lost_samples();
+            if (lostSamples > _lostSamplesBase && samples > 0) {
+                window.lostPercent = (lostSamples - _lostSamplesBase)
+                        * 100.0 / (samples * (double) _numSubscribers);
+            }
+            _lostSamplesBase = lostSamples;
+            window.pongs = _latencyListener->take_step_latency(
+                    window.latencyAve,
+                    window.latencyP50,
+                    window.latencyP90,
+                    window.latencyP99);
+        }
+        return window;
+    }
+
+    // Mean and sample standard deviation
+    static void get_statistics(
+            std::vector<double>::const_iterator begin,
+            std::vector<double>::const_iterator end,
+            double &mean,
+            double &deviation)
+    {
+        double count = (double) (end - begin);
+        double sum = 0;
+        double sumSquare = 0;
+        for (std::vector<double>::const_iterator it = begin; it != end; ++it) {
+            sum += *it;
+        }
+        mean = count > 0 ? sum / count : 0;
+        for (std::vector<double>::const_iterator it = begin; it != end; ++it) {
+            sumSquare += (*it - mean) * (*it - mean);
+        }
+        deviation = count > 1 ? sqrt(sumSquare / (count - 1)) : 0;
+    }
+
+    // Two-sided 95% quantile of the Student's t distribution
+    static double get_t_quantile(size_t degreesOfFreedom)
+    {
+        static const double quantiles[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+            2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+            2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+            2.048, 2.045, 2.042
+        };
+        if (degreesOfFreedom == 0) {
+            return 0;
+        }
+        if (degreesOfFreedom <= sizeof(quantiles) / sizeof(quantiles[0])) {
+            return quantiles[degreesOfFreedom - 1];
+        }
+        return 1.960;
+    }
+
+    void print_statistic(const char *name, double RepetitionWindow::*field)
+    {
+        std::vector<double> values;
+        for (unsigned int i = 0; i < _windows.size(); i++) {
+            values.push_back(_windows[i].*field);
+        }
+        double mean = 0;
+        double deviation = 0;
+        get_statistics(values.begin(), values.end(), mean, deviation);
+        double interval = get_t_quantile(values.size() - 1) * deviation
+                / sqrt((double) values.size());
+        printf("%10s,%10.1f,%10.2f,%14.2f,%9.2f\n",
+                name,
+                mean,
+                deviation,
+                interval,
+                mean > 0 ? deviation * 100.0 / mean : 0.0);
+    }
+
+    LatencyListener *_latencyListener;
+    unsigned long long _sampleSize;
+    int _numSubscribers;
+    unsigned long long _repetitions;
+    unsigned long long _windowUsec;
+    unsigned long long _warmupUsec;
+    double _maxVariation;
+
+    bool _warmingUp;
+    bool _steady;
+    unsigned long long _startTime;
+    unsigned long long _periodStartTime;
+    unsigned long long _periodFirstLoop;
+    unsigned long long _lostSamplesBase;
+    unsigned long long _warmupElapsedUsec;
+    std::vector<double> _throughputHistory;
+    std::vector<double> _latencyHistory;
+    std::vector<RepetitionWindow> _windows;
+};
+
+/*********************************************************
+ * Scenario (-scenario)
+ *
+ * The end of every phase is a one-shot timer of the timer wheel, which
+ * increments the number of phases due. The main loop of the Publisher checks
+ * that number before every sample and, when it changes, copies the sample
+ * size, rate and latency count precomputed for the next phase. Every phase
+ * is measured like the steps of -rampRate: the throughput sent, the loss
+ * reported in the pongs and the latency of the pongs received in the phase.
+ * A mark sent with the samples at every phase change lets the Subscribers
+ * report every phase too.
+ */
+
+// Longest sleep between bursts before checking the end of the phase
+static const unsigned long long SCENARIO_SLEEP_SLICE_USEC = 1000;
+
+class ScenarioRunner
+{
+  public:
+    ScenarioRunner(
+            const PerftestScenario &scenario,
+            PerftestTimerWheel &timerWheel,
+            IMessagingWriter *writer,
+            LatencyListener *latencyListener,
+            ParameterManager &PM)
+            : _phases(scenario.get_phases()),
+              _timerWheel(timerWheel),
+              _writer(writer),
+              _latencyListener(latencyListener),
+              _numSubscribers(PM.get<int>("numSubscribers")),
+              _numInstances((unsigned long) PM.get<long>("instances")),
+              _useInstanceSets(scenario.get_max_instance() >= 0),
+              _phase(-1),
+              _phaseStartTime(0),
+              _phaseFirstLoop(0),
+              _lostSamplesBase(0),
+              _burstSamples(0),
+              _burstLeft(0),
+              _burstNextTime(0),
+              _markData(perftest_cpp::INITIALIZE_SIZE, 0)
+    {
+        _phasesDue.store(0);
+        _mark.data = &_markData[0];
+        _mark.size = perftest_cpp::INITIALIZE_SIZE;
+        _mark.entity_id = PM.get<int>("pidMultiPubTest");
+        _mark.latency_ping = perftest_cpp::SCENARIO_PHASE_MARK;
+
+        // Everything the main loop needs when the phase changes
+        for (unsigned int i = 0; i < _phases.size(); i++) {
+            int sampleSize = (int) (_phases[i].dataLen
+                    - perftest_cpp::OVERHEAD_BYTES);
+            // The sizes that signal the test cannot be used as data
+            if (sampleSize == perftest_cpp::INITIALIZE_SIZE
+                    || sampleSize == perftest_cpp::FINISHED_SIZE) {
+                sampleSize = perftest_cpp::INITIALIZE_SIZE - 1;
+            }
+            _sampleSizes.push_back(sampleSize);
+
+            if (_phases[i].pubRate > 0) {
+                _latencyCounts.push_back(
+                        ramp_rate_latency_count(_phases[i].pubRate));
+            } else if (_phases[i].burstSamples > 0) {
+                _latencyCounts.push_back(ramp_rate_latency_count(
+                        _phases[i].burstSamples * 1000000
+                                / _phases[i].burstPeriodUsec));
+            } else {
+                _latencyCounts.push_back(
+                        PM.get<unsigned long long>("latencyCount"));
+            }
+        }
+    }
+
+    /* Schedule the end of every phase. The first phase starts now */
+    bool start()
+    {
+        if (_latencyListener != NULL) {
+            finish_ramp_rate_step(
+                    _latencyListener, 0, 0, 0, _numSubscribers,
+                    _lostSamplesBase);
+        }
+
+        unsigned long long endUsec = 0;
+        for (unsigned int i = 0; i < _phases.size(); i++) {
+            endUsec += _phases[i].durationUsec;
+            long timer = _timerWheel.schedule(
+                    endUsec * 1000,
+                    0,
+                    ScenarioPhaseTimer,
+                    &_phasesDue);
+            if (timer < 0) {
+                fprintf(stderr, "Problem scheduling the -scenario phases.\n");
+                return false;
+            }
+            _timers.push_back(timer);
+        }
+        return true;
+    }
+
+    /* Cancel the phases not finished yet */
+    void stop()
+    {
+        for (unsigned int i = 0; i < _timers.size(); i++) {
+            _timerWheel.cancel(_timers[i]);
+        }
+        _timers.clear();
+    }
+
+    /* The current phase has finished, or the first one has not started */
+    bool phase_due() const
+    {
+        return _phase < (long) _phasesDue.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Finish the current phase and start the next one, waiting during the
+     * pauses. Returns false after the last phase.
+     */
+    bool next_phase(unsigned long long loop)
+    {
+        while (phase_due()) {
+            unsigned long long now = PerftestClock::getInstance().getTime();
+            finish(loop);
+            _phase++;
+            _phaseStartTime = now;
+            _phaseFirstLoop = loop;
+            send_phase_mark();
+            if (_phase >= (long) _phases.size()) {
+                return false;
+            }
+
+            const PerftestScenarioPhase &phase = _phases[_phase];
+            fprintf(stderr,
+                    "Phase %ld of %u (%s) ...\n",
+                    _phase + 1,
+                    (unsigned int) _phases.size(),
+                    phase.name.c_str());
+            fflush(stderr);
+
+            if (phase.pause) {
+                while (!phase_due() && !perftest_cpp::_testCompleted) {
+                    PerftestClock::milliSleep(1);
                 }
+                if (perftest_cpp::_testCompleted) {
+                    return false;
+                }
+                continue;
             }
-        } else {
-            fprintf(stderr,
-                    "Clock skew suspected: received time %llu usec,"
-                    " sent time %llu usec\n",
-                    now,
-                    sentTime);
-            ++clock_skew_count;
+
+            if (_useInstanceSets
+                    && !_writer->set_instance_set(
+                            phase.instanceCount > 0 ? phase.firstInstance : 0,
+                            phase.instanceCount > 0
+                                    ? phase.instanceCount
+                                    : _numInstances)) {
+                fprintf(stderr,
+                        "Problem setting the instances of phase %s.\n",
+                        phase.name.c_str());
+                return false;
+            }
+            _burstSamples = phase.burstSamples;
+            _burstLeft = _burstSamples;
+            _burstNextTime = now + phase.burstPeriodUsec;
         }
+        return true;
+    }
 
-        if (_writer != NULL) {
-            _writer->notify_ping_response();
+    /*
+     * With burst=, called before every sample: once the samples of the burst
+     * are sent, sleep until the next burst or the end of the phase.
+     */
+    void wait_for_burst()
+    {
+        if (_burstSamples == 0) {
+            return;
+        }
+        if (_burstLeft == 0) {
+            unsigned long long now = PerftestClock::getInstance().getTime();
+            while (now < _burstNextTime && !phase_due()) {
+                DDS_Duration_t sleepPeriod = {0, 0};
+                sleepPeriod.nanosec = (unsigned long) (1000 * (std::min)(
+                        _burstNextTime - now,
+                        SCENARIO_SLEEP_SLICE_USEC));
+                PerftestClock::sleep(sleepPeriod);
+                now = PerftestClock::getInstance().getTime();
+            }
+            // The bursts keep their period, unless the Publisher falls behind
+            _burstNextTime += _phases[_phase].burstPeriodUsec;
+            if (_burstNextTime < now) {
+                _burstNextTime = now + _phases[_phase].burstPeriodUsec;
+            }
+            _burstLeft = _burstSamples;
         }
+        _burstLeft--;
     }
-};
 
-void perftest_cpp::calculate_publication_rate()
-{
-    unsigned long long pubRate =
-            (_PM.get_pair<unsigned long long, std::string>("pubRatebps").first
-                / (8 * _PM.get<unsigned long long>("dataLen")));
-    if (pubRate < 1) {
-        pubRate = 1;
+    /* Values of the current phase */
+    const PerftestScenarioPhase &get_phase() const
+    {
+        return _phases[_phase];
+    }
+    int get_sample_size() const
+    {
+        return _sampleSizes[_phase];
+    }
+    unsigned long long get_latency_count() const
+    {
+        return _latencyCounts[_phase];
     }
-    fprintf(stderr, "Calculated Publication Rate is: %lld samples/s\n", pubRate);
 
-    _PM.set("pubRate", std::pair<unsigned long long, std::string>(
-        pubRate,
-        _PM.get_pair<unsigned long long, std::string>("pubRatebps").second
-    ));
+    /* Record the statistics of the current phase, if it was not done */
+    void finish(unsigned long long loop)
+    {
+        if (_phase < 0 || _phase >= (long) _phases.size()
+                || _results.size() > (size_t) _phase) {
+            return;
+        }
+        unsigned long long now = PerftestClock::getInstance().getTime();
+        _results.push_back(finish_ramp_rate_step(
+                _latencyListener,
+                _phases[_phase].pubRate,
+                loop - _phaseFirstLoop,
+                now - _phaseStartTime,
+                _numSubscribers,
+                _lostSamplesBase));
+        _elapsedUsec.push_back(now - _phaseStartTime);
+    }
 
-}
+    void print_report()
+    {
+        printf("\nScenario (latency in μs):\n");
+        if (_results.size() < _phases.size()) {
+            printf("Only %u of %u phases completed, increase -numIter or "
+                    "-executionTime\n",
+                    (unsigned int) _results.size(),
+                    (unsigned int) _phases.size());
+        }
+        printf("           Phase, Time (s),           Target, Length (B),"
+                " Sent (Samples/s),      Mbps, Lost Samples, Lost (%%),"
+                "   Pongs,       Ave,       50%%,       90%%,       99%%\n");
+        for (unsigned int i = 0; i < _results.size(); i++) {
+            const PerftestScenarioPhase &phase = _phases[i];
+            std::ostringstream target;
+            if (phase.pause) {
+                target << "pause";
+            } else if (phase.pubRate > 0) {
+                target << phase.pubRate << "/s";
+            } else if (phase.burstSamples > 0) {
+                target << phase.burstSamples << "/"
+                       << phase.burstPeriodUsec / 1000 << "ms";
+            } else {
+                target << "max";
+            }
+            printf("%16s,%9.1f,%17s,%11llu,%17.0f,%10.1f,",
+                    phase.name.c_str(),
+                    _elapsedUsec[i] / 1000000.0,
+                    target.str().c_str(),
+                    phase.dataLen,
+                    _results[i].samplesPerSec,
+                    _results[i].samplesPerSec * 8.0 * phase.dataLen
+                            / 1000000.0);
+            print_step_loss(_results[i]);
+            printf("%8llu,%10.1f,%10.1f,%10.1f,%10.1f\n",
+                    _results[i].pongs,
+                    _results[i].latencyAve,
+                    _results[i].latencyP50,
+                    _results[i].latencyP90,
+                    _results[i].latencyP99);
+        }
+        fflush(stdout);
+    }
+
+  private:
+    /*
+     * Tell the Subscribers that the phase starts (or that the last one
+     * ended). It goes in order with the samples to every instance, so they
+     * split their counters at the same sample.
+     */
+    void send_phase_mark()
+    {
+        _mark.timestamp_sec = (int) _phase;
+        _writer->send(_mark, true);
+        _writer->flush();
+    }
+
+    const std::vector<PerftestScenarioPhase> &_phases;
+    PerftestTimerWheel &_timerWheel;
+    IMessagingWriter *_writer;
+    LatencyListener *_latencyListener;
+    int _numSubscribers;
+    unsigned long _numInstances;
+    bool _useInstanceSets;
+    std::vector<int> _sampleSizes;
+    std::vector<unsigned long long> _latencyCounts;
+
+    // Number of phases finished, incremented by the timer wheel
+    std::atomic<unsigned int> _phasesDue;
+    std::vector<long> _timers;
+    long _phase;
+    unsigned long long _phaseStartTime;
+    unsigned long long _phaseFirstLoop;
+    unsigned long long _lostSamplesBase;
+
+    unsigned long long _burstSamples;
+    unsigned long long _burstLeft;
+    unsigned long long _burstNextTime;
+
+    std::vector<RampRateStep> _results;
+    std::vector<unsigned long long> _elapsedUsec;
+
+    std::vector<char> _markData;
+    TestMessage _mark;
+};
+#endif // PERFTEST_RTI_PRO
 
 /*********************************************************
  * Publisher
@@ -1905,7 +5437,11 @@ int perftest_cpp::Publisher()
     IMessagingReader *announcement_reader;
     IMessagingReader *reader;
     struct PerftestThread *latencyReadThread = NULL;
+  #ifdef PERFTEST_RTI_PRO
+    long executionTimer = -1;
+  #else
     struct PerftestThread *executionTimeoutThread = NULL;
+  #endif
     unsigned long num_latency;
     unsigned long announcementSampleCount = 50;
     unsigned int samplesPerBatch = get_samples_per_batch();
@@ -1920,6 +5456,29 @@ int perftest_cpp::Publisher()
         return -1;
     }
 
+    /*
+     * With -sendThreads, one writer per thread. The first one is the writer
+     * created above; the rest share its DataWriter or create their own.
+     */
+    std::vector<IMessagingWriter *> sendThreadWriters(1, writer);
+  #ifdef PERFTEST_RTI_PRO
+    for (int i = 1; i < _PM.get<int>("sendThreads"); i++) {
+        IMessagingWriter *threadWriter = NULL;
+        if (_PM.get<std::string>("sendThreadsWriter") == "own") {
+            threadWriter = _MessagingImpl->create_writer(THROUGHPUT_TOPIC_NAME);
+        } else {
+            threadWriter = _MessagingImpl->create_shared_writer(writer);
+        }
+        if (threadWriter == NULL) {
+            fprintf(stderr,
+                    "Problem creating throughput writer for send thread %d.\n",
+                    i);
+            return -1;
+        }
+        sendThreadWriters.push_back(threadWriter);
+    }
+  #endif
+
     // Calculate number of latency pings that will be sent per data size
     num_latency = (unsigned long)((_PM.get<unsigned long long>("numIter") /
             samplesPerBatch) /
@@ -1935,6 +5494,33 @@ int perftest_cpp::Publisher()
         ++num_latency;
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // With -batchSizeSweep the batch size changes in every step
+    if (_PM.is_set("batchSizeSweep")) {
+        num_latency = (unsigned long) (_PM.get<unsigned long long>("numIter")
+                / _PM.get<unsigned long long>("latencyCount")
+                + _PM.get_vector<unsigned long long>("batchSizeSweep").size());
+    }
+
+    /*
+     * With -rampRate the latency counters are reset in every step, and about
+     * RAMP_RATE_PINGS_PER_SEC pings are sent per second (up to twice as many
+     * due to the rounding of the latency count).
+     */
+    if (_PM.is_set("rampRate")) {
+        num_latency = (unsigned long) (4 * RAMP_RATE_PINGS_PER_SEC
+                * _PM.get_vector<unsigned long long>("rampRate")[3]);
+    }
+
+    // Same with -scenario, where the counters are reset in every phase
+    if (_PM.is_set("scenario")) {
+        num_latency = (std::max)(
+                num_latency,
+                (unsigned long) (4 * RAMP_RATE_PINGS_PER_SEC
+                        * (_scenario.get_longest_phase_usec() / 1000000 + 1)));
+    }
+  #endif
+
     // Only publisher with ID 0 will send/receive pings
     if (_PM.get<int>("pidMultiPubTest") == 0) {
         // Check if using callbacks or read thread
@@ -2043,6 +5629,39 @@ int perftest_cpp::Publisher()
         }
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // Only publisher with ID 0 will send latency probes
+    IMessagingWriter *probe_writer = NULL;
+    IMessagingReader *probe_reader = NULL;
+    LatencyProbeListener *probe_listener = NULL;
+    struct PerftestThread *probeThread = NULL;
+    LatencyProbeThreadInfo probeInfo;
+    if (_PM.is_set("latencyProbeRate")
+            && _PM.get<int>("pidMultiPubTest") == 0) {
+        if (!_MessagingImpl->supports_listeners()) {
+            fprintf(stderr, "'-latencyProbeRate' requires listeners.\n");
+            return -1;
+        }
+        probe_writer = _MessagingImpl->create_writer(LATENCY_PROBE_TOPIC_NAME);
+        if (probe_writer == NULL) {
+            fprintf(stderr, "Problem creating latency probe writer.\n");
+            return -1;
+        }
+        probe_listener = new LatencyProbeListener((unsigned long) (
+                _PM.get<unsigned long long>("latencyProbeRate")
+                * (_PM.get<unsigned long long>("executionTime") > 0
+                        ? _PM.get<unsigned long long>("executionTime")
+                        : 60)));
+        probe_reader = _MessagingImpl->create_reader(
+                LATENCY_PROBE_ECHO_TOPIC_NAME,
+                probe_listener);
+        if (probe_reader == NULL) {
+            fprintf(stderr, "Problem creating latency probe echo reader.\n");
+            return -1;
+        }
+    }
+  #endif
+
     unsigned long long spinPerUsec = 0;
     unsigned long sleepUsec = 1000;
     DDS_Duration_t sleep_period = {0,0};
@@ -2071,16 +5690,37 @@ int perftest_cpp::Publisher()
         }
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // The phases of -scenario set the rate themselves
+    if (_PM.is_set("scenario") && _scenario.uses_spin()) {
+        spinPerUsec = NDDSUtility::get_spin_per_microsecond();
+        if (spinPerUsec == 0) {
+            fprintf(stderr,
+                    "Error initializing spin per microsecond. '-scenario' "
+                    "cannot use 'pubRate=<rate>:spin'\nExiting...\n");
+            return -1;
+        }
+    }
+  #endif
+
     fprintf(stderr,
             "Waiting to discover %d subscribers ...\n",
             _PM.get<int>("numSubscribers"));
     fflush(stderr);
-    writer->wait_for_readers(_PM.get<int>("numSubscribers"));
+    for (unsigned int i = 0; i < sendThreadWriters.size(); i++) {
+        sendThreadWriters[i]->wait_for_readers(_PM.get<int>("numSubscribers"));
+    }
     // Only publisher with ID 0 will have a reader.
     if (reader != NULL) {
         reader->wait_for_writers(_PM.get<int>("numSubscribers"));
     }
     announcement_reader->wait_for_writers(_PM.get<int>("numSubscribers"));
+  #ifdef PERFTEST_RTI_PRO
+    if (probe_writer != NULL) {
+        probe_writer->wait_for_readers(1);
+        probe_reader->wait_for_writers(1);
+    }
+  #endif
     // We have to wait until every Subscriber sends an announcement message
     // indicating that it has discovered every Publisher
     fprintf(stderr,"Waiting for subscribers announcement ...\n");
@@ -2097,6 +5737,16 @@ int perftest_cpp::Publisher()
     if (_PM.is_set("loadDataFromFile")) {
         message.data = _fileDataLoader.get_next_buffer();
     } else {
+      #ifdef PERFTEST_RTI_PRO
+        message.data = static_cast<char *>(MemoryArena::get_instance().allocate(
+                (std::max)(
+                        (int) _PM.get<unsigned long long>("dataLen"),
+                        (int) FINISHED_SIZE)));
+        if (message.data == NULL) {
+            fprintf(stderr, "Problem allocating the data of the samples.\n");
+            return -1;
+        }
+      #else
         message.data = new char[(std::max)(
                 (int) _PM.get<unsigned long long>("dataLen"),
                 (int) FINISHED_SIZE)];
@@ -2105,6 +5755,7 @@ int perftest_cpp::Publisher()
                (std::max)(
                        (int) _PM.get<unsigned long long>("dataLen"),
                        (int) FINISHED_SIZE));
+      #endif
     }
 
     if (showCpu && _PM.get<int>("pidMultiPubTest") == 0) {
@@ -2145,11 +5796,23 @@ int perftest_cpp::Publisher()
             initializeSampleCount);
     fflush(stderr);
 
+  #ifdef PERFTEST_RTI_PRO
+    // Tell the Subscribers how many threads share the sequence numbers
+    if (sendThreadWriters.size() > 1) {
+        message.seq_num = (unsigned int) sendThreadWriters.size();
+    }
+    // Ask for the samples lost in the pongs, see LatencyListener
+    if (_PM.get<int>("pidMultiPubTest") == 0) {
+        message.latency_ping = LOST_SAMPLES_REQUEST;
+    }
+  #endif
     for (unsigned long i = 0; i < initializeSampleCount; i++) {
         // Send test initialization message
         writer->send(message, true);
     }
     writer->flush();
+    message.seq_num = 0;
+    message.latency_ping = 0;
 
     fprintf(stderr, "Sending data ...\n");
     fflush(stderr);
@@ -2162,6 +5825,16 @@ int perftest_cpp::Publisher()
     // Sleep 1 second, then begin test
     PerftestClock::milliSleep(1000);
 
+  #ifdef PERFTEST_RTI_PRO
+    unsigned long long minorFaults = 0;
+    unsigned long long majorFaults = 0;
+    const bool reportPageFaults = _PM.is_set("memoryMode")
+            && MemoryArena::get_page_faults(minorFaults, majorFaults);
+    NumaTopology::NodeStats numaStats;
+    const bool reportNumaStats = _numaNode >= 0
+            && NumaTopology::get_node_stats(_numaNode, numaStats);
+  #endif
+
     int num_pings = 0;
     int pingID = -1;
     int current_index_in_batch = 0;
@@ -2186,13 +5859,20 @@ int perftest_cpp::Publisher()
     }
 
     if (_PM.get<unsigned long long>("executionTime") > 0) {
-
+      #ifdef PERFTEST_RTI_PRO
+        // An absolute deadline of the timer wheel, in ns since now
+        executionTimer = _timerWheel.schedule(
+                _PM.get<unsigned long long>("executionTime") * 1000000000ULL,
+                0,
+                ExecutionTimeoutTimer,
+                NULL);
+      #else
         struct PerftestTimer::ScheduleInfo schedInfo = {
             (unsigned int)_PM.get<unsigned long long>("executionTime"),
             Timeout
         };
 
-        // Set thread priority and CPU affinity if configured
+        // Set thread priority if configured
         int execThreadPriority = Perftest_THREAD_PRIORITY_DEFAULT;
         int execThreadOptions = Perftest_THREAD_OPTION_DEFAULT;
         if (_threadPriorities.isSet) {
@@ -2201,34 +5881,25 @@ int perftest_cpp::Publisher()
                     | Perftest_THREAD_SETTINGS_PRIORITY_ENFORCE;
         }
 
-        int execThreadCpuAffinity = -1;
-      #ifdef PERFTEST_RTI_PRO
-        if (_threadCPUAffinity.isInitialized()) {
-            // For simplicity, use the first core assigned to main thread
-            // (get_cores_main() returns a vector<int>)
-            const std::vector<int>& cores = _threadCPUAffinity.get_cores_main();
-            if (!cores.empty()) {
-                execThreadCpuAffinity = cores[0];
-            }
-        }
-      #endif // PERFTEST_RTI_PRO
-
         executionTimeoutThread = PerftestTimer::getInstance().setParameters(
             schedInfo,
             execThreadPriority,
             execThreadOptions,
-            execThreadCpuAffinity
+            -1
         );
 
         if (executionTimeoutThread == NULL) {
             fprintf(stderr, "Problem creating timeoutThread for executionTime.\n");
             return -1;
         }
+      #endif
     }
 
     /*
      * Copy variable to no query the ParameterManager in every iteration.
-     * They should not be modified:
+     * They should not be modified (except latencyCount and the pubRate
+     * settings, which are changed in every step of -rampRate and every
+     * phase of -scenario):
      * - NumIter
      * - latencyCount
      * - numSubscribers
@@ -2241,19 +5912,22 @@ int perftest_cpp::Publisher()
      * - isSetPubRate
      */
     const unsigned long long numIter = _PM.get<unsigned long long>("numIter");
-    const unsigned long long latencyCount =
+    unsigned long long latencyCount =
             _PM.get<unsigned long long>("latencyCount");
     const int numSubscribers = _PM.get<int>("numSubscribers");
     const bool bestEffort = _PM.get<bool>("bestEffort");
     const bool latencyTest = _PM.get<bool>("latencyTest");
     const int pidMultiPubTest = _PM.get<int>("pidMultiPubTest");
-    const bool pubRateMethodSpin =
+    bool pubRateMethodSpin =
             _PM.get_pair<unsigned long long, std::string>("pubRate").second == "spin";
-    const unsigned long pubRate =
+    unsigned long pubRate =
             (unsigned long)_PM.get_pair<unsigned long long, std::string>("pubRate").first;
     const bool cacheStats = _PM.get<bool>("cacheStats");
-    const bool isSetPubRate = _PM.is_set("pubRate");
+    bool isSetPubRate = _PM.is_set("pubRate");
     const bool useDatafromFile = _PM.is_set("loadDataFromFile");
+  #ifdef PERFTEST_RTI_PRO
+    const bool useDataLenDistribution = _PM.is_set("dataLenDistribution");
+  #endif
 
 
     /*
@@ -2272,11 +5946,203 @@ int perftest_cpp::Publisher()
         startTestTime = PerftestClock::getInstance().getTime();
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    // Start sending the latency probes just before the main loop
+    unsigned long long loadStartTime = PerftestClock::getInstance().getTime();
+    if (probe_writer != NULL) {
+        probeInfo.writer = probe_writer;
+        probeInfo.message = message;
+        probeInfo.message.data = new char[message.size];
+        memset(probeInfo.message.data, 0, message.size);
+        probeInfo.message.latency_ping = -1;
+        probeInfo.periodUsec = 1000000
+                / _PM.get<unsigned long long>("latencyProbeRate");
+        probeInfo.probesSent = 0;
+        probeInfo.stop.store(false);
+        probeInfo.finished.store(false);
+
+        int threadPriority = Perftest_THREAD_PRIORITY_DEFAULT;
+        int threadOptions = Perftest_THREAD_OPTION_DEFAULT;
+        if (_threadPriorities.isSet) {
+            threadPriority = _threadPriorities.main;
+            threadOptions = Perftest_THREAD_SETTINGS_REALTIME_PRIORITY
+                    | Perftest_THREAD_SETTINGS_PRIORITY_ENFORCE;
+        }
+        probeThread = PerftestThread_new(
+                "LatencyProbeThread",
+                threadPriority,
+                threadOptions,
+                LatencyProbeThread,
+                &probeInfo);
+        if (probeThread == NULL) {
+            fprintf(stderr, "Problem creating LatencyProbeThread.\n");
+            return -1;
+        }
+    }
+
+    // -statsSegment and -metricsEndpoint: updated off the sending loop
+    StatsTimerInfo *statsInfo = NULL;
+    long statsTimer = -1;
+    if (_statsSegment.is_initialized() || _metricsServer != NULL) {
+        statsInfo = new StatsTimerInfo();
+        statsInfo->segment = &_statsSegment;
+        statsInfo->metricsServer = _metricsServer;
+        statsInfo->listener = reader_listener;
+        statsInfo->reader = reader_listener != NULL ? reader : NULL;
+        statsInfo->writer = writer;
+        statsInfo->cpu.initialize();
+        statsTimer = _timerWheel.schedule(
+                PERFTEST_DISCOVERY_TIME_MSEC * 1000000ULL,
+                PERFTEST_DISCOVERY_TIME_MSEC * 1000000ULL,
+                StatsTimer,
+                statsInfo);
+    }
+
+    // -cpu: the latency intervals print the CPU sampled once per interval
+    long cpuSampleTimer = -1;
+    if (reader_listener != NULL && _PM.get<bool>("cpu")) {
+        reader_listener->set_cpu_sampled();
+        cpuSampleTimer = _timerWheel.schedule(
+                PERFTEST_DISCOVERY_TIME_MSEC * 1000000ULL,
+                PERFTEST_DISCOVERY_TIME_MSEC * 1000000ULL,
+                CpuSampleTimer,
+                reader_listener);
+    }
+  #endif
+
     /********************
      *  Main sending loop
      */
     unsigned long long loop = 0;
-    for (loop = 0; (loop < numIter) && (!_testCompleted); ++loop) {
+    unsigned long long mainThreadNumIter = numIter;
+  #ifdef PERFTEST_RTI_PRO
+    // With -sendThreads the samples are sent by the send threads instead
+    if (sendThreadWriters.size() > 1) {
+        if (!run_send_threads(
+                sendThreadWriters,
+                message,
+                samplesPerBatch,
+                spinPerUsec)) {
+            return -1;
+        }
+        mainThreadNumIter = 0;
+    }
+
+    // With -batchSizeSweep the samples are sent once per batch size
+    if (_PM.is_set("batchSizeSweep")) {
+        if (!run_batch_size_sweep(
+                writer,
+                _PM.get<int>("pidMultiPubTest") == 0 ? reader_listener : NULL,
+                message)) {
+            return -1;
+        }
+        mainThreadNumIter = 0;
+    }
+
+    // With -rampRate the rate is increased in the control loop below
+    std::vector<unsigned long long> rampRate;
+    std::vector<RampRateStep> rampSteps;
+    std::atomic<bool> rampStepDue(false);
+    long rampStepTimer = -1;
+    unsigned long long rampStepStartTime = 0;
+    unsigned long long rampStepFirstLoop = 0;
+    unsigned long long rampLostSamples = 0;
+    if (_PM.is_set("rampRate")) {
+        rampRate = _PM.get_vector<unsigned long long>("rampRate");
+        latencyCount = ramp_rate_latency_count(pubRate);
+        if (!_PM.is_set("numIter")) {
+            // The test finishes after the last step
+            mainThreadNumIter = ULLONG_MAX;
+        }
+        if (reader_listener != NULL) {
+            finish_ramp_rate_step(
+                    reader_listener, 0, 0, 0, numSubscribers, rampLostSamples);
+        }
+        fprintf(stderr, "Sending data at %lu samples/s ...\n", pubRate);
+        fflush(stderr);
+        rampStepStartTime = PerftestClock::getInstance().getTime();
+        // The steps are timed by the timer wheel, so they do not drift
+        rampStepTimer = _timerWheel.schedule(
+                rampRate[3] * 1000000000ULL,
+                rampRate[3] * 1000000000ULL,
+                RampStepTimer,
+                &rampStepDue);
+    }
+
+    // With -repetitions the windows are measured in the main loop
+    RepetitionRunner *repetitions = NULL;
+    unsigned long long repetitionCheckPeriod = 0;
+    unsigned long long repetitionNextCheck = 0;
+    if (_PM.is_set("repetitions")) {
+        repetitions = new RepetitionRunner(
+                _PM,
+                reader_listener,
+                _PM.get<unsigned long long>("dataLen"));
+        if (!_PM.is_set("numIter")) {
+            // The test finishes after the last window
+            mainThreadNumIter = ULLONG_MAX;
+        }
+        // Same frequency as the -pubRate control loop, or every 100 samples
+        repetitionCheckPeriod = isSetPubRate ? pubRate_sample_period : 100;
+        repetitionNextCheck = repetitionCheckPeriod;
+        repetitions->start(PerftestClock::getInstance().getTime());
+    }
+
+    // With -scenario the phases are applied at the beginning of the loop
+    ScenarioRunner *scenario = NULL;
+    if (_PM.is_set("scenario")) {
+        scenario = new ScenarioRunner(
+                _scenario,
+                _timerWheel,
+                writer,
+                reader_listener,
+                _PM);
+        if (!_PM.is_set("numIter")) {
+            // The test finishes after the last phase
+            mainThreadNumIter = ULLONG_MAX;
+        }
+        if (!scenario->start()) {
+            delete scenario;
+            return -1;
+        }
+    }
+  #endif
+    for (loop = 0; (loop < mainThreadNumIter) && (!_testCompleted); ++loop) {
+
+      #ifdef PERFTEST_RTI_PRO
+        // Wait for the next burst and move to the next phase of -scenario
+        if (scenario != NULL) {
+            scenario->wait_for_burst();
+            if (scenario->phase_due()) {
+                if (!scenario->next_phase(loop)) {
+                    break;
+                }
+                isSetPubRate = scenario->get_phase().pubRate > 0;
+                pubRate = (unsigned long) scenario->get_phase().pubRate;
+                pubRateMethodSpin = scenario->get_phase().pubRateSpin;
+                pubRate_sample_period = pubRate > 100 ? pubRate / 100 : 1;
+                _SpinLoopCount = isSetPubRate && pubRateMethodSpin
+                        ? 1000000 * spinPerUsec / pubRate
+                        : 0;
+                _SleepNanosec = isSetPubRate && !pubRateMethodSpin
+                        ? 1000000000 / pubRate
+                        : 0;
+                latencyCount = scenario->get_latency_count();
+                message.size = scenario->get_sample_size();
+                time_last_check = PerftestClock::getInstance().getTime();
+            }
+        }
+
+        // Finish the warm-up or the current window of -repetitions
+        if (repetitions != NULL && loop >= repetitionNextCheck) {
+            repetitionNextCheck = loop + repetitionCheckPeriod;
+            if (!repetitions->check(
+                        PerftestClock::getInstance().getTime(),
+                        loop)) {
+                break;
+            }
+        }
+      #endif
 
         /* This if has been included to perform the control loop
            that modifies the publication rate according to -pubRate */
@@ -2284,6 +6150,32 @@ int perftest_cpp::Publisher()
 
             time_now = PerftestClock::getInstance().getTime();
 
+          #ifdef PERFTEST_RTI_PRO
+            // Move to the next step of -rampRate, or finish after the last one
+            if (!rampRate.empty() && rampStepDue.exchange(false)) {
+                rampSteps.push_back(finish_ramp_rate_step(
+                        reader_listener,
+                        pubRate,
+                        loop - rampStepFirstLoop,
+                        time_now - rampStepStartTime,
+                        numSubscribers,
+                        rampLostSamples));
+                if (pubRate + rampRate[1] > rampRate[2]) {
+                    break;
+                }
+                pubRate += (unsigned long) rampRate[1];
+                latencyCount = ramp_rate_latency_count(pubRate);
+                pubRate_sample_period = pubRate > 100 ? pubRate / 100 : 1;
+                if (pubRateMethodSpin) {
+                    _SpinLoopCount = 1000000 * spinPerUsec / pubRate;
+                }
+                rampStepFirstLoop = loop;
+                rampStepStartTime = time_now;
+                fprintf(stderr, "Sending data at %lu samples/s ...\n", pubRate);
+                fflush(stderr);
+            }
+          #endif
+
             time_delta = time_now - time_last_check;
             time_last_check = time_now;
             if (time_delta > 0) {
@@ -2370,6 +6262,18 @@ int perftest_cpp::Publisher()
         if (useDatafromFile) {
             message.data = _fileDataLoader.get_next_buffer();
         }
+      #ifdef PERFTEST_RTI_PRO
+        if (useDataLenDistribution) {
+            message.size = (int) (std::max)(
+                    _dataLenDistribution.next_size(),
+                    OVERHEAD_BYTES) - OVERHEAD_BYTES;
+            // The sizes that signal the test cannot be used as data
+            if (message.size == INITIALIZE_SIZE
+                    || message.size == FINISHED_SIZE) {
+                message.size = INITIALIZE_SIZE - 1;
+            }
+        }
+      #endif
         writer->send(message);
         if(latencyTest && sentPing) {
             if (!bestEffort) {
@@ -2396,6 +6300,31 @@ int perftest_cpp::Publisher()
     // In case of batching, flush
     writer->flush();
 
+  #ifdef PERFTEST_RTI_PRO
+    unsigned long long loadElapsedUsec =
+            PerftestClock::getInstance().getTime() - loadStartTime;
+    if (probeThread != NULL) {
+        probeInfo.stop.store(true);
+        while (!probeInfo.finished.load()) {
+            PerftestClock::milliSleep(1);
+        }
+        PerftestThread_delete(probeThread);
+        probeThread = NULL;
+    }
+    if (statsInfo != NULL) {
+        _timerWheel.cancel(statsTimer);
+        delete statsInfo;
+        statsInfo = NULL;
+    }
+    _timerWheel.cancel(cpuSampleTimer);
+    _timerWheel.cancel(rampStepTimer);
+    _timerWheel.cancel(executionTimer);
+    if (scenario != NULL) {
+        scenario->stop();
+        scenario->finish(loop);
+    }
+  #endif
+
     /*
      * This is where we report the time when using the low resolution clock
      * feature, as mentioned above, this time is a rough estimation.
@@ -2407,6 +6336,15 @@ int perftest_cpp::Publisher()
                     - startTestTime)
                         / (2 * loop));
     }
+  #ifdef PERFTEST_RTI_PRO
+    if (reportPageFaults) {
+        print_page_faults(minorFaults, majorFaults);
+    }
+    if (reportNumaStats) {
+        print_numa_stats(_numaNode, numaStats);
+    }
+  #endif
+
     // Test has finished, send end of test message, send multiple
     // times in case of best effort
     if (FINISHED_SIZE > MAX_PERFTEST_SAMPLE_SIZE) {
@@ -2426,8 +6364,35 @@ int perftest_cpp::Publisher()
         i++;
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    if (!rampRate.empty()) {
+        print_ramp_rate_report(
+                rampSteps,
+                rampRate[3],
+                strtod(_PM.get<std::string>("rampMaxLoss").c_str(), NULL),
+                _PM.get<unsigned long long>("rampMaxLatency"));
+    }
+    if (repetitions != NULL) {
+        repetitions->print_report();
+        delete repetitions;
+        repetitions = NULL;
+    }
+    if (scenario != NULL) {
+        scenario->print_report();
+        delete scenario;
+        scenario = NULL;
+    }
+  #endif
+
     if (_PM.get<int>("pidMultiPubTest") == 0) {
-        reader_listener->print_summary_latency(true);
+        /*
+         * With -batchSizeSweep, -rampRate, -repetitions and -scenario the
+         * latency is reported per step
+         */
+        if (!_PM.is_set("batchSizeSweep") && !_PM.is_set("rampRate")
+                && !_PM.is_set("repetitions") && !_PM.is_set("scenario")) {
+            reader_listener->print_summary_latency(true);
+        }
         reader_listener->end_test = true;
     } else {
         fprintf(
@@ -2435,6 +6400,26 @@ int perftest_cpp::Publisher()
             "Latency results are only shown when -pidMultiPubTest = 0\n");
     }
 
+  #ifdef PERFTEST_RTI_PRO
+    if (probe_listener != NULL) {
+        // Give the last echoes some time to arrive
+        probe_writer->wait_for_ack(
+                timeout_wait_for_ack_sec,
+                timeout_wait_for_ack_nsec);
+        PerftestClock::milliSleep(100);
+        probe_listener->print_summary(
+                probeInfo.probesSent,
+                _PM.get<unsigned long long>("latencyProbeRate"),
+                loadElapsedUsec > 0
+                    ? loop * 1000000.0 / loadElapsedUsec
+                    : 0.0,
+                loadElapsedUsec > 0
+                    ? loop * 8.0 * (_PM.get<unsigned long long>("dataLen"))
+                            / loadElapsedUsec
+                    : 0.0);
+    }
+  #endif
+
     if (_PM.get<bool>("cacheStats")) {
         printf("Pulled samples: %3d, Samples Writer Queue Peak: %3d\n",
                 writer->get_pulled_sample_count(),
@@ -2463,6 +6448,23 @@ int perftest_cpp::Publisher()
         delete writer;
     }
 
+    for (unsigned int i = 1; i < sendThreadWriters.size(); i++) {
+        delete sendThreadWriters[i];
+    }
+
+  #ifdef PERFTEST_RTI_PRO
+    if (probe_reader != NULL) {
+        delete probe_reader;
+    }
+    if (probe_listener != NULL) {
+        delete probe_listener;
+    }
+    if (probe_writer != NULL) {
+        delete probe_writer;
+        delete []probeInfo.message.data;
+    }
+  #endif
+
     if (reader_listener != NULL) {
         delete reader_listener;
     }
@@ -2473,13 +6475,17 @@ int perftest_cpp::Publisher()
 
     /* The FileDataLoader class will remove this data, if in use */
     if (!useDatafromFile) {
+      #ifdef PERFTEST_RTI_PRO
+        MemoryArena::get_instance().release(message.data);
+      #else
         delete []message.data;
+      #endif
     }
     // For Json format, print last brackets
     _printer->print_final_output();
     if (_testCompleted) {
         // Delete timeout thread
-#if !defined(PERFTEST_CERT)
+#if !defined(PERFTEST_CERT) && !defined(PERFTEST_RTI_PRO)
         if (executionTimeoutThread != NULL) {
             PerftestThread_delete(executionTimeoutThread);
         }
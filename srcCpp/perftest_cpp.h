@@ -20,12 +20,26 @@
 #include "ThreadPriorities.h"
 #ifdef PERFTEST_RTI_PRO
   #include "ThreadCPUAffinity.h"
+  #include "DataLenDistribution.h"
+  #include "MemoryArena.h"
+  #include "NumaTopology.h"
+  #include "PerftestAsyncPrinter.h"
+  #include "PerftestColumnarPrinter.h"
+  #include "PerftestStatsSegment.h"
+  #include "PerftestMetricsServer.h"
+  #include "PerftestLatencyTrace.h"
+  #include "PerftestHostNoise.h"
+  #include "PerftestTimerWheel.h"
+  #include "PerftestController.h"
+  #include "PerftestScenario.h"
 #endif
 #include "ParameterManager.h"
 #include "Infrastructure_common.h"
 #include "FileDataLoader.h"
 #include "PerftestPrinter.h"
 
+class LatencyListener;
+
 struct Perftest_ProductVersion_t
 {
     char major;
@@ -46,6 +60,11 @@ class perftest_cpp
     const ThreadPriorities get_thread_priorities();
   #ifdef PERFTEST_RTI_PRO
     const ThreadCPUAffinity get_thread_cpu_affinity();
+    /* Run as the subscriber subscriberId of a -loopback test */
+    void set_loopback_subscriber(int subscriberId)
+    {
+        _loopbackSubscriberId = subscriberId;
+    }
   #endif
     void calculate_publication_rate();
     static const Perftest_ProductVersion_t get_perftest_version();
@@ -56,6 +75,19 @@ class perftest_cpp
     int Subscriber();
     template <class ListenerType>
     bool finalize_read_thread(PerftestThread *thread, ListenerType *listener);
+  #ifdef PERFTEST_RTI_PRO
+    bool run_send_threads(
+            const std::vector<IMessagingWriter *> &writers,
+            const TestMessage &message,
+            unsigned int samplesPerBatch,
+            unsigned long long spinPerUsec);
+    bool run_batch_size_sweep(
+            IMessagingWriter *&writer,
+            LatencyListener *latencyListener,
+            TestMessage &message);
+    int run_loopback(int argc, char *argv[]);
+    bool run_host_noise_check();
+  #endif
 
     // Private members
     ParameterManager _PM;
@@ -72,6 +104,32 @@ class perftest_cpp
   #ifdef PERFTEST_RTI_PRO
     // Thread affinity for the threads used by perftest and Connext.
     ThreadCPUAffinity _threadCPUAffinity;
+
+    // Id of the subscriber when running as a thread of a -loopback test
+    int _loopbackSubscriberId;
+
+    // Sizes of the samples sent with -dataLenDistribution
+    DataLenDistribution _dataLenDistribution;
+
+    // Phases of the test with -scenario
+    PerftestScenario _scenario;
+
+    // -numaPlacement: node of the threads and buffers (-1 if not set)
+    NumaTopology _numaTopology;
+    int _numaNode;
+    std::string _numaNodeReason;
+
+    // Live counters for perftest_top (-statsSegment)
+    PerftestStatsSegment _statsSegment;
+
+    // OpenMetrics endpoint (-metricsEndpoint), NULL if not used
+    PerftestMetricsServer *_metricsServer;
+
+    // Results of -hostNoiseCheck, NULL if not used
+    PerftestHostNoise *_hostNoise;
+
+    // Service thread of the timeouts, intervals and samples of the test
+    PerftestTimerWheel _timerWheel;
   #endif
 
     static void Timeout();
@@ -93,6 +151,28 @@ class perftest_cpp
     static const int INITIALIZE_SIZE = 1234;
     // Flag used to indicate end of test
     static const int FINISHED_SIZE = 1235;
+    /*
+     * Samples lost by the Subscribers in the pongs (-rampRate, -repetitions,
+     * -scenario and -batchSizeSweep).
+     *
+     * The Publisher with -pidMultiPubTest 0 sends its initialization messages
+     * with latency_ping = LOST_SAMPLES_REQUEST. A Subscriber that sees every
+     * sequence number (no -cft, -cftKeys or -readThreads) answers them with
+     * an initialization message with latency_ping = LOST_SAMPLES_REPLY, and
+     * from then on puts the number of samples it has lost in the seq_num of
+     * its pongs. Any other Subscriber (other languages, older versions)
+     * echoes the request like any initialization message and keeps the
+     * sequence number of the ping in its pongs, so the Publisher reports the
+     * loss as N/A.
+     */
+    static const int LOST_SAMPLES_REQUEST = -2;
+    static const int LOST_SAMPLES_REPLY = -3;
+    /*
+     * latency_ping of the initialization messages sent by a Publisher at the
+     * beginning of every phase of -scenario (and after the last one), with
+     * the index of the phase in timestamp_sec. Nobody replies to them.
+     */
+    static const int SCENARIO_PHASE_MARK = -4;
 
     /*
      * Value used to compare against to check if the latency_min has
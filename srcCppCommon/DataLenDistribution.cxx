@@ -0,0 +1,340 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "DataLenDistribution.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+/* Seed of the sizes, so the publisher and subscriber get the same table */
+#define DATA_LEN_DISTRIBUTION_SEED 5489
+
+/* Size of the smallest bucket of DataLenBucketStats, in bytes */
+#define DATA_LEN_BUCKET_MIN_SIZE 64
+
+/* Parse the numbers separated by ':' of a distribution */
+static bool parse_numbers(
+        const std::string &values,
+        std::vector<double> &numbers)
+{
+    std::stringstream stream(values);
+    std::string value;
+    while (std::getline(stream, value, ':')) {
+        char *end = NULL;
+        double number = strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+            return false;
+        }
+        numbers.push_back(number);
+    }
+    return true;
+}
+
+bool DataLenDistribution::load_histogram(
+        const std::string &path,
+        std::vector<unsigned int> &sizes,
+        std::vector<double> &weights)
+{
+    std::ifstream file(path.c_str());
+    if (!file.is_open()) {
+        fprintf(stderr,
+                "[Error] DataLenDistribution: Could not open \"%s\".\n",
+                path.c_str());
+        return false;
+    }
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::stringstream stream(line);
+        double size = 0;
+        double weight = 0;
+        if (!(stream >> size >> weight) || size < 0 || weight < 0) {
+            fprintf(stderr,
+                    "[Error] DataLenDistribution: Wrong line %u in \"%s\", "
+                    "expected '<size> <weight>'.\n",
+                    lineNumber,
+                    path.c_str());
+            return false;
+        }
+        sizes.push_back((unsigned int) size);
+        weights.push_back(weight);
+    }
+
+    if (sizes.empty()) {
+        fprintf(stderr,
+                "[Error] DataLenDistribution: No sizes in \"%s\".\n",
+                path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool DataLenDistribution::initialize(
+        const std::string &description,
+        unsigned long long minSize,
+        unsigned long long maxSize)
+{
+    std::string::size_type colon = description.find(':');
+    std::string kind = description.substr(0, colon);
+    std::string values =
+            colon == std::string::npos ? "" : description.substr(colon + 1);
+    std::vector<double> numbers;
+
+    std::mt19937 generator(DATA_LEN_DISTRIBUTION_SEED);
+    _sizes.resize(DATA_LEN_DISTRIBUTION_TABLE_SIZE);
+
+    if (kind == "uniform") {
+        if (!parse_numbers(values, numbers)
+                || numbers.size() != 2
+                || numbers[0] < minSize
+                || numbers[1] > maxSize
+                || numbers[0] > numbers[1]) {
+            fprintf(stderr,
+                    "[Error] DataLenDistribution: Wrong value '%s', expected "
+                    "'uniform:<min>:<max>' with sizes from %llu to %llu.\n",
+                    description.c_str(),
+                    minSize,
+                    maxSize);
+            return false;
+        }
+        std::uniform_int_distribution<unsigned int> distribution(
+                (unsigned int) numbers[0],
+                (unsigned int) numbers[1]);
+        for (unsigned int i = 0; i < _sizes.size(); i++) {
+            _sizes[i] = distribution(generator);
+        }
+
+    } else if (kind == "lognormal") {
+        if (!parse_numbers(values, numbers)
+                || numbers.size() < 2
+                || numbers.size() > 3
+                || numbers[0] < minSize
+                || numbers[0] > maxSize
+                || numbers[1] <= 0
+                || (numbers.size() == 3
+                    && (numbers[2] < numbers[0] || numbers[2] > maxSize))) {
+            fprintf(stderr,
+                    "[Error] DataLenDistribution: Wrong value '%s', expected "
+                    "'lognormal:<median>:<sigma>[:<max>]' with sizes from "
+                    "%llu to %llu and sigma bigger than 0.\n",
+                    description.c_str(),
+                    minSize,
+                    maxSize);
+            return false;
+        }
+        double upperLimit = numbers.size() == 3 ? numbers[2] : (double) maxSize;
+        std::lognormal_distribution<double> distribution(
+                log(numbers[0]),
+                numbers[1]);
+        for (unsigned int i = 0; i < _sizes.size(); i++) {
+            double size = distribution(generator);
+            size = (std::max)((double) minSize, (std::min)(upperLimit, size));
+            _sizes[i] = (unsigned int) size;
+        }
+
+    } else if (kind == "file") {
+        std::vector<unsigned int> sizes;
+        std::vector<double> weights;
+        if (!load_histogram(values, sizes, weights)) {
+            return false;
+        }
+        for (unsigned int i = 0; i < sizes.size(); i++) {
+            if (sizes[i] < minSize || sizes[i] > maxSize) {
+                fprintf(stderr,
+                        "[Error] DataLenDistribution: Size %u in \"%s\" is "
+                        "not between %llu and %llu.\n",
+                        sizes[i],
+                        values.c_str(),
+                        minSize,
+                        maxSize);
+                return false;
+            }
+        }
+        std::discrete_distribution<unsigned int> distribution(
+                weights.begin(),
+                weights.end());
+        for (unsigned int i = 0; i < _sizes.size(); i++) {
+            _sizes[i] = sizes[distribution(generator)];
+        }
+
+    } else {
+        fprintf(stderr,
+                "[Error] DataLenDistribution: Unknown distribution '%s'. "
+                "Use 'uniform:<min>:<max>', "
+                "'lognormal:<median>:<sigma>[:<max>]' or 'file:<path>'.\n",
+                description.c_str());
+        return false;
+    }
+
+    _max = *std::max_element(_sizes.begin(), _sizes.end());
+    _index = 0;
+    return true;
+}
+
+DataLenBucketStats::Bucket &DataLenBucketStats::get_bucket(unsigned int size)
+{
+    size_t index = 0;
+    for (unsigned long long limit = DATA_LEN_BUCKET_MIN_SIZE;
+            size > limit;
+            limit *= 2) {
+        index++;
+    }
+    if (index >= _buckets.size()) {
+        index = _buckets.size() - 1;
+    }
+    return _buckets[index];
+}
+
+void DataLenBucketStats::Bucket::reset_latency()
+{
+    pongs = 0;
+    latencySum = 0;
+    latencyMin = 0;
+    latencyMax = 0;
+    memset(latencySlots, 0, sizeof(latencySlots));
+}
+
+unsigned int DataLenBucketStats::get_latency_slot(unsigned long latency)
+{
+    if (latency < DATA_LEN_LATENCY_SUB_SLOTS) {
+        return (unsigned int) latency;
+    }
+    // Position of the highest bit, at least 4
+    unsigned int power = 0;
+    for (unsigned long long value = latency; value > 1; value >>= 1) {
+        power++;
+    }
+    unsigned int sub = (unsigned int) (latency >> (power - 4))
+            & (DATA_LEN_LATENCY_SUB_SLOTS - 1);
+    unsigned int slot = (power - 3) * DATA_LEN_LATENCY_SUB_SLOTS + sub;
+    return slot < DATA_LEN_LATENCY_SLOTS ? slot : DATA_LEN_LATENCY_SLOTS - 1;
+}
+
+unsigned long long DataLenBucketStats::get_slot_latency(unsigned int slot)
+{
+    if (slot < DATA_LEN_LATENCY_SUB_SLOTS) {
+        return slot;
+    }
+    unsigned int power = slot / DATA_LEN_LATENCY_SUB_SLOTS + 3;
+    unsigned long long sub = slot % DATA_LEN_LATENCY_SUB_SLOTS;
+    return ((DATA_LEN_LATENCY_SUB_SLOTS + sub + 1) << (power - 4)) - 1;
+}
+
+unsigned long DataLenBucketStats::get_percentile(
+        const Bucket &bucket,
+        unsigned int percent)
+{
+    // Same element as the sorted history: the one at pongs * percent / 100
+    unsigned long long rank = bucket.pongs * percent / 100;
+    unsigned long long counted = 0;
+    for (unsigned int slot = 0; slot < DATA_LEN_LATENCY_SLOTS; slot++) {
+        counted += bucket.latencySlots[slot];
+        if (counted > rank) {
+            unsigned long long latency = get_slot_latency(slot);
+            return latency < bucket.latencyMax
+                    ? (unsigned long) latency
+                    : bucket.latencyMax;
+        }
+    }
+    return bucket.latencyMax;
+}
+
+void DataLenBucketStats::add_sample(unsigned int size)
+{
+    Bucket &bucket = get_bucket(size);
+    bucket.samples++;
+    bucket.bytes += size;
+}
+
+void DataLenBucketStats::add_latency(unsigned int size, unsigned long latency)
+{
+    Bucket &bucket = get_bucket(size);
+    if (bucket.pongs == 0 || latency < bucket.latencyMin) {
+        bucket.latencyMin = latency;
+    }
+    if (latency > bucket.latencyMax) {
+        bucket.latencyMax = latency;
+    }
+    bucket.pongs++;
+    bucket.latencySum += latency;
+    bucket.latencySlots[get_latency_slot(latency)]++;
+}
+
+void DataLenBucketStats::print_throughput(unsigned long long intervalUsec)
+{
+    unsigned long long totalSamples = 0;
+    for (size_t i = 0; i < _buckets.size(); i++) {
+        totalSamples += _buckets[i].samples;
+    }
+    if (totalSamples == 0 || intervalUsec == 0) {
+        return;
+    }
+
+    printf("\nThroughput by Sample Size:\n");
+    printf("Sample Size (Bytes), Total Samples, Samples (%%), Avg Samples/s,"
+           "    Avg Mbps\n");
+    unsigned long long limit = DATA_LEN_BUCKET_MIN_SIZE;
+    for (size_t i = 0; i < _buckets.size(); i++, limit *= 2) {
+        Bucket &bucket = _buckets[i];
+        if (bucket.samples == 0) {
+            continue;
+        }
+        char sizes[32];
+        snprintf(sizes, sizeof(sizes), "<= %llu", limit);
+        printf("%19s,%14llu,%12.2f,%14.0f,%12.1f\n",
+               sizes,
+               bucket.samples,
+               bucket.samples * 100.0 / totalSamples,
+               bucket.samples * 1000000.0 / intervalUsec,
+               bucket.bytes * 8.0 / intervalUsec);
+        bucket.samples = 0;
+        bucket.bytes = 0;
+    }
+    fflush(stdout);
+}
+
+void DataLenBucketStats::print_latency(const char *units)
+{
+    bool header = false;
+    unsigned long long limit = DATA_LEN_BUCKET_MIN_SIZE;
+    for (size_t i = 0; i < _buckets.size(); i++, limit *= 2) {
+        Bucket &bucket = _buckets[i];
+        if (bucket.pongs == 0) {
+            continue;
+        }
+        if (!header) {
+            printf("\nLatency by Sample Size:\n");
+            printf("Sample Size (Bytes),  Pongs, Ave (%s), Min (%s), "
+                   "Max (%s), 50%% (%s), 90%% (%s), 99%% (%s)\n",
+                   units, units, units, units, units, units);
+            header = true;
+        }
+
+        char sizes[32];
+        snprintf(sizes, sizeof(sizes), "<= %llu", limit);
+        printf("%19s,%7llu,%9.1f,%9lu,%9lu,%9lu,%9lu,%9lu\n",
+               sizes,
+               bucket.pongs,
+               (double) bucket.latencySum / bucket.pongs,
+               bucket.latencyMin,
+               bucket.latencyMax,
+               get_percentile(bucket, 50),
+               get_percentile(bucket, 90),
+               get_percentile(bucket, 99));
+        bucket.reset_latency();
+    }
+    fflush(stdout);
+}
@@ -0,0 +1,121 @@
+#ifndef __DATA_LEN_DISTRIBUTION_H__
+#define __DATA_LEN_DISTRIBUTION_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <string>
+#include <vector>
+
+/* Number of sizes precomputed by DataLenDistribution, a power of 2 */
+#define DATA_LEN_DISTRIBUTION_TABLE_SIZE 65536
+
+/* Size buckets of DataLenBucketStats: up to 64 bytes... up to 2 GB */
+#define DATA_LEN_BUCKET_COUNT 26
+
+/*
+ * Latency histogram of every size bucket: the latencies up to 15 have their
+ * own slot, and every power of 2 above is split in 16 slots (6% error).
+ */
+#define DATA_LEN_LATENCY_SUB_SLOTS 16
+#define DATA_LEN_LATENCY_SLOTS (DATA_LEN_LATENCY_SUB_SLOTS * 33)
+
+/*
+ * Sizes of the samples sent in a single test (-dataLenDistribution):
+ *  - uniform:<min>:<max>: Any size from <min> to <max> bytes.
+ *  - lognormal:<median>:<sigma>[:<max>]: Log-normal distribution with the
+ *    given median (bytes) and sigma (of the logarithm of the size).
+ *  - file:<path>: Empirical histogram, every line of the file has a size
+ *    (bytes) and its weight.
+ *
+ * The sizes are drawn when the distribution is initialized and stored in a
+ * table, so getting the size of the next sample is just reading the table.
+ * The same table is obtained in every run.
+ */
+class DataLenDistribution {
+  public:
+    DataLenDistribution() : _index(0), _max(0) {}
+
+    /*
+     * Parse the value of -dataLenDistribution and precompute the sizes,
+     * which must be between minSize and maxSize. Returns false on error.
+     */
+    bool initialize(
+            const std::string &description,
+            unsigned long long minSize,
+            unsigned long long maxSize);
+
+    /* Size of the next sample */
+    unsigned int next_size()
+    {
+        return _sizes[_index++ & (DATA_LEN_DISTRIBUTION_TABLE_SIZE - 1)];
+    }
+
+    /* Biggest size in the table */
+    unsigned int get_max() const
+    {
+        return _max;
+    }
+
+  private:
+    bool load_histogram(
+            const std::string &path,
+            std::vector<unsigned int> &sizes,
+            std::vector<double> &weights);
+
+    std::vector<unsigned int> _sizes;
+    unsigned long _index;
+    unsigned int _max;
+};
+
+/*
+ * Throughput and latency of the samples received in a test with
+ * -dataLenDistribution, grouped by size: up to 64 bytes, up to 128 bytes...
+ * Everything is allocated on creation, so adding a sample or a latency does
+ * not allocate. The latency percentiles come from a histogram.
+ */
+class DataLenBucketStats {
+  public:
+    DataLenBucketStats() : _buckets(DATA_LEN_BUCKET_COUNT) {}
+
+    void add_sample(unsigned int size);
+    void add_latency(unsigned int size, unsigned long latency);
+
+    /* Print and reset the samples received in intervalUsec */
+    void print_throughput(unsigned long long intervalUsec);
+    /* Print and reset the latencies (in the units of the clock) */
+    void print_latency(const char *units);
+
+  private:
+    struct Bucket {
+        unsigned long long samples;
+        unsigned long long bytes;
+        unsigned long long pongs;
+        unsigned long long latencySum;
+        unsigned long latencyMin;
+        unsigned long latencyMax;
+        unsigned long long latencySlots[DATA_LEN_LATENCY_SLOTS];
+
+        Bucket() : samples(0), bytes(0)
+        {
+            reset_latency();
+        }
+        void reset_latency();
+    };
+
+    Bucket &get_bucket(unsigned int size);
+
+    static unsigned int get_latency_slot(unsigned long latency);
+    /* Highest latency counted in the slot */
+    static unsigned long long get_slot_latency(unsigned int slot);
+    /* Latency of the given percentile of the pongs of the bucket */
+    static unsigned long get_percentile(
+            const Bucket &bucket,
+            unsigned int percent);
+
+    std::vector<Bucket> _buckets;
+};
+
+#endif // __DATA_LEN_DISTRIBUTION_H__
@@ -128,7 +128,15 @@ bool FileDataLoader::load_file_into_buffers()
     /* Now we need to iterate through the vector filling each of the buffers */
     for (unsigned int i = 0; i < _dataBuffers.size(); i++) {
 
+      #ifdef PERFTEST_RTI_PRO
+        _dataBuffers[i] = static_cast<char *>(
+                MemoryArena::get_instance().allocate(_bufferSize));
+        if (_dataBuffers[i] == NULL) {
+            return false;
+        }
+      #else
         _dataBuffers[i] = new char[_bufferSize];
+      #endif
         long currentBytesRead = PerftestFileHandler::read_file(
                     _filePath,        // filename
                     _dataBuffers[i],  // where to store it
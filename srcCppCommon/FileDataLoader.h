@@ -5,6 +5,9 @@
 #include <algorithm>
 #include "ParameterManager.h"
 #include "Infrastructure_common.h"
+#ifdef PERFTEST_RTI_PRO
+  #include "MemoryArena.h"
+#endif
 
 class FileDataLoader {
 
@@ -57,7 +60,11 @@ class FileDataLoader {
     ~FileDataLoader()
     {
         for (unsigned int i = 0; i < _numberOfBuffers; i++) {
+          #ifdef PERFTEST_RTI_PRO
+            MemoryArena::get_instance().release(_dataBuffers[i]);
+          #else
             delete []_dataBuffers[i];
+          #endif
         }
     };
 
@@ -0,0 +1,243 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "KeyDistribution.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+/* Share of the samples sent to the hot set if not given */
+#define KEY_DISTRIBUTION_DEFAULT_HOT_TRAFFIC 80.0
+
+KeyDistribution::KeyDistribution()
+        : _kind(KEY_DISTRIBUTION_UNIFORM),
+          _instances(1),
+          _state(0)
+{
+    /* Every writer gets its own sequence, but the same in every run */
+    static unsigned long long writerCount = 0;
+    _state = 0x9E3779B97F4A7C15ULL * (++writerCount);
+}
+
+/* Parse a number that takes the whole string */
+static bool parse_number(const std::string &value, double &number)
+{
+    char *end = NULL;
+    number = strtod(value.c_str(), &end);
+    return !value.empty() && end != NULL && *end == '\0';
+}
+
+bool KeyDistribution::parse(
+        const std::string &description,
+        KeyDistributionKind &kind,
+        double &parameter,
+        double &hotTraffic)
+{
+    parameter = 0;
+    hotTraffic = KEY_DISTRIBUTION_DEFAULT_HOT_TRAFFIC;
+
+    if (description == "uniform") {
+        kind = KEY_DISTRIBUTION_UNIFORM;
+        return true;
+    }
+
+    if (description.compare(0, 5, "zipf:") == 0) {
+        kind = KEY_DISTRIBUTION_ZIPF;
+        if (!parse_number(description.substr(5), parameter)
+                || parameter <= 0) {
+            fprintf(stderr,
+                    "[Error] KeyDistribution: The exponent of '%s' must be "
+                    "bigger than 0.\n",
+                    description.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    if (description.compare(0, 7, "hotset:") == 0) {
+        kind = KEY_DISTRIBUTION_HOTSET;
+        std::string values = description.substr(7);
+        std::string::size_type colon = values.find(':');
+        if (!parse_number(values.substr(0, colon), parameter)
+                || parameter <= 0
+                || parameter >= 100
+                || (colon != std::string::npos
+                    && (!parse_number(values.substr(colon + 1), hotTraffic)
+                        || hotTraffic <= 0
+                        || hotTraffic > 100))) {
+            fprintf(stderr,
+                    "[Error] KeyDistribution: Wrong value '%s', the hot set "
+                    "must be between 0 and 100 (%%) not included, and the "
+                    "traffic between 0 (not included) and 100 (%%).\n",
+                    description.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    fprintf(stderr,
+            "[Error] KeyDistribution: Unknown distribution '%s'. Use "
+            "'uniform', 'zipf:<s>' or 'hotset:<pct>[:<traffic>]'.\n",
+            description.c_str());
+    return false;
+}
+
+bool KeyDistribution::initialize(
+        const std::string &description,
+        unsigned long instances)
+{
+    double parameter = 0;
+    double hotTraffic = 0;
+    if (!parse(description, _kind, parameter, hotTraffic)) {
+        return false;
+    }
+
+    _instances = instances;
+    if (_kind == KEY_DISTRIBUTION_UNIFORM) {
+        return true;
+    }
+
+    std::vector<double> weights(instances);
+    if (_kind == KEY_DISTRIBUTION_ZIPF) {
+        for (unsigned long i = 0; i < instances; i++) {
+            weights[i] = 1.0 / pow((double) (i + 1), parameter);
+        }
+    } else {
+        unsigned long hotInstances =
+                (unsigned long) (instances * parameter / 100.0 + 0.5);
+        if (hotInstances == 0) {
+            hotInstances = 1;
+        }
+        for (unsigned long i = 0; i < instances; i++) {
+            weights[i] = i < hotInstances
+                    ? hotTraffic / hotInstances
+                    : (100.0 - hotTraffic) / (instances - hotInstances);
+        }
+    }
+
+    build_alias_table(weights);
+    return true;
+}
+
+/*
+ * Vose's alias method: every column keeps its own key with some probability
+ * and gives the rest to an alias, so all the columns have the same weight.
+ */
+void KeyDistribution::build_alias_table(const std::vector<double> &weights)
+{
+    unsigned long instances = (unsigned long) weights.size();
+    double total = 0;
+    for (unsigned long i = 0; i < instances; i++) {
+        total += weights[i];
+    }
+
+    std::vector<double> scaled(instances);
+    std::vector<unsigned int> small;
+    std::vector<unsigned int> large;
+    for (unsigned long i = 0; i < instances; i++) {
+        scaled[i] = weights[i] * instances / total;
+        if (scaled[i] < 1.0) {
+            small.push_back((unsigned int) i);
+        } else {
+            large.push_back((unsigned int) i);
+        }
+    }
+
+    _threshold.assign(instances, 0xFFFFFFFFU);
+    _alias.resize(instances);
+    for (unsigned long i = 0; i < instances; i++) {
+        _alias[i] = (unsigned int) i;
+    }
+
+    while (!small.empty() && !large.empty()) {
+        unsigned int lessLikely = small.back();
+        small.pop_back();
+        unsigned int moreLikely = large.back();
+
+        _threshold[lessLikely] =
+                (unsigned int) (scaled[lessLikely] * 4294967296.0);
+        _alias[lessLikely] = moreLikely;
+
+        scaled[moreLikely] -= 1.0 - scaled[lessLikely];
+        if (scaled[moreLikely] < 1.0) {
+            large.pop_back();
+            small.push_back(moreLikely);
+        }
+    }
+    /* The columns left are full, up to rounding errors */
+}
+
+unsigned long long InstanceCostStats::now_ns()
+{
+    return (unsigned long long)
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+}
+
+InstanceCostStats::Bucket &InstanceCostStats::get_bucket(
+        unsigned long registered)
+{
+    size_t index = 0;
+    for (unsigned long long limit = 10; registered > limit; limit *= 10) {
+        index++;
+    }
+    if (index >= _buckets.size()) {
+        Bucket empty = {0, 0, 0, 0};
+        _buckets.resize(index + 1, empty);
+    }
+    return _buckets[index];
+}
+
+void InstanceCostStats::add_registration(
+        unsigned long registered,
+        unsigned long long ns)
+{
+    Bucket &bucket = get_bucket(registered);
+    bucket.registrations++;
+    bucket.registrationNs += ns;
+}
+
+void InstanceCostStats::add_write(
+        unsigned long registered,
+        unsigned long long ns)
+{
+    Bucket &bucket = get_bucket(registered);
+    bucket.writes++;
+    bucket.writeNs += ns;
+}
+
+void InstanceCostStats::print(const char *topicName)
+{
+    printf("Instance cost (%s):\n", topicName);
+    printf("%22s %14s %12s %14s %14s\n",
+           "Registered instances",
+           "Writes",
+           "ns/write",
+           "Registrations",
+           "ns/register");
+
+    unsigned long long limit = 10;
+    for (size_t i = 0; i < _buckets.size(); i++, limit *= 10) {
+        const Bucket &bucket = _buckets[i];
+        if (bucket.writes == 0 && bucket.registrations == 0) {
+            continue;
+        }
+        char registered[32];
+        snprintf(registered, sizeof(registered), "<= %llu", limit);
+        printf("%22s %14llu %12.1f %14llu %14.1f\n",
+               registered,
+               bucket.writes,
+               bucket.writes == 0
+                       ? 0.0
+                       : (double) bucket.writeNs / bucket.writes,
+               bucket.registrations,
+               bucket.registrations == 0
+                       ? 0.0
+                       : (double) bucket.registrationNs
+                               / bucket.registrations);
+    }
+}
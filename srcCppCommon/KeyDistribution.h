@@ -0,0 +1,112 @@
+#ifndef __KEY_DISTRIBUTION_H__
+#define __KEY_DISTRIBUTION_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <string>
+#include <vector>
+
+enum KeyDistributionKind {
+    KEY_DISTRIBUTION_UNIFORM,
+    KEY_DISTRIBUTION_ZIPF,
+    KEY_DISTRIBUTION_HOTSET
+};
+
+/*
+ * Chooses the instance written by every sample of a keyed test
+ * (-keyDistribution):
+ *  - uniform: Round robin over the instances (default).
+ *  - zipf:<s>: Instance k is chosen with a probability proportional to
+ *    1 / (k + 1)^s.
+ *  - hotset:<pct>[:<traffic>]: <pct>% of the instances get <traffic>%
+ *    (80 by default) of the samples.
+ *
+ * The weighted distributions are sampled with an alias table, so choosing a
+ * key costs one random number and one comparison whatever the number of
+ * instances.
+ */
+class KeyDistribution {
+  public:
+    KeyDistribution();
+
+    /* Parse the value of -keyDistribution, returns false if it is wrong */
+    static bool parse(
+            const std::string &description,
+            KeyDistributionKind &kind,
+            double &parameter,
+            double &hotTraffic);
+
+    /* Build the distribution for the given number of instances */
+    bool initialize(const std::string &description, unsigned long instances);
+
+    bool is_uniform() const
+    {
+        return _kind == KEY_DISTRIBUTION_UNIFORM;
+    }
+
+    /* Next key, only for non uniform distributions */
+    unsigned long next_key()
+    {
+        unsigned long long random = next_random();
+        /* High 32 bits choose the column, low 32 bits the side */
+        unsigned long column = (unsigned long)
+                (((random >> 32) * _instances) >> 32);
+        return (unsigned int) random < _threshold[column]
+                ? column
+                : _alias[column];
+    }
+
+  private:
+    void build_alias_table(const std::vector<double> &weights);
+
+    /* xorshift64* */
+    unsigned long long next_random()
+    {
+        _state ^= _state >> 12;
+        _state ^= _state << 25;
+        _state ^= _state >> 27;
+        return _state * 2685821657736338717ULL;
+    }
+
+    KeyDistributionKind _kind;
+    unsigned long long _instances;
+    /* Probability (scaled to 2^32) of keeping the column, or its alias */
+    std::vector<unsigned int> _threshold;
+    std::vector<unsigned int> _alias;
+    unsigned long long _state;
+};
+
+/*
+ * Cost of the writes and of the registrations of the instances
+ * (-instanceCost), grouped by the number of instances registered when they
+ * happen: up to 10, up to 100, up to 1000...
+ */
+class InstanceCostStats {
+  public:
+    InstanceCostStats() {}
+
+    /* Current time in ns */
+    static unsigned long long now_ns();
+
+    void add_registration(unsigned long registered, unsigned long long ns);
+    void add_write(unsigned long registered, unsigned long long ns);
+
+    void print(const char *topicName);
+
+  private:
+    struct Bucket {
+        unsigned long long writes;
+        unsigned long long writeNs;
+        unsigned long long registrations;
+        unsigned long long registrationNs;
+    };
+
+    Bucket &get_bucket(unsigned long registered);
+
+    std::vector<Bucket> _buckets;
+};
+
+#endif // __KEY_DISTRIBUTION_H__
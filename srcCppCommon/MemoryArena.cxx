@@ -0,0 +1,217 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "MemoryArena.h"
+#include "NumaTopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#ifdef RTI_UNIX
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/resource.h>
+#endif
+
+/* Size of the chunks shared by the small buffers (one 2MB huge page) */
+#define MEMORY_ARENA_CHUNK_SIZE (2UL * 1024 * 1024)
+
+/* Alignment of every buffer, a cache line */
+#define MEMORY_ARENA_ALIGNMENT 64
+
+MemoryArena::MemoryArena()
+        : _mode(MEMORY_MODE_DEFAULT),
+          _numaNode(-1),
+          _pageSize(4096),
+          _current(NULL),
+          _available(0),
+          _hugePagesWarned(false)
+{
+  #ifdef RTI_UNIX
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize > 0) {
+        _pageSize = (size_t) pageSize;
+    }
+  #endif
+}
+
+MemoryArena::~MemoryArena()
+{
+  #ifdef RTI_UNIX
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        munmap(_chunks[i].address, _chunks[i].size);
+    }
+  #endif
+}
+
+MemoryArena &MemoryArena::get_instance()
+{
+    static MemoryArena instance;
+    return instance;
+}
+
+bool MemoryArena::initialize(const std::string &mode)
+{
+    if (mode == "default") {
+        _mode = MEMORY_MODE_DEFAULT;
+        return true;
+    } else if (mode == "prefault") {
+        _mode = MEMORY_MODE_PREFAULT;
+    } else if (mode == "locked") {
+        _mode = MEMORY_MODE_LOCKED;
+    } else if (mode == "hugepages") {
+        _mode = MEMORY_MODE_HUGEPAGES;
+    } else {
+        fprintf(stderr,
+                "[Error] MemoryArena: Unknown memory mode '%s'. Use "
+                "'default', 'prefault', 'locked' or 'hugepages'.\n",
+                mode.c_str());
+        return false;
+    }
+
+  #ifdef RTI_UNIX
+    if (_mode == MEMORY_MODE_LOCKED
+            && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        fprintf(stderr,
+                "[Error] MemoryArena: mlockall failed: %s. Check the limit of "
+                "locked memory ('ulimit -l') or run with CAP_IPC_LOCK.\n",
+                strerror(errno));
+        return false;
+    }
+    return true;
+  #else
+    fprintf(stderr,
+            "[Error] MemoryArena: '-memoryMode %s' is only available on "
+            "UNIX systems.\n",
+            mode.c_str());
+    return false;
+  #endif
+}
+
+char *MemoryArena::map_chunk(size_t &size)
+{
+  #ifdef RTI_UNIX
+    size_t alignment = _mode == MEMORY_MODE_HUGEPAGES
+            ? MEMORY_ARENA_CHUNK_SIZE
+            : _pageSize;
+    size = (size + alignment - 1) / alignment * alignment;
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  #ifdef MAP_POPULATE
+    // With a NUMA node the pages are populated after binding them
+    if (_numaNode < 0) {
+        flags |= MAP_POPULATE;
+    }
+  #endif
+
+    void *address = MAP_FAILED;
+  #ifdef MAP_HUGETLB
+    if (_mode == MEMORY_MODE_HUGEPAGES) {
+        address = mmap(
+                NULL,
+                size,
+                PROT_READ | PROT_WRITE,
+                flags | MAP_HUGETLB,
+                -1,
+                0);
+    }
+  #endif
+    if (address == MAP_FAILED) {
+        if (_mode == MEMORY_MODE_HUGEPAGES && !_hugePagesWarned) {
+            fprintf(stderr,
+                    "[Warning] MemoryArena: No huge pages reserved "
+                    "(/proc/sys/vm/nr_hugepages), using transparent huge "
+                    "pages.\n");
+            _hugePagesWarned = true;
+        }
+        address = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (address == MAP_FAILED) {
+            fprintf(stderr,
+                    "[Error] MemoryArena: Could not map %lu bytes: %s.\n",
+                    (unsigned long) size,
+                    strerror(errno));
+            return NULL;
+        }
+      #ifdef MADV_HUGEPAGE
+        if (_mode == MEMORY_MODE_HUGEPAGES) {
+            madvise(address, size, MADV_HUGEPAGE);
+        }
+      #endif
+    }
+
+    if (_numaNode >= 0) {
+        NumaTopology::bind_memory(address, size, _numaNode);
+    }
+
+    /* MAP_POPULATE may not be available, touch every page anyway */
+    char *chunk = (char *) address;
+    for (size_t offset = 0; offset < size; offset += _pageSize) {
+        chunk[offset] = 0;
+    }
+
+    Chunk mapped = {chunk, size};
+    _chunks.push_back(mapped);
+    return chunk;
+  #else
+    (void) size;
+    return NULL;
+  #endif
+}
+
+void *MemoryArena::allocate(size_t size)
+{
+    if (_mode == MEMORY_MODE_DEFAULT && _numaNode < 0) {
+        return calloc(1, size);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    size = (size + MEMORY_ARENA_ALIGNMENT - 1)
+            / MEMORY_ARENA_ALIGNMENT * MEMORY_ARENA_ALIGNMENT;
+
+    /* Big buffers get their own chunk, so no space is wasted */
+    if (size > MEMORY_ARENA_CHUNK_SIZE / 4) {
+        return map_chunk(size);
+    }
+
+    if (size > _available) {
+        size_t chunkSize = MEMORY_ARENA_CHUNK_SIZE;
+        _current = map_chunk(chunkSize);
+        if (_current == NULL) {
+            _available = 0;
+            return NULL;
+        }
+        _available = chunkSize;
+    }
+    char *buffer = _current;
+    _current += size;
+    _available -= size;
+    return buffer;
+}
+
+void MemoryArena::release(void *buffer)
+{
+    if (_mode == MEMORY_MODE_DEFAULT && _numaNode < 0) {
+        free(buffer);
+    }
+}
+
+bool MemoryArena::get_page_faults(
+        unsigned long long &minorFaults,
+        unsigned long long &majorFaults)
+{
+  #ifdef RTI_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return false;
+    }
+    minorFaults = (unsigned long long) usage.ru_minflt;
+    majorFaults = (unsigned long long) usage.ru_majflt;
+    return true;
+  #else
+    minorFaults = 0;
+    majorFaults = 0;
+    return false;
+  #endif
+}
@@ -0,0 +1,93 @@
+#ifndef __MEMORY_ARENA_H__
+#define __MEMORY_ARENA_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <mutex>
+
+enum MemoryMode {
+    MEMORY_MODE_DEFAULT,
+    MEMORY_MODE_PREFAULT,
+    MEMORY_MODE_LOCKED,
+    MEMORY_MODE_HUGEPAGES
+};
+
+/*
+ * Memory of the buffers owned by Perftest (payload of the samples, data
+ * loaded from a file and latency history), selected with -memoryMode:
+ *  - default: Regular heap memory.
+ *  - prefault: Every page is written when allocated, so the test does not
+ *    take a page fault the first time it touches a buffer.
+ *  - locked: Same as prefault, and all the memory of the process is locked
+ *    (mlockall) so it is never paged out.
+ *  - hugepages: Same as prefault, using huge pages (MAP_HUGETLB, or
+ *    transparent huge pages if none are reserved) to reduce TLB misses.
+ *
+ * Except in default mode the buffers come from chunks mapped by the arena.
+ * Small buffers share a chunk, big ones get their own. Perftest allocates its
+ * buffers once, so releasing a buffer does nothing and the chunks are
+ * unmapped when the arena is destroyed.
+ */
+class MemoryArena {
+  public:
+    ~MemoryArena();
+
+    static MemoryArena &get_instance();
+
+    /* Parse the value of -memoryMode and apply it to the process */
+    bool initialize(const std::string &mode);
+
+    MemoryMode get_mode() const
+    {
+        return _mode;
+    }
+
+    /*
+     * Bind the buffers allocated from now on to a NUMA node (-numaPlacement).
+     * They are allocated by the arena even in default mode.
+     */
+    void set_numa_node(int node)
+    {
+        _numaNode = node;
+    }
+
+    /* Zeroed buffer of the given size, NULL if it cannot be allocated */
+    void *allocate(size_t size);
+    void release(void *buffer);
+
+    /* Page faults of the process so far, false if not available */
+    static bool get_page_faults(
+            unsigned long long &minorFaults,
+            unsigned long long &majorFaults);
+
+  private:
+    MemoryArena();
+    MemoryArena(const MemoryArena &);
+    MemoryArena &operator=(const MemoryArena &);
+
+    /* Map (and touch) a chunk of at least the given size */
+    char *map_chunk(size_t &size);
+
+    struct Chunk {
+        char *address;
+        size_t size;
+    };
+
+    MemoryMode _mode;
+    int _numaNode;
+    size_t _pageSize;
+    std::vector<Chunk> _chunks;
+    /* Free space of the chunk shared by the small buffers */
+    char *_current;
+    size_t _available;
+    bool _hugePagesWarned;
+    std::mutex _mutex;
+};
+
+#endif // __MEMORY_ARENA_H__
@@ -0,0 +1,284 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "NumaTopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fstream>
+#include <sstream>
+#ifdef RTI_LINUX
+  #include <dirent.h>
+  #include <sched.h>
+  #include <unistd.h>
+  #include <ifaddrs.h>
+  #include <netdb.h>
+  #include <sys/socket.h>
+  #include <sys/syscall.h>
+#endif
+
+#define NUMA_TOPOLOGY_NODE_PATH "/sys/devices/system/node"
+
+/* From <numaif.h>, so libnuma is not needed */
+#define NUMA_TOPOLOGY_MPOL_BIND 2
+#define NUMA_TOPOLOGY_MPOL_MF_MOVE (1 << 1)
+#define NUMA_TOPOLOGY_MAX_NODES 1024
+
+/* Parse a list of cores as in the sysfs files, e.g. "0-13,28-41" */
+static bool parse_cpu_list(const std::string &list, std::vector<int> &cores)
+{
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        char *end = NULL;
+        long first = strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        if (end == range.c_str() || first < 0 || last < first) {
+            return false;
+        }
+        for (long core = first; core <= last; core++) {
+            cores.push_back((int) core);
+        }
+    }
+    return true;
+}
+
+/* First line of a file, empty if it cannot be read */
+static std::string read_line(const std::string &path)
+{
+    std::ifstream file(path.c_str());
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+bool NumaTopology::load()
+{
+  #ifdef RTI_LINUX
+    _nodes.clear();
+
+    DIR *directory = opendir(NUMA_TOPOLOGY_NODE_PATH);
+    if (directory != NULL) {
+        struct dirent *entry = NULL;
+        while ((entry = readdir(directory)) != NULL) {
+            int id = 0;
+            char extra = 0;
+            if (sscanf(entry->d_name, "node%d%c", &id, &extra) != 1) {
+                continue;
+            }
+            Node node;
+            node.id = id;
+            std::string path = std::string(NUMA_TOPOLOGY_NODE_PATH) + "/"
+                    + entry->d_name + "/cpulist";
+            if (!parse_cpu_list(read_line(path), node.cores)) {
+                fprintf(stderr,
+                        "[Error] NumaTopology: Could not parse %s.\n",
+                        path.c_str());
+                closedir(directory);
+                return false;
+            }
+            _nodes.push_back(node);
+        }
+        closedir(directory);
+    }
+
+    if (_nodes.empty()) {
+        // No NUMA support in the kernel: one node with all the cores
+        Node node;
+        node.id = 0;
+        parse_cpu_list(
+                read_line("/sys/devices/system/cpu/online"),
+                node.cores);
+        _nodes.push_back(node);
+    }
+    return true;
+  #else
+    fprintf(stderr,
+            "[Error] NumaTopology: NUMA placement is only available on "
+            "Linux.\n");
+    return false;
+  #endif
+}
+
+const std::vector<int> &NumaTopology::get_cores(int node) const
+{
+    static const std::vector<int> noCores;
+    for (size_t i = 0; i < _nodes.size(); i++) {
+        if (_nodes[i].id == node) {
+            return _nodes[i].cores;
+        }
+    }
+    return noCores;
+}
+
+int NumaTopology::get_nic_node(const std::string &nic)
+{
+  #ifdef RTI_LINUX
+    std::string interfaceName = nic;
+
+    // An IP address is translated to the name of its interface
+    struct ifaddrs *interfaces = NULL;
+    if (getifaddrs(&interfaces) == 0) {
+        for (struct ifaddrs *current = interfaces;
+                current != NULL;
+                current = current->ifa_next) {
+            if (current->ifa_addr == NULL
+                    || (current->ifa_addr->sa_family != AF_INET
+                        && current->ifa_addr->sa_family != AF_INET6)) {
+                continue;
+            }
+            char address[NI_MAXHOST];
+            socklen_t length = current->ifa_addr->sa_family == AF_INET
+                    ? sizeof(struct sockaddr_in)
+                    : sizeof(struct sockaddr_in6);
+            if (getnameinfo(
+                        current->ifa_addr,
+                        length,
+                        address,
+                        sizeof(address),
+                        NULL,
+                        0,
+                        NI_NUMERICHOST) == 0
+                    && nic == address) {
+                interfaceName = current->ifa_name;
+                break;
+            }
+        }
+        freeifaddrs(interfaces);
+    }
+
+    std::string value = read_line(
+            "/sys/class/net/" + interfaceName + "/device/numa_node");
+    if (value.empty()) {
+        return -1;
+    }
+    return atoi(value.c_str());
+  #else
+    (void) nic;
+    return -1;
+  #endif
+}
+
+int NumaTopology::get_current_node() const
+{
+  #ifdef RTI_LINUX
+    int core = sched_getcpu();
+    for (size_t i = 0; i < _nodes.size(); i++) {
+        for (size_t j = 0; j < _nodes[i].cores.size(); j++) {
+            if (_nodes[i].cores[j] == core) {
+                return _nodes[i].id;
+            }
+        }
+    }
+  #endif
+    return -1;
+}
+
+/* Cores [first, last] of the list, as "a,b,c" */
+static std::string join_cores(
+        const std::vector<int> &cores,
+        size_t first,
+        size_t last)
+{
+    std::ostringstream stream;
+    for (size_t i = first; i <= last && i < cores.size(); i++) {
+        if (i != first) {
+            stream << ",";
+        }
+        stream << cores[i];
+    }
+    return stream.str();
+}
+
+std::string NumaTopology::plan_affinity(int node) const
+{
+    const std::vector<int> &cores = get_cores(node);
+    if (cores.empty()) {
+        return "";
+    }
+
+    size_t count = cores.size();
+    if (count < 4) {
+        // Not enough cores to split, all the threads share the node
+        std::string all = join_cores(cores, 0, count - 1);
+        return all + ":" + all + ":" + all + ":" + all;
+    }
+
+    /*
+     * main: first core, receive: the cores in the middle (one per
+     * -readThreads partition), database and event: the last two.
+     */
+    return join_cores(cores, 0, 0) + ":"
+            + join_cores(cores, 1, count - 3) + ":"
+            + join_cores(cores, count - 2, count - 2) + ":"
+            + join_cores(cores, count - 1, count - 1);
+}
+
+bool NumaTopology::get_node_stats(int node, NodeStats &stats)
+{
+    std::ostringstream path;
+    path << NUMA_TOPOLOGY_NODE_PATH << "/node" << node << "/numastat";
+    std::ifstream file(path.str().c_str());
+    if (!file.is_open()) {
+        return false;
+    }
+
+    stats.local = 0;
+    stats.other = 0;
+    stats.foreign = 0;
+    std::string name;
+    unsigned long long value = 0;
+    while (file >> name >> value) {
+        if (name == "local_node") {
+            stats.local = value;
+        } else if (name == "other_node") {
+            stats.other = value;
+        } else if (name == "numa_foreign") {
+            stats.foreign = value;
+        }
+    }
+    return true;
+}
+
+bool NumaTopology::bind_memory(void *address, size_t size, int node)
+{
+  #if defined(RTI_LINUX) && defined(SYS_mbind)
+    if (node < 0 || node >= NUMA_TOPOLOGY_MAX_NODES) {
+        return false;
+    }
+    const size_t bitsPerWord = sizeof(unsigned long) * 8;
+    unsigned long mask[NUMA_TOPOLOGY_MAX_NODES / (sizeof(unsigned long) * 8)];
+    memset(mask, 0, sizeof(mask));
+    mask[node / bitsPerWord] = 1UL << (node % bitsPerWord);
+
+    if (syscall(SYS_mbind,
+                address,
+                size,
+                NUMA_TOPOLOGY_MPOL_BIND,
+                mask,
+                (unsigned long) NUMA_TOPOLOGY_MAX_NODES + 1,
+                NUMA_TOPOLOGY_MPOL_MF_MOVE) != 0) {
+        fprintf(stderr,
+                "[Warning] NumaTopology: Could not bind memory to node %d: "
+                "%s.\n",
+                node,
+                strerror(errno));
+        return false;
+    }
+    return true;
+  #else
+    (void) address;
+    (void) size;
+    (void) node;
+    return false;
+  #endif
+}
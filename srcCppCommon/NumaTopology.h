@@ -0,0 +1,73 @@
+#ifndef __NUMA_TOPOLOGY_H__
+#define __NUMA_TOPOLOGY_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/*
+ * NUMA nodes of the machine and their cores, read from
+ * /sys/devices/system/node (-numaPlacement). A machine without NUMA is seen
+ * as a single node 0 with all the online cores.
+ */
+class NumaTopology {
+  public:
+    NumaTopology() {}
+
+    /* Read the nodes and their cores, false if not available */
+    bool load();
+
+    unsigned int get_node_count() const
+    {
+        return (unsigned int) _nodes.size();
+    }
+
+    /* Cores of the given node, empty if it does not exist */
+    const std::vector<int> &get_cores(int node) const;
+
+    /*
+     * Node of the NIC given by name or IP address (as in -nic), -1 if unknown
+     * (i.e. virtual interfaces or machines without NUMA).
+     */
+    static int get_nic_node(const std::string &nic);
+
+    /* Node of the core the calling thread runs on, -1 if unknown */
+    int get_current_node() const;
+
+    /*
+     * Plan the affinity of the Perftest threads in the cores of a node, in
+     * the format of -threadCPUAffinity ("main:receive:db:event"). The main
+     * and receive threads get their own cores when the node has enough.
+     */
+    std::string plan_affinity(int node) const;
+
+    /*
+     * Pages allocated by the whole system (numastat) in the node for a
+     * process running in it (local) or in another node (other), and pages
+     * meant for the node that were allocated in another one (foreign).
+     */
+    struct NodeStats {
+        unsigned long long local;
+        unsigned long long other;
+        unsigned long long foreign;
+    };
+    static bool get_node_stats(int node, NodeStats &stats);
+
+    /* Bind the memory of a buffer to a node (mbind), before touching it */
+    static bool bind_memory(void *address, size_t size, int node);
+
+  private:
+    struct Node {
+        int id;
+        std::vector<int> cores;
+    };
+
+    std::vector<Node> _nodes;
+};
+
+#endif // __NUMA_TOPOLOGY_H__
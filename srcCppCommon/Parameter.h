@@ -147,6 +147,12 @@ class ParameterBase {
         void add_valid_str_value(const std::string validStrValue);
         virtual void set_parse_method(const ParseMethod var) {}
 
+        // Value as text, to export the configuration of a test
+        virtual std::string get_value_str()
+        {
+            return "";
+        }
+
         // Get members
         const std::string get_arg();
         const std::string get_option();
@@ -185,6 +191,13 @@ class Parameter : public ParameterBase {
             _value = value;
             set_isSet(true);
         }
+
+        std::string get_value_str()
+        {
+            std::ostringstream stream;
+            stream << _value;
+            return stream.str();
+        }
 };
 
 template <typename T>
@@ -248,6 +261,15 @@ class ParameterVector : public ParameterBase {
         {
             return _parseMethod;
         }
+
+        std::string get_value_str()
+        {
+            std::ostringstream stream;
+            for (unsigned int i = 0; i < _value.size(); i++) {
+                stream << (i == 0 ? "" : ",") << _value[i];
+            }
+            return stream.str();
+        }
 };
 
 
@@ -279,6 +301,13 @@ class ParameterPair : public ParameterBase {
             _value = std::make_pair(key, val);
             set_isSet(true);
         }
+
+        std::string get_value_str()
+        {
+            std::ostringstream stream;
+            stream << _value.first << ":" << _value.second;
+            return stream.str();
+        }
 };
 
 class AnyParameter {
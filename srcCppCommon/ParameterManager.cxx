@@ -361,12 +361,18 @@ void ParameterManager::initialize()
             " - 'csv'\n"
             " - 'json'\n"
             " - 'legacy'\n"
+          #ifdef RTI_LANGUAGE_CPP_TRADITIONAL
+            " - 'columnar': binary, needs -outputFile (Connext Pro)\n"
+          #endif
             "Default: 'csv'");
     outputFormat->set_type(T_STR);
     outputFormat->set_extra_argument(YES);
     outputFormat->add_valid_str_value("legacy");
     outputFormat->add_valid_str_value("json");
     outputFormat->add_valid_str_value("csv");
+  #ifdef RTI_LANGUAGE_CPP_TRADITIONAL
+    outputFormat->add_valid_str_value("columnar");
+  #endif
     outputFormat->set_group(GENERAL);
     outputFormat->set_supported_middleware(Middleware::ALL);
     create("outputFormat", outputFormat);
@@ -702,6 +708,27 @@ void ParameterManager::initialize()
             | Middleware::RTITSSPRO);
     create("batchSize", batchSize);
 
+  #ifdef RTI_LANGUAGE_CPP_TRADITIONAL
+    ParameterVector<unsigned long long> *batchSizeSweep =
+            new ParameterVector<unsigned long long>();
+    batchSizeSweep->set_command_line_argument(
+            "-batchSizeSweep",
+            "<bytes>:<bytes>:...");
+    batchSizeSweep->set_description(
+            "Run the test once per batch size in the list, recreating\n"
+            "the Throughput DataWriter for each one, and print the\n"
+            "throughput/latency Pareto frontier at the end.\n"
+            "The samples of -numIter are divided among the steps.\n"
+            "Default: Not set");
+    batchSizeSweep->set_type(T_VECTOR_NUMERIC);
+    batchSizeSweep->set_extra_argument(YES);
+    batchSizeSweep->set_range(0, MAX_PERFTEST_SAMPLE_SIZE - 1);
+    batchSizeSweep->set_parse_method(SPLIT);
+    batchSizeSweep->set_group(PUB);
+    batchSizeSweep->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("batchSizeSweep", batchSizeSweep);
+  #endif
+
     Parameter<bool> *enableAutoThrottle = new Parameter<bool>(false);
     enableAutoThrottle->set_command_line_argument("-enableAutoThrottle", "");
     enableAutoThrottle->set_description(
@@ -748,6 +775,25 @@ void ParameterManager::initialize()
     latencyCount->set_supported_middleware(Middleware::ALL);
     create("latencyCount", latencyCount);
 
+  #ifdef RTI_LANGUAGE_CPP_TRADITIONAL
+    Parameter<unsigned long long> *latencyProbeRate =
+            new Parameter<unsigned long long>(0);
+    latencyProbeRate->set_command_line_argument(
+            "-latencyProbeRate",
+            "<samples/s>");
+    latencyProbeRate->set_description(
+            "Send latency probes at this rate on their own topic,\n"
+            "from a dedicated thread, while the main loop sends the\n"
+            "throughput data. Must be used on both sides.\n"
+            "Default: Not set");
+    latencyProbeRate->set_type(T_NUMERIC_LLU);
+    latencyProbeRate->set_extra_argument(YES);
+    latencyProbeRate->set_range(1, 1000000);
+    latencyProbeRate->set_group(GENERAL);
+    latencyProbeRate->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("latencyProbeRate", latencyProbeRate);
+  #endif
+
     Parameter<unsigned long long> *executionTime =
             new Parameter<unsigned long long>(0);
     executionTime->set_command_line_argument("-executionTime", "<sec>");
@@ -877,6 +923,137 @@ void ParameterManager::initialize()
     pubRatebps->add_valid_str_value("sleep");
     pubRatebps->add_valid_str_value("spin");
     create("pubRatebps", pubRatebps);
+
+    Parameter<int> *sendThreads = new Parameter<int>(1);
+    sendThreads->set_command_line_argument("-sendThreads", "<count>");
+    sendThreads->set_description(
+            "Number of threads sending samples of the Throughput topic.\n"
+            "Thread i sends the sequence numbers i, i + <count>...\n"
+            "Only the first thread sends latency pings.\n"
+            "Default: 1");
+    sendThreads->set_type(T_NUMERIC_D);
+    sendThreads->set_extra_argument(YES);
+    sendThreads->set_range(1, 1024);
+    sendThreads->set_group(PUB);
+    sendThreads->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("sendThreads", sendThreads);
+
+    Parameter<std::string> *sendThreadsWriter =
+            new Parameter<std::string>("shared");
+    sendThreadsWriter->set_command_line_argument(
+            "-sendThreadsWriter",
+            "<shared|own>");
+    sendThreadsWriter->set_description(
+            "When using -sendThreads, whether all the threads write\n"
+            "using the same DataWriter ('shared') or every thread\n"
+            "creates its own DataWriter ('own').\n"
+            "Default: 'shared'");
+    sendThreadsWriter->set_type(T_STR);
+    sendThreadsWriter->set_extra_argument(YES);
+    sendThreadsWriter->add_valid_str_value("shared");
+    sendThreadsWriter->add_valid_str_value("own");
+    sendThreadsWriter->set_group(PUB);
+    sendThreadsWriter->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("sendThreadsWriter", sendThreadsWriter);
+
+    ParameterVector<unsigned long long> *rampRate =
+            new ParameterVector<unsigned long long>();
+    rampRate->set_command_line_argument(
+            "-rampRate",
+            "<start>:<step>:<max>:<secondsPerStep>");
+    rampRate->set_description(
+            "Increase the publication rate (samples/s) from <start>\n"
+            "to <max> in increments of <step>, every <secondsPerStep>.\n"
+            "The loss and latency of every step are reported, together\n"
+            "with the highest rate within -rampMaxLoss/-rampMaxLatency.\n"
+            "Default: Not set");
+    rampRate->set_type(T_VECTOR_NUMERIC);
+    rampRate->set_extra_argument(YES);
+    rampRate->set_range(1, MAX_ULLONG);
+    rampRate->set_parse_method(SPLIT);
+    rampRate->set_group(PUB);
+    rampRate->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("rampRate", rampRate);
+
+    Parameter<std::string> *rampMaxLoss = new Parameter<std::string>("0");
+    rampMaxLoss->set_command_line_argument("-rampMaxLoss", "<percent>");
+    rampMaxLoss->set_description(
+            "Maximum percentage of lost samples for a -rampRate\n"
+            "step to be considered sustainable. Default: 0");
+    rampMaxLoss->set_type(T_STR);
+    rampMaxLoss->set_extra_argument(YES);
+    rampMaxLoss->set_group(PUB);
+    rampMaxLoss->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("rampMaxLoss", rampMaxLoss);
+
+    Parameter<unsigned long long> *rampMaxLatency =
+            new Parameter<unsigned long long>(0);
+    rampMaxLatency->set_command_line_argument("-rampMaxLatency", "<usec>");
+    rampMaxLatency->set_description(
+            "Maximum 99% latency for a -rampRate step to be\n"
+            "considered sustainable. Default: Not set");
+    rampMaxLatency->set_type(T_NUMERIC_LLU);
+    rampMaxLatency->set_extra_argument(YES);
+    rampMaxLatency->set_range(1, MAX_ULLONG);
+    rampMaxLatency->set_group(PUB);
+    rampMaxLatency->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("rampMaxLatency", rampMaxLatency);
+
+    Parameter<unsigned long long> *repetitions =
+            new Parameter<unsigned long long>(0);
+    repetitions->set_command_line_argument("-repetitions", "<count>");
+    repetitions->set_description(
+            "After the warm-up, measure <count> windows of\n"
+            "-repetitionSeconds and report the mean, standard\n"
+            "deviation and 95% confidence interval of their\n"
+            "throughput and latency. Default: Not set");
+    repetitions->set_type(T_NUMERIC_LLU);
+    repetitions->set_extra_argument(YES);
+    repetitions->set_range(1, MAX_ULLONG);
+    repetitions->set_group(PUB);
+    repetitions->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("repetitions", repetitions);
+
+    Parameter<unsigned long long> *repetitionSeconds =
+            new Parameter<unsigned long long>(10);
+    repetitionSeconds->set_command_line_argument(
+            "-repetitionSeconds",
+            "<seconds>");
+    repetitionSeconds->set_description(
+            "Duration of every -repetitions window. Default: 10");
+    repetitionSeconds->set_type(T_NUMERIC_LLU);
+    repetitionSeconds->set_extra_argument(YES);
+    repetitionSeconds->set_range(1, MAX_ULLONG);
+    repetitionSeconds->set_group(PUB);
+    repetitionSeconds->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("repetitionSeconds", repetitionSeconds);
+
+    Parameter<unsigned long long> *warmupSeconds =
+            new Parameter<unsigned long long>(0);
+    warmupSeconds->set_command_line_argument("-warmupSeconds", "<seconds>");
+    warmupSeconds->set_description(
+            "Discard the first <seconds> of a -repetitions test.\n"
+            "With -steadyState, the maximum warm-up time.\n"
+            "Default: 0, or 60 with -steadyState");
+    warmupSeconds->set_type(T_NUMERIC_LLU);
+    warmupSeconds->set_extra_argument(YES);
+    warmupSeconds->set_range(0, MAX_ULLONG);
+    warmupSeconds->set_group(PUB);
+    warmupSeconds->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("warmupSeconds", warmupSeconds);
+
+    Parameter<std::string> *steadyState = new Parameter<std::string>("");
+    steadyState->set_command_line_argument("-steadyState", "<percent>");
+    steadyState->set_description(
+            "End the warm-up of a -repetitions test when the\n"
+            "coefficient of variation of the throughput and of the\n"
+            "average latency in the last 5 seconds is below\n"
+            "<percent>. Default: Not set");
+    steadyState->set_type(T_STR);
+    steadyState->set_extra_argument(YES);
+    steadyState->set_group(PUB);
+    steadyState->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("steadyState", steadyState);
 #endif
 
     Parameter<unsigned long long> *sleep = new Parameter<unsigned long long>(0);
@@ -1066,6 +1243,309 @@ void ParameterManager::initialize()
                                   | Middleware::RTITSSPRO);
     create("cft", cft);
 
+  #ifdef RTI_LANGUAGE_CPP_TRADITIONAL
+    Parameter<int> *readThreads = new Parameter<int>(1);
+    readThreads->set_command_line_argument("-readThreads", "<count>");
+    readThreads->set_description(
+            "Number of threads used to receive the Throughput topic.\n"
+            "The instances are split in <count> ranges, each one\n"
+            "received by its own reader and thread. Implies\n"
+            "-useReadThread and requires -keyed and -instances >= <count>.\n"
+            "Default: 1");
+    readThreads->set_type(T_NUMERIC_D);
+    readThreads->set_extra_argument(YES);
+    readThreads->set_range(1, 1024);
+    readThreads->set_group(SUB);
+    readThreads->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("readThreads", readThreads);
+
+    ParameterVector<unsigned long long> *cftKeys =
+            new ParameterVector<unsigned long long>();
+    cftKeys->set_command_line_argument("-cftKeys", "<key>:<key>:...");
+    cftKeys->set_description(
+            "Like -cft, but receive only the samples with one of the\n"
+            "given keys (a sparse set of instances).\n"
+            "Default: Not set");
+    cftKeys->set_type(T_VECTOR_NUMERIC);
+    cftKeys->set_extra_argument(YES);
+    cftKeys->set_range(0, MAX_CFT_VALUE - 1);
+    cftKeys->set_parse_method(SPLIT);
+    cftKeys->set_group(SUB);
+    cftKeys->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("cftKeys", cftKeys);
+
+    Parameter<bool> *cftSql = new Parameter<bool>(false);
+    cftSql->set_command_line_argument("-cftSql", "");
+    cftSql->set_description(
+            "Filter the keys of -cft and -cftKeys with an SQL expression\n"
+            "comparing the key bytes, instead of the compiled key filter.\n"
+            "Default: Not set");
+    cftSql->set_type(T_BOOL);
+    cftSql->set_extra_argument(NO);
+    cftSql->set_group(SUB);
+    cftSql->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("cftSql", cftSql);
+
+    Parameter<bool> *cftBenchmark = new Parameter<bool>(false);
+    cftBenchmark->set_command_line_argument("-cftBenchmark", "");
+    cftBenchmark->set_description(
+            "Measure the evaluations of the compiled key filter. At the\n"
+            "end of the test, the Publisher reports the writer side\n"
+            "filtering and the Subscriber the reader side filtering.\n"
+            "Default: Not set");
+    cftBenchmark->set_type(T_BOOL);
+    cftBenchmark->set_extra_argument(NO);
+    cftBenchmark->set_group(GENERAL);
+    cftBenchmark->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("cftBenchmark", cftBenchmark);
+
+    Parameter<std::string> *keyDistribution =
+            new Parameter<std::string>("uniform");
+    keyDistribution->set_command_line_argument(
+            "-keyDistribution", "<kind>");
+    keyDistribution->set_description(
+            "Set how the instances are chosen when publishing:\n"
+            " - 'uniform': Round robin over the instances\n"
+            " - 'zipf:<s>': Instance k is chosen with a probability\n"
+            "   proportional to 1/(k+1)^s\n"
+            " - 'hotset:<pct>[:<traffic>]': <pct>% of the instances\n"
+            "   get <traffic>% of the samples (80 by default)\n"
+            "Default: 'uniform'");
+    keyDistribution->set_type(T_STR);
+    keyDistribution->set_extra_argument(YES);
+    keyDistribution->set_group(PUB);
+    keyDistribution->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("keyDistribution", keyDistribution);
+
+    Parameter<bool> *lazyRegistration = new Parameter<bool>(false);
+    lazyRegistration->set_command_line_argument("-lazyRegistration", "");
+    lazyRegistration->set_description(
+            "Register the instances the first time they are written, and\n"
+            "do not preallocate them in the DataWriters and DataReaders.\n"
+            "Default: Not set");
+    lazyRegistration->set_type(T_BOOL);
+    lazyRegistration->set_extra_argument(NO);
+    lazyRegistration->set_group(GENERAL);
+    lazyRegistration->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("lazyRegistration", lazyRegistration);
+
+    Parameter<bool> *instanceCost = new Parameter<bool>(false);
+    instanceCost->set_command_line_argument("-instanceCost", "");
+    instanceCost->set_description(
+            "Measure the time spent writing and registering instances,\n"
+            "grouped by the number of instances already registered.\n"
+            "Reported by every DataWriter at the end of the test.\n"
+            "Default: Not set");
+    instanceCost->set_type(T_BOOL);
+    instanceCost->set_extra_argument(NO);
+    instanceCost->set_group(GENERAL);
+    instanceCost->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("instanceCost", instanceCost);
+
+    Parameter<std::string> *dataLenDistribution =
+            new Parameter<std::string>("");
+    dataLenDistribution->set_command_line_argument(
+            "-dataLenDistribution",
+            "<dist>");
+    dataLenDistribution->set_description(
+            "Send samples of different sizes in the same test:\n"
+            "\tuniform:<min>:<max>\n"
+            "\tlognormal:<median>:<sigma>[:<max>]\n"
+            "\tfile:<path> (one '<size> <weight>' per line)\n"
+            "Sizes in bytes. The data length is the biggest size.\n"
+            "Throughput and latency are also reported by size.\n"
+            "Must be used in the Publisher and the Subscriber.\n"
+            "Default: Not set");
+    dataLenDistribution->set_type(T_STR);
+    dataLenDistribution->set_extra_argument(YES);
+    dataLenDistribution->set_group(GENERAL);
+    dataLenDistribution->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("dataLenDistribution", dataLenDistribution);
+
+    Parameter<std::string> *clock = new Parameter<std::string>("default");
+    clock->set_command_line_argument("-clock", "<source>");
+    clock->set_description(
+            "Clock used to measure the test:\n"
+            "\tdefault: Clock of the OS\n"
+            "\ttsc: Time Stamp Counter of the CPU, calibrated\n"
+            "\t     at startup. Requires an invariant TSC\n"
+            "The cost and resolution of every clock are printed\n"
+            "at startup.\n"
+            "Default: default");
+    clock->set_type(T_STR);
+    clock->set_extra_argument(YES);
+    clock->set_group(GENERAL);
+    clock->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("clock", clock);
+
+    Parameter<std::string> *memoryMode = new Parameter<std::string>("default");
+    memoryMode->set_command_line_argument("-memoryMode", "<mode>");
+    memoryMode->set_description(
+            "Memory of the sample data, the data loaded from a file\n"
+            "and the latency history:\n"
+            "\tdefault: Regular heap memory\n"
+            "\tprefault: Pages touched when allocated\n"
+            "\tlocked: prefault, and lock all the memory (mlockall)\n"
+            "\thugepages: prefault, using huge pages\n"
+            "When set, the page faults taken during the test are\n"
+            "printed.\n"
+            "Default: default");
+    memoryMode->set_type(T_STR);
+    memoryMode->set_extra_argument(YES);
+    memoryMode->set_group(GENERAL);
+    memoryMode->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("memoryMode", memoryMode);
+
+    Parameter<std::string> *numaPlacement = new Parameter<std::string>("auto");
+    numaPlacement->set_command_line_argument("-numaPlacement", "<auto|node>");
+    numaPlacement->set_description(
+            "Place the threads and the buffers of Perftest in a\n"
+            "NUMA node. 'auto' uses the node of the -nic, or the\n"
+            "node where Perftest starts. The thread CPU affinity is\n"
+            "planned in the cores of the node, unless given with\n"
+            "-threadCPUAffinity. The pages allocated in the node\n"
+            "are reported at the end of the test. Linux only.\n"
+            "Default: Not set");
+    numaPlacement->set_type(T_STR);
+    numaPlacement->set_extra_argument(YES);
+    numaPlacement->set_group(GENERAL);
+    numaPlacement->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("numaPlacement", numaPlacement);
+
+    Parameter<bool> *asyncPrinter = new Parameter<bool>(false);
+    asyncPrinter->set_command_line_argument("-asyncPrinter", "");
+    asyncPrinter->set_description(
+            "Format and write the intervals in a background thread,\n"
+            "so printing does not delay the measured threads.\n"
+            "Intervals are dropped (and counted) if the queue is full.\n"
+            "Default: Not set");
+    asyncPrinter->set_type(T_BOOL);
+    asyncPrinter->set_extra_argument(NO);
+    asyncPrinter->set_group(GENERAL);
+    asyncPrinter->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("asyncPrinter", asyncPrinter);
+
+    Parameter<bool> *statsSegment = new Parameter<bool>(false);
+    statsSegment->set_command_line_argument("-statsSegment", "");
+    statsSegment->set_description(
+            "Publish the live counters of the test (throughput, losses,\n"
+            "latency histogram, CPU and queue peaks) every second in a\n"
+            "shared-memory segment (/dev/shm/perftest_stats_<pid>_<role><id>)\n"
+            "that the perftest_top tool displays. Only on Linux.\n"
+            "Default: Not set");
+    statsSegment->set_type(T_BOOL);
+    statsSegment->set_extra_argument(NO);
+    statsSegment->set_group(GENERAL);
+    statsSegment->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("statsSegment", statsSegment);
+
+    Parameter<std::string> *metricsEndpoint = new Parameter<std::string>("");
+    metricsEndpoint->set_command_line_argument(
+            "-metricsEndpoint",
+            "<[address:]port>");
+    metricsEndpoint->set_description(
+            "Serve the counters of the test in the OpenMetrics format\n"
+            "at http://<address>:<port>/metrics, for Prometheus.\n"
+            "The address is 127.0.0.1 if not given. UNIX only.\n"
+            "Default: Not set");
+    metricsEndpoint->set_type(T_STR);
+    metricsEndpoint->set_extra_argument(YES);
+    metricsEndpoint->set_group(GENERAL);
+    metricsEndpoint->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("metricsEndpoint", metricsEndpoint);
+
+    Parameter<bool> *latencyFileBinary = new Parameter<bool>(false);
+    latencyFileBinary->set_command_line_argument("-latencyFileBinary", "");
+    latencyFileBinary->set_description(
+            "Save the -latencyFile samples in binary, with the data\n"
+            "length of every summary, to compare runs with the\n"
+            "perftest_compare tool.\n"
+            "Default: Not set");
+    latencyFileBinary->set_type(T_BOOL);
+    latencyFileBinary->set_extra_argument(NO);
+    latencyFileBinary->set_group(PUB);
+    latencyFileBinary->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("latencyFileBinary", latencyFileBinary);
+
+    Parameter<unsigned long long> *hostNoiseCheck =
+            new Parameter<unsigned long long>(1000);
+    hostNoiseCheck->set_command_line_argument("-hostNoiseCheck", "<ms>");
+    hostNoiseCheck->set_description(
+            "Before the test, measure for <ms> the gaps of a busy\n"
+            "loop reading the clock and the wake-up latency of\n"
+            "clock_nanosleep on every -threadCPUAffinity core, and\n"
+            "report their histograms. <ms> is optional.\n"
+            "Default: Not set (1000 ms if <ms> is not given)");
+    hostNoiseCheck->set_type(T_NUMERIC_LLU);
+    hostNoiseCheck->set_extra_argument(POSSIBLE);
+    hostNoiseCheck->set_range(1, MAX_ULLONG);
+    hostNoiseCheck->set_group(GENERAL);
+    hostNoiseCheck->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("hostNoiseCheck", hostNoiseCheck);
+
+    Parameter<unsigned long long> *hostNoiseThreshold =
+            new Parameter<unsigned long long>(100);
+    hostNoiseThreshold->set_command_line_argument(
+            "-hostNoiseThreshold",
+            "<usec>");
+    hostNoiseThreshold->set_description(
+            "Gap or wake-up latency that makes -hostNoiseCheck\n"
+            "report the host as noisy. Default: 100");
+    hostNoiseThreshold->set_type(T_NUMERIC_LLU);
+    hostNoiseThreshold->set_extra_argument(YES);
+    hostNoiseThreshold->set_range(1, MAX_ULLONG);
+    hostNoiseThreshold->set_group(GENERAL);
+    hostNoiseThreshold->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("hostNoiseThreshold", hostNoiseThreshold);
+
+    Parameter<bool> *controller = new Parameter<bool>(false);
+    controller->set_command_line_argument("-controller", "");
+    controller->set_description(
+            "Launch the -numSubscribers subscribers and the\n"
+            "-numPublishers publishers of the test as processes\n"
+            "of this one, with the rest of the command line, and\n"
+            "print a report aggregating their JSON outputs.\n"
+            "Default: Not set");
+    controller->set_type(T_BOOL);
+    controller->set_extra_argument(NO);
+    controller->set_group(GENERAL);
+    controller->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("controller", controller);
+
+    Parameter<std::string> *controllerCores = new Parameter<std::string>();
+    controllerCores->set_command_line_argument(
+            "-controllerCores",
+            "<list>");
+    controllerCores->set_description(
+            "Split the cores of <list> (e.g. 0-31) among the\n"
+            "processes of -controller, and pin every process\n"
+            "to its part. Only on Linux.\n"
+            "Default: Not set");
+    controllerCores->set_type(T_STR);
+    controllerCores->set_extra_argument(YES);
+    controllerCores->set_group(GENERAL);
+    controllerCores->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("controllerCores", controllerCores);
+
+    Parameter<std::string> *scenario = new Parameter<std::string>();
+    scenario->set_command_line_argument("-scenario", "<file>");
+    scenario->set_description(
+            "Run the timed phases of <file>, one per line:\n"
+            "\t<name> duration=<s> [pubRate=<samples/s>[:spin|sleep]]\n"
+            "\t[dataLen=<bytes>] [burst=<samples>:<periodMs>]\n"
+            "\t[instances=<first>[-<last>]] [pause]\n"
+            "The Publisher and the Subscriber report the statistics\n"
+            "of every phase.\n"
+            "The data length is the biggest of the phases.\n"
+            "Must be used in the Publisher and the Subscriber.\n"
+            "Default: Not set");
+    scenario->set_type(T_STR);
+    scenario->set_extra_argument(YES);
+    scenario->set_group(GENERAL);
+    scenario->set_supported_middleware(Middleware::RTIDDSPRO);
+    create("scenario", scenario);
+  #endif
+
     ////////////////////////////////////////////////////////////////////////////
     // TRANSPORT PARAMETER:
     Parameter<std::string> *nic = new Parameter<std::string>();
@@ -1411,6 +1891,108 @@ void ParameterManager::initialize()
     noBlockingSockets->set_group(RAWTRANSPORT);
     noBlockingSockets->set_supported_middleware(Middleware::RAWTRANSPORT);
     create("noBlockingSockets", noBlockingSockets);
+
+    Parameter<bool> *ioUring = new Parameter<bool>(false);
+    ioUring->set_command_line_argument("-ioUring", "");
+    ioUring->set_description(
+            "Send and receive with io_uring instead of the transport\n"
+            "plugin when using -rawTransport (UDPv4, Linux only).\n");
+    ioUring->set_type(T_BOOL);
+    ioUring->set_extra_argument(NO);
+    ioUring->set_group(RAWTRANSPORT);
+    ioUring->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("ioUring", ioUring);
+
+    Parameter<bool> *ioUringSqPoll = new Parameter<bool>(false);
+    ioUringSqPoll->set_command_line_argument("-ioUringSqPoll", "");
+    ioUringSqPoll->set_description(
+            "Use a kernel thread polling the io_uring submission queue\n"
+            "(SQPOLL), so sending does not need system calls.\n");
+    ioUringSqPoll->set_type(T_BOOL);
+    ioUringSqPoll->set_extra_argument(NO);
+    ioUringSqPoll->set_group(RAWTRANSPORT);
+    ioUringSqPoll->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("ioUringSqPoll", ioUringSqPoll);
+
+    Parameter<unsigned long long> *ioUringDepth =
+            new Parameter<unsigned long long>(64);
+    ioUringDepth->set_command_line_argument("-ioUringDepth", "<count>");
+    ioUringDepth->set_description(
+            "Number of registered send buffers and of provided receive\n"
+            "buffers used by -ioUring. Must be a power of 2.\n"
+            "Default: 64");
+    ioUringDepth->set_type(T_NUMERIC_LLU);
+    ioUringDepth->set_extra_argument(YES);
+    ioUringDepth->set_range(2, 4096);
+    ioUringDepth->set_group(RAWTRANSPORT);
+    ioUringDepth->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("ioUringDepth", ioUringDepth);
+
+    Parameter<bool> *packetTimestamps = new Parameter<bool>(false);
+    packetTimestamps->set_command_line_argument("-packetTimestamps", "");
+    packetTimestamps->set_description(
+            "Use the kernel (SO_TIMESTAMPING) RX and TX timestamps of\n"
+            "the pings and pongs to split the round trip in the time\n"
+            "spent in the send path, on the wire and from the kernel to\n"
+            "the application. Hardware timestamps are used for the wire\n"
+            "if the NIC has them enabled. Requires -ioUring in the\n"
+            "Publisher and the Subscriber.\n"
+            "Default: Not set");
+    packetTimestamps->set_type(T_BOOL);
+    packetTimestamps->set_extra_argument(NO);
+    packetTimestamps->set_group(RAWTRANSPORT);
+    packetTimestamps->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("packetTimestamps", packetTimestamps);
+
+    Parameter<bool> *shmRing = new Parameter<bool>(false);
+    shmRing->set_command_line_argument("-shmRing", "");
+    shmRing->set_description(
+            "Use lock-free rings in POSIX shared memory instead of DDS.\n"
+            "Only for applications in the same host (Linux only).\n"
+            "Many of the parameters are not supported with it.\n");
+    shmRing->set_type(T_BOOL);
+    shmRing->set_extra_argument(NO);
+    shmRing->set_group(RAWTRANSPORT);
+    shmRing->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("shmRing", shmRing);
+
+    Parameter<unsigned long long> *shmRingSlots =
+            new Parameter<unsigned long long>(1024);
+    shmRingSlots->set_command_line_argument("-shmRingSlots", "<count>");
+    shmRingSlots->set_description(
+            "Number of slots of the -shmRing ring used for the\n"
+            "Throughput topic. Must be a power of 2.\n"
+            "Default: 1024");
+    shmRingSlots->set_type(T_NUMERIC_LLU);
+    shmRingSlots->set_extra_argument(YES);
+    shmRingSlots->set_range(2, 1048576);
+    shmRingSlots->set_group(RAWTRANSPORT);
+    shmRingSlots->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("shmRingSlots", shmRingSlots);
+
+    Parameter<std::string> *shmRingWait = new Parameter<std::string>("futex");
+    shmRingWait->set_command_line_argument("-shmRingWait", "<method>");
+    shmRingWait->set_description(
+            "How -shmRing waits for data or free slots:\n"
+            "'futex' (sleep until notified) or 'spin' (busy wait).\n"
+            "Default: futex");
+    shmRingWait->set_type(T_STR);
+    shmRingWait->set_extra_argument(YES);
+    shmRingWait->set_group(RAWTRANSPORT);
+    shmRingWait->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("shmRingWait", shmRingWait);
+
+    Parameter<bool> *loopback = new Parameter<bool>(false);
+    loopback->set_command_line_argument("-loopback", "");
+    loopback->set_description(
+            "Run the subscribers as threads of the publisher process,\n"
+            "delivering the samples directly to their listeners,\n"
+            "without middleware. Measures the overhead of Perftest.\n");
+    loopback->set_type(T_BOOL);
+    loopback->set_extra_argument(NO);
+    loopback->set_group(RAWTRANSPORT);
+    loopback->set_supported_middleware(Middleware::RAWTRANSPORT);
+    create("loopback", loopback);
   #endif
 
   #if defined(RTI_LANGUAGE_CPP_TRADITIONAL) && defined(PERFTEST_FAST_QUEUE)
@@ -1874,16 +2456,29 @@ bool ParameterManager::is_set(std::string parameterKey)
     }
 }
 
+std::map<std::string, ParameterBase *> ParameterManager::get_parameters()
+{
+    std::map<std::string, ParameterBase *> parameters;
+    std::map<std::string, AnyParameter>::iterator it;
+    for (it = _parameterList.begin(); it != _parameterList.end(); it++) {
+        parameters[it->first] = it->second.get();
+    }
+    return parameters;
+}
+
 bool ParameterManager::check_incompatible_parameters()
 {
     bool success = true;
     std::map<std::string, AnyParameter>::iterator it;
 
     /*
-     * RAWTRANSPORT is not actually a middleware, and the desition is made at
-     * execution time (it has to be RTI Connext DDS Pro to support this feature)
+     * RAWTRANSPORT (also used by -shmRing and -loopback) is not actually a
+     * middleware, and the desition is made at execution time (it has to be
+     * RTI Connext DDS Pro to support this feature)
      */
-    if (get<bool>("rawTransport")) {
+    if (get<bool>("rawTransport")
+            || get<bool>("shmRing")
+            || get<bool>("loopback")) {
         this->middleware = Middleware::RAWTRANSPORT;
     }
 
@@ -1967,3 +2562,37 @@ bool ParameterManager::group_is_used(Group group)
     }
     return false;
 }
+
+std::vector<std::string> ParameterManager::remove_group_arguments(
+        int argc,
+        char *argv[],
+        Group group)
+{
+    std::vector<std::string> arguments;
+    std::map<std::string, AnyParameter>::iterator it;
+
+    if (argc > 0) {
+        arguments.push_back(argv[0]);
+    }
+    for (int i = 1; i < argc; i++) {
+        // Same matching as parse(), the first parameter matching the option
+        for (it = _parameterList.begin(); it != _parameterList.end(); it++) {
+            if (IS_OPTION(argv[i], it->second.get()->get_option().c_str())) {
+                break;
+            }
+        }
+        int values = 0;
+        if (it != _parameterList.end()
+                && it->second.get()->get_extra_argument() != NO
+                && i + 1 < argc
+                && argv[i + 1][0] != '-') {
+            values = 1;
+        }
+        if (it == _parameterList.end()
+                || it->second.get()->get_group() != group) {
+            arguments.insert(arguments.end(), argv + i, argv + i + values + 1);
+        }
+        i += values;
+    }
+    return arguments;
+}
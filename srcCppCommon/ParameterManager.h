@@ -120,6 +120,12 @@ class ParameterManager
         // Check if a variable has been set
         bool is_set(std::string parameterKey);
 
+        /*
+         * All the parameters by key, to export the configuration of a test.
+         * They are owned by the ParameterManager.
+         */
+        std::map<std::string, ParameterBase *> get_parameters();
+
         /*
          * Validate:
          *     That if -pub not use parameter of SUB group
@@ -130,6 +136,15 @@ class ParameterManager
         // Verify if there is a parameter of the group set
         bool group_is_used(Group group);
 
+        /*
+         * Copy of the command line without the options of the group and
+         * their values, matched as parse() does.
+         */
+        std::vector<std::string> remove_group_arguments(
+                int argc,
+                char *argv[],
+                Group group);
+
 
     private:
         MiddlewareMask middleware;
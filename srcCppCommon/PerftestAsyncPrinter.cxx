@@ -0,0 +1,364 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestAsyncPrinter.h"
+#include "ThreadCPUAffinity.h"
+#include <chrono>
+#include <thread>
+#ifdef RTI_LINUX
+  #include <unistd.h>
+  #include <sys/resource.h>
+  #include <sys/syscall.h>
+#endif
+
+/* Time the background thread waits when there is nothing to print */
+#define PERFTEST_ASYNC_PRINTER_IDLE_MSEC 1
+
+/* Niceness of the background thread, so it yields to the test threads */
+#define PERFTEST_ASYNC_PRINTER_NICENESS 10
+
+PerftestAsyncPrinter::PerftestAsyncPrinter(PerftestPrinter *printer)
+        : _printer(printer),
+          _slots(NULL),
+          _enqueuePosition(0),
+          _dequeuePosition(0),
+          _printedRecords(0),
+          _droppedRecords(0),
+          _thread(NULL),
+          _core(-1),
+          _stop(false),
+          _threadFinished(false)
+{
+    // The decorated printer owns the output file
+    _outputFile = NULL;
+    _dataLength = printer->_dataLength;
+    _printHeaders = printer->_printHeaders;
+
+    _slots = new Slot[PERFTEST_ASYNC_PRINTER_QUEUE_SIZE];
+    for (unsigned long long i = 0; i < PERFTEST_ASYNC_PRINTER_QUEUE_SIZE; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+PerftestAsyncPrinter::~PerftestAsyncPrinter()
+{
+    if (_thread != NULL) {
+        _stop.store(true);
+        while (!_threadFinished.load()) {
+            std::this_thread::sleep_for(
+                    std::chrono::milliseconds(PERFTEST_ASYNC_PRINTER_IDLE_MSEC));
+        }
+        PerftestThread_delete(_thread);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_printMutex);
+        drain();
+    }
+    if (_droppedRecords.load() > 0) {
+        fprintf(stderr,
+                "[Warning] PerftestAsyncPrinter: %llu intervals printed, %llu "
+                "dropped because the queue was full.\n",
+                _printedRecords.load(),
+                _droppedRecords.load());
+    }
+
+    delete _printer;
+    delete []_slots;
+}
+
+bool PerftestAsyncPrinter::start(int core)
+{
+    _core = core;
+    _thread = PerftestThread_new(
+            "AsyncPrinterThread",
+            Perftest_THREAD_PRIORITY_DEFAULT,
+            Perftest_THREAD_OPTION_DEFAULT,
+            printer_thread,
+            this);
+    if (_thread == NULL) {
+        fprintf(stderr,
+                "[PerftestAsyncPrinter] Error: Cannot create the printer "
+                "thread.\n");
+        return false;
+    }
+    return true;
+}
+
+void *PerftestAsyncPrinter::printer_thread(void *arg)
+{
+    PerftestAsyncPrinter *printer = static_cast<PerftestAsyncPrinter *>(arg);
+
+  #ifdef RTI_LINUX
+    if (printer->_core >= 0) {
+        ThreadCPUAffinity::set_current_thread_affinity(printer->_core);
+    }
+    setpriority(
+            PRIO_PROCESS,
+            (id_t) syscall(SYS_gettid),
+            PERFTEST_ASYNC_PRINTER_NICENESS);
+  #endif
+
+    while (!printer->_stop.load()) {
+        unsigned int printed = 0;
+        {
+            std::lock_guard<std::mutex> lock(printer->_printMutex);
+            printed = printer->drain();
+        }
+        if (printed == 0) {
+            std::this_thread::sleep_for(
+                    std::chrono::milliseconds(PERFTEST_ASYNC_PRINTER_IDLE_MSEC));
+        }
+    }
+
+    printer->_threadFinished.store(true);
+    return NULL;
+}
+
+void PerftestAsyncPrinter::push(const PerftestAsyncPrinterRecord &record)
+{
+    const unsigned long long mask = PERFTEST_ASYNC_PRINTER_QUEUE_SIZE - 1;
+    unsigned long long position =
+            _enqueuePosition.load(std::memory_order_relaxed);
+    Slot *slot = NULL;
+
+    while (true) {
+        slot = &_slots[position & mask];
+        unsigned long long sequence =
+                slot->sequence.load(std::memory_order_acquire);
+        long long difference = (long long) (sequence - position);
+        if (difference == 0) {
+            if (_enqueuePosition.compare_exchange_weak(
+                        position,
+                        position + 1,
+                        std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Full: never block the thread measuring the test
+            _droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->record = record;
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+bool PerftestAsyncPrinter::pop(PerftestAsyncPrinterRecord &record)
+{
+    const unsigned long long mask = PERFTEST_ASYNC_PRINTER_QUEUE_SIZE - 1;
+    unsigned long long position =
+            _dequeuePosition.load(std::memory_order_relaxed);
+    Slot *slot = NULL;
+
+    while (true) {
+        slot = &_slots[position & mask];
+        unsigned long long sequence =
+                slot->sequence.load(std::memory_order_acquire);
+        long long difference = (long long) (sequence - (position + 1));
+        if (difference == 0) {
+            if (_dequeuePosition.compare_exchange_weak(
+                        position,
+                        position + 1,
+                        std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = _dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    record = slot->record;
+    slot->sequence.store(position + mask + 1, std::memory_order_release);
+    return true;
+}
+
+unsigned int PerftestAsyncPrinter::drain()
+{
+    PerftestAsyncPrinterRecord record;
+    unsigned int printed = 0;
+    while (pop(record)) {
+        print_record(record);
+        printed++;
+    }
+    if (printed > 0) {
+        _printedRecords.fetch_add(printed, std::memory_order_relaxed);
+        fflush(_printer->_outputFile);
+    }
+    return printed;
+}
+
+void PerftestAsyncPrinter::print_record(
+        const PerftestAsyncPrinterRecord &record)
+{
+    _printer->_dataLength = record.dataLength;
+    switch (record.kind) {
+    case ASYNC_PRINTER_LATENCY_HEADER:
+        _printer->print_latency_header();
+        break;
+    case ASYNC_PRINTER_LATENCY_INTERVAL:
+        _printer->print_latency_interval(
+                (unsigned long) record.values[0],
+                record.reals[0],
+                record.reals[1],
+                (unsigned long) record.values[1],
+                (unsigned long) record.values[2],
+                record.reals[2]);
+        break;
+    case ASYNC_PRINTER_THROUGHPUT_HEADER:
+        _printer->print_throughput_header();
+        break;
+    case ASYNC_PRINTER_THROUGHPUT_INTERVAL:
+        _printer->print_throughput_interval(
+                record.values[0],
+                record.values[1],
+                record.reals[0],
+                record.values[2],
+                record.reals[1],
+                record.values[3],
+                record.percent,
+                record.reals[2]);
+        break;
+    }
+}
+
+void PerftestAsyncPrinter::print_latency_header()
+{
+    PerftestAsyncPrinterRecord record;
+    record.kind = ASYNC_PRINTER_LATENCY_HEADER;
+    record.dataLength = _dataLength;
+    push(record);
+}
+
+void PerftestAsyncPrinter::print_latency_interval(
+        unsigned long latency,
+        double latencyAve,
+        double latencyStd,
+        unsigned long latencyMin,
+        unsigned long latencyMax,
+        double outputCpu)
+{
+    PerftestAsyncPrinterRecord record;
+    record.kind = ASYNC_PRINTER_LATENCY_INTERVAL;
+    record.dataLength = _dataLength;
+    record.values[0] = latency;
+    record.values[1] = latencyMin;
+    record.values[2] = latencyMax;
+    record.reals[0] = latencyAve;
+    record.reals[1] = latencyStd;
+    record.reals[2] = outputCpu;
+    push(record);
+}
+
+void PerftestAsyncPrinter::print_latency_summary(
+        int totalSampleSize,
+        double latencyAve,
+        double latencyStd,
+        unsigned long latencyMin,
+        unsigned long latencyMax,
+        unsigned long *latencyHistory,
+        unsigned long long count,
+        double serializeTime,
+        double deserializeTime,
+        double outputCpu)
+{
+    std::lock_guard<std::mutex> lock(_printMutex);
+    drain();
+    _printer->_dataLength = _dataLength;
+    _printer->print_latency_summary(
+            totalSampleSize,
+            latencyAve,
+            latencyStd,
+            latencyMin,
+            latencyMax,
+            latencyHistory,
+            count,
+            serializeTime,
+            deserializeTime,
+            outputCpu);
+    fflush(_printer->_outputFile);
+}
+
+void PerftestAsyncPrinter::print_throughput_header()
+{
+    PerftestAsyncPrinterRecord record;
+    record.kind = ASYNC_PRINTER_THROUGHPUT_HEADER;
+    record.dataLength = _dataLength;
+    push(record);
+}
+
+void PerftestAsyncPrinter::print_throughput_interval(
+        unsigned long long lastMsgs,
+        unsigned long long mps,
+        double mpsAve,
+        unsigned long long bps,
+        double bpsAve,
+        unsigned long long missingPackets,
+        float missingPacketsPercent,
+        double outputCpu)
+{
+    PerftestAsyncPrinterRecord record;
+    record.kind = ASYNC_PRINTER_THROUGHPUT_INTERVAL;
+    record.dataLength = _dataLength;
+    record.values[0] = lastMsgs;
+    record.values[1] = mps;
+    record.values[2] = bps;
+    record.values[3] = missingPackets;
+    record.reals[0] = mpsAve;
+    record.reals[1] = bpsAve;
+    record.reals[2] = outputCpu;
+    record.percent = missingPacketsPercent;
+    push(record);
+}
+
+void PerftestAsyncPrinter::print_throughput_summary(
+        int length,
+        unsigned long long intervalPacketsReceived,
+        unsigned long long intervalTime,
+        unsigned long long intervalBytesReceived,
+        unsigned long long intervalMissingPackets,
+        float missingPacketsPercent,
+        double outputCpu)
+{
+    std::lock_guard<std::mutex> lock(_printMutex);
+    drain();
+    _printer->_dataLength = _dataLength;
+    _printer->print_throughput_summary(
+            length,
+            intervalPacketsReceived,
+            intervalTime,
+            intervalBytesReceived,
+            intervalMissingPackets,
+            missingPacketsPercent,
+            outputCpu);
+    fflush(_printer->_outputFile);
+}
+
+void PerftestAsyncPrinter::print_initial_output()
+{
+    std::lock_guard<std::mutex> lock(_printMutex);
+    drain();
+    _printer->print_initial_output();
+    fflush(_printer->_outputFile);
+}
+
+void PerftestAsyncPrinter::print_final_output()
+{
+    std::lock_guard<std::mutex> lock(_printMutex);
+    drain();
+    _printer->print_final_output();
+    fflush(_printer->_outputFile);
+}
+
+void PerftestAsyncPrinter::set_host_noise_json(const std::string &json)
+{
+    std::lock_guard<std::mutex> lock(_printMutex);
+    _printer->set_host_noise_json(json);
+}
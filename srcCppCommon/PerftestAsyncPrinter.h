@@ -0,0 +1,140 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#ifndef __PERFTESTASYNCPRINTER_H__
+#define __PERFTESTASYNCPRINTER_H__
+
+#include <atomic>
+#include <mutex>
+#include "PerftestPrinter.h"
+
+/* Number of records the queue can hold, a power of 2 */
+#define PERFTEST_ASYNC_PRINTER_QUEUE_SIZE 65536
+
+enum PerftestAsyncPrinterRecordKind {
+    ASYNC_PRINTER_LATENCY_HEADER,
+    ASYNC_PRINTER_LATENCY_INTERVAL,
+    ASYNC_PRINTER_THROUGHPUT_HEADER,
+    ASYNC_PRINTER_THROUGHPUT_INTERVAL
+};
+
+/* Arguments of one call to the printer, copied into the queue */
+struct PerftestAsyncPrinterRecord {
+    PerftestAsyncPrinterRecordKind kind;
+    unsigned int dataLength;
+    unsigned long long values[4];
+    double reals[3];
+    float percent;
+};
+
+/*
+ * Printer that moves the formatting and the writes of the intervals out of
+ * the threads measuring the test (-asyncPrinter).
+ *
+ * The headers and intervals are copied into a bounded lock-free queue, and a
+ * background thread (default priority, pinned to the event thread cores if
+ * -threadCPUAffinity is used) formats them with the printer it decorates.
+ * If the queue is full the record is dropped and counted, the measuring
+ * thread never waits.
+ *
+ * The summaries are not in the measured path and may refer to memory that
+ * changes after the call (the latency history), so they are printed right
+ * away, after the records queued before them.
+ */
+class PerftestAsyncPrinter : public PerftestPrinter {
+  public:
+    /* Takes ownership of the printer, already initialized */
+    PerftestAsyncPrinter(PerftestPrinter *printer);
+    ~PerftestAsyncPrinter();
+
+    /* Start the background thread, pinned to core if not -1 */
+    bool start(int core);
+
+    void print_latency_header();
+    void print_latency_interval(
+            unsigned long latency,
+            double latencyAve,
+            double latencyStd,
+            unsigned long latencyMin,
+            unsigned long latencyMax,
+            double outputCpu);
+    void print_latency_summary(
+            int totalSampleSize,
+            double latencyAve,
+            double latencyStd,
+            unsigned long latencyMin,
+            unsigned long latencyMax,
+            unsigned long *latencyHistory,
+            unsigned long long count,
+            double serializeTime,
+            double deserializeTime,
+            double outputCpu);
+
+    void print_throughput_header();
+    void print_throughput_interval(
+            unsigned long long lastMsgs,
+            unsigned long long mps,
+            double mpsAve,
+            unsigned long long bps,
+            double bpsAve,
+            unsigned long long missingPackets,
+            float missingPacketsPercent,
+            double outputCpu);
+    void print_throughput_summary(
+            int length,
+            unsigned long long intervalPacketsReceived,
+            unsigned long long intervalTime,
+            unsigned long long intervalBytesReceived,
+            unsigned long long intervalMissingPackets,
+            float missingPacketsPercent,
+            double outputCpu);
+
+    void print_initial_output();
+    void print_final_output();
+    void set_host_noise_json(const std::string &json);
+
+    unsigned long long get_printed_records() const
+    {
+        return _printedRecords.load();
+    }
+
+    unsigned long long get_dropped_records() const
+    {
+        return _droppedRecords.load();
+    }
+
+  private:
+    struct Slot {
+        std::atomic<unsigned long long> sequence;
+        PerftestAsyncPrinterRecord record;
+    };
+
+    static void *printer_thread(void *arg);
+
+    /* Bounded multi-producer multi-consumer queue (Vyukov) */
+    void push(const PerftestAsyncPrinterRecord &record);
+    bool pop(PerftestAsyncPrinterRecord &record);
+
+    /* Print every queued record, with _printMutex taken */
+    unsigned int drain();
+    void print_record(const PerftestAsyncPrinterRecord &record);
+
+    PerftestPrinter *_printer;
+    Slot *_slots;
+    std::atomic<unsigned long long> _enqueuePosition;
+    std::atomic<unsigned long long> _dequeuePosition;
+    std::atomic<unsigned long long> _printedRecords;
+    std::atomic<unsigned long long> _droppedRecords;
+
+    /* Taken while the decorated printer writes */
+    std::mutex _printMutex;
+
+    PerftestThread *_thread;
+    int _core;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _threadFinished;
+};
+
+#endif // __PERFTESTASYNCPRINTER_H__
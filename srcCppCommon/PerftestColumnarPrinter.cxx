@@ -0,0 +1,311 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestColumnarPrinter.h"
+#include <stdlib.h>
+#include <time.h>
+#include <map>
+
+/* Factor from the unit of the latencies given to the printer to ns */
+#ifdef RTI_PERFTEST_NANO_CLOCK
+  #define PERFTEST_COLUMNAR_TO_NS 1
+#else
+  #define PERFTEST_COLUMNAR_TO_NS 1000
+#endif
+
+/* Buckets of latency_histogram, bucket i has the values in [2^i, 2^(i+1)) ns */
+#define PERFTEST_COLUMNAR_HISTOGRAM_BUCKETS 64
+
+static long long to_ns(unsigned long value)
+{
+    return (long long) value * PERFTEST_COLUMNAR_TO_NS;
+}
+
+PerftestColumnarPrinter::PerftestColumnarPrinter()
+        : _runId(PerftestColumnarStore_new_run_id()),
+          _interval(0),
+          _writeFailed(false),
+          _latencyIntervals("latency_intervals", _runId),
+          _latencySummary("latency_summary", _runId),
+          _latencyHistogram("latency_histogram", _runId),
+          _throughputIntervals("throughput_intervals", _runId),
+          _throughputSummary("throughput_summary", _runId)
+{
+    _outputFile = NULL;
+}
+
+PerftestColumnarPrinter::~PerftestColumnarPrinter()
+{
+    print_final_output();
+}
+
+bool PerftestColumnarPrinter::initialize(ParameterManager *_PM)
+{
+    if (!_PM->is_set("outputFile")) {
+        fprintf(stderr,
+                "[PerftestColumnarPrinter] Error: '-outputFormat columnar' "
+                "needs '-outputFile'.\n");
+        return false;
+    }
+    std::string fileName = _PM->get<std::string>("outputFile");
+
+    // The file is appended, it has to be empty or have columnar blocks
+    FILE *existingFile = fopen(fileName.c_str(), "rb");
+    if (existingFile != NULL) {
+        unsigned char magic[4];
+        size_t size = fread(magic, 1, sizeof(magic), existingFile);
+        fclose(existingFile);
+        if (size > 0
+                && (size != sizeof(magic)
+                        || (magic[0] | magic[1] << 8 | magic[2] << 16
+                                | (unsigned int) magic[3] << 24)
+                                != PERFTEST_COLUMNAR_MAGIC)) {
+            fprintf(stderr,
+                    "[PerftestColumnarPrinter] Error: %s is not a columnar "
+                    "file, the results cannot be appended.\n",
+                    fileName.c_str());
+            return false;
+        }
+    }
+
+    if (!PerftestPrinter::initialize(_PM)) {
+        return false;
+    }
+    _outputFile = freopen(fileName.c_str(), "ab", _outputFile);
+    if (_outputFile == NULL) {
+        fprintf(stderr,
+                "[PerftestColumnarPrinter] Error: Cannot open output file "
+                "%s.\n",
+                fileName.c_str());
+        return false;
+    }
+
+    // Numbers and booleans as integers, the rest as strings
+    PerftestColumnarTable config("config", _runId);
+    std::map<std::string, ParameterBase *> parameters = _PM->get_parameters();
+    std::map<std::string, ParameterBase *>::iterator it;
+    for (it = parameters.begin(); it != parameters.end(); it++) {
+        std::string value = it->second->get_value_str();
+        switch (it->second->get_type()) {
+        case T_NUMERIC_LLU:
+            config.set_int(
+                    it->first,
+                    (long long) strtoull(value.c_str(), NULL, 10));
+            break;
+        case T_NUMERIC_LD:
+        case T_NUMERIC_D:
+        case T_BOOL:
+            config.set_int(it->first, strtoll(value.c_str(), NULL, 10));
+            break;
+        default:
+            config.set_string(it->first, value);
+            break;
+        }
+    }
+    config.set_int("start_time_s", (long long) time(NULL));
+    config.end_row();
+    write(config);
+
+    return !_writeFailed;
+}
+
+void PerftestColumnarPrinter::end_row(PerftestColumnarTable &table)
+{
+    table.end_row();
+    if (table.get_rows() >= PERFTEST_COLUMNAR_BLOCK_ROWS) {
+        write(table);
+    }
+}
+
+void PerftestColumnarPrinter::write(PerftestColumnarTable &table)
+{
+    if (table.get_rows() == 0 || _outputFile == NULL) {
+        return;
+    }
+    if (!table.write(_outputFile) && !_writeFailed) {
+        fprintf(stderr,
+                "[PerftestColumnarPrinter] Error: Cannot write the %s "
+                "table.\n",
+                table.get_name().c_str());
+        _writeFailed = true;
+    }
+    table.clear();
+}
+
+void PerftestColumnarPrinter::print_latency_header()
+{
+    _interval = 0;
+}
+
+void PerftestColumnarPrinter::print_throughput_header()
+{
+    _interval = 0;
+}
+
+void PerftestColumnarPrinter::print_latency_interval(
+        unsigned long latency,
+        double latencyAve,
+        double latencyStd,
+        unsigned long latencyMin,
+        unsigned long latencyMax,
+        double outputCpu)
+{
+    PerftestColumnarTable &table = _latencyIntervals;
+    table.set_int("length", _dataLength);
+    table.set_int("interval", _interval++);
+    table.set_int("latency_ns", to_ns(latency));
+    table.set_double("latency_ave_ns", latencyAve * PERFTEST_COLUMNAR_TO_NS);
+    table.set_double("latency_std_ns", latencyStd * PERFTEST_COLUMNAR_TO_NS);
+    table.set_int("latency_min_ns", to_ns(latencyMin));
+    table.set_int("latency_max_ns", to_ns(latencyMax));
+    if (_showCPU) {
+        table.set_double("cpu", outputCpu);
+    }
+    end_row(table);
+}
+
+void PerftestColumnarPrinter::print_latency_summary(
+        int totalSampleSize,
+        double latencyAve,
+        double latencyStd,
+        unsigned long latencyMin,
+        unsigned long latencyMax,
+        unsigned long *latencyHistory,
+        unsigned long long count,
+        double serializeTime,
+        double deserializeTime,
+        double outputCpu)
+{
+    PerftestColumnarTable &table = _latencySummary;
+    table.set_int("length", totalSampleSize);
+    table.set_int("count", count);
+    table.set_double("latency_ave_ns", latencyAve * PERFTEST_COLUMNAR_TO_NS);
+    table.set_double("latency_std_ns", latencyStd * PERFTEST_COLUMNAR_TO_NS);
+    table.set_int("latency_min_ns", to_ns(latencyMin));
+    table.set_int("latency_max_ns", to_ns(latencyMax));
+    if (latencyHistory != NULL && count > 0) {
+        // The history is sorted, same percentiles as the other printers
+        table.set_int(
+                "latency_50_ns",
+                to_ns(latencyHistory[count * 50 / 100]));
+        table.set_int(
+                "latency_90_ns",
+                to_ns(latencyHistory[count * 90 / 100]));
+        table.set_int(
+                "latency_99_ns",
+                to_ns(latencyHistory[count * 99 / 100]));
+        table.set_int(
+                "latency_99.99_ns",
+                to_ns(latencyHistory[(int) (count * (9999.0 / 10000))]));
+        table.set_int(
+                "latency_99.9999_ns",
+                to_ns(latencyHistory[(int) (count * (999999.0 / 1000000))]));
+    }
+    if (_printSerialization) {
+        table.set_double("serialize_us", serializeTime);
+        table.set_double("deserialize_us", deserializeTime);
+    }
+    if (_showCPU) {
+        table.set_double("cpu", outputCpu);
+    }
+    end_row(table);
+
+    if (latencyHistory == NULL || count == 0) {
+        return;
+    }
+    unsigned long long buckets[PERFTEST_COLUMNAR_HISTOGRAM_BUCKETS] = {0};
+    for (unsigned long long i = 0; i < count; i++) {
+        unsigned long long value = to_ns(latencyHistory[i]);
+        unsigned int bucket = 0;
+        while (value > 1) {
+            value >>= 1;
+            bucket++;
+        }
+        buckets[bucket]++;
+    }
+    for (unsigned int i = 0; i < PERFTEST_COLUMNAR_HISTOGRAM_BUCKETS; i++) {
+        if (buckets[i] == 0) {
+            continue;
+        }
+        _latencyHistogram.set_int("length", totalSampleSize);
+        _latencyHistogram.set_int("bucket_ns", i == 0 ? 0 : 1LL << i);
+        _latencyHistogram.set_int("count", buckets[i]);
+        end_row(_latencyHistogram);
+    }
+}
+
+void PerftestColumnarPrinter::print_throughput_interval(
+        unsigned long long lastMsgs,
+        unsigned long long mps,
+        double mpsAve,
+        unsigned long long bps,
+        double bpsAve,
+        unsigned long long missingPackets,
+        float missingPacketsPercent,
+        double outputCpu)
+{
+    PerftestColumnarTable &table = _throughputIntervals;
+    table.set_int("length", _dataLength);
+    table.set_int("interval", _interval++);
+    table.set_int("packets", lastMsgs);
+    table.set_int("packets/s", mps);
+    table.set_double("packets/s_ave", mpsAve);
+    table.set_double("mbps", bps * 8.0 / 1000.0 / 1000.0);
+    table.set_double("mbps_ave", bpsAve * 8.0 / 1000.0 / 1000.0);
+    table.set_int("lost", missingPackets);
+    table.set_double("lost_percent", missingPacketsPercent);
+    if (_showCPU) {
+        table.set_double("cpu", outputCpu);
+    }
+    end_row(table);
+}
+
+void PerftestColumnarPrinter::print_throughput_summary(
+        int length,
+        unsigned long long intervalPacketsReceived,
+        unsigned long long intervalTime,
+        unsigned long long intervalBytesReceived,
+        unsigned long long intervalMissingPackets,
+        float missingPacketsPercent,
+        double outputCpu)
+{
+    PerftestColumnarTable &table = _throughputSummary;
+    table.set_int("length", length);
+    table.set_int("packets", intervalPacketsReceived);
+    table.set_int("time_us", intervalTime);
+    if (intervalTime > 0) {
+        table.set_double(
+                "packets/s_ave",
+                intervalPacketsReceived * 1000000.0 / intervalTime);
+        table.set_double(
+                "mbps_ave",
+                intervalBytesReceived * 1000000.0 / intervalTime * 8.0
+                        / 1000.0 / 1000.0);
+    }
+    table.set_int("lost", intervalMissingPackets);
+    table.set_double("lost_percent", missingPacketsPercent);
+    if (_showCPU) {
+        table.set_double("cpu", outputCpu);
+    }
+    end_row(table);
+}
+
+void PerftestColumnarPrinter::print_final_output()
+{
+    write(_latencyIntervals);
+    write(_latencySummary);
+    write(_latencyHistogram);
+    write(_throughputIntervals);
+    write(_throughputSummary);
+}
+
+void PerftestColumnarPrinter::set_host_noise_json(const std::string &json)
+{
+    PerftestPrinter::set_host_noise_json(json);
+    PerftestColumnarTable table("host_noise", _runId);
+    table.set_string("json", json);
+    table.end_row();
+    write(table);
+}
@@ -0,0 +1,95 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#ifndef __PERFTESTCOLUMNARPRINTER_H__
+#define __PERFTESTCOLUMNARPRINTER_H__
+
+#include "PerftestPrinter.h"
+#include "PerftestColumnarStore.h"
+
+/*
+ * Printer of "-outputFormat columnar": appends the results of the test to
+ * -outputFile in the columnar binary format of PerftestColumnarStore.h, so the
+ * results of large sweeps are small and fast to load. perftest_columnar
+ * filters them and exports them to CSV.
+ *
+ * Every run writes these tables, all the rows tagged with a random run id:
+ *   - config: one row with the value of every parameter.
+ *   - latency_intervals, throughput_intervals: one row per interval.
+ *   - latency_summary, throughput_summary: one row per data length.
+ *   - latency_histogram: the latencies of every data length in log2 buckets.
+ *   - host_noise: the JSON of -hostNoiseCheck, if used.
+ * The latencies are in ns, whatever the clock of the build.
+ *
+ * The rows are written in blocks, when a table has
+ * PERFTEST_COLUMNAR_BLOCK_ROWS rows and at the end of the test.
+ */
+class PerftestColumnarPrinter : public PerftestPrinter {
+  public:
+    PerftestColumnarPrinter();
+    ~PerftestColumnarPrinter();
+
+    bool initialize(ParameterManager *_PM);
+
+    void print_latency_header();
+    void print_latency_interval(
+            unsigned long latency,
+            double latencyAve,
+            double latencyStd,
+            unsigned long latencyMin,
+            unsigned long latencyMax,
+            double outputCpu);
+    void print_latency_summary(
+            int totalSampleSize,
+            double latencyAve,
+            double latencyStd,
+            unsigned long latencyMin,
+            unsigned long latencyMax,
+            unsigned long *latencyHistory,
+            unsigned long long count,
+            double serializeTime,
+            double deserializeTime,
+            double outputCpu);
+
+    void print_throughput_header();
+    void print_throughput_interval(
+            unsigned long long lastMsgs,
+            unsigned long long mps,
+            double mpsAve,
+            unsigned long long bps,
+            double bpsAve,
+            unsigned long long missingPackets,
+            float missingPacketsPercent,
+            double outputCpu);
+    void print_throughput_summary(
+            int length,
+            unsigned long long intervalPacketsReceived,
+            unsigned long long intervalTime,
+            unsigned long long intervalBytesReceived,
+            unsigned long long intervalMissingPackets,
+            float missingPacketsPercent,
+            double outputCpu);
+
+    void print_final_output();
+
+    void set_host_noise_json(const std::string &json);
+
+  private:
+    // End the row, and write the table if it is full
+    void end_row(PerftestColumnarTable &table);
+    void write(PerftestColumnarTable &table);
+
+    unsigned long long _runId;
+    unsigned long long _interval;
+    bool _writeFailed;
+
+    PerftestColumnarTable _latencyIntervals;
+    PerftestColumnarTable _latencySummary;
+    PerftestColumnarTable _latencyHistogram;
+    PerftestColumnarTable _throughputIntervals;
+    PerftestColumnarTable _throughputSummary;
+};
+
+#endif // __PERFTESTCOLUMNARPRINTER_H__
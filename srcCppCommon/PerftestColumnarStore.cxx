@@ -0,0 +1,599 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestColumnarStore.h"
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <random>
+
+/* Entries of the hash table and maximum distance of the LZ matches */
+#define PERFTEST_COLUMNAR_LZ_HASH_BITS 14
+#define PERFTEST_COLUMNAR_LZ_WINDOW 65535
+#define PERFTEST_COLUMNAR_LZ_MIN_MATCH 4
+
+/* magic, version, reserved and size */
+#define PERFTEST_COLUMNAR_HEADER_SIZE 12
+
+/******************************************************************************/
+/* Encoding                                                                   */
+/******************************************************************************/
+
+static void put_u8(std::string &buffer, unsigned char value)
+{
+    buffer.push_back((char) value);
+}
+
+static void put_uint(std::string &buffer, unsigned long long value, int bytes)
+{
+    for (int i = 0; i < bytes; i++) {
+        buffer.push_back((char) ((value >> (8 * i)) & 0xff));
+    }
+}
+
+static void put_varint(std::string &buffer, unsigned long long value)
+{
+    while (value >= 0x80) {
+        buffer.push_back((char) ((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((char) value);
+}
+
+static void put_string(std::string &buffer, const std::string &value)
+{
+    put_varint(buffer, value.size());
+    buffer += value;
+}
+
+/* Bounds-checked reads of an encoded buffer */
+struct ColumnarDecoder {
+    const unsigned char *data;
+    size_t size;
+    size_t position;
+    bool failed;
+
+    ColumnarDecoder(const std::string &buffer)
+            : data((const unsigned char *) buffer.data()),
+              size(buffer.size()),
+              position(0),
+              failed(false)
+    {
+    }
+
+    bool has(size_t bytes)
+    {
+        if (failed || size - position < bytes) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    unsigned long long get_uint(int bytes)
+    {
+        unsigned long long value = 0;
+        if (!has(bytes)) {
+            return 0;
+        }
+        for (int i = 0; i < bytes; i++) {
+            value |= (unsigned long long) data[position++] << (8 * i);
+        }
+        return value;
+    }
+
+    unsigned long long get_varint()
+    {
+        unsigned long long value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!has(1)) {
+                return 0;
+            }
+            unsigned char byte = data[position++];
+            value |= (unsigned long long) (byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        failed = true;
+        return 0;
+    }
+
+    std::string get_string()
+    {
+        unsigned long long length = get_varint();
+        if (!has(length)) {
+            return "";
+        }
+        std::string value((const char *) data + position, (size_t) length);
+        position += (size_t) length;
+        return value;
+    }
+
+    bool finished() const
+    {
+        return position == size;
+    }
+};
+
+/******************************************************************************/
+/* Compression                                                                */
+/******************************************************************************/
+
+/*
+ * Byte-oriented LZ77, in the spirit of LZ4 but with varints: a sequence of
+ * (literal count, literals, match length, match offset), the last one with
+ * only the literals. Good enough for the repetitive columns of a sweep and
+ * simple enough to not need a dependency.
+ */
+static std::string lz_compress(const std::string &input)
+{
+    const unsigned char *in = (const unsigned char *) input.data();
+    const size_t size = input.size();
+    std::vector<long long> table(1 << PERFTEST_COLUMNAR_LZ_HASH_BITS, -1);
+    std::string output;
+    size_t anchor = 0;
+    size_t position = 0;
+
+    while (position + PERFTEST_COLUMNAR_LZ_MIN_MATCH <= size) {
+        unsigned int word;
+        memcpy(&word, in + position, sizeof(word));
+        unsigned int hash = (word * 2654435761U)
+                >> (32 - PERFTEST_COLUMNAR_LZ_HASH_BITS);
+        long long candidate = table[hash];
+        table[hash] = (long long) position;
+
+        if (candidate < 0
+                || position - (size_t) candidate > PERFTEST_COLUMNAR_LZ_WINDOW
+                || memcmp(in + candidate,
+                          in + position,
+                          PERFTEST_COLUMNAR_LZ_MIN_MATCH) != 0) {
+            position++;
+            continue;
+        }
+
+        size_t length = PERFTEST_COLUMNAR_LZ_MIN_MATCH;
+        while (position + length < size
+                && in[(size_t) candidate + length] == in[position + length]) {
+            length++;
+        }
+        put_varint(output, position - anchor);
+        output.append(input, anchor, position - anchor);
+        put_varint(output, length);
+        put_varint(output, position - (size_t) candidate);
+        position += length;
+        anchor = position;
+    }
+
+    put_varint(output, size - anchor);
+    output.append(input, anchor, size - anchor);
+    return output;
+}
+
+static bool lz_decompress(
+        const std::string &input,
+        size_t rawSize,
+        std::string &output)
+{
+    ColumnarDecoder decoder(input);
+    output.clear();
+    output.reserve(rawSize);
+
+    while (true) {
+        unsigned long long literals = decoder.get_varint();
+        if (!decoder.has(literals) || output.size() + literals > rawSize) {
+            return false;
+        }
+        output.append(
+                (const char *) decoder.data + decoder.position,
+                (size_t) literals);
+        decoder.position += (size_t) literals;
+        if (output.size() == rawSize) {
+            return decoder.finished();
+        }
+
+        unsigned long long length = decoder.get_varint();
+        unsigned long long offset = decoder.get_varint();
+        if (decoder.failed || offset == 0 || offset > output.size()
+                || output.size() + length > rawSize) {
+            return false;
+        }
+        // Byte by byte, the match may overlap the bytes it writes
+        size_t from = output.size() - (size_t) offset;
+        for (unsigned long long i = 0; i < length; i++) {
+            output.push_back(output[from + (size_t) i]);
+        }
+    }
+}
+
+/******************************************************************************/
+/* Columns                                                                    */
+/******************************************************************************/
+
+PerftestColumn::PerftestColumn(const std::string &name, PerftestColumnType type)
+        : name(name), type(type)
+{
+}
+
+size_t PerftestColumn::size() const
+{
+    switch (type) {
+    case PERFTEST_COLUMN_INT64:
+        return ints.size();
+    case PERFTEST_COLUMN_DOUBLE:
+        return doubles.size();
+    default:
+        return strings.size();
+    }
+}
+
+void PerftestColumn::add_empty()
+{
+    switch (type) {
+    case PERFTEST_COLUMN_INT64:
+        ints.push_back(0);
+        break;
+    case PERFTEST_COLUMN_DOUBLE:
+        doubles.push_back(0);
+        break;
+    default:
+        strings.push_back("");
+        break;
+    }
+}
+
+std::string PerftestColumn::to_string(size_t row) const
+{
+    char buffer[64];
+    switch (type) {
+    case PERFTEST_COLUMN_INT64:
+        snprintf(buffer, sizeof(buffer), "%lld", ints[row]);
+        return buffer;
+    case PERFTEST_COLUMN_DOUBLE:
+        snprintf(buffer, sizeof(buffer), "%.15g", doubles[row]);
+        return buffer;
+    default:
+        return strings[row];
+    }
+}
+
+static std::string encode_column(const PerftestColumn &column)
+{
+    std::string buffer;
+    switch (column.type) {
+    case PERFTEST_COLUMN_INT64: {
+        // Zigzag of the delta, so slowly changing counters take one byte
+        unsigned long long previous = 0;
+        for (size_t i = 0; i < column.ints.size(); i++) {
+            unsigned long long value = (unsigned long long) column.ints[i];
+            long long delta = (long long) (value - previous);
+            put_varint(buffer,
+                    ((unsigned long long) delta << 1)
+                            ^ (unsigned long long) (delta >> 63));
+            previous = value;
+        }
+        break;
+    }
+    case PERFTEST_COLUMN_DOUBLE:
+        for (size_t i = 0; i < column.doubles.size(); i++) {
+            unsigned long long bits;
+            memcpy(&bits, &column.doubles[i], sizeof(bits));
+            put_uint(buffer, bits, 8);
+        }
+        break;
+    default: {
+        std::map<std::string, unsigned long long> indexes;
+        std::vector<const std::string *> dictionary;
+        std::string values;
+        for (size_t i = 0; i < column.strings.size(); i++) {
+            std::map<std::string, unsigned long long>::iterator it =
+                    indexes.find(column.strings[i]);
+            if (it == indexes.end()) {
+                it = indexes.insert(std::make_pair(
+                        column.strings[i],
+                        (unsigned long long) dictionary.size())).first;
+                dictionary.push_back(&it->first);
+            }
+            put_varint(values, it->second);
+        }
+        put_varint(buffer, dictionary.size());
+        for (size_t i = 0; i < dictionary.size(); i++) {
+            put_string(buffer, *dictionary[i]);
+        }
+        buffer += values;
+        break;
+    }
+    }
+    return buffer;
+}
+
+static bool decode_column(
+        const std::string &buffer,
+        unsigned int rows,
+        PerftestColumn &column)
+{
+    ColumnarDecoder decoder(buffer);
+    switch (column.type) {
+    case PERFTEST_COLUMN_INT64: {
+        unsigned long long previous = 0;
+        for (unsigned int i = 0; i < rows; i++) {
+            unsigned long long zigzag = decoder.get_varint();
+            unsigned long long delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+            previous += delta;
+            column.ints.push_back((long long) previous);
+        }
+        break;
+    }
+    case PERFTEST_COLUMN_DOUBLE:
+        for (unsigned int i = 0; i < rows; i++) {
+            unsigned long long bits = decoder.get_uint(8);
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            column.doubles.push_back(value);
+        }
+        break;
+    case PERFTEST_COLUMN_STRING: {
+        unsigned long long count = decoder.get_varint();
+        std::vector<std::string> dictionary;
+        for (unsigned long long i = 0; i < count && !decoder.failed; i++) {
+            dictionary.push_back(decoder.get_string());
+        }
+        for (unsigned int i = 0; i < rows; i++) {
+            unsigned long long index = decoder.get_varint();
+            if (index >= dictionary.size()) {
+                return false;
+            }
+            column.strings.push_back(dictionary[(size_t) index]);
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    return !decoder.failed && decoder.finished();
+}
+
+/******************************************************************************/
+/* Tables                                                                     */
+/******************************************************************************/
+
+PerftestColumnarTable::PerftestColumnarTable(
+        const std::string &name,
+        unsigned long long runId)
+        : _name(name), _runId(runId), _rows(0)
+{
+}
+
+int PerftestColumnarTable::find_column(const std::string &column) const
+{
+    for (unsigned int i = 0; i < _columns.size(); i++) {
+        if (_columns[i].name == column) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+PerftestColumn &PerftestColumnarTable::get_column(
+        const std::string &column,
+        PerftestColumnType type)
+{
+    int index = find_column(column);
+    if (index < 0) {
+        _columns.push_back(PerftestColumn(column, type));
+        index = (int) _columns.size() - 1;
+    }
+    // Fill the previous rows that did not set the column
+    PerftestColumn &result = _columns[index];
+    while (result.size() < _rows) {
+        result.add_empty();
+    }
+    return result;
+}
+
+void PerftestColumnarTable::set_int(const std::string &column, long long value)
+{
+    PerftestColumn &result = get_column(column, PERFTEST_COLUMN_INT64);
+    if (result.type == PERFTEST_COLUMN_INT64 && result.size() == _rows) {
+        result.ints.push_back(value);
+    }
+}
+
+void PerftestColumnarTable::set_double(const std::string &column, double value)
+{
+    PerftestColumn &result = get_column(column, PERFTEST_COLUMN_DOUBLE);
+    if (result.type == PERFTEST_COLUMN_DOUBLE && result.size() == _rows) {
+        result.doubles.push_back(value);
+    }
+}
+
+void PerftestColumnarTable::set_string(
+        const std::string &column,
+        const std::string &value)
+{
+    PerftestColumn &result = get_column(column, PERFTEST_COLUMN_STRING);
+    if (result.type == PERFTEST_COLUMN_STRING && result.size() == _rows) {
+        result.strings.push_back(value);
+    }
+}
+
+void PerftestColumnarTable::end_row()
+{
+    _rows++;
+    for (unsigned int i = 0; i < _columns.size(); i++) {
+        while (_columns[i].size() < _rows) {
+            _columns[i].add_empty();
+        }
+    }
+}
+
+void PerftestColumnarTable::clear()
+{
+    _rows = 0;
+    for (unsigned int i = 0; i < _columns.size(); i++) {
+        _columns[i].ints.clear();
+        _columns[i].doubles.clear();
+        _columns[i].strings.clear();
+    }
+}
+
+bool PerftestColumnarTable::write(FILE *file) const
+{
+    std::string body;
+    put_uint(body, _runId, 8);
+    put_string(body, _name);
+    put_uint(body, _rows, 4);
+    put_uint(body, _columns.size(), 4);
+    for (unsigned int i = 0; i < _columns.size(); i++) {
+        std::string raw = encode_column(_columns[i]);
+        std::string compressed = lz_compress(raw);
+        bool useCompression = compressed.size() < raw.size();
+        const std::string &data = useCompression ? compressed : raw;
+
+        put_string(body, _columns[i].name);
+        put_u8(body, (unsigned char) _columns[i].type);
+        put_u8(body,
+                useCompression ? PERFTEST_COLUMN_LZ
+                               : PERFTEST_COLUMN_UNCOMPRESSED);
+        put_uint(body, raw.size(), 4);
+        put_uint(body, data.size(), 4);
+        body += data;
+    }
+
+    std::string block;
+    put_uint(block, PERFTEST_COLUMNAR_MAGIC, 4);
+    put_uint(block, PERFTEST_COLUMNAR_VERSION, 2);
+    put_uint(block, 0, 2);
+    put_uint(block, body.size(), 4);
+    block += body;
+
+    // In one write, so the blocks of runs appending to the same file do not mix
+    if (fwrite(block.data(), 1, block.size(), file) != block.size()) {
+        return false;
+    }
+    return fflush(file) == 0;
+}
+
+bool PerftestColumnarTable::read(FILE *file, std::string &error)
+{
+    error.clear();
+    _name.clear();
+    _runId = 0;
+    _rows = 0;
+    _columns.clear();
+
+    std::string header(PERFTEST_COLUMNAR_HEADER_SIZE, '\0');
+    size_t headerSize = fread(&header[0], 1, header.size(), file);
+    if (headerSize == 0 && feof(file)) {
+        return false;
+    }
+    if (headerSize != header.size()) {
+        error = "truncated block header";
+        return false;
+    }
+    ColumnarDecoder headerDecoder(header);
+    if (headerDecoder.get_uint(4) != PERFTEST_COLUMNAR_MAGIC) {
+        error = "not a columnar file";
+        return false;
+    }
+    unsigned long long version = headerDecoder.get_uint(2);
+    if (version > PERFTEST_COLUMNAR_VERSION) {
+        error = "unsupported version " + std::to_string(version);
+        return false;
+    }
+    headerDecoder.get_uint(2);
+    std::string body((size_t) headerDecoder.get_uint(4), '\0');
+    if (!body.empty() && fread(&body[0], 1, body.size(), file) != body.size()) {
+        error = "truncated block";
+        return false;
+    }
+
+    ColumnarDecoder decoder(body);
+    _runId = decoder.get_uint(8);
+    _name = decoder.get_string();
+    _rows = (unsigned int) decoder.get_uint(4);
+    unsigned long long columns = decoder.get_uint(4);
+    for (unsigned long long i = 0; i < columns && !decoder.failed; i++) {
+        std::string name = decoder.get_string();
+        unsigned long long type = decoder.get_uint(1);
+        unsigned long long compression = decoder.get_uint(1);
+        unsigned long long rawSize = decoder.get_uint(4);
+        unsigned long long size = decoder.get_uint(4);
+        if (!decoder.has(size)) {
+            break;
+        }
+        std::string data(
+                (const char *) decoder.data + decoder.position,
+                (size_t) size);
+        decoder.position += (size_t) size;
+
+        if (compression == PERFTEST_COLUMN_LZ) {
+            std::string raw;
+            if (!lz_decompress(data, (size_t) rawSize, raw)) {
+                error = "corrupted column " + name + " of " + _name;
+                return false;
+            }
+            data.swap(raw);
+        } else if (compression != PERFTEST_COLUMN_UNCOMPRESSED
+                || rawSize != size) {
+            error = "unknown compression of column " + name + " of " + _name;
+            return false;
+        }
+
+        _columns.push_back(PerftestColumn(name, (PerftestColumnType) type));
+        if (!decode_column(data, _rows, _columns.back())) {
+            error = "corrupted column " + name + " of " + _name;
+            return false;
+        }
+    }
+    if (decoder.failed || !decoder.finished()) {
+        error = "corrupted block of " + _name;
+        return false;
+    }
+    return true;
+}
+
+/******************************************************************************/
+/* Files                                                                      */
+/******************************************************************************/
+
+bool PerftestColumnarStore_read_file(
+        const std::string &fileName,
+        std::vector<PerftestColumnarTable> &blocks)
+{
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (file == NULL) {
+        fprintf(stderr,
+                "[PerftestColumnarStore] Error: Cannot open %s.\n",
+                fileName.c_str());
+        return false;
+    }
+
+    std::string error;
+    PerftestColumnarTable table;
+    while (table.read(file, error)) {
+        blocks.push_back(table);
+    }
+    fclose(file);
+
+    if (!error.empty()) {
+        fprintf(stderr,
+                "[PerftestColumnarStore] Error: %s: %s after %u blocks.\n",
+                fileName.c_str(),
+                error.c_str(),
+                (unsigned int) blocks.size());
+        return false;
+    }
+    return true;
+}
+
+unsigned long long PerftestColumnarStore_new_run_id()
+{
+    std::random_device device;
+    unsigned long long now = (unsigned long long)
+            std::chrono::system_clock::now().time_since_epoch().count();
+    return (now * 6364136223846793005ULL)
+            ^ ((unsigned long long) device() << 32) ^ device();
+}
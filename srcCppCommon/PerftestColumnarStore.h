@@ -0,0 +1,128 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#ifndef __PERFTEST_COLUMNAR_STORE_H__
+#define __PERFTEST_COLUMNAR_STORE_H__
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+ * Columnar binary format of "-outputFormat columnar", read by the
+ * perftest_columnar tool. It only depends on the C++ standard library.
+ *
+ * A file is a sequence of self-describing blocks. Every block holds some rows
+ * of one table of one run, so a file can be appended by any number of runs
+ * (one per configuration of a sweep) and a run can write a table in several
+ * blocks. All the integers are little endian.
+ *
+ *   magic (u32) | version (u16) | reserved (u16) | size (u32, rest of block)
+ *   runId (u64) | table name | rows (u32) | columns (u32)
+ *   for each column:
+ *     name | type (u8) | compression (u8) | raw size (u32) | size (u32)
+ *     data (size bytes)
+ *
+ * Names are a varint length followed by the characters. The data of a column
+ * is encoded by type and then compressed:
+ *   - INT64: zigzag varints of the difference with the previous row.
+ *   - DOUBLE: the 8 bytes of every value.
+ *   - STRING: a dictionary (varint count, names) and the varint index of the
+ *     value of every row.
+ * The compression is a byte-oriented LZ77 (see PerftestColumnarStore.cxx), it
+ * is only used if it makes the column smaller.
+ */
+#define PERFTEST_COLUMNAR_MAGIC 0x4c4f4350 /* "PCOL" */
+#define PERFTEST_COLUMNAR_VERSION 1
+
+/* Rows kept in memory per table before they are written as a block */
+#define PERFTEST_COLUMNAR_BLOCK_ROWS 4096
+
+enum PerftestColumnType {
+    PERFTEST_COLUMN_INT64 = 0,
+    PERFTEST_COLUMN_DOUBLE = 1,
+    PERFTEST_COLUMN_STRING = 2
+};
+
+enum PerftestColumnCompression {
+    PERFTEST_COLUMN_UNCOMPRESSED = 0,
+    PERFTEST_COLUMN_LZ = 1
+};
+
+struct PerftestColumn {
+    std::string name;
+    PerftestColumnType type;
+    // Only the vector of the type is used
+    std::vector<long long> ints;
+    std::vector<double> doubles;
+    std::vector<std::string> strings;
+
+    PerftestColumn(const std::string &name, PerftestColumnType type);
+
+    size_t size() const;
+
+    // Add the default value (0 or "") of the type
+    void add_empty();
+
+    std::string to_string(size_t row) const;
+};
+
+/*
+ * Rows of a table of one run. The columns are created the first time they are
+ * set, the rows that did not set a column get the default value of its type.
+ */
+class PerftestColumnarTable {
+  public:
+    PerftestColumnarTable(
+            const std::string &name = "",
+            unsigned long long runId = 0);
+
+    void set_int(const std::string &column, long long value);
+    void set_double(const std::string &column, double value);
+    void set_string(const std::string &column, const std::string &value);
+
+    // Close the current row
+    void end_row();
+
+    // Remove the rows, keeping the columns
+    void clear();
+
+    const std::string &get_name() const { return _name; }
+    unsigned long long get_run_id() const { return _runId; }
+    unsigned int get_rows() const { return _rows; }
+    const std::vector<PerftestColumn> &get_columns() const { return _columns; }
+
+    // Index of the column, -1 if it does not exist
+    int find_column(const std::string &column) const;
+
+    /* Append the rows as a block, false on errors */
+    bool write(FILE *file) const;
+
+    /*
+     * Read the next block of the file. Returns false at the end of the file
+     * or on errors; "error" is empty at the end of the file.
+     */
+    bool read(FILE *file, std::string &error);
+
+  private:
+    PerftestColumn &get_column(
+            const std::string &column,
+            PerftestColumnType type);
+
+    std::string _name;
+    unsigned long long _runId;
+    unsigned int _rows;
+    std::vector<PerftestColumn> _columns;
+};
+
+/* Read all the blocks of a file, false on errors */
+bool PerftestColumnarStore_read_file(
+        const std::string &fileName,
+        std::vector<PerftestColumnarTable> &blocks);
+
+/* A random id for a run, to tell apart the blocks of the runs of a file */
+unsigned long long PerftestColumnarStore_new_run_id();
+
+#endif // __PERFTEST_COLUMNAR_STORE_H__
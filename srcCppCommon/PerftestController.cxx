@@ -0,0 +1,544 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestController.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include "PerftestJsonReader.h"
+#include "ThreadCPUAffinity.h"
+#ifdef RTI_UNIX
+  #include <fcntl.h>
+  #include <poll.h>
+  #include <signal.h>
+  #include <unistd.h>
+  #include <sys/types.h>
+  #include <sys/wait.h>
+#endif
+#ifdef RTI_LINUX
+  #include <sched.h>
+#endif
+
+PerftestControllerChild::PerftestControllerChild(bool publisher, int id)
+        : publisher(publisher),
+          id(id),
+          pid(-1),
+          outputFd(-1),
+          exited(false),
+          exitCode(0)
+{
+}
+
+std::string PerftestControllerChild::get_name() const
+{
+    std::ostringstream name;
+    name << (publisher ? "Publisher " : "Subscriber ") << id;
+    return name.str();
+}
+
+PerftestControllerResult::PerftestControllerResult()
+        : latency(false),
+          packetsPerSecond(0),
+          mbps(0),
+          lost(0),
+          lostPercent(0),
+          latencyAve(0),
+          latency50(0),
+          latency90(0),
+          latency99(0),
+          latency9999(0)
+{
+}
+
+static std::string cores_to_string(const std::vector<int> &cores)
+{
+    if (cores.empty()) {
+        return "-";
+    }
+    std::ostringstream result;
+    for (unsigned int i = 0; i < cores.size(); i++) {
+        result << (i > 0 ? "," : "") << cores[i];
+    }
+    return result.str();
+}
+
+PerftestController::PerftestController(ParameterManager &PM) : _PM(PM)
+{
+}
+
+int PerftestController::run(int argc, char *argv[])
+{
+  #ifdef RTI_UNIX
+    if (!plan_children()) {
+        return -1;
+    }
+
+    fprintf(stderr,
+            "Controller: launching %d subscriber(s) and %d publisher(s)\n",
+            _PM.get<int>("numSubscribers"),
+            _PM.get<int>("numPublishers"));
+    for (unsigned int i = 0; i < _children.size(); i++) {
+        std::vector<std::string> arguments =
+                get_child_arguments(argc, argv, _children[i]);
+        if (!launch(_children[i], arguments)) {
+            terminate_children();
+            wait_for_children();
+            return -1;
+        }
+        fprintf(stderr,
+                "Controller: %s started (pid %d, cores %s)\n",
+                _children[i].get_name().c_str(),
+                _children[i].pid,
+                cores_to_string(_children[i].cores).c_str());
+    }
+
+    bool succeeded = wait_for_children();
+    print_report();
+    return succeeded ? 0 : -1;
+  #else
+    (void) argc;
+    (void) argv;
+    fprintf(stderr,
+            "[PerftestController] Error: -controller is only available on "
+            "Unix systems.\n");
+    return -1;
+  #endif
+}
+
+/*
+ * The subscribers are launched first, so they are already waiting when the
+ * publishers look for them in the announcement topic.
+ */
+bool PerftestController::plan_children()
+{
+    for (int i = 0; i < _PM.get<int>("numSubscribers"); i++) {
+        _children.push_back(PerftestControllerChild(false, i));
+    }
+    for (int i = 0; i < _PM.get<int>("numPublishers"); i++) {
+        _children.push_back(PerftestControllerChild(true, i));
+    }
+
+    if (!_PM.is_set("controllerCores")) {
+        return true;
+    }
+  #ifdef RTI_LINUX
+    std::vector<int> cores;
+    try {
+        cores = ThreadCPUAffinity::parse_core_list(
+                _PM.get<std::string>("controllerCores"));
+    } catch (std::exception &) {
+        cores.clear();
+    }
+    if (cores.empty()) {
+        fprintf(stderr,
+                "[PerftestController] Error: Cannot parse the core list "
+                "'%s'.\n",
+                _PM.get<std::string>("controllerCores").c_str());
+        return false;
+    }
+
+    // The same number of cores for every child, or a core shared by several
+    size_t coresPerChild = std::max(cores.size() / _children.size(),
+                                    (size_t) 1);
+    for (size_t i = 0; i < _children.size(); i++) {
+        for (size_t j = 0; j < coresPerChild; j++) {
+            _children[i].cores.push_back(
+                    cores[(i * coresPerChild + j) % cores.size()]);
+        }
+    }
+    if (cores.size() < _children.size()) {
+        fprintf(stderr,
+                "Controller: %lu cores for %lu processes, some cores are "
+                "shared.\n",
+                (unsigned long) cores.size(),
+                (unsigned long) _children.size());
+    }
+    return true;
+  #else
+    fprintf(stderr,
+            "[PerftestController] Error: -controllerCores is only available "
+            "on Linux.\n");
+    return false;
+  #endif
+}
+
+/*
+ * The command line of the controller without -controller and
+ * -controllerCores, plus the role and the output of the child.
+ */
+std::vector<std::string> PerftestController::get_child_arguments(
+        int argc,
+        char *argv[],
+        const PerftestControllerChild &child)
+{
+    // The options of the other side would be rejected by the child
+    std::vector<std::string> commandLine = _PM.remove_group_arguments(
+            argc,
+            argv,
+            child.publisher ? SUB : PUB);
+
+    std::vector<std::string> arguments;
+    arguments.push_back(commandLine[0]);
+    for (unsigned int i = 1; i < commandLine.size(); i++) {
+        const char *argument = commandLine[i].c_str();
+        // Same matching as ParameterManager::parse(), -controller goes first
+        if (IS_OPTION(argument, "-controller")
+                && strlen(argument) <= strlen("-controller")) {
+            continue;
+        }
+        if (IS_OPTION(argument, "-controllerCores")) {
+            i++;
+            continue;
+        }
+        arguments.push_back(commandLine[i]);
+    }
+
+    std::ostringstream id;
+    id << child.id;
+    arguments.push_back(child.publisher ? "-pub" : "-sub");
+    arguments.push_back(
+            child.publisher ? "-pidMultiPubTest" : "-sidMultiSubTest");
+    arguments.push_back(id.str());
+    arguments.push_back("-outputFormat");
+    arguments.push_back("json");
+    return arguments;
+}
+
+bool PerftestController::launch(
+        PerftestControllerChild &child,
+        const std::vector<std::string> &arguments)
+{
+  #ifdef RTI_UNIX
+    int fds[2];
+    if (pipe(fds) != 0) {
+        fprintf(stderr,
+                "[PerftestController] Error: Cannot create the pipe of %s "
+                "(errno %d).\n",
+                child.get_name().c_str(),
+                errno);
+        return false;
+    }
+    // The children launched later must not keep the pipe open
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+    // Otherwise the buffered output would be printed by the child too
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr,
+                "[PerftestController] Error: Cannot create the process of %s "
+                "(errno %d).\n",
+                child.get_name().c_str(),
+                errno);
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+
+      #ifdef RTI_LINUX
+        if (!child.cores.empty()) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            for (unsigned int i = 0; i < child.cores.size(); i++) {
+                CPU_SET(child.cores[i], &cpuSet);
+            }
+            if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+                fprintf(stderr,
+                        "[PerftestController] Error: Cannot pin %s to cores "
+                        "%s (errno %d).\n",
+                        child.get_name().c_str(),
+                        cores_to_string(child.cores).c_str(),
+                        errno);
+                _exit(127);
+            }
+        }
+      #endif
+
+        std::vector<char *> childArgv;
+        for (unsigned int i = 0; i < arguments.size(); i++) {
+            childArgv.push_back(const_cast<char *>(arguments[i].c_str()));
+        }
+        childArgv.push_back(NULL);
+        execvp(childArgv[0], &childArgv[0]);
+        fprintf(stderr,
+                "[PerftestController] Error: Cannot run %s for %s "
+                "(errno %d).\n",
+                childArgv[0],
+                child.get_name().c_str(),
+                errno);
+        _exit(127);
+    }
+
+    close(fds[1]);
+    child.pid = (int) pid;
+    child.outputFd = fds[0];
+    return true;
+  #else
+    (void) child;
+    (void) arguments;
+    return false;
+  #endif
+}
+
+/*
+ * Read the outputs until all the children are done. Returns false if any of
+ * them failed; the rest are terminated then, as they would wait forever for
+ * the one that failed.
+ */
+bool PerftestController::wait_for_children()
+{
+  #ifdef RTI_UNIX
+    bool succeeded = true;
+    while (true) {
+        std::vector<struct pollfd> fds;
+        std::vector<unsigned int> owners;
+        for (unsigned int i = 0; i < _children.size(); i++) {
+            if (_children[i].outputFd >= 0) {
+                struct pollfd fd;
+                fd.fd = _children[i].outputFd;
+                fd.events = POLLIN;
+                fd.revents = 0;
+                fds.push_back(fd);
+                owners.push_back(i);
+            }
+        }
+
+        if (!fds.empty()
+                && poll(&fds[0], fds.size(), PERFTEST_CONTROLLER_POLL_MSEC)
+                        > 0) {
+            for (unsigned int i = 0; i < fds.size(); i++) {
+                if (fds[i].revents == 0) {
+                    continue;
+                }
+                PerftestControllerChild &child = _children[owners[i]];
+                char buffer[4096];
+                ssize_t size = read(child.outputFd, buffer, sizeof(buffer));
+                if (size > 0) {
+                    child.output.append(buffer, (size_t) size);
+                } else if (size == 0 || errno != EINTR) {
+                    close(child.outputFd);
+                    child.outputFd = -1;
+                }
+            }
+        }
+
+        bool running = false;
+        for (unsigned int i = 0; i < _children.size(); i++) {
+            PerftestControllerChild &child = _children[i];
+            if (child.pid < 0 || child.exited) {
+                continue;
+            }
+            int status = 0;
+            pid_t result = waitpid(
+                    (pid_t) child.pid,
+                    &status,
+                    fds.empty() ? 0 : WNOHANG);
+            if (result == 0) {
+                running = true;
+                continue;
+            }
+            child.exited = true;
+            child.exitCode = result < 0
+                    ? -1
+                    : WIFEXITED(status) ? WEXITSTATUS(status)
+                                        : 128 + WTERMSIG(status);
+            if (child.exitCode != 0 && succeeded) {
+                fprintf(stderr,
+                        "[PerftestController] Error: %s failed (exit code "
+                        "%d), terminating the test.\n",
+                        child.get_name().c_str(),
+                        child.exitCode);
+                succeeded = false;
+                terminate_children();
+            }
+        }
+
+        if (!running && fds.empty()) {
+            return succeeded;
+        }
+    }
+  #else
+    return false;
+  #endif
+}
+
+void PerftestController::terminate_children()
+{
+  #ifdef RTI_UNIX
+    for (unsigned int i = 0; i < _children.size(); i++) {
+        if (_children[i].pid >= 0 && !_children[i].exited) {
+            kill((pid_t) _children[i].pid, SIGTERM);
+        }
+    }
+  #endif
+}
+
+/* The summaries of every data length in the JSON output of the child */
+bool PerftestController::parse_output(
+        const PerftestControllerChild &child,
+        std::vector<std::pair<int, PerftestControllerResult> > &results)
+{
+    size_t position = child.output.find("{\"perftest\"");
+    if (position == std::string::npos) {
+        return false;
+    }
+    JsonParser parser(child.output, position);
+    JsonValue document;
+    const JsonValue *tests = NULL;
+    if (!parser.parse(document)
+            || (tests = document.get("perftest")) == NULL
+            || tests->type != JsonValue::JSON_ARRAY) {
+        return false;
+    }
+
+    for (size_t i = 0; i < tests->items.size(); i++) {
+        const JsonValue *length = tests->items[i].get("length");
+        const JsonValue *summary = tests->items[i].get("summary");
+        if (length == NULL || summary == NULL) {
+            continue;
+        }
+        const char *names[] = {
+            "packets/sAve", "mbpsAve", "lost", "lostPercent", "latency_ave",
+            "latency_50", "latency_90", "latency_99", "latency_99.99"
+        };
+        double values[sizeof(names) / sizeof(names[0])] = {0};
+        for (size_t j = 0; j < sizeof(names) / sizeof(names[0]); j++) {
+            const JsonValue *value = summary->get(names[j]);
+            if (value != NULL && value->type == JsonValue::JSON_NUMBER) {
+                values[j] = value->number;
+            }
+        }
+
+        PerftestControllerResult result;
+        result.latency = summary->get("latency_ave") != NULL;
+        result.packetsPerSecond = values[0];
+        result.mbps = values[1];
+        result.lost = values[2];
+        result.lostPercent = values[3];
+        result.latencyAve = values[4];
+        result.latency50 = values[5];
+        result.latency90 = values[6];
+        result.latency99 = values[7];
+        result.latency9999 = values[8];
+        results.push_back(
+                std::make_pair((int) length->number, result));
+    }
+    return true;
+}
+
+void PerftestController::print_report()
+{
+    // Results of every child for every data length
+    std::map<int, std::vector<std::pair<unsigned int,
+                                        PerftestControllerResult> > >
+            lengths;
+    for (unsigned int i = 0; i < _children.size(); i++) {
+        std::vector<std::pair<int, PerftestControllerResult> > results;
+        if (!parse_output(_children[i], results)) {
+            if (!_children[i].publisher || _children[i].id == 0) {
+                fprintf(stderr,
+                        "Controller: No JSON output from %s.\n",
+                        _children[i].get_name().c_str());
+            }
+            continue;
+        }
+        for (unsigned int j = 0; j < results.size(); j++) {
+            lengths[results[j].first].push_back(
+                    std::make_pair(i, results[j].second));
+        }
+    }
+
+    const int numPublishers = _PM.get<int>("numPublishers");
+    const int numSubscribers = _PM.get<int>("numSubscribers");
+    printf("\nController report: %d publisher(s) -> %d subscriber(s)\n",
+           numPublishers,
+           numSubscribers);
+    printf("%-15s %6s %9s %s\n", "Process", "Pid", "Exit Code", "Cores");
+    for (unsigned int i = 0; i < _children.size(); i++) {
+        printf("%-15s %6d %9d %s\n",
+               _children[i].get_name().c_str(),
+               _children[i].pid,
+               _children[i].exitCode,
+               cores_to_string(_children[i].cores).c_str());
+    }
+
+    std::map<int, std::vector<std::pair<unsigned int,
+                                        PerftestControllerResult> > >
+            ::iterator it;
+    for (it = lengths.begin(); it != lengths.end(); it++) {
+        printf("\nLength: %d bytes\n", it->first);
+
+        double totalPackets = 0;
+        double totalMbps = 0;
+        double totalLost = 0;
+        double minPackets = 0;
+        double maxPackets = 0;
+        int subscribers = 0;
+        for (unsigned int i = 0; i < it->second.size(); i++) {
+            const PerftestControllerChild &child =
+                    _children[it->second[i].first];
+            const PerftestControllerResult &result = it->second[i].second;
+            if (result.latency) {
+                printf("  %-13s Latency (us) Ave %10.2f  50%% %10.2f  "
+                       "90%% %10.2f  99%% %10.2f  99.99%% %10.2f\n",
+                       child.get_name().c_str(),
+                       result.latencyAve,
+                       result.latency50,
+                       result.latency90,
+                       result.latency99,
+                       result.latency9999);
+                continue;
+            }
+            printf("  %-13s Packets/s %12.0f  Mbps %10.1f  Lost %10.0f "
+                   "(%1.2f%%)\n",
+                   child.get_name().c_str(),
+                   result.packetsPerSecond,
+                   result.mbps,
+                   result.lost,
+                   result.lostPercent);
+            if (subscribers == 0 || result.packetsPerSecond < minPackets) {
+                minPackets = result.packetsPerSecond;
+            }
+            if (subscribers == 0 || result.packetsPerSecond > maxPackets) {
+                maxPackets = result.packetsPerSecond;
+            }
+            totalPackets += result.packetsPerSecond;
+            totalMbps += result.mbps;
+            totalLost += result.lost;
+            subscribers++;
+        }
+        if (subscribers == 0) {
+            continue;
+        }
+
+        // Every subscriber receives the samples of every publisher
+        printf("  Fan-out: %d subscriber(s) received %.0f packets/s "
+               "(%.1f Mbps) in total, %.0f lost\n",
+               subscribers,
+               totalPackets,
+               totalMbps,
+               totalLost);
+        printf("           per subscriber: min %.0f  ave %.0f  max %.0f "
+               "packets/s\n",
+               minPackets,
+               totalPackets / subscribers,
+               maxPackets);
+        printf("  Fan-in:  %.0f packets/s per publisher received by every "
+               "subscriber\n",
+               totalPackets / subscribers / numPublishers);
+    }
+    fflush(stdout);
+}
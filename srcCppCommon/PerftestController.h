@@ -0,0 +1,98 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#ifndef __PERFTEST_CONTROLLER_H__
+#define __PERFTEST_CONTROLLER_H__
+
+#include <string>
+#include <vector>
+#include "ParameterManager.h"
+
+/* Time the controller waits for the outputs before checking the children */
+#define PERFTEST_CONTROLLER_POLL_MSEC 500
+
+/* A publisher or subscriber process launched by the controller */
+struct PerftestControllerChild {
+    bool publisher;
+    // -pidMultiPubTest or -sidMultiSubTest
+    int id;
+    // Cores the process is pinned to, empty if not pinned
+    std::vector<int> cores;
+
+    int pid;
+    // Read end of the pipe with the standard output of the process
+    int outputFd;
+    std::string output;
+    bool exited;
+    int exitCode;
+
+    PerftestControllerChild(bool publisher, int id);
+
+    std::string get_name() const;
+};
+
+/* Summary of a data length in the JSON output of a child */
+struct PerftestControllerResult {
+    bool latency;
+    // Throughput
+    double packetsPerSecond;
+    double mbps;
+    double lost;
+    double lostPercent;
+    // Latency, in us
+    double latencyAve;
+    double latency50;
+    double latency90;
+    double latency99;
+    double latency9999;
+
+    PerftestControllerResult();
+};
+
+/*
+ * Orchestrated run of a -numPublishers/-numSubscribers test (-controller).
+ *
+ * The controller does not join the test: it launches every subscriber and
+ * then every publisher as a child process of this one, with the rest of the
+ * command line plus -pub/-sub, -pidMultiPubTest/-sidMultiSubTest and
+ * "-outputFormat json". The children find each other as usual, the
+ * publishers do not start sending until all the subscribers are announced in
+ * the announcement topic. With -controllerCores, the list is split among the
+ * children and every child (all its threads) is pinned to its part.
+ *
+ * The standard output of every child goes to a pipe. When all of them are
+ * done, their JSON summaries are aggregated per data length: the throughput
+ * of every subscriber, the total (fan-out) and the share of every publisher
+ * (fan-in), and the latency measured by publisher 0. If a child fails, the
+ * others are terminated.
+ */
+class PerftestController {
+  public:
+    PerftestController(ParameterManager &PM);
+
+    /* Run the test with the command line of the controller */
+    int run(int argc, char *argv[]);
+
+  private:
+    bool plan_children();
+    std::vector<std::string> get_child_arguments(
+            int argc,
+            char *argv[],
+            const PerftestControllerChild &child);
+    bool launch(
+            PerftestControllerChild &child,
+            const std::vector<std::string> &arguments);
+    bool wait_for_children();
+    void terminate_children();
+    bool parse_output(
+            const PerftestControllerChild &child,
+            std::vector<std::pair<int, PerftestControllerResult> > &results);
+    void print_report();
+
+    ParameterManager &_PM;
+    std::vector<PerftestControllerChild> _children;
+};
+
+#endif // __PERFTEST_CONTROLLER_H__
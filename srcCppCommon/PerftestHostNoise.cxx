@@ -0,0 +1,294 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestHostNoise.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include "Infrastructure_common.h"
+#include "ThreadCPUAffinity.h"
+
+/* Period of the wake-ups of clock_nanosleep */
+#define PERFTEST_HOST_NOISE_WAKE_UP_PERIOD_NSEC 1000000ULL
+
+struct PerftestHostNoiseThreadInfo {
+    PerftestHostNoiseCore *core;
+    unsigned long long durationMsec;
+    unsigned long long thresholdNsec;
+    std::atomic<bool> finished;
+};
+
+PerftestHostNoiseHistogram::PerftestHostNoiseHistogram()
+        : count(0), sum(0), max(0), overThreshold(0)
+{
+    memset(buckets, 0, sizeof(buckets));
+}
+
+PerftestHostNoise::PerftestHostNoise(
+        unsigned long long durationMsec,
+        unsigned long long thresholdUsec)
+        : _durationMsec(durationMsec), _thresholdNsec(thresholdUsec * 1000)
+{
+}
+
+void PerftestHostNoise::add_core(int core, int priority, int threadOptions)
+{
+    for (unsigned int i = 0; i < _cores.size(); i++) {
+        if (_cores[i].core == core) {
+            return;
+        }
+    }
+    PerftestHostNoiseCore result;
+    result.core = core;
+    result.priority = priority;
+    result.threadOptions = threadOptions;
+    _cores.push_back(result);
+}
+
+static unsigned long long get_clock_ns()
+{
+  #ifdef RTI_PERFTEST_NANO_CLOCK
+    return PerftestClock::getInstance().getTimeNs();
+  #else
+    return PerftestClock::getInstance().getTime() * 1000;
+  #endif
+}
+
+void *PerftestHostNoise::clock_gap_thread(void *arg)
+{
+    PerftestHostNoiseThreadInfo *info =
+            static_cast<PerftestHostNoiseThreadInfo *>(arg);
+
+    if (info->core->core >= 0) {
+        ThreadCPUAffinity::set_current_thread_affinity(info->core->core);
+    }
+
+    PerftestHostNoiseHistogram &gaps = info->core->clockGaps;
+    unsigned long long last = get_clock_ns();
+    const unsigned long long end = last + info->durationMsec * 1000000;
+    while (last < end) {
+        unsigned long long now = get_clock_ns();
+        gaps.add(now - last, info->thresholdNsec);
+        last = now;
+    }
+
+    info->finished.store(true);
+    return NULL;
+}
+
+void *PerftestHostNoise::wake_up_thread(void *arg)
+{
+    PerftestHostNoiseThreadInfo *info =
+            static_cast<PerftestHostNoiseThreadInfo *>(arg);
+
+  #ifdef RTI_LINUX
+    if (info->core->core >= 0) {
+        ThreadCPUAffinity::set_current_thread_affinity(info->core->core);
+    }
+
+    PerftestHostNoiseHistogram &wakeUps = info->core->wakeUps;
+    const unsigned long long wakeUpCount = info->durationMsec * 1000000
+            / PERFTEST_HOST_NOISE_WAKE_UP_PERIOD_NSEC;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    for (unsigned long long i = 0; i < wakeUpCount; i++) {
+        deadline.tv_nsec += PERFTEST_HOST_NOISE_WAKE_UP_PERIOD_NSEC;
+        while (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+        while (clock_nanosleep(
+                       CLOCK_MONOTONIC,
+                       TIMER_ABSTIME,
+                       &deadline,
+                       NULL) != 0) {
+            // Interrupted by a signal, sleep again until the deadline
+        }
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long long late = (now.tv_sec - deadline.tv_sec) * 1000000000LL
+                + (now.tv_nsec - deadline.tv_nsec);
+        wakeUps.add(late > 0 ? (unsigned long long) late : 0,
+                info->thresholdNsec);
+    }
+  #endif
+
+    info->finished.store(true);
+    return NULL;
+}
+
+bool PerftestHostNoise::run_threads(bool wakeUps)
+{
+    std::vector<PerftestHostNoiseThreadInfo> infos(_cores.size());
+    std::vector<PerftestThread *> threads(_cores.size(), NULL);
+    bool success = true;
+
+    for (unsigned int i = 0; i < _cores.size(); i++) {
+        infos[i].core = &_cores[i];
+        infos[i].durationMsec = _durationMsec;
+        infos[i].thresholdNsec = _thresholdNsec;
+        infos[i].finished.store(false);
+
+        // The busy loop runs with the default priority so it sees the noise
+        threads[i] = PerftestThread_new(
+                wakeUps ? "HostNoiseWakeUpThread" : "HostNoiseClockThread",
+                wakeUps ? _cores[i].priority : Perftest_THREAD_PRIORITY_DEFAULT,
+                wakeUps ? _cores[i].threadOptions
+                        : Perftest_THREAD_OPTION_DEFAULT,
+                wakeUps ? wake_up_thread : clock_gap_thread,
+                &infos[i]);
+        if (threads[i] == NULL) {
+            fprintf(stderr,
+                    "[PerftestHostNoise] Error: Cannot create the thread for "
+                    "core %d.\n",
+                    _cores[i].core);
+            infos[i].finished.store(true);
+            success = false;
+        }
+    }
+
+    for (unsigned int i = 0; i < _cores.size(); i++) {
+        while (!infos[i].finished.load()) {
+            PerftestClock::milliSleep(10);
+        }
+        if (threads[i] != NULL) {
+            PerftestThread_delete(threads[i]);
+        }
+    }
+    return success;
+}
+
+bool PerftestHostNoise::run()
+{
+    if (_cores.empty()) {
+        add_core(
+                -1,
+                Perftest_THREAD_PRIORITY_DEFAULT,
+                Perftest_THREAD_OPTION_DEFAULT);
+    }
+
+    fprintf(stderr,
+            "Checking the host noise on %u core(s) for %llu ms ...\n",
+            (unsigned int) _cores.size(),
+            _durationMsec * 2);
+    fflush(stderr);
+
+    return run_threads(false) && run_threads(true);
+}
+
+bool PerftestHostNoise::is_noisy() const
+{
+    for (unsigned int i = 0; i < _cores.size(); i++) {
+        if (_cores[i].clockGaps.overThreshold > 0
+                || _cores[i].wakeUps.overThreshold > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Non-empty buckets as "<lower bound in us>: <count>" */
+static std::string get_histogram_summary(
+        const PerftestHostNoiseHistogram &histogram)
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (unsigned int i = 0; i < PERFTEST_HOST_NOISE_BUCKETS; i++) {
+        if (histogram.buckets[i] == 0) {
+            continue;
+        }
+        stream << (first ? "" : ", ")
+               << (i == 0 ? 0.0 : (double) (1ULL << i) / 1000.0) << ": "
+               << histogram.buckets[i];
+        first = false;
+    }
+    return stream.str();
+}
+
+std::string PerftestHostNoise::get_summary() const
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    stream << "\tHost Noise Check: " << _durationMsec
+           << " ms per test, threshold " << _thresholdNsec / 1000
+           << " us: " << (is_noisy() ? "NOISY" : "OK") << "\n";
+
+    for (unsigned int i = 0; i < _cores.size(); i++) {
+        const PerftestHostNoiseCore &core = _cores[i];
+        stream << "\t\tCore ";
+        if (core.core >= 0) {
+            stream << core.core;
+        } else {
+            stream << "(any)";
+        }
+        stream << ": clock gaps max " << core.clockGaps.max / 1000.0
+               << " us (" << core.clockGaps.overThreshold
+               << " over threshold)";
+        if (core.wakeUps.count > 0) {
+            stream << ", wake-ups ave "
+                   << core.wakeUps.sum / 1000.0 / core.wakeUps.count
+                   << " us, max " << core.wakeUps.max / 1000.0 << " us ("
+                   << core.wakeUps.overThreshold << " over threshold)";
+        }
+        stream << "\n\t\t\tClock gaps (us): "
+               << get_histogram_summary(core.clockGaps) << "\n";
+        if (core.wakeUps.count > 0) {
+            stream << "\t\t\tWake-ups (us): "
+                   << get_histogram_summary(core.wakeUps) << "\n";
+        }
+    }
+    return stream.str();
+}
+
+/* Non-empty buckets as [<lower bound in ns>, <count>] */
+static std::string get_histogram_json(
+        const PerftestHostNoiseHistogram &histogram)
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3)
+           << "{\"count\": " << histogram.count
+           << ", \"max_us\": " << histogram.max / 1000.0
+           << ", \"ave_us\": "
+           << (histogram.count > 0
+                       ? histogram.sum / 1000.0 / histogram.count
+                       : 0.0)
+           << ", \"over_threshold\": " << histogram.overThreshold
+           << ", \"histogram_ns\": [";
+    bool first = true;
+    for (unsigned int i = 0; i < PERFTEST_HOST_NOISE_BUCKETS; i++) {
+        if (histogram.buckets[i] == 0) {
+            continue;
+        }
+        stream << (first ? "" : ", ") << "["
+               << (i == 0 ? 0ULL : 1ULL << i) << ", "
+               << histogram.buckets[i] << "]";
+        first = false;
+    }
+    stream << "]}";
+    return stream.str();
+}
+
+std::string PerftestHostNoise::get_json() const
+{
+    std::ostringstream stream;
+    stream << "{\n\t\t\"duration_ms\": " << _durationMsec
+           << ",\n\t\t\"threshold_us\": " << _thresholdNsec / 1000
+           << ",\n\t\t\"noisy\": " << (is_noisy() ? "true" : "false")
+           << ",\n\t\t\"cores\": [";
+    for (unsigned int i = 0; i < _cores.size(); i++) {
+        stream << (i == 0 ? "" : ",") << "\n\t\t\t{\"core\": "
+               << _cores[i].core
+               << ", \"clock_gaps\": " << get_histogram_json(_cores[i].clockGaps)
+               << ", \"wake_ups\": " << get_histogram_json(_cores[i].wakeUps)
+               << "}";
+    }
+    stream << "\n\t\t]\n\t}";
+    return stream.str();
+}
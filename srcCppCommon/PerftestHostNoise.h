@@ -0,0 +1,101 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#ifndef __PERFTEST_HOST_NOISE_H__
+#define __PERFTEST_HOST_NOISE_H__
+
+#include <string>
+#include <vector>
+
+/* Bucket i counts the values in [2^i, 2^(i+1)) ns, bucket 0 also has 0 */
+#define PERFTEST_HOST_NOISE_BUCKETS 40
+
+struct PerftestHostNoiseHistogram {
+    unsigned long long count;
+    unsigned long long sum;
+    unsigned long long max;
+    unsigned long long overThreshold;
+    unsigned long long buckets[PERFTEST_HOST_NOISE_BUCKETS];
+
+    PerftestHostNoiseHistogram();
+
+    // Values in ns
+    void add(unsigned long long value, unsigned long long threshold)
+    {
+        unsigned int bucket = 0;
+        for (unsigned long long rest = value >> 1;
+                rest != 0 && bucket < PERFTEST_HOST_NOISE_BUCKETS - 1;
+                rest >>= 1) {
+            bucket++;
+        }
+        buckets[bucket]++;
+        count++;
+        sum += value;
+        if (value > max) {
+            max = value;
+        }
+        if (value > threshold) {
+            overThreshold++;
+        }
+    }
+};
+
+/* Results of one core, -1 if the threads were not pinned */
+struct PerftestHostNoiseCore {
+    int core;
+    int priority;
+    int threadOptions;
+
+    // Time between consecutive reads of PerftestClock in a busy loop
+    PerftestHostNoiseHistogram clockGaps;
+    // Delay of the wake-ups of clock_nanosleep, every millisecond
+    PerftestHostNoiseHistogram wakeUps;
+};
+
+/*
+ * Pre-flight check of the noise of the host (-hostNoiseCheck), before the
+ * test starts.
+ *
+ * On every core, at the same time, a thread pinned to the core reads
+ * PerftestClock in a busy loop and records the gaps between consecutive
+ * reads (like hwlat, but in user space, so the gaps also include the time
+ * other threads, interrupts or SMIs took the core). Then another thread,
+ * with the priority given for the core, sleeps until absolute deadlines
+ * every millisecond with clock_nanosleep and records how late it wakes up
+ * (like cyclictest). The wake-up test is only available on Linux.
+ *
+ * A host is noisy if any gap or wake-up is longer than the threshold.
+ */
+class PerftestHostNoise {
+  public:
+    PerftestHostNoise(
+            unsigned long long durationMsec,
+            unsigned long long thresholdUsec);
+
+    /* Check the core (-1 for any) with the priority of its threads */
+    void add_core(int core, int priority, int threadOptions);
+
+    /* Run both tests, false if the threads could not be created */
+    bool run();
+
+    bool is_noisy() const;
+
+    /* Results, for the configuration summary */
+    std::string get_summary() const;
+
+    /* Results as a JSON object */
+    std::string get_json() const;
+
+  private:
+    static void *clock_gap_thread(void *arg);
+    static void *wake_up_thread(void *arg);
+    bool run_threads(bool wakeUps);
+
+    unsigned long long _durationMsec;
+    unsigned long long _thresholdNsec;
+    std::vector<PerftestHostNoiseCore> _cores;
+};
+
+#endif // __PERFTEST_HOST_NOISE_H__
@@ -0,0 +1,165 @@
+#ifndef __PERFTEST_JSON_READER_H__
+#define __PERFTEST_JSON_READER_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*
+ * Just enough JSON for the output of PerftestJSONPrinter, read by
+ * perftest_compare and by -controller. It only depends on the C++ standard
+ * library.
+ */
+struct JsonValue {
+    enum Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY,
+                JSON_OBJECT };
+
+    Type type;
+    double number;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::string> keys;
+
+    JsonValue() : type(JSON_NULL), number(0)
+    {
+    }
+
+    const JsonValue *get(const std::string &key) const
+    {
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == key) {
+                return &items[i];
+            }
+        }
+        return NULL;
+    }
+};
+
+class JsonParser {
+  public:
+    JsonParser(const std::string &text, size_t position)
+            : _text(text), _position(position)
+    {
+    }
+
+    bool parse(JsonValue &value)
+    {
+        skip_spaces();
+        if (_position >= _text.size()) {
+            return false;
+        }
+        char first = _text[_position];
+        if (first == '{') {
+            return parse_object(value);
+        } else if (first == '[') {
+            return parse_array(value);
+        } else if (first == '"') {
+            value.type = JsonValue::JSON_STRING;
+            return parse_string(value.text);
+        } else if (_text.compare(_position, 4, "true") == 0
+                || _text.compare(_position, 5, "false") == 0) {
+            value.type = JsonValue::JSON_BOOL;
+            value.number = first == 't' ? 1 : 0;
+            _position += first == 't' ? 4 : 5;
+            return true;
+        } else if (_text.compare(_position, 4, "null") == 0) {
+            _position += 4;
+            return true;
+        }
+
+        const char *start = _text.c_str() + _position;
+        char *end = NULL;
+        value.type = JsonValue::JSON_NUMBER;
+        value.number = strtod(start, &end);
+        if (end == start) {
+            return false;
+        }
+        _position += end - start;
+        return true;
+    }
+
+    size_t get_position() const
+    {
+        return _position;
+    }
+
+  private:
+    void skip_spaces()
+    {
+        while (_position < _text.size()
+                && strchr(" \t\r\n", _text[_position]) != NULL) {
+            _position++;
+        }
+    }
+
+    bool expect(char character)
+    {
+        skip_spaces();
+        if (_position < _text.size() && _text[_position] == character) {
+            _position++;
+            return true;
+        }
+        return false;
+    }
+
+    bool parse_string(std::string &result)
+    {
+        if (!expect('"')) {
+            return false;
+        }
+        while (_position < _text.size() && _text[_position] != '"') {
+            if (_text[_position] == '\\' && _position + 1 < _text.size()) {
+                _position++;
+            }
+            result += _text[_position++];
+        }
+        return expect('"');
+    }
+
+    bool parse_array(JsonValue &value)
+    {
+        value.type = JsonValue::JSON_ARRAY;
+        expect('[');
+        if (expect(']')) {
+            return true;
+        }
+        do {
+            value.items.push_back(JsonValue());
+            if (!parse(value.items.back())) {
+                return false;
+            }
+        } while (expect(','));
+        return expect(']');
+    }
+
+    bool parse_object(JsonValue &value)
+    {
+        value.type = JsonValue::JSON_OBJECT;
+        expect('{');
+        if (expect('}')) {
+            return true;
+        }
+        do {
+            skip_spaces();
+            value.keys.push_back("");
+            value.items.push_back(JsonValue());
+            if (!parse_string(value.keys.back())
+                    || !expect(':')
+                    || !parse(value.items.back())) {
+                return false;
+            }
+        } while (expect(','));
+        return expect('}');
+    }
+
+    const std::string &_text;
+    size_t _position;
+};
+
+#endif // __PERFTEST_JSON_READER_H__
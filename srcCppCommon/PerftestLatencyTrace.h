@@ -0,0 +1,28 @@
+#ifndef __PERFTEST_LATENCY_TRACE_H__
+#define __PERFTEST_LATENCY_TRACE_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+/*
+ * Binary format of -latencyFile with -latencyFileBinary, read by
+ * perftest_compare. The file is a sequence of blocks, one per latency
+ * summary: a header followed by "count" unsigned long long latencies, in the
+ * order they were received and in the byte order of the Publisher.
+ */
+#define PERFTEST_LATENCY_TRACE_MAGIC 0x544c5450 /* "PTLT" */
+#define PERFTEST_LATENCY_TRACE_VERSION 1
+
+struct PerftestLatencyTraceHeader {
+    unsigned int magic;
+    unsigned int version;
+    // Size of the samples, including the Perftest overhead (as in the summary)
+    unsigned int dataLength;
+    // 1 if the latencies are in ns (RTI_PERFTEST_NANO_CLOCK), 0 if in us
+    unsigned int nanoseconds;
+    unsigned long long count;
+};
+
+#endif // __PERFTEST_LATENCY_TRACE_H__
@@ -0,0 +1,377 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestMetricsServer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#ifdef RTI_UNIX
+  #include <netdb.h>
+  #include <poll.h>
+  #include <unistd.h>
+  #include <sys/socket.h>
+  #include <sys/time.h>
+#endif
+
+/* Time the server waits for a connection before checking if it must stop */
+#define PERFTEST_METRICS_SERVER_POLL_MSEC 100
+
+/* Time a client has to send its request */
+#define PERFTEST_METRICS_SERVER_RECEIVE_TIMEOUT_SEC 1
+
+#define PERFTEST_METRICS_SERVER_MAX_REQUEST 4096
+
+#define PERFTEST_METRICS_CONTENT_TYPE \
+    "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+PerftestMetricsServer::PerftestMetricsServer(const std::string &role, int id)
+        : _role(role),
+          _id(id),
+          _socket(-1),
+          _thread(NULL),
+          _stop(false),
+          _threadFinished(false)
+{
+    memset(&_snapshot, 0, sizeof(_snapshot));
+    _snapshot.readerQueuePeak = -1;
+    _snapshot.writerQueuePeak = -1;
+}
+
+PerftestMetricsServer::~PerftestMetricsServer()
+{
+    if (_thread != NULL) {
+        _stop.store(true);
+        while (!_threadFinished.load()) {
+            PerftestClock::milliSleep(1);
+        }
+        PerftestThread_delete(_thread);
+    }
+  #ifdef RTI_UNIX
+    if (_socket >= 0) {
+        close(_socket);
+    }
+  #endif
+}
+
+bool PerftestMetricsServer::start(const std::string &endpoint)
+{
+  #ifdef RTI_UNIX
+    std::string address = "127.0.0.1";
+    std::string port = endpoint;
+    std::string::size_type separator = endpoint.rfind(':');
+    if (separator != std::string::npos) {
+        address = endpoint.substr(0, separator);
+        port = endpoint.substr(separator + 1);
+        // IPv6 addresses are written as [address]:port
+        if (address.size() > 1 && address[0] == '['
+                && address[address.size() - 1] == ']') {
+            address = address.substr(1, address.size() - 2);
+        }
+    }
+    if (port.empty() || atoi(port.c_str()) <= 0) {
+        fprintf(stderr,
+                "[Error] PerftestMetricsServer: Wrong endpoint '%s', use "
+                "[address:]port.\n",
+                endpoint.c_str());
+        return false;
+    }
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    struct addrinfo *addresses = NULL;
+    int error = getaddrinfo(address.c_str(), port.c_str(), &hints, &addresses);
+    if (error != 0) {
+        fprintf(stderr,
+                "[Error] PerftestMetricsServer: Cannot resolve '%s': %s.\n",
+                address.c_str(),
+                gai_strerror(error));
+        return false;
+    }
+
+    for (struct addrinfo *current = addresses;
+            current != NULL && _socket < 0;
+            current = current->ai_next) {
+        _socket = socket(
+                current->ai_family,
+                current->ai_socktype,
+                current->ai_protocol);
+        if (_socket < 0) {
+            error = errno;
+            continue;
+        }
+        int reuse = 1;
+        setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(_socket, current->ai_addr, current->ai_addrlen) != 0
+                || listen(_socket, SOMAXCONN) != 0) {
+            error = errno;
+            close(_socket);
+            _socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (_socket < 0) {
+        fprintf(stderr,
+                "[Error] PerftestMetricsServer: Cannot listen on %s: %s.\n",
+                endpoint.c_str(),
+                strerror(error));
+        return false;
+    }
+
+    _thread = PerftestThread_new(
+            "MetricsServerThread",
+            Perftest_THREAD_PRIORITY_DEFAULT,
+            Perftest_THREAD_OPTION_DEFAULT,
+            server_thread,
+            this);
+    if (_thread == NULL) {
+        fprintf(stderr,
+                "[Error] PerftestMetricsServer: Cannot create the server "
+                "thread.\n");
+        return false;
+    }
+    return true;
+  #else
+    fprintf(stderr,
+            "[Error] PerftestMetricsServer: -metricsEndpoint is only "
+            "available on UNIX systems.\n");
+    (void) endpoint;
+    return false;
+  #endif
+}
+
+void PerftestMetricsServer::update(const PerftestStatsSnapshot &snapshot)
+{
+    std::lock_guard<std::mutex> lock(_snapshotMutex);
+    unsigned long long updates = _snapshot.updates;
+    _snapshot = snapshot;
+    _snapshot.updates = updates + 1;
+    _snapshot.updateTime = (unsigned long long)
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+}
+
+void *PerftestMetricsServer::server_thread(void *arg)
+{
+    PerftestMetricsServer *server = static_cast<PerftestMetricsServer *>(arg);
+
+  #ifdef RTI_UNIX
+    while (!server->_stop.load()) {
+        struct pollfd listening;
+        listening.fd = server->_socket;
+        listening.events = POLLIN;
+        listening.revents = 0;
+        if (poll(&listening, 1, PERFTEST_METRICS_SERVER_POLL_MSEC) <= 0) {
+            continue;
+        }
+        int connection = accept(server->_socket, NULL, NULL);
+        if (connection < 0) {
+            continue;
+        }
+        server->serve(connection);
+        close(connection);
+    }
+  #endif
+
+    server->_threadFinished.store(true);
+    return NULL;
+}
+
+void PerftestMetricsServer::serve(int connection)
+{
+  #ifdef RTI_UNIX
+    struct timeval timeout = {PERFTEST_METRICS_SERVER_RECEIVE_TIMEOUT_SEC, 0};
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // Only the request line is used, read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos
+            && request.size() < PERFTEST_METRICS_SERVER_MAX_REQUEST) {
+        ssize_t received = recv(connection, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, (size_t) received);
+    }
+
+    std::string status = "200 OK";
+    std::string contentType = PERFTEST_METRICS_CONTENT_TYPE;
+    std::string body;
+    if (request.compare(0, 13, "GET /metrics ") == 0
+            || request.compare(0, 13, "GET /metrics?") == 0) {
+        body = get_metrics();
+    } else if (request.compare(0, 4, "GET ") == 0) {
+        status = "404 Not Found";
+        contentType = "text/plain";
+        body = "Perftest metrics are served at /metrics\n";
+    } else {
+        status = "405 Method Not Allowed";
+        contentType = "text/plain";
+        body = "Only GET is supported\n";
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: " << contentType << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    std::string text = response.str();
+    size_t sent = 0;
+    while (sent < text.size()) {
+        ssize_t result = send(
+                connection,
+                text.data() + sent,
+                text.size() - sent,
+                MSG_NOSIGNAL);
+        if (result <= 0) {
+            break;
+        }
+        sent += (size_t) result;
+    }
+  #else
+    (void) connection;
+  #endif
+}
+
+/* Metadata of a metric family, the unit is the suffix of the name */
+static void add_family(
+        std::ostringstream &out,
+        const char *name,
+        const char *type,
+        const char *unit,
+        const char *help)
+{
+    out << "# TYPE " << name << " " << type << "\n";
+    if (unit != NULL) {
+        out << "# UNIT " << name << " " << unit << "\n";
+    }
+    out << "# HELP " << name << " " << help << "\n";
+}
+
+std::string PerftestMetricsServer::get_metrics()
+{
+    PerftestStatsSnapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(_snapshotMutex);
+        snapshot = _snapshot;
+    }
+
+    std::ostringstream labelsStream;
+    labelsStream << "role=\"" << _role << "\",id=\"" << _id << "\"";
+    const std::string labels = labelsStream.str();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+
+    add_family(out, "perftest_updates", "counter", NULL,
+            "Number of intervals reported.");
+    out << "perftest_updates_total{" << labels << "} "
+        << snapshot.updates << "\n";
+    add_family(out, "perftest_last_update_timestamp_seconds", "gauge",
+            "seconds", "Time of the last interval reported.");
+    out << "perftest_last_update_timestamp_seconds{" << labels << "} "
+        << snapshot.updateTime / 1000.0 << "\n";
+    add_family(out, "perftest_data_length_bytes", "gauge", "bytes",
+            "Size of the samples of the current interval.");
+    out << "perftest_data_length_bytes{" << labels << "} "
+        << snapshot.dataLength << "\n";
+
+    if (_role == "sub") {
+        // Same counters as the throughput summary
+        add_family(out, "perftest_received_samples", "counter", NULL,
+                "Samples received with the current data length.");
+        out << "perftest_received_samples_total{" << labels << "} "
+            << snapshot.samples << "\n";
+        add_family(out, "perftest_received_bytes", "counter", "bytes",
+                "Bytes received with the current data length.");
+        out << "perftest_received_bytes_total{" << labels << "} "
+            << snapshot.bytes << "\n";
+        add_family(out, "perftest_throughput_samples_per_second", "gauge",
+                NULL, "Samples received per second in the last interval.");
+        out << "perftest_throughput_samples_per_second{" << labels << "} "
+            << snapshot.samplesPerSecond << "\n";
+        add_family(out, "perftest_throughput_megabits_per_second", "gauge",
+                NULL, "Mbps received in the last interval.");
+        out << "perftest_throughput_megabits_per_second{" << labels << "} "
+            << snapshot.bytesPerSecond * 8 / 1000000.0 << "\n";
+        add_family(out, "perftest_lost_samples", "counter", NULL,
+                "Samples lost with the current data length.");
+        out << "perftest_lost_samples_total{" << labels << "} "
+            << snapshot.lostSamples << "\n";
+        add_family(out, "perftest_lost_samples_percent", "gauge", NULL,
+                "Percentage of samples lost with the current data length.");
+        out << "perftest_lost_samples_percent{" << labels << "} "
+            << snapshot.lostPercent << "\n";
+    } else {
+        // Same counters as the latency summary
+        add_family(out, "perftest_lost_samples", "counter", NULL,
+                "Samples lost by the subscribers, as reported in the pongs.");
+        out << "perftest_lost_samples_total{" << labels << "} "
+            << snapshot.lostSamples << "\n";
+        add_family(out, "perftest_latency_average_microseconds", "gauge",
+                "microseconds", "Average latency of the current data length.");
+        out << "perftest_latency_average_microseconds{" << labels << "} "
+            << snapshot.latencyAve << "\n";
+        add_family(out, "perftest_latency_std_microseconds", "gauge",
+                "microseconds", "Standard deviation of the latency.");
+        out << "perftest_latency_std_microseconds{" << labels << "} "
+            << snapshot.latencyStd << "\n";
+        add_family(out, "perftest_latency_min_microseconds", "gauge",
+                "microseconds", "Minimum latency of the current data length.");
+        out << "perftest_latency_min_microseconds{" << labels << "} "
+            << snapshot.latencyMin << "\n";
+        add_family(out, "perftest_latency_max_microseconds", "gauge",
+                "microseconds", "Maximum latency of the current data length.");
+        out << "perftest_latency_max_microseconds{" << labels << "} "
+            << snapshot.latencyMax << "\n";
+
+        /*
+         * The buckets are cumulative. The count is the one of the histogram,
+         * which may be a few samples behind latencyCount.
+         */
+        add_family(out, "perftest_latency_microseconds", "histogram",
+                "microseconds", "Latency of the current data length.");
+        unsigned long long accumulated = 0;
+        for (unsigned int i = 0; i < PERFTEST_STATS_HISTOGRAM_BUCKETS; i++) {
+            accumulated += snapshot.latencyHistogram[i];
+            out << "perftest_latency_microseconds_bucket{" << labels
+                << ",le=\"" << (1ULL << (i + 1)) << "\"} " << accumulated
+                << "\n";
+        }
+        out << "perftest_latency_microseconds_bucket{" << labels
+            << ",le=\"+Inf\"} " << accumulated << "\n";
+        out << "perftest_latency_microseconds_count{" << labels << "} "
+            << accumulated << "\n";
+        out << "perftest_latency_microseconds_sum{" << labels << "} "
+            << snapshot.latencyAve * accumulated << "\n";
+    }
+
+    add_family(out, "perftest_cpu_percent", "gauge", NULL,
+            "CPU used by the process in the last interval.");
+    out << "perftest_cpu_percent{" << labels << "} " << snapshot.cpu << "\n";
+    if (snapshot.readerQueuePeak >= 0) {
+        add_family(out, "perftest_reader_queue_peak_samples", "gauge", NULL,
+                "Peak of samples in the queue of the reader.");
+        out << "perftest_reader_queue_peak_samples{" << labels << "} "
+            << snapshot.readerQueuePeak << "\n";
+    }
+    if (snapshot.writerQueuePeak >= 0) {
+        add_family(out, "perftest_writer_queue_peak_samples", "gauge", NULL,
+                "Peak of samples in the queue of the writer.");
+        out << "perftest_writer_queue_peak_samples{" << labels << "} "
+            << snapshot.writerQueuePeak << "\n";
+    }
+
+    out << "# EOF\n";
+    return out.str();
+}
@@ -0,0 +1,59 @@
+#ifndef __PERFTEST_METRICS_SERVER_H__
+#define __PERFTEST_METRICS_SERVER_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include "Infrastructure_common.h"
+#include "PerftestStatsSegment.h"
+
+/*
+ * Minimal HTTP server exposing the counters of the test in the OpenMetrics
+ * text format at /metrics (-metricsEndpoint), for Prometheus to scrape long
+ * running tests.
+ *
+ * It serves the last snapshot given to update(), which is called once per
+ * interval with the same snapshot as the -statsSegment, so the listeners are
+ * never blocked by a request. The requests are served one at a time by the
+ * thread of the server.
+ */
+class PerftestMetricsServer {
+  public:
+    /* role is "pub" or "sub", used with id as the labels of the metrics */
+    PerftestMetricsServer(const std::string &role, int id);
+    ~PerftestMetricsServer();
+
+    /* Listen on "[address:]port" (127.0.0.1 by default) and start serving */
+    bool start(const std::string &endpoint);
+
+    /* Replace the snapshot served */
+    void update(const PerftestStatsSnapshot &snapshot);
+
+    /* Body of the /metrics response for the current snapshot */
+    std::string get_metrics();
+
+  private:
+    PerftestMetricsServer(const PerftestMetricsServer &);
+    PerftestMetricsServer &operator=(const PerftestMetricsServer &);
+
+    static void *server_thread(void *arg);
+    void serve(int connection);
+
+    std::string _role;
+    int _id;
+    int _socket;
+
+    std::mutex _snapshotMutex;
+    PerftestStatsSnapshot _snapshot;
+
+    PerftestThread *_thread;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _threadFinished;
+};
+
+#endif // __PERFTEST_METRICS_SERVER_H__
@@ -458,7 +458,13 @@ void PerftestJSONPrinter::print_initial_output()
 
 void PerftestJSONPrinter::print_final_output()
 {
-    fprintf(_outputFile, "\n\t]\n}\n");
+    fprintf(_outputFile, "\n\t]");
+    if (!_hostNoiseJson.empty()) {
+        fprintf(_outputFile,
+                ",\n\t\"host_noise\": %s",
+                _hostNoiseJson.c_str());
+    }
+    fprintf(_outputFile, "\n}\n");
 }
 
 
@@ -37,7 +37,7 @@ public:
         }
     };
 
-    bool initialize(ParameterManager *_PM);
+    virtual bool initialize(ParameterManager *_PM);
 
     virtual void print_latency_header() = 0;
 
@@ -104,9 +104,21 @@ public:
             float missingPacketsPercent,
             double outputCpu) = 0;
 
-    void print_initial_output() {};
+    virtual void print_initial_output() {};
 
-    void print_final_output() {};
+    virtual void print_final_output() {};
+
+    /*
+     * Results of the checks done before the test (-hostNoiseCheck), as a
+     * JSON object. Only the JSON printer includes them, in the final output.
+     */
+    virtual void set_host_noise_json(const std::string &json)
+    {
+        _hostNoiseJson = json;
+    };
+
+protected:
+    std::string _hostNoiseJson;
 };
 
 class PerftestCSVPrinter : public PerftestPrinter {
@@ -0,0 +1,234 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestScenario.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+
+/* Parse a whole unsigned number */
+static bool parse_number(const std::string &value, unsigned long long &number)
+{
+    char *end = NULL;
+    if (value.empty() || value[0] == '-') {
+        return false;
+    }
+    number = strtoull(value.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+PerftestScenarioPhase::PerftestScenarioPhase()
+        : durationUsec(0),
+          pubRate(0),
+          pubRateSpin(true),
+          dataLen(0),
+          burstSamples(0),
+          burstPeriodUsec(0),
+          firstInstance(0),
+          instanceCount(0),
+          pause(false)
+{
+}
+
+bool PerftestScenario::initialize(
+        const std::string &path,
+        unsigned long long defaultDataLen,
+        unsigned long long minDataLen,
+        unsigned long long maxDataLen)
+{
+    std::ifstream file(path.c_str());
+    if (!file.is_open()) {
+        fprintf(stderr,
+                "[Error] PerftestScenario: Could not open \"%s\".\n",
+                path.c_str());
+        return false;
+    }
+
+    _path = path;
+    _phases.clear();
+    _maxDataLen = 0;
+    _maxInstance = -1;
+
+    std::string line;
+    _lineNumber = 0;
+    while (std::getline(file, line)) {
+        _lineNumber++;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        PerftestScenarioPhase phase;
+        if (!parse_phase(line, defaultDataLen, minDataLen, maxDataLen, phase)) {
+            return false;
+        }
+        if (phase.dataLen > _maxDataLen) {
+            _maxDataLen = phase.dataLen;
+        }
+        if (phase.instanceCount > 0
+                && (long) (phase.firstInstance + phase.instanceCount - 1)
+                        > _maxInstance) {
+            _maxInstance =
+                    (long) (phase.firstInstance + phase.instanceCount - 1);
+        }
+        _phases.push_back(phase);
+    }
+
+    if (_phases.empty()) {
+        fprintf(stderr,
+                "[Error] PerftestScenario: No phases in \"%s\".\n",
+                path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool PerftestScenario::parse_phase(
+        const std::string &line,
+        unsigned long long defaultDataLen,
+        unsigned long long minDataLen,
+        unsigned long long maxDataLen,
+        PerftestScenarioPhase &phase)
+{
+    std::stringstream stream(line);
+    stream >> phase.name;
+    phase.dataLen = defaultDataLen;
+
+    std::string item;
+    bool hasDuration = false;
+    while (stream >> item) {
+        std::string::size_type equal = item.find('=');
+        std::string key = item.substr(0, equal);
+        std::string value =
+                equal == std::string::npos ? "" : item.substr(equal + 1);
+        bool valid = true;
+        unsigned long long number = 0;
+
+        if (key == "pause" && equal == std::string::npos) {
+            phase.pause = true;
+
+        } else if (key == "duration") {
+            char *end = NULL;
+            double seconds = strtod(value.c_str(), &end);
+            valid = !value.empty() && *end == '\0' && seconds > 0;
+            phase.durationUsec = (unsigned long long) (seconds * 1000000);
+            hasDuration = true;
+
+        } else if (key == "pubRate") {
+            std::string::size_type colon = value.find(':');
+            std::string method = colon == std::string::npos
+                    ? "spin"
+                    : value.substr(colon + 1);
+            valid = parse_number(value.substr(0, colon), phase.pubRate)
+                    && phase.pubRate > 0
+                    && (method == "spin" || method == "sleep");
+            phase.pubRateSpin = method == "spin";
+
+        } else if (key == "dataLen") {
+            valid = parse_number(value, phase.dataLen)
+                    && phase.dataLen >= minDataLen
+                    && phase.dataLen <= maxDataLen;
+
+        } else if (key == "burst") {
+            std::string::size_type colon = value.find(':');
+            valid = colon != std::string::npos
+                    && parse_number(value.substr(0, colon), phase.burstSamples)
+                    && parse_number(value.substr(colon + 1), number)
+                    && phase.burstSamples > 0
+                    && number > 0;
+            phase.burstPeriodUsec = number * 1000;
+
+        } else if (key == "instances") {
+            std::string::size_type dash = value.find('-');
+            unsigned long long first = 0;
+            unsigned long long last = 0;
+            valid = parse_number(value.substr(0, dash), first);
+            last = first;
+            if (valid && dash != std::string::npos) {
+                valid = parse_number(value.substr(dash + 1), last)
+                        && last >= first;
+            }
+            phase.firstInstance = (unsigned long) first;
+            phase.instanceCount = (unsigned long) (last - first + 1);
+
+        } else {
+            fprintf(stderr,
+                    "[Error] PerftestScenario: Unknown setting '%s' in line "
+                    "%u of \"%s\". Use duration=, pubRate=, dataLen=, "
+                    "burst=, instances= or pause.\n",
+                    item.c_str(),
+                    _lineNumber,
+                    _path.c_str());
+            return false;
+        }
+
+        if (!valid) {
+            fprintf(stderr,
+                    "[Error] PerftestScenario: Wrong value '%s' in line %u "
+                    "of \"%s\", expected duration=<s>, "
+                    "pubRate=<samples/s>[:spin|sleep], dataLen=<bytes> "
+                    "(from %llu to %llu), burst=<samples>:<periodMs> or "
+                    "instances=<first>[-<last>].\n",
+                    item.c_str(),
+                    _lineNumber,
+                    _path.c_str(),
+                    minDataLen,
+                    maxDataLen);
+            return false;
+        }
+    }
+
+    if (!hasDuration) {
+        fprintf(stderr,
+                "[Error] PerftestScenario: Phase '%s' in line %u of \"%s\" "
+                "requires duration=<s>.\n",
+                phase.name.c_str(),
+                _lineNumber,
+                _path.c_str());
+        return false;
+    }
+    if (phase.pubRate > 0 && phase.burstSamples > 0) {
+        fprintf(stderr,
+                "[Error] PerftestScenario: Phase '%s' in line %u of \"%s\" "
+                "cannot use both pubRate= and burst=.\n",
+                phase.name.c_str(),
+                _lineNumber,
+                _path.c_str());
+        return false;
+    }
+    if (phase.pause
+            && (phase.pubRate > 0 || phase.burstSamples > 0
+                || phase.instanceCount > 0)) {
+        fprintf(stderr,
+                "[Error] PerftestScenario: Phase '%s' in line %u of \"%s\" "
+                "is a pause, it only takes duration=<s>.\n",
+                phase.name.c_str(),
+                _lineNumber,
+                _path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool PerftestScenario::uses_spin() const
+{
+    for (unsigned int i = 0; i < _phases.size(); i++) {
+        if (_phases[i].pubRate > 0 && _phases[i].pubRateSpin) {
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned long long PerftestScenario::get_longest_phase_usec() const
+{
+    unsigned long long longest = 0;
+    for (unsigned int i = 0; i < _phases.size(); i++) {
+        if (_phases[i].durationUsec > longest) {
+            longest = _phases[i].durationUsec;
+        }
+    }
+    return longest;
+}
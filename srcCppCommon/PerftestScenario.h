@@ -0,0 +1,100 @@
+#ifndef __PERFTEST_SCENARIO_H__
+#define __PERFTEST_SCENARIO_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <string>
+#include <vector>
+
+/* A timed phase of a -scenario file */
+struct PerftestScenarioPhase {
+    std::string name;
+    unsigned long long durationUsec;
+    // Samples/s, 0 to send as fast as possible
+    unsigned long long pubRate;
+    bool pubRateSpin;
+    // Bytes, as -dataLen
+    unsigned long long dataLen;
+    // Samples sent back to back every burstPeriodUsec, 0 if not bursting
+    unsigned long long burstSamples;
+    unsigned long long burstPeriodUsec;
+    // Instances written, from firstInstance. 0 to write all of them
+    unsigned long firstInstance;
+    unsigned long instanceCount;
+    // Do not send anything during the phase
+    bool pause;
+
+    PerftestScenarioPhase();
+};
+
+/*
+ * Phases of a test run by the Publisher (-scenario). Every line of the file
+ * is a phase, run in order for the given time:
+ *
+ *   <name> duration=<s> [pubRate=<samples/s>[:spin|sleep]] [dataLen=<bytes>]
+ *          [burst=<samples>:<periodMs>] [instances=<first>[-<last>]] [pause]
+ *
+ * Empty lines and what follows a '#' are ignored. A phase without pubRate or
+ * burst sends as fast as possible, without dataLen it uses -dataLen and
+ * without instances it writes all the -instances.
+ *
+ * The whole file is parsed and checked when the test starts, the Publisher
+ * only copies the values of the next phase when the phase changes.
+ */
+class PerftestScenario {
+  public:
+    PerftestScenario() : _lineNumber(0), _maxDataLen(0), _maxInstance(-1) {}
+
+    /*
+     * Load the phases of the file. The data lengths must be between
+     * minDataLen and maxDataLen, defaultDataLen is used by the phases that
+     * do not set it. Returns false on error.
+     */
+    bool initialize(
+            const std::string &path,
+            unsigned long long defaultDataLen,
+            unsigned long long minDataLen,
+            unsigned long long maxDataLen);
+
+    const std::vector<PerftestScenarioPhase> &get_phases() const
+    {
+        return _phases;
+    }
+
+    /* Biggest data length of the phases */
+    unsigned long long get_max_data_len() const
+    {
+        return _maxDataLen;
+    }
+
+    /* Highest instance of the phases with an instance set, -1 if none */
+    long get_max_instance() const
+    {
+        return _maxInstance;
+    }
+
+    /* Some phase controls the rate spinning */
+    bool uses_spin() const;
+
+    /* Duration of the longest phase */
+    unsigned long long get_longest_phase_usec() const;
+
+  private:
+    bool parse_phase(
+            const std::string &line,
+            unsigned long long defaultDataLen,
+            unsigned long long minDataLen,
+            unsigned long long maxDataLen,
+            PerftestScenarioPhase &phase);
+
+    std::string _path;
+    unsigned int _lineNumber;
+    std::vector<PerftestScenarioPhase> _phases;
+    unsigned long long _maxDataLen;
+    long _maxInstance;
+};
+
+#endif // __PERFTEST_SCENARIO_H__
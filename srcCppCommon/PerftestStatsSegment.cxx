@@ -0,0 +1,131 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestStatsSegment.h"
+#include <stdio.h>
+#include <errno.h>
+#include <chrono>
+#include <new>
+#include <sstream>
+#ifdef RTI_LINUX
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+PerftestStatsSegment::PerftestStatsSegment() : _layout(NULL)
+{
+}
+
+PerftestStatsSegment::~PerftestStatsSegment()
+{
+  #ifdef RTI_LINUX
+    if (_layout != NULL) {
+        munmap(_layout, sizeof(PerftestStatsSegmentLayout));
+        shm_unlink(_name.c_str());
+    }
+  #endif
+}
+
+bool PerftestStatsSegment::initialize(
+        const std::string &role,
+        int id,
+        const std::string &description)
+{
+  #ifdef RTI_LINUX
+    std::ostringstream name;
+    name << "/" << PERFTEST_STATS_SEGMENT_PREFIX << getpid() << "_" << role
+         << id;
+    _name = name.str();
+
+    int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        // Left by a process that did not finish cleanly and had our pid
+        shm_unlink(_name.c_str());
+        fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        fprintf(stderr,
+                "[Error] PerftestStatsSegment: Could not create %s: %s.\n",
+                _name.c_str(),
+                strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, sizeof(PerftestStatsSegmentLayout)) != 0) {
+        fprintf(stderr,
+                "[Error] PerftestStatsSegment: Could not size %s: %s.\n",
+                _name.c_str(),
+                strerror(errno));
+        close(fd);
+        shm_unlink(_name.c_str());
+        return false;
+    }
+    void *address = mmap(
+            NULL,
+            sizeof(PerftestStatsSegmentLayout),
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            fd,
+            0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        fprintf(stderr,
+                "[Error] PerftestStatsSegment: Could not map %s: %s.\n",
+                _name.c_str(),
+                strerror(errno));
+        shm_unlink(_name.c_str());
+        return false;
+    }
+
+    PerftestStatsSegmentLayout *layout =
+            new (address) PerftestStatsSegmentLayout();
+    layout->version = PERFTEST_STATS_SEGMENT_VERSION;
+    layout->size = sizeof(PerftestStatsSegmentLayout);
+    layout->pid = (int) getpid();
+    strncpy(layout->role, role.c_str(), PERFTEST_STATS_ROLE_LENGTH - 1);
+    strncpy(layout->description,
+            description.c_str(),
+            PERFTEST_STATS_DESCRIPTION_LENGTH - 1);
+    layout->sequence.store(0, std::memory_order_relaxed);
+    layout->snapshot.readerQueuePeak = -1;
+    layout->snapshot.writerQueuePeak = -1;
+
+    // Readers ignore the segment until the magic is set
+    std::atomic_thread_fence(std::memory_order_release);
+    layout->magic = PERFTEST_STATS_SEGMENT_MAGIC;
+    _layout = layout;
+    return true;
+  #else
+    (void) role;
+    (void) id;
+    (void) description;
+    fprintf(stderr,
+            "[Error] PerftestStatsSegment: -statsSegment is only available "
+            "on Linux.\n");
+    return false;
+  #endif
+}
+
+void PerftestStatsSegment::update(PerftestStatsSnapshot &snapshot)
+{
+    if (_layout == NULL) {
+        return;
+    }
+
+    snapshot.updateTime = (unsigned long long)
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+    snapshot.updates = _layout->snapshot.updates + 1;
+
+    // Single writer: odd sequence while the snapshot is copied
+    unsigned long long sequence =
+            _layout->sequence.load(std::memory_order_relaxed);
+    _layout->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&_layout->snapshot, &snapshot, sizeof(snapshot));
+    _layout->sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,145 @@
+#ifndef __PERFTEST_STATS_SEGMENT_H__
+#define __PERFTEST_STATS_SEGMENT_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <string.h>
+#include <atomic>
+#include <string>
+
+/*
+ * Layout of the shared-memory segment where a Perftest process publishes its
+ * live counters (-statsSegment), read by perftest_top. This header does not
+ * depend on Connext, so perftest_top can be built with only this file.
+ *
+ * Increase PERFTEST_STATS_SEGMENT_VERSION when the layout changes.
+ */
+#define PERFTEST_STATS_SEGMENT_MAGIC 0x50545354 /* "PTST" */
+#define PERFTEST_STATS_SEGMENT_VERSION 2
+
+/* Segments are named "/perftest_stats_<pid>_<pub|sub><id>" */
+#define PERFTEST_STATS_SEGMENT_PREFIX "perftest_stats_"
+#define PERFTEST_STATS_SEGMENT_DIRECTORY "/dev/shm"
+
+/* Bucket i counts the latencies in [2^i, 2^(i+1)) us, bucket 0 also has 0 */
+#define PERFTEST_STATS_HISTOGRAM_BUCKETS 32
+
+#define PERFTEST_STATS_ROLE_LENGTH 16
+#define PERFTEST_STATS_DESCRIPTION_LENGTH 256
+
+/* Counters of one interval, copied as a whole under the sequence lock */
+struct PerftestStatsSnapshot {
+    // Milliseconds since the epoch of the last update, and number of updates
+    unsigned long long updateTime;
+    unsigned long long updates;
+
+    unsigned long long dataLength;
+
+    // Throughput (Subscriber), for the current data length
+    unsigned long long samples;
+    unsigned long long bytes;
+    unsigned long long samplesPerSecond;
+    unsigned long long bytesPerSecond;
+    unsigned long long lostSamples;
+    double lostPercent;
+
+    // Latency (Publisher), for the current data length, in us
+    unsigned long long latencyCount;
+    double latencyAve;
+    double latencyStd;
+    unsigned long long latencyMin;
+    unsigned long long latencyMax;
+    unsigned long long latencyHistogram[PERFTEST_STATS_HISTOGRAM_BUCKETS];
+
+    double cpu;
+    long long readerQueuePeak;
+    long long writerQueuePeak;
+};
+
+struct PerftestStatsSegmentLayout {
+    // Set once, when the segment is created (magic last)
+    unsigned int magic;
+    unsigned int version;
+    unsigned int size;
+    int pid;
+    char role[PERFTEST_STATS_ROLE_LENGTH];
+    char description[PERFTEST_STATS_DESCRIPTION_LENGTH];
+
+    // Odd while the snapshot is being written
+    std::atomic<unsigned long long> sequence;
+    PerftestStatsSnapshot snapshot;
+};
+
+/*
+ * Writer of the segment of this process.
+ *
+ * The segment is updated by the thread that already wakes up once per
+ * interval (the Subscriber main loop, or a thread of the Publisher), from
+ * counters the test threads keep anyway, so the threads sending and
+ * receiving samples take no locks and make no system calls for it. Readers
+ * never block the writer: they retry if the sequence changed while copying.
+ */
+class PerftestStatsSegment {
+  public:
+    PerftestStatsSegment();
+    ~PerftestStatsSegment();
+
+    /* Create the segment, role is "pub" or "sub" */
+    bool initialize(
+            const std::string &role,
+            int id,
+            const std::string &description);
+
+    bool is_initialized() const
+    {
+        return _layout != NULL;
+    }
+
+    /* Publish a new snapshot, updateTime and updates are set here */
+    void update(PerftestStatsSnapshot &snapshot);
+
+    static unsigned int get_histogram_bucket(unsigned long long latency)
+    {
+        unsigned int bucket = 0;
+        while (latency > 1 && bucket < PERFTEST_STATS_HISTOGRAM_BUCKETS - 1) {
+            latency >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    /*
+     * Copy the snapshot of a mapped segment, false if the writer was always
+     * in the middle of an update.
+     */
+    static bool read(
+            const PerftestStatsSegmentLayout *layout,
+            PerftestStatsSnapshot &snapshot)
+    {
+        for (int attempt = 0; attempt < 1000; attempt++) {
+            unsigned long long before =
+                    layout->sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            memcpy(&snapshot, &layout->snapshot, sizeof(snapshot));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (layout->sequence.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    PerftestStatsSegment(const PerftestStatsSegment &);
+    PerftestStatsSegment &operator=(const PerftestStatsSegment &);
+
+    std::string _name;
+    PerftestStatsSegmentLayout *_layout;
+};
+
+#endif // __PERFTEST_STATS_SEGMENT_H__
@@ -0,0 +1,281 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "PerftestTimerWheel.h"
+#include <algorithm>
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+#include "ThreadCPUAffinity.h"
+
+PerftestTimerWheel::PerftestTimerWheel()
+        : _slots(PERFTEST_TIMER_WHEEL_SLOTS),
+          _startTime(get_time_ns()),
+          _currentTick(0),
+          _nextId(0),
+          _runningId(-1),
+          _missedPeriods(0),
+          _core(-1),
+          _thread(NULL)
+{
+    _stop.store(false);
+    _finished.store(false);
+}
+
+PerftestTimerWheel::~PerftestTimerWheel()
+{
+    stop();
+}
+
+unsigned long long PerftestTimerWheel::get_time_ns()
+{
+  #ifdef RTI_LINUX
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+  #elif defined(RTI_PERFTEST_NANO_CLOCK)
+    return PerftestClock::getInstance().getTimeNs();
+  #else
+    return PerftestClock::getInstance().getTime() * 1000;
+  #endif
+}
+
+void PerftestTimerWheel::sleep_until(unsigned long long deadline)
+{
+  #ifdef RTI_LINUX
+    struct timespec wakeUp;
+    wakeUp.tv_sec = (time_t) (deadline / 1000000000ULL);
+    wakeUp.tv_nsec = (long) (deadline % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp, NULL)
+            == EINTR) {
+        // Interrupted by a signal, sleep again until the deadline
+    }
+  #else
+    unsigned long long now = get_time_ns();
+    if (deadline > now) {
+        PerftestClock::milliSleep(
+                (unsigned int) ((deadline - now + 999999) / 1000000));
+    }
+  #endif
+}
+
+bool PerftestTimerWheel::start(int priority, int threadOptions, int core)
+{
+    _core = core;
+    _stop.store(false);
+    _finished.store(false);
+    _thread = PerftestThread_new(
+            "PerftestTimerWheel",
+            priority,
+            threadOptions,
+            service_thread,
+            this);
+    if (_thread == NULL) {
+        fprintf(stderr,
+                "[PerftestTimerWheel] Error: Cannot create the service "
+                "thread.\n");
+        return false;
+    }
+    return true;
+}
+
+void PerftestTimerWheel::stop()
+{
+    if (_thread == NULL) {
+        return;
+    }
+    _stop.store(true);
+    while (!_finished.load()) {
+        PerftestClock::milliSleep(1);
+    }
+    PerftestThread_delete(_thread);
+    _thread = NULL;
+}
+
+long PerftestTimerWheel::schedule(
+        unsigned long long delayNsec,
+        unsigned long long periodNsec,
+        PerftestTimerCallback callback,
+        void *arg)
+{
+    if (callback == NULL) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Timer timer;
+    timer.id = _nextId++;
+    timer.deadline = get_time_ns() + delayNsec;
+    timer.period = periodNsec;
+    timer.callback = callback;
+    timer.arg = arg;
+    insert(timer);
+    return timer.id;
+}
+
+void PerftestTimerWheel::cancel(long id)
+{
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // A periodic timer is inserted again once its callback returns
+            if (id != _runningId) {
+                for (unsigned int i = 0; i < _slots.size(); i++) {
+                    for (unsigned int j = 0; j < _slots[i].size(); j++) {
+                        if (_slots[i][j].id == id) {
+                            _slots[i].erase(_slots[i].begin() + j);
+                            return;
+                        }
+                    }
+                }
+                // Already taken out of the wheel, not run yet
+                for (unsigned int i = 0; i < _expired.size(); i++) {
+                    if (_expired[i].id == id) {
+                        _cancelled.push_back(id);
+                        return;
+                    }
+                }
+                return;
+            }
+        }
+        PerftestClock::milliSleep(1);
+    }
+}
+
+unsigned long long PerftestTimerWheel::get_missed_periods()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _missedPeriods;
+}
+
+void PerftestTimerWheel::insert(const Timer &timer)
+{
+    Timer result = timer;
+    result.tick = timer.deadline > _startTime
+            ? (timer.deadline - _startTime) / PERFTEST_TIMER_WHEEL_TICK_NSEC
+            : 0;
+    if (result.tick < _currentTick) {
+        result.tick = _currentTick;
+    }
+    _slots[result.tick % _slots.size()].push_back(result);
+}
+
+unsigned long long PerftestTimerWheel::get_next_deadline()
+{
+    // The first slot with timers for this turn of the wheel
+    for (unsigned long long tick = _currentTick;
+            tick < _currentTick + _slots.size();
+            tick++) {
+        const std::vector<Timer> &slot = _slots[tick % _slots.size()];
+        bool found = false;
+        unsigned long long deadline = 0;
+        for (unsigned int i = 0; i < slot.size(); i++) {
+            if (slot[i].tick == tick
+                    && (!found || slot[i].deadline < deadline)) {
+                deadline = slot[i].deadline;
+                found = true;
+            }
+        }
+        if (found) {
+            return deadline;
+        }
+    }
+    return _startTime
+            + (_currentTick + _slots.size()) * PERFTEST_TIMER_WHEEL_TICK_NSEC;
+}
+
+void PerftestTimerWheel::take_expired(
+        unsigned long long now,
+        std::vector<Timer> &expired)
+{
+    while (true) {
+        std::vector<Timer> &slot = _slots[_currentTick % _slots.size()];
+        for (unsigned int i = 0; i < slot.size();) {
+            if (slot[i].tick == _currentTick && slot[i].deadline <= now) {
+                expired.push_back(slot[i]);
+                slot.erase(slot.begin() + i);
+            } else {
+                i++;
+            }
+        }
+
+        // Move to the next slot once the whole tick is in the past
+        unsigned long long tickEnd = _startTime
+                + (_currentTick + 1) * PERFTEST_TIMER_WHEEL_TICK_NSEC;
+        if (tickEnd > now) {
+            return;
+        }
+        _currentTick++;
+    }
+}
+
+void *PerftestTimerWheel::service_thread(void *arg)
+{
+    PerftestTimerWheel *wheel = static_cast<PerftestTimerWheel *>(arg);
+    wheel->run();
+    wheel->_finished.store(true);
+    return NULL;
+}
+
+void PerftestTimerWheel::run()
+{
+    if (_core >= 0) {
+        ThreadCPUAffinity::set_current_thread_affinity(_core);
+    }
+
+    while (!_stop.load()) {
+        unsigned long long deadline;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            deadline = get_next_deadline();
+        }
+        unsigned long long now = get_time_ns();
+        if (deadline > now + PERFTEST_TIMER_WHEEL_MAX_SLEEP_NSEC) {
+            deadline = now + PERFTEST_TIMER_WHEEL_MAX_SLEEP_NSEC;
+        }
+        sleep_until(deadline);
+
+        now = get_time_ns();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _expired.clear();
+            _cancelled.clear();
+            take_expired(now, _expired);
+        }
+
+        /*
+         * Only this thread changes _expired, and it does so with the mutex
+         * taken, so it can read it without the mutex.
+         */
+        for (unsigned int i = 0; i < _expired.size() && !_stop.load(); i++) {
+            Timer &timer = _expired[i];
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (std::find(_cancelled.begin(), _cancelled.end(), timer.id)
+                        != _cancelled.end()) {
+                    continue;
+                }
+                _runningId = timer.id;
+            }
+            timer.callback(timer.arg);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _runningId = -1;
+            if (timer.period == 0) {
+                continue;
+            }
+            // From the previous deadline, skipping the periods already missed
+            timer.deadline += timer.period;
+            now = get_time_ns();
+            if (timer.deadline <= now) {
+                unsigned long long missed =
+                        (now - timer.deadline) / timer.period + 1;
+                timer.deadline += missed * timer.period;
+                _missedPeriods += missed;
+            }
+            insert(timer);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#ifndef __PERFTEST_TIMER_WHEEL_H__
+#define __PERFTEST_TIMER_WHEEL_H__
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "Infrastructure_common.h"
+
+/* Resolution of the slots of the wheel and number of slots */
+#define PERFTEST_TIMER_WHEEL_TICK_NSEC 1000000ULL
+#define PERFTEST_TIMER_WHEEL_SLOTS 256
+
+/*
+ * Longest the service thread sleeps, which is the most a timer scheduled
+ * from another thread or a stop() can be delayed.
+ */
+#define PERFTEST_TIMER_WHEEL_MAX_SLEEP_NSEC 10000000ULL
+
+typedef void (*PerftestTimerCallback)(void *arg);
+
+/*
+ * Single service thread running the periodic work of the test at precise
+ * instants: the -executionTime timeout, the interval snapshots, the steps of
+ * -rampRate and the CPU samples.
+ *
+ * The timers are kept in a hashed timing wheel of PERFTEST_TIMER_WHEEL_SLOTS
+ * slots of PERFTEST_TIMER_WHEEL_TICK_NSEC, so scheduling is O(1) whatever the
+ * number of timers. Deadlines are absolute, in ns of the monotonic clock: the
+ * thread sleeps until the earliest deadline of the coming slots with
+ * clock_nanosleep(TIMER_ABSTIME) (milliSleep where it is not available), and
+ * periodic timers are rescheduled from their previous deadline, so they do
+ * not drift. If a callback runs late enough to miss periods, they are skipped
+ * and counted instead of run in a burst.
+ *
+ * The callbacks run in the service thread, one at a time: they must be short
+ * and must not block.
+ */
+class PerftestTimerWheel {
+  public:
+    PerftestTimerWheel();
+    ~PerftestTimerWheel();
+
+    /* Start the service thread, pinned to core if not -1 */
+    bool start(int priority, int threadOptions, int core);
+
+    /* Stop the thread, waiting for the callback that may be running */
+    void stop();
+
+    /*
+     * Run callback(arg) in delayNsec, and then every periodNsec if it is not
+     * 0. Returns the id of the timer, or -1 on errors.
+     */
+    long schedule(
+            unsigned long long delayNsec,
+            unsigned long long periodNsec,
+            PerftestTimerCallback callback,
+            void *arg);
+
+    /*
+     * Remove the timer. If its callback is running, wait for it to return, so
+     * what the callback uses can be released afterwards, and if it is due in
+     * the batch the service thread is running, it is skipped. It must not be
+     * called from a callback.
+     */
+    void cancel(long id);
+
+    /* Periods skipped because the service thread was late */
+    unsigned long long get_missed_periods();
+
+    /* Time of the monotonic clock used for the deadlines */
+    static unsigned long long get_time_ns();
+
+  private:
+    struct Timer {
+        long id;
+        unsigned long long deadline;
+        unsigned long long period;
+        unsigned long long tick;
+        PerftestTimerCallback callback;
+        void *arg;
+    };
+
+    static void *service_thread(void *arg);
+    void run();
+
+    // With the mutex taken
+    void insert(const Timer &timer);
+    unsigned long long get_next_deadline();
+    void take_expired(unsigned long long now, std::vector<Timer> &expired);
+
+    static void sleep_until(unsigned long long deadline);
+
+    std::mutex _mutex;
+    std::vector<std::vector<Timer> > _slots;
+    unsigned long long _startTime;
+    unsigned long long _currentTick;
+    long _nextId;
+    // Timers due, run by the service thread one after another
+    std::vector<Timer> _expired;
+    // Timers of _expired cancelled before their callback ran
+    std::vector<long> _cancelled;
+    // Timer whose callback is running
+    long _runningId;
+    unsigned long long _missedPeriods;
+
+    int _core;
+    PerftestThread *_thread;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _finished;
+};
+
+#endif // __PERFTEST_TIMER_WHEEL_H__
@@ -26,6 +26,7 @@ class ThreadCPUAffinity {
     std::string cores_event_str;
     bool isSet;
 
+  public:
     // Helper to parse a single core string, e.g. "8-9,11,13-15"
     static std::vector<int> parse_core_list(const std::string& str) {
         std::vector<int> result;
@@ -47,7 +48,6 @@ class ThreadCPUAffinity {
         return result;
     }
 
-  public:
     ThreadCPUAffinity()
         : isSet(false) {}
 
@@ -114,6 +114,25 @@ class ThreadCPUAffinity {
       #endif
     }
 
+    // Pin the calling thread to a single core, e.g. one of get_cores_receive()
+    static bool set_current_thread_affinity(int core) {
+      #ifdef RTI_LINUX
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(core, &cpuset);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        if (error != 0) {
+          fprintf(stderr, "[ThreadCPUAffinity] Failed to set CPU affinity to core %d (error %d)\n", core, error);
+          return false;
+        }
+        return true;
+      #else
+        (void) core;
+        fprintf(stderr, "[ThreadCPUAffinity] CPU affinity is not supported on this platform\n");
+        return false;
+      #endif
+    }
+
 };
 
 #endif // THREADCPUAFFINITY_H
@@ -0,0 +1,188 @@
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include "TscClock.h"
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#if defined(PERFTEST_TSC_X86) && !defined(_MSC_VER)
+  #include <cpuid.h>
+#endif
+
+/* Drift from the monotonic clock (parts per million) reported as a warning */
+#define TSC_CLOCK_MAX_DRIFT_PPM 100.0
+
+/* Reads of the pair (counter, monotonic clock) to find the closest one */
+#define TSC_CLOCK_PAIR_READS 10
+
+#ifdef PERFTEST_TSC_X86
+/* Registers eax, ebx, ecx, edx of the given CPUID leaf, false if missing */
+static bool read_cpuid(unsigned int leaf, unsigned int registers[4])
+{
+  #ifdef _MSC_VER
+    int values[4];
+    __cpuid(values, (int) (leaf & 0x80000000));
+    if ((unsigned int) values[0] < leaf) {
+        return false;
+    }
+    __cpuid(values, (int) leaf);
+    for (int i = 0; i < 4; i++) {
+        registers[i] = (unsigned int) values[i];
+    }
+    return true;
+  #else
+    return __get_cpuid(
+            leaf,
+            &registers[0],
+            &registers[1],
+            &registers[2],
+            &registers[3]) != 0;
+  #endif
+}
+#endif
+
+TscClock::TscClock()
+        : _useRdtscp(false),
+          _nsPerTick(0),
+          _baseTicks(0),
+          _baseNs(0),
+          _checkTicks(0),
+          _nextCheck(~0ULL),
+          _checking(false),
+          _driftReported(false),
+          _maxDriftPpm(0)
+{
+  #ifdef PERFTEST_TSC_X86
+    unsigned int registers[4];
+    /* CPUID 0x80000001, EDX bit 27: rdtscp */
+    _useRdtscp = read_cpuid(0x80000001, registers)
+            && (registers[3] & (1U << 27)) != 0;
+  #endif
+}
+
+bool TscClock::is_available(std::string &reason)
+{
+  #if defined(PERFTEST_TSC_X86)
+    unsigned int registers[4];
+    /* CPUID 0x80000007, EDX bit 8: invariant TSC */
+    if (!read_cpuid(0x80000007, registers)
+            || (registers[3] & (1U << 8)) == 0) {
+        reason = "the TSC of this CPU is not invariant";
+        return false;
+    }
+    return true;
+  #elif defined(PERFTEST_TSC_ARM64)
+    /* The generic timer always runs at a constant rate */
+    return true;
+  #else
+    reason = "this platform has no supported cycle counter";
+    return false;
+  #endif
+}
+
+unsigned long long TscClock::get_monotonic_ns()
+{
+    return (unsigned long long)
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+}
+
+void TscClock::read_pair(unsigned long long &ticks, unsigned long long &ns)
+{
+    /*
+     * Take the counter between two reads of the monotonic clock, and keep the
+     * read that took less time (less likely to be interrupted).
+     */
+    unsigned long long bestWindow = ~0ULL;
+    for (int i = 0; i < TSC_CLOCK_PAIR_READS; i++) {
+        unsigned long long before = get_monotonic_ns();
+        unsigned long long counter = read_counter();
+        unsigned long long after = get_monotonic_ns();
+        if (after - before < bestWindow) {
+            bestWindow = after - before;
+            ticks = counter;
+            ns = before + (after - before) / 2;
+        }
+    }
+}
+
+bool TscClock::calibrate(unsigned int millisec)
+{
+    unsigned long long startTicks = 0;
+    unsigned long long startNs = 0;
+    unsigned long long endTicks = 0;
+    unsigned long long endNs = 0;
+
+    read_pair(startTicks, startNs);
+    std::this_thread::sleep_for(std::chrono::milliseconds(millisec));
+    read_pair(endTicks, endNs);
+
+    if (endTicks <= startTicks || endNs <= startNs) {
+        fprintf(stderr,
+                "[Error] TscClock: The counter did not advance during the "
+                "calibration.\n");
+        return false;
+    }
+
+    _nsPerTick = (double) (endNs - startNs) / (double) (endTicks - startTicks);
+    _baseTicks = endTicks;
+    _baseNs = endNs;
+    _checkTicks = (unsigned long long) (1000000000.0 / _nsPerTick);
+    _nextCheck.store(endTicks + _checkTicks);
+    return true;
+}
+
+void TscClock::check_drift(unsigned long long ticks)
+{
+    /* Only one thread checks, the others keep going */
+    bool expected = false;
+    if (!_checking.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    if (ticks < _nextCheck.load()) {
+        _checking.store(false);
+        return;
+    }
+
+    unsigned long long tscNs = _baseNs + (unsigned long long)
+            ((double) (ticks - _baseTicks) * _nsPerTick);
+    unsigned long long monotonicNs = get_monotonic_ns();
+    if (monotonicNs > _baseNs) {
+        double driftPpm = ((double) tscNs - (double) monotonicNs) * 1000000.0
+                / (double) (monotonicNs - _baseNs);
+        if (fabs(driftPpm) > fabs(_maxDriftPpm.load())) {
+            _maxDriftPpm.store(driftPpm);
+        }
+        if (fabs(driftPpm) > TSC_CLOCK_MAX_DRIFT_PPM
+                && !_driftReported.exchange(true)) {
+            fprintf(stderr,
+                    "[Warning] TscClock: The TSC clock drifted %.1f ppm from "
+                    "the monotonic clock since the calibration. Times may "
+                    "not be accurate, use the default clock.\n",
+                    driftPpm);
+        }
+    }
+
+    _nextCheck.store(ticks + _checkTicks);
+    _checking.store(false);
+}
+
+std::string TscClock::get_description() const
+{
+    std::ostringstream stream;
+    stream.setf(std::ios::fixed);
+    stream.precision(1);
+    stream << 1000.0 / _nsPerTick << " MHz, ";
+  #if defined(PERFTEST_TSC_X86)
+    stream << (_useRdtscp ? "rdtscp" : "rdtsc");
+  #elif defined(PERFTEST_TSC_ARM64)
+    stream << "cntvct_el0";
+  #endif
+    stream << ", max drift " << _maxDriftPpm.load() << " ppm";
+    return stream.str();
+}
@@ -0,0 +1,105 @@
+#ifndef __TSC_CLOCK_H__
+#define __TSC_CLOCK_H__
+
+/*
+ * (c) 2005-2024  Copyright, Real-Time Innovations, Inc. All rights reserved.
+ * Subject to Eclipse Public License v1.0; see LICENSE.md for details.
+ */
+
+#include <string>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__) \
+        || defined(_M_X64) || defined(_M_IX86)
+  #define PERFTEST_TSC_X86
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+#elif defined(__aarch64__)
+  #define PERFTEST_TSC_ARM64
+#endif
+
+/*
+ * Clock based on the Time Stamp Counter of the CPU (-clock tsc): rdtscp (or
+ * rdtsc) on x86, the virtual counter on ARM64.
+ *
+ * Reading the counter costs a few ns, so the clock adds less noise than a
+ * system call to the smallest latencies. It is only used when the counter
+ * runs at a constant rate and is synchronized between cores (invariant TSC).
+ *
+ * The frequency is calibrated against the monotonic clock of the OS at
+ * startup. While the clock is used it is compared again with the monotonic
+ * clock every second, and a warning is printed if they drift apart. The
+ * conversion is never changed during the test, so times do not jump.
+ */
+class TscClock {
+  public:
+    TscClock();
+
+    /*
+     * Whether the counter of this CPU can be used as a clock, if not the
+     * reason is returned.
+     */
+    static bool is_available(std::string &reason);
+
+    /* Measure the frequency of the counter for the given time */
+    bool calibrate(unsigned int millisec);
+
+    /*
+     * Time in ns, in the same base as the monotonic clock. PerftestClock
+     * moves it to the base of the RTI clock for getTime().
+     */
+    unsigned long long get_time_ns()
+    {
+        unsigned long long ticks = read_counter();
+        if (ticks >= _nextCheck.load(std::memory_order_relaxed)) {
+            check_drift(ticks);
+        }
+        return _baseNs + (long long)
+                ((double) (long long) (ticks - _baseTicks) * _nsPerTick);
+    }
+
+    /* Time of the monotonic clock of the OS, in ns */
+    static unsigned long long get_monotonic_ns();
+
+    /* Frequency, instruction and drift, to print in the configuration */
+    std::string get_description() const;
+
+  private:
+    unsigned long long read_counter()
+    {
+      #if defined(PERFTEST_TSC_X86)
+        if (_useRdtscp) {
+            unsigned int aux;
+            return __rdtscp(&aux);
+        }
+        return __rdtsc();
+      #elif defined(PERFTEST_TSC_ARM64)
+        unsigned long long ticks;
+        __asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+      #else
+        return 0;
+      #endif
+    }
+
+    /* Read the counter and the monotonic clock at the same time */
+    void read_pair(unsigned long long &ticks, unsigned long long &ns);
+
+    void check_drift(unsigned long long ticks);
+
+    bool _useRdtscp;
+    double _nsPerTick;
+    unsigned long long _baseTicks;
+    unsigned long long _baseNs;
+    unsigned long long _checkTicks;
+    std::atomic<unsigned long long> _nextCheck;
+    std::atomic<bool> _checking;
+    std::atomic<bool> _driftReported;
+    // Written by the thread checking the drift, read by get_description()
+    std::atomic<double> _maxDriftPpm;
+};
+
+#endif // __TSC_CLOCK_H__
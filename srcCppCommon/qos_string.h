@@ -1,6 +1,6 @@
 #include <string.h>
 #define PERFTEST_QOS_STRING_SIZE 30
-#define PERFTEST_QOS_STRING_TOTAL_SIZE 29821
+#define PERFTEST_QOS_STRING_TOTAL_SIZE 30263
 const char * PERFTEST_QOS_STRING[PERFTEST_QOS_STRING_SIZE] = {
 "<?xml version=\"1.0\" encoding=\"iso-8859-1\"?>\n\n<!--\n(c) 2005-2024 Copyright, Real-Time Innovations, Inc. All rights reserved.\nSubject to Eclipse Public License v1.0; see LICENSE.md for details.\n-->\n\n<!--\nThis file contains the QoS configurations used by RTI Perftest, RTI's\nperformance test for measuring latency and throughput of RTI Connext DDS.\n\nThe format of this file is described in the RTI Connext Core Libraries\nand Utilities User's Manual in the chapter titled \"Configuring QoS with XML.\"\n-->\n\n<dds xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n  xsi:noNamespaceSchemaLocation=\"https://community.rti.com/schema/7.3.0/rti_dds_profiles.xsd\">\n\n  <qos_library name=\"PerftestQosLibrary\">\n\n    <!-- Auxiliary QoS Snippets used to build the profiles -->\n\n    <qos_profile name=\"Reliability.StrictReliable\">\n      <base_name>\n        <element>BuiltinQosSnippetLib::QosPolicy.Reliability.Reliable</element>\n        <element>BuiltinQosSnippetLib::QosPolicy.History.KeepAll</element>\n      </base_name>\n\n      <datawrite",
 "r_qos>\n        <reliability>\n          <max_blocking_time>\n            <sec>DURATION_INFINITE_SEC</sec>\n            <nanosec>DURATION_INFINITE_NSEC</nanosec>\n          </max_blocking_time>\n        </reliability>\n\n        <protocol>\n          <rtps_reliable_writer>\n            <max_heartbeat_retries>LENGTH_UNLIMITED</max_heartbeat_retries>\n          </rtps_reliable_writer>\n        </protocol>\n      </datawriter_qos>\n\n\n      \n    </qos_profile>\n\n    <qos_profile name=\"Presentation.TopicPresentation\">\n      <!--\n      These changes are here to make sure that the DataReader can access\n      the samples in the order that they were written by the DataWriter.\n      By default, DDS does not guarantee any ordering when presenting samples\n      to the DataReader.\n\n      This profile is useful in perftest when using keyed types, since we write\n      in a round-robin fashion and we want to make sure that the DataReader reads\n      the samples in the same order that they were written, otherwise it would\n      detect some ",
@@ -30,8 +30,8 @@ const char * PERFTEST_QOS_STRING[PERFTEST_QOS_STRING_SIZE] = {
 "        </property>\n\n      </participant_qos>\n    </qos_profile>\n\n    <!--\n    Base QoS Profile:\n    Used by the rest of the profiles. Participants will be created using this profile.\n    -->\n    <qos_profile name=\"BaseProfileQos\">\n\n      <base_name>\n        <!-- General Settings that affect to all the Perftest profiles -->\n        <element>PerftestQosLibrary::Presentation.TopicPresentation</element>\n\n        <!-- Settings related to Transport -->\n        <element>PerftestQosLibrary::Perftest.Transport.UDPv4.IncreaseSendReceiveBuffers</element>\n        <element>PerftestQosLibrary::Perftest.Transport.UDPv4_WAN.IncreaseSendReceiveBuffers</element>\n        <element>PerftestQosLibrary::Perftest.Transport.TCPv4.BaseConfiguration</element>\n        <element>PerftestQosLibrary::Perftest.Transport.TCPv4.IncreaseSendReceiveBuffers</element>\n\n        <!-- Some Resource Limits had to be increased in order to run our application -->\n        <element>PerftestQosLibrary::Perftest.IncreaseResourceLimits</element>\n\n        <!",
 "-- Load the flow controllers for asynchronous publishing-->\n        <element>PerftestQosLibrary::Perftest.FlowController.1Gbps</element>\n        <element>PerftestQosLibrary::Perftest.FlowController.10Gbps</element>\n\n        <!-- For security some settings are modified from the default behavior -->\n        <element>PerftestQosLibrary::Perftest.Security</element>\n      </base_name>\n\n      <participant_qos>\n        <participant_name>\n          <name>Perftest Participant</name>\n        </participant_name>\n\n        <!--\n        Some of the properties we set may not be recognized if we are not \n        loading all the libraries (e.g: the tcp transport settings), in order to\n        avoid errors in the application we just skip their validation.\n        -->\n        <property>\n          <value>\n            <element>\n              <name>dds.participant.property_validation_action</name>\n              <value>1</value>\n            </element>\n            <element>\n                <name>dds.type_consistency.ignore_sequence_",
 "bounds</name>\n                <value>false</value>\n            </element>\n          </value>\n        </property>\n      </participant_qos>\n    </qos_profile>\n\n    <!--\n    Throughput QoS Profile:\n    This is the profile used by the throughput-testing portion of the application,\n    in the topic that sends the pings (from the Perftest publisher to the Perftest\n    subscriber).\n    -->\n    <qos_profile name=\"ThroughputQos\" base_name=\"BaseProfileQos\">\n\n      <base_name>\n        <element>PerftestQosLibrary::Reliability.StrictReliable</element>\n        <element>PerftestQosLibrary::Perftest.Throughput.ReliableSettings</element>\n        <element>PerftestQosLibrary::Perftest.Throughput.BatchingConfig</element>\n        <element>PerftestQosLibrary::Perftest.Throughput.ResourceLimits</element>\n      </base_name>\n  \n      <datawriter_qos>\n        <writer_resource_limits>\n          <max_remote_reader_filters>256</max_remote_reader_filters>\n        </writer_resource_limits>\n      </datawriter_qos>\n\n    </qos_profile>\n\n    <",
-"!--\n    Latency QoS Profile:\n    This is the profile used by the latency-testing portion of the application,\n    in the topic that sends the pongs (from the Perftest subscriber to the Perftest\n    publisher).\n    -->\n    <qos_profile name=\"LatencyQos\" base_name=\"BaseProfileQos\">\n\n      <base_name>\n        <element>PerftestQosLibrary::Reliability.StrictReliable</element>\n        <element>PerftestQosLibrary::Perftest.Latency.ReliableSettings</element>\n        <element>PerftestQosLibrary::Perftest.Latency.ResourceLimits</element>\n      </base_name>\n\n      <datareader_qos>\n        <history>\n          <kind>KEEP_LAST_HISTORY_QOS</kind>\n        </history>\n      </datareader_qos>\n\n    </qos_profile>\n\n    <!--\n    Announcement QoS Profile:\n    This profile is used by the test harness for the announcement topic,\n    which is used to synchronize the publishing and subscribing size\n    to start the test.\n    -->\n    <qos_profile name=\"AnnouncementQos\" base_name=\"LatencyQos\">\n\n      <base_name>\n        <element>BuiltinQo",
-"sSnippetLib::QosPolicy.Durability.TransientLocal</element>\n      </base_name>\n\n    </qos_profile>\n\n  </qos_library>\n</dds>" };
+"!--\n    Latency QoS Profile:\n    This is the profile used by the latency-testing portion of the application,\n    in the topic that sends the pongs (from the Perftest subscriber to the Perftest\n    publisher).\n    -->\n    <qos_profile name=\"LatencyQos\" base_name=\"BaseProfileQos\">\n\n      <base_name>\n        <element>PerftestQosLibrary::Reliability.StrictReliable</element>\n        <element>PerftestQosLibrary::Perftest.Latency.ReliableSettings</element>\n        <element>PerftestQosLibrary::Perftest.Latency.ResourceLimits</element>\n      </base_name>\n\n      <datareader_qos>\n        <history>\n          <kind>KEEP_LAST_HISTORY_QOS</kind>\n        </history>\n      </datareader_qos>\n\n    </qos_profile>\n\n    <!--\n    Latency Probe QoS Profile:\n    This profile is used by the latency probes (-latencyProbeRate), which are\n    sent from the Perftest publisher to the Perftest subscriber and echoed back\n    on their own topics. By default it is the same as the Latency profile, it\n    can be modified to measure the latency of",
+" a different QoS under load.\n    -->\n    <qos_profile name=\"LatencyProbeQos\" base_name=\"LatencyQos\">\n    </qos_profile>\n\n    <!--\n    Announcement QoS Profile:\n    This profile is used by the test harness for the announcement topic,\n    which is used to synchronize the publishing and subscribing size\n    to start the test.\n    -->\n    <qos_profile name=\"AnnouncementQos\" base_name=\"LatencyQos\">\n\n      <base_name>\n        <element>BuiltinQosSnippetLib::QosPolicy.Durability.TransientLocal</element>\n      </base_name>\n\n    </qos_profile>\n\n  </qos_library>\n</dds>" };
 
 #define PERFTEST_QOS_STRING_asString(str) {\
        int i;\